@@ -3,31 +3,204 @@
 // AST.cpp
 
 #include "AST.hpp"
+#include "LatencyTracing.hpp"
 
-void ASTPrinter::Print(const std::shared_ptr<BaseAST>& logicalExprAST, Notation notation) const
+void FactorAST::ParseLazyRange() const
+{
+    // 複数のスレッドから同時に参照されても構文解析は1回のみ行う
+    std::call_once(this->mLazyRange->mParsed, [this]() {
+        this->mExpr = this->mLazyRange->mSource->ParseRange(this->mLazyRange->mBeginIndex, this->mLazyRange->mEndIndex); });
+}
+
+std::shared_ptr<BaseAST> MakeAndOrExpression(
+    std::shared_ptr<BaseAST> left, const std::shared_ptr<BaseAST>& right, const std::string& op)
+{
+    assert(left != nullptr);
+    assert(right != nullptr);
+
+    // 左辺が同じ演算子のノードであればオペランドをまとめる
+    // 左辺のノードを他から参照していなければ (構文解析中の左結合の連続) そのまま追加し,
+    // 共有している場合は書き換えずに新しいノードにオペランドを複製する
+    // 括弧で囲まれた部分はFactorASTになっているのでまとめられない
+    std::shared_ptr<AndOrExpressionAST> andOrExprAST;
+
+    if (left->Type() == ASTType::AndOrExpression &&
+        static_cast<const AndOrExpressionAST*>(left.get())->Operator() == op) {
+        if (left.use_count() == 1) {
+            andOrExprAST = std::static_pointer_cast<AndOrExpressionAST>(std::move(left));
+        } else {
+            const auto& leftOperands = static_cast<const AndOrExpressionAST*>(left.get())->Operands();
+            std::vector<std::shared_ptr<BaseAST>> operands;
+            operands.reserve(leftOperands.size() + 1U);
+            operands.assign(leftOperands.begin(), leftOperands.end());
+            andOrExprAST = std::make_shared<AndOrExpressionAST>(std::move(operands), op);
+        }
+    } else {
+        andOrExprAST = std::make_shared<AndOrExpressionAST>();
+        andOrExprAST->SetOperator(op);
+        andOrExprAST->AddOperand(left);
+    }
+
+    // 右辺が同じ演算子のノードであればオペランドを展開する (結合則)
+    if (right->Type() == ASTType::AndOrExpression &&
+        static_cast<const AndOrExpressionAST*>(right.get())->Operator() == op) {
+        for (const auto& operand : static_cast<const AndOrExpressionAST*>(right.get())->Operands())
+            andOrExprAST->AddOperand(operand);
+    } else {
+        andOrExprAST->AddOperand(right);
+    }
+
+    return andOrExprAST;
+}
+
+std::size_t ASTChildCount(const BaseAST* exprAST)
+{
+    switch (exprAST->Type()) {
+        case ASTType::Factor:
+        case ASTType::NotExpression:
+            return 1U;
+        case ASTType::AndOrExpression:
+            return static_cast<const AndOrExpressionAST*>(exprAST)->OperandCount();
+        case ASTType::Expression:
+        case ASTType::XorExpression:
+        case ASTType::NandNorExpression:
+            return 2U;
+        default:
+            return 0U;
+    }
+}
+
+const std::shared_ptr<BaseAST>& ASTChild(const BaseAST* exprAST, std::size_t index)
+{
+    assert(index < ASTChildCount(exprAST));
+
+    switch (exprAST->Type()) {
+        case ASTType::Factor:
+            return static_cast<const FactorAST*>(exprAST)->Expr();
+        case ASTType::NotExpression:
+            return static_cast<const NotExpressionAST*>(exprAST)->Expr();
+        case ASTType::AndOrExpression:
+            return static_cast<const AndOrExpressionAST*>(exprAST)->Operand(index);
+        case ASTType::Expression:
+        {
+            const ExpressionAST* binaryAST = static_cast<const ExpressionAST*>(exprAST);
+            return (index == 0U) ? binaryAST->Left() : binaryAST->Right();
+        }
+        case ASTType::XorExpression:
+        {
+            const XorExpressionAST* binaryAST = static_cast<const XorExpressionAST*>(exprAST);
+            return (index == 0U) ? binaryAST->Left() : binaryAST->Right();
+        }
+        default:
+        {
+            const NandNorExpressionAST* binaryAST = static_cast<const NandNorExpressionAST*>(exprAST);
+            return (index == 0U) ? binaryAST->Left() : binaryAST->Right();
+        }
+    }
+}
+
+void ASTPrinter::Print(const std::shared_ptr<BaseAST>& logicalExprAST, Notation notation, std::ostream& os) const
 {
     assert(logicalExprAST != nullptr);
     assert(logicalExprAST->Type() != ASTType::Base);
 
+    ScopedPhaseTimer phaseTimer(Phase::Print);
+
+    // 出力したバイト数を数える
+    CountingStreamBuffer countingStreamBuffer(os.rdbuf());
+    std::ostream countingStream(&countingStreamBuffer);
+
     switch (notation) {
         case Notation::Infix:
-            std::cout << "Infix Expression: ";
-            this->PrintInfixNotation(logicalExprAST);
+            countingStream << "Infix Expression: ";
             break;
         case Notation::Prefix:
-            std::cout << "Prefix Expression: ";
-            this->PrintPrefixNotation(logicalExprAST);
+            countingStream << "Prefix Expression: ";
             break;
         case Notation::Postfix:
-            std::cout << "Postfix Expression: ";
-            this->PrintPostfixNotation(logicalExprAST);
+            countingStream << "Postfix Expression: ";
             break;
     }
+
+    this->PrintExpression(logicalExprAST, notation, countingStream);
     
-    std::cout << '\n';
+    countingStream << '\n';
+    PerformanceCounters::Add(PerformanceCounter::PrinterBytes, countingStreamBuffer.ByteCount());
 }
 
-void ASTPrinter::PrintInfixNotation(const std::shared_ptr<BaseAST>& logicalExprAST) const
+void ASTPrinter::PrintExpression(const std::shared_ptr<BaseAST>& logicalExprAST, Notation notation, std::ostream& os) const
+{
+    switch (notation) {
+        case Notation::Infix:
+            this->PrintInfixNotation(logicalExprAST, os);
+            break;
+        case Notation::Prefix:
+            this->PrintPrefixNotation(logicalExprAST, os);
+            break;
+        case Notation::Postfix:
+            this->PrintPostfixNotation(logicalExprAST, os);
+            break;
+    }
+}
+
+void ASTPrinter::PrintNodeRange(const BaseAST* exprAST, Notation notation, std::size_t beginChild, std::size_t endChild,
+                                std::ostream& os, const std::function<void(const std::shared_ptr<BaseAST>&, std::ostream&)>& printChild) const
+{
+    // 各記法の出力と同じ記号と区切りを, 子ノードの前後に分けて出力する
+    const std::size_t childCount = ASTChildCount(exprAST);
+    const bool isFirst = (beginChild == 0U);
+    const bool isLast = (endChild == childCount);
+    std::string op;
+
+    switch (exprAST->Type()) {
+        case ASTType::AndOrExpression:
+            op = static_cast<const AndOrExpressionAST*>(exprAST)->Operator();
+            break;
+        case ASTType::Expression:
+            op = static_cast<const ExpressionAST*>(exprAST)->Operator();
+            break;
+        case ASTType::XorExpression:
+            op = static_cast<const XorExpressionAST*>(exprAST)->Operator();
+            break;
+        case ASTType::NandNorExpression:
+            op = static_cast<const NandNorExpressionAST*>(exprAST)->Operator();
+            break;
+        default:
+            break;
+    }
+
+    const bool isFactor = (exprAST->Type() == ASTType::Factor);
+    const bool isNot = (exprAST->Type() == ASTType::NotExpression);
+
+    if (isFirst) {
+        if (notation == Notation::Infix && !isFactor)
+            os << (isNot ? "( ￢ " : "( ");
+        else if (notation == Notation::Prefix && isNot)
+            os << "￢ ";
+        else if (notation == Notation::Prefix && !isFactor)
+            for (std::size_t i = 1; i < childCount; ++i)
+                os << op << ' ';
+    }
+
+    for (std::size_t i = beginChild; i < endChild; ++i) {
+        if (i > 0U)
+            os << ((notation == Notation::Infix) ? op + ' ' : std::string(" "));
+
+        printChild(ASTChild(exprAST, i), os);
+
+        if (i > 0U && notation == Notation::Postfix)
+            os << op << ' ';
+    }
+
+    if (isLast) {
+        if (notation == Notation::Infix && !isFactor)
+            os << ") ";
+        else if (notation == Notation::Postfix && isNot)
+            os << "￢ ";
+    }
+}
+
+void ASTPrinter::PrintInfixNotation(const std::shared_ptr<BaseAST>& logicalExprAST, std::ostream& os) const
 {
     switch (logicalExprAST->Type()) {
         case ASTType::Constant:
@@ -36,7 +209,7 @@ void ASTPrinter::PrintInfixNotation(const std::shared_ptr<BaseAST>& logicalExprA
             std::shared_ptr<ConstantAST> constAST = std::dynamic_pointer_cast<ConstantAST>(logicalExprAST);
 
             if (constAST != nullptr)
-                std::cout << std::boolalpha << constAST->Value() << ' ';
+                os << std::boolalpha << constAST->Value() << ' ';
 
             return;
         }
@@ -46,7 +219,7 @@ void ASTPrinter::PrintInfixNotation(const std::shared_ptr<BaseAST>& logicalExprA
             std::shared_ptr<VariableAST> variableAST = std::dynamic_pointer_cast<VariableAST>(logicalExprAST);
 
             if (variableAST != nullptr)
-                std::cout << variableAST->Name() << ' ';
+                os << variableAST->Name() << ' ';
 
             return;
         }
@@ -56,7 +229,7 @@ void ASTPrinter::PrintInfixNotation(const std::shared_ptr<BaseAST>& logicalExprA
             std::shared_ptr<FactorAST> factorAST = std::dynamic_pointer_cast<FactorAST>(logicalExprAST);
 
             if (factorAST != nullptr)
-                this->PrintInfixNotation(factorAST->Expr());
+                this->PrintInfixNotation(factorAST->Expr(), os);
             
             return;
         }
@@ -66,10 +239,10 @@ void ASTPrinter::PrintInfixNotation(const std::shared_ptr<BaseAST>& logicalExprA
             std::shared_ptr<NotExpressionAST> notExprAST = std::dynamic_pointer_cast<NotExpressionAST>(logicalExprAST);
 
             if (notExprAST != nullptr) {
-                std::cout << "( ";
-                std::cout << "￢ ";
-                this->PrintInfixNotation(notExprAST->Expr());
-                std::cout << ") ";
+                os << "( ";
+                os << "￢ ";
+                this->PrintInfixNotation(notExprAST->Expr(), os);
+                os << ") ";
             }
 
             return;
@@ -80,11 +253,16 @@ void ASTPrinter::PrintInfixNotation(const std::shared_ptr<BaseAST>& logicalExprA
             std::shared_ptr<AndOrExpressionAST> andOrExprAST = std::dynamic_pointer_cast<AndOrExpressionAST>(logicalExprAST);
 
             if (andOrExprAST != nullptr) {
-                std::cout << "( ";
-                this->PrintInfixNotation(andOrExprAST->Left());
-                std::cout << andOrExprAST->Operator() << ' ';
-                this->PrintInfixNotation(andOrExprAST->Right());
-                std::cout << ") ";
+                os << "( ";
+
+                for (std::size_t i = 0; i < andOrExprAST->OperandCount(); ++i) {
+                    if (i > 0)
+                        os << andOrExprAST->Operator() << ' ';
+
+                    this->PrintInfixNotation(andOrExprAST->Operand(i), os);
+                }
+
+                os << ") ";
             }
 
             return;
@@ -95,11 +273,41 @@ void ASTPrinter::PrintInfixNotation(const std::shared_ptr<BaseAST>& logicalExprA
             std::shared_ptr<ExpressionAST> exprAST = std::dynamic_pointer_cast<ExpressionAST>(logicalExprAST);
 
             if (exprAST != nullptr) {
-                std::cout << "( ";
-                this->PrintInfixNotation(exprAST->Left());
-                std::cout << exprAST->Operator() << ' ';
-                this->PrintInfixNotation(exprAST->Right());
-                std::cout << ") ";
+                os << "( ";
+                this->PrintInfixNotation(exprAST->Left(), os);
+                os << exprAST->Operator() << ' ';
+                this->PrintInfixNotation(exprAST->Right(), os);
+                os << ") ";
+            }
+
+            return;
+        }
+        case ASTType::XorExpression:
+        {
+            // XorまたはXnor
+            std::shared_ptr<XorExpressionAST> exprAST = std::dynamic_pointer_cast<XorExpressionAST>(logicalExprAST);
+
+            if (exprAST != nullptr) {
+                os << "( ";
+                this->PrintInfixNotation(exprAST->Left(), os);
+                os << exprAST->Operator() << ' ';
+                this->PrintInfixNotation(exprAST->Right(), os);
+                os << ") ";
+            }
+
+            return;
+        }
+        case ASTType::NandNorExpression:
+        {
+            // NandまたはNor
+            std::shared_ptr<NandNorExpressionAST> exprAST = std::dynamic_pointer_cast<NandNorExpressionAST>(logicalExprAST);
+
+            if (exprAST != nullptr) {
+                os << "( ";
+                this->PrintInfixNotation(exprAST->Left(), os);
+                os << exprAST->Operator() << ' ';
+                this->PrintInfixNotation(exprAST->Right(), os);
+                os << ") ";
             }
 
             return;
@@ -109,7 +317,7 @@ void ASTPrinter::PrintInfixNotation(const std::shared_ptr<BaseAST>& logicalExprA
     return;
 }
 
-void ASTPrinter::PrintPrefixNotation(const std::shared_ptr<BaseAST>& logicalExprAST) const
+void ASTPrinter::PrintPrefixNotation(const std::shared_ptr<BaseAST>& logicalExprAST, std::ostream& os) const
 {
     switch (logicalExprAST->Type()) {
         case ASTType::Constant:
@@ -118,7 +326,7 @@ void ASTPrinter::PrintPrefixNotation(const std::shared_ptr<BaseAST>& logicalExpr
             std::shared_ptr<ConstantAST> constAST = std::dynamic_pointer_cast<ConstantAST>(logicalExprAST);
 
             if (constAST != nullptr)
-                std::cout << std::boolalpha << constAST->Value() << ' ';
+                os << std::boolalpha << constAST->Value() << ' ';
 
             return;
         }
@@ -128,7 +336,7 @@ void ASTPrinter::PrintPrefixNotation(const std::shared_ptr<BaseAST>& logicalExpr
             std::shared_ptr<VariableAST> variableAST = std::dynamic_pointer_cast<VariableAST>(logicalExprAST);
 
             if (variableAST != nullptr)
-                std::cout << variableAST->Name() << ' ';
+                os << variableAST->Name() << ' ';
 
             return;
         }
@@ -138,7 +346,7 @@ void ASTPrinter::PrintPrefixNotation(const std::shared_ptr<BaseAST>& logicalExpr
             std::shared_ptr<FactorAST> factorAST = std::dynamic_pointer_cast<FactorAST>(logicalExprAST);
 
             if (factorAST != nullptr)
-                this->PrintPrefixNotation(factorAST->Expr());
+                this->PrintPrefixNotation(factorAST->Expr(), os);
 
             return;
         }
@@ -148,8 +356,8 @@ void ASTPrinter::PrintPrefixNotation(const std::shared_ptr<BaseAST>& logicalExpr
             std::shared_ptr<NotExpressionAST> notExprAST = std::dynamic_pointer_cast<NotExpressionAST>(logicalExprAST);
 
             if (notExprAST != nullptr) {
-                std::cout << "￢ ";
-                this->PrintPrefixNotation(notExprAST->Expr());
+                os << "￢ ";
+                this->PrintPrefixNotation(notExprAST->Expr(), os);
             }
 
             return;
@@ -160,10 +368,16 @@ void ASTPrinter::PrintPrefixNotation(const std::shared_ptr<BaseAST>& logicalExpr
             std::shared_ptr<AndOrExpressionAST> andOrExprAST = std::dynamic_pointer_cast<AndOrExpressionAST>(logicalExprAST);
 
             if (andOrExprAST != nullptr) {
-                std::cout << andOrExprAST->Operator() << ' ';
-                this->PrintPrefixNotation(andOrExprAST->Left());
-                std::cout << ' ';
-                this->PrintPrefixNotation(andOrExprAST->Right());
+                // 2項演算子の左結合の連鎖として出力する
+                for (std::size_t i = 1; i < andOrExprAST->OperandCount(); ++i)
+                    os << andOrExprAST->Operator() << ' ';
+
+                this->PrintPrefixNotation(andOrExprAST->Operand(0), os);
+
+                for (std::size_t i = 1; i < andOrExprAST->OperandCount(); ++i) {
+                    os << ' ';
+                    this->PrintPrefixNotation(andOrExprAST->Operand(i), os);
+                }
             }
 
             return;
@@ -174,10 +388,38 @@ void ASTPrinter::PrintPrefixNotation(const std::shared_ptr<BaseAST>& logicalExpr
             std::shared_ptr<ExpressionAST> exprAST = std::dynamic_pointer_cast<ExpressionAST>(logicalExprAST);
 
             if (exprAST != nullptr) {
-                std::cout << exprAST->Operator() << ' ';
-                this->PrintPrefixNotation(exprAST->Left());
-                std::cout << ' ';
-                this->PrintPrefixNotation(exprAST->Right());
+                os << exprAST->Operator() << ' ';
+                this->PrintPrefixNotation(exprAST->Left(), os);
+                os << ' ';
+                this->PrintPrefixNotation(exprAST->Right(), os);
+            }
+
+            return;
+        }
+        case ASTType::XorExpression:
+        {
+            // XorまたはXnor
+            std::shared_ptr<XorExpressionAST> exprAST = std::dynamic_pointer_cast<XorExpressionAST>(logicalExprAST);
+
+            if (exprAST != nullptr) {
+                os << exprAST->Operator() << ' ';
+                this->PrintPrefixNotation(exprAST->Left(), os);
+                os << ' ';
+                this->PrintPrefixNotation(exprAST->Right(), os);
+            }
+
+            return;
+        }
+        case ASTType::NandNorExpression:
+        {
+            // NandまたはNor
+            std::shared_ptr<NandNorExpressionAST> exprAST = std::dynamic_pointer_cast<NandNorExpressionAST>(logicalExprAST);
+
+            if (exprAST != nullptr) {
+                os << exprAST->Operator() << ' ';
+                this->PrintPrefixNotation(exprAST->Left(), os);
+                os << ' ';
+                this->PrintPrefixNotation(exprAST->Right(), os);
             }
 
             return;
@@ -187,7 +429,7 @@ void ASTPrinter::PrintPrefixNotation(const std::shared_ptr<BaseAST>& logicalExpr
     return;
 }
 
-void ASTPrinter::PrintPostfixNotation(const std::shared_ptr<BaseAST>& logicalExprAST) const
+void ASTPrinter::PrintPostfixNotation(const std::shared_ptr<BaseAST>& logicalExprAST, std::ostream& os) const
 {
     switch (logicalExprAST->Type()) {
         case ASTType::Constant:
@@ -196,7 +438,7 @@ void ASTPrinter::PrintPostfixNotation(const std::shared_ptr<BaseAST>& logicalExp
             std::shared_ptr<ConstantAST> constAST = std::dynamic_pointer_cast<ConstantAST>(logicalExprAST);
 
             if (constAST != nullptr)
-                std::cout << std::boolalpha << constAST->Value() << ' ';
+                os << std::boolalpha << constAST->Value() << ' ';
 
             return;
         }
@@ -206,7 +448,7 @@ void ASTPrinter::PrintPostfixNotation(const std::shared_ptr<BaseAST>& logicalExp
             std::shared_ptr<VariableAST> variableAST = std::dynamic_pointer_cast<VariableAST>(logicalExprAST);
 
             if (variableAST != nullptr)
-                std::cout << variableAST->Name() << ' ';
+                os << variableAST->Name() << ' ';
 
             return;
         }
@@ -216,7 +458,7 @@ void ASTPrinter::PrintPostfixNotation(const std::shared_ptr<BaseAST>& logicalExp
             std::shared_ptr<FactorAST> factorAST = std::dynamic_pointer_cast<FactorAST>(logicalExprAST);
 
             if (factorAST != nullptr)
-                this->PrintPostfixNotation(factorAST->Expr());
+                this->PrintPostfixNotation(factorAST->Expr(), os);
 
             return;
         }
@@ -226,8 +468,8 @@ void ASTPrinter::PrintPostfixNotation(const std::shared_ptr<BaseAST>& logicalExp
             std::shared_ptr<NotExpressionAST> notExprAST = std::dynamic_pointer_cast<NotExpressionAST>(logicalExprAST);
 
             if (notExprAST != nullptr) {
-                this->PrintPostfixNotation(notExprAST->Expr());
-                std::cout << "￢ ";
+                this->PrintPostfixNotation(notExprAST->Expr(), os);
+                os << "￢ ";
             }
 
             return;
@@ -238,10 +480,14 @@ void ASTPrinter::PrintPostfixNotation(const std::shared_ptr<BaseAST>& logicalExp
             std::shared_ptr<AndOrExpressionAST> andOrExprAST = std::dynamic_pointer_cast<AndOrExpressionAST>(logicalExprAST);
 
             if (andOrExprAST != nullptr) {
-                this->PrintPostfixNotation(andOrExprAST->Left());
-                std::cout << ' ';
-                this->PrintPostfixNotation(andOrExprAST->Right());
-                std::cout << andOrExprAST->Operator() << ' ';
+                // 2項演算子の左結合の連鎖として出力する
+                this->PrintPostfixNotation(andOrExprAST->Operand(0), os);
+
+                for (std::size_t i = 1; i < andOrExprAST->OperandCount(); ++i) {
+                    os << ' ';
+                    this->PrintPostfixNotation(andOrExprAST->Operand(i), os);
+                    os << andOrExprAST->Operator() << ' ';
+                }
             }
 
             return;
@@ -252,10 +498,38 @@ void ASTPrinter::PrintPostfixNotation(const std::shared_ptr<BaseAST>& logicalExp
             std::shared_ptr<ExpressionAST> exprAST = std::dynamic_pointer_cast<ExpressionAST>(logicalExprAST);
 
             if (exprAST != nullptr) {
-                this->PrintPostfixNotation(exprAST->Left());
-                std::cout << ' ';
-                this->PrintPostfixNotation(exprAST->Right());
-                std::cout << exprAST->Operator() << ' ';
+                this->PrintPostfixNotation(exprAST->Left(), os);
+                os << ' ';
+                this->PrintPostfixNotation(exprAST->Right(), os);
+                os << exprAST->Operator() << ' ';
+            }
+
+            return;
+        }
+        case ASTType::XorExpression:
+        {
+            // XorまたはXnor
+            std::shared_ptr<XorExpressionAST> exprAST = std::dynamic_pointer_cast<XorExpressionAST>(logicalExprAST);
+
+            if (exprAST != nullptr) {
+                this->PrintPostfixNotation(exprAST->Left(), os);
+                os << ' ';
+                this->PrintPostfixNotation(exprAST->Right(), os);
+                os << exprAST->Operator() << ' ';
+            }
+
+            return;
+        }
+        case ASTType::NandNorExpression:
+        {
+            // NandまたはNor
+            std::shared_ptr<NandNorExpressionAST> exprAST = std::dynamic_pointer_cast<NandNorExpressionAST>(logicalExprAST);
+
+            if (exprAST != nullptr) {
+                this->PrintPostfixNotation(exprAST->Left(), os);
+                os << ' ';
+                this->PrintPostfixNotation(exprAST->Right(), os);
+                os << exprAST->Operator() << ' ';
             }
 
             return;
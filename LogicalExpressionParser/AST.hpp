@@ -8,9 +8,14 @@
 #pragma once
 
 #include <cassert>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+#include "PerformanceCounters.hpp"
 
 /*
 ʂ̏ȗK܂߂_̕@ (EBNF)
@@ -22,15 +27,17 @@
     '(' <Expression> ')'
 <NotExpression> ::=
     <Factor> |
-    'Not' <Factor>
+    'Not' <NotExpression>
 <AndOrExpression> ::=
-    <NotExpression> |
-    <NotExpression> 'And' <NotExpression> |
-    <NotExpression> 'Or' <NotExpression>
+    <NotExpression> { <AndOrOperator> <NotExpression> }
+<AndOrOperator> ::= 'And' | 'Or' | 'Xor' | 'Xnor' | 'Nand' | 'Nor'
+    (SēD揇ʂō, AndOr͓Zq̘A1̃m[hɂ܂Ƃ߂)
 <Expression> ::=
     <AndOrExpression> |
-    <AndOrExpression> '->' <AndOrExpression> |
-    <AndOrExpression> '<->' <AndOrExpression>
+    <AndOrExpression> '->' <Expression> |
+    <AndOrExpression> '<->' <Expression>
+    (E)
+uL@̍\͉͊Zq̕\(Parser.cpp)pD揇ʖ@ŏL̕@͂
  */
 
 enum class ASTType {
@@ -39,13 +46,15 @@ enum class ASTType {
     NotExpression,
     AndOrExpression,
     Expression,
+    XorExpression,
+    NandNorExpression,
     Constant,
     Variable
 };
 
 class BaseAST {
 public:
-    BaseAST(ASTType type) : mType(type) { }
+    BaseAST(ASTType type) : mType(type) { PerformanceCounters::CountASTNode(type); }
     virtual ~BaseAST() { }
 
     inline ASTType Type() const { return this->mType; }
@@ -54,19 +63,48 @@ private:
     ASTType mType;
 };
 
+// x\͂, ܂\͂ĂȂʂ̒g\͂
+class LazyExpressionSource {
+public:
+    virtual ~LazyExpressionSource() { }
+
+    // beginIndexendIndex̒O܂ł̃g[N\͂
+    virtual std::shared_ptr<BaseAST> ParseRange(std::size_t beginIndex, std::size_t endIndex) = 0;
+};
+
 class FactorAST : public BaseAST {
 public:
     FactorAST(const std::shared_ptr<BaseAST>& expr) :
         BaseAST(ASTType::Factor), mExpr(expr) { }
+    // ʂ̒gg[N͈̔͂Ƃĕێ, ŏɎQƂꂽƂɍ\͂
+    // \͂Ɏsꍇ, ExprnullptrԂ
+    FactorAST(const std::shared_ptr<LazyExpressionSource>& lazySource, std::size_t beginIndex, std::size_t endIndex) :
+        BaseAST(ASTType::Factor), mLazyRange(std::make_unique<LazyRange>(lazySource, beginIndex, endIndex)) { }
     FactorAST() :
         BaseAST(ASTType::Factor) { }
     ~FactorAST() { }
 
-    inline const std::shared_ptr<BaseAST>& Expr() const { return this->mExpr; }
-    void SetExpr(const std::shared_ptr<BaseAST>& exprAST) { this->mExpr = exprAST; }
+    inline const std::shared_ptr<BaseAST>& Expr() const {
+        if (this->mLazyRange != nullptr)
+            this->ParseLazyRange();
+        return this->mExpr; }
+    void SetExpr(const std::shared_ptr<BaseAST>& exprAST) { this->mLazyRange.reset(); this->mExpr = exprAST; }
 
 private:
-    std::shared_ptr<BaseAST> mExpr;
+    struct LazyRange {
+        LazyRange(const std::shared_ptr<LazyExpressionSource>& source, std::size_t beginIndex, std::size_t endIndex) :
+            mSource(source), mBeginIndex(beginIndex), mEndIndex(endIndex) { }
+
+        std::shared_ptr<LazyExpressionSource> mSource;
+        std::size_t mBeginIndex;
+        std::size_t mEndIndex;
+        std::once_flag mParsed;
+    };
+
+    void ParseLazyRange() const;
+
+    mutable std::shared_ptr<BaseAST> mExpr;
+    std::unique_ptr<LazyRange> mLazyRange;
 };
 
 class NotExpressionAST : public BaseAST {
@@ -84,25 +122,29 @@ private:
     std::shared_ptr<BaseAST> mExpr;
 };
 
+// Zq(And܂Or)̘A1̃m[hɂ܂Ƃ, IyhzŎ
 class AndOrExpressionAST : public BaseAST {
 public:
     AndOrExpressionAST(const std::shared_ptr<BaseAST>& left, const std::shared_ptr<BaseAST>& right, const std::string& op) :
-        BaseAST(ASTType::AndOrExpression), mLeft(left), mRight(right), mOperator(op) { }
+        BaseAST(ASTType::AndOrExpression), mOperands { left, right }, mOperator(op) { }
+    AndOrExpressionAST(std::vector<std::shared_ptr<BaseAST>>&& operands, const std::string& op) :
+        BaseAST(ASTType::AndOrExpression), mOperands(std::move(operands)), mOperator(op) { }
     AndOrExpressionAST() :
         BaseAST(ASTType::AndOrExpression) { }
     ~AndOrExpressionAST() { }
 
-    inline const std::shared_ptr<BaseAST>& Left() const { return this->mLeft; }
-    inline const std::shared_ptr<BaseAST>& Right() const { return this->mRight; }
+    inline const std::vector<std::shared_ptr<BaseAST>>& Operands() const { return this->mOperands; }
+    inline std::size_t OperandCount() const { return this->mOperands.size(); }
+    inline const std::shared_ptr<BaseAST>& Operand(std::size_t index) const { return this->mOperands[index]; }
     inline const std::string& Operator() const { return this->mOperator; }
 
-    void SetLeft(const std::shared_ptr<BaseAST>& leftExprAST) { this->mLeft = leftExprAST; }
-    void SetRight(const std::shared_ptr<BaseAST>& rightExprAST) { this->mRight = rightExprAST; }
+    void AddOperand(const std::shared_ptr<BaseAST>& exprAST) { this->mOperands.push_back(exprAST); }
+    void SetOperand(std::size_t index, const std::shared_ptr<BaseAST>& exprAST) { this->mOperands[index] = exprAST; }
+    void SetOperands(std::vector<std::shared_ptr<BaseAST>>&& operands) { this->mOperands = std::move(operands); }
     void SetOperator(const std::string& op) { this->mOperator = op; }
 
 private:
-    std::shared_ptr<BaseAST> mLeft;
-    std::shared_ptr<BaseAST> mRight;
+    std::vector<std::shared_ptr<BaseAST>> mOperands;
     std::string mOperator;
 };
 
@@ -128,6 +170,52 @@ private:
     std::string mOperator;
 };
 
+// Zq "" (Xor) ܂ "" (Xnor)
+class XorExpressionAST : public BaseAST {
+public:
+    XorExpressionAST(const std::shared_ptr<BaseAST>& left, const std::shared_ptr<BaseAST>& right, const std::string& op) :
+        BaseAST(ASTType::XorExpression), mLeft(left), mRight(right), mOperator(op) { }
+    XorExpressionAST() :
+        BaseAST(ASTType::XorExpression) { }
+    ~XorExpressionAST() { }
+
+    inline const std::shared_ptr<BaseAST>& Left() const { return this->mLeft; }
+    inline const std::shared_ptr<BaseAST>& Right() const { return this->mRight; }
+    inline const std::string& Operator() const { return this->mOperator; }
+
+    void SetLeft(const std::shared_ptr<BaseAST>& leftExprAST) { this->mLeft = leftExprAST; }
+    void SetRight(const std::shared_ptr<BaseAST>& rightExprAST) { this->mRight = rightExprAST; }
+    void SetOperator(const std::string& op) { this->mOperator = op; }
+
+private:
+    std::shared_ptr<BaseAST> mLeft;
+    std::shared_ptr<BaseAST> mRight;
+    std::string mOperator;
+};
+
+// Zq "" (Nand) ܂ "" (Nor)
+class NandNorExpressionAST : public BaseAST {
+public:
+    NandNorExpressionAST(const std::shared_ptr<BaseAST>& left, const std::shared_ptr<BaseAST>& right, const std::string& op) :
+        BaseAST(ASTType::NandNorExpression), mLeft(left), mRight(right), mOperator(op) { }
+    NandNorExpressionAST() :
+        BaseAST(ASTType::NandNorExpression) { }
+    ~NandNorExpressionAST() { }
+
+    inline const std::shared_ptr<BaseAST>& Left() const { return this->mLeft; }
+    inline const std::shared_ptr<BaseAST>& Right() const { return this->mRight; }
+    inline const std::string& Operator() const { return this->mOperator; }
+
+    void SetLeft(const std::shared_ptr<BaseAST>& leftExprAST) { this->mLeft = leftExprAST; }
+    void SetRight(const std::shared_ptr<BaseAST>& rightExprAST) { this->mRight = rightExprAST; }
+    void SetOperator(const std::string& op) { this->mOperator = op; }
+
+private:
+    std::shared_ptr<BaseAST> mLeft;
+    std::shared_ptr<BaseAST> mRight;
+    std::string mOperator;
+};
+
 class ConstantAST : public BaseAST {
 public:
     ConstantAST(bool value) : BaseAST(ASTType::Constant), mValue(value) { }
@@ -154,6 +242,14 @@ private:
     std::string mName;
 };
 
+// ӂ𑼂QƂĂȂꍇɌ, ӂ̃m[hɃIyhǉĕԂ
+std::shared_ptr<BaseAST> MakeAndOrExpression(
+    std::shared_ptr<BaseAST> left, const std::shared_ptr<BaseAST>& right, const std::string& op);
+
+// qm[h̐Ǝqm[h (萔ƕϐ͎qȂ, 2Zq͍, Eӂ̏)
+std::size_t ASTChildCount(const BaseAST* exprAST);
+const std::shared_ptr<BaseAST>& ASTChild(const BaseAST* exprAST, std::size_t index);
+
 enum class Notation {
     Infix,
     Prefix,
@@ -165,12 +261,20 @@ public:
     ASTPrinter() = default;
     ~ASTPrinter() = default;
 
-    void Print(const std::shared_ptr<BaseAST>& logicalExprAST, Notation notation) const;
+    void Print(const std::shared_ptr<BaseAST>& logicalExprAST, Notation notation, std::ostream& os = std::cout) const;
+    // oƉstɘ_݂̂o͂
+    void PrintExpression(const std::shared_ptr<BaseAST>& logicalExprAST, Notation notation, std::ostream& os) const;
+
+    // m[h̋LƋ؂̂, beginChildendChild̒O܂ł̎qm[hɊւ镔o͂
+    // qm[hprintChildŏo͂̂, qm[h͈̔͂ƂɕʁXɏo͂ďɘA
+    // m[hŜo͂̂ƓɂȂ
+    void PrintNodeRange(const BaseAST* exprAST, Notation notation, std::size_t beginChild, std::size_t endChild,
+                        std::ostream& os, const std::function<void(const std::shared_ptr<BaseAST>&, std::ostream&)>& printChild) const;
 
 private:
-    void PrintInfixNotation(const std::shared_ptr<BaseAST>& logicalExprAST) const;
-    void PrintPrefixNotation(const std::shared_ptr<BaseAST>& logicalExprAST) const;
-    void PrintPostfixNotation(const std::shared_ptr<BaseAST>& logicalExprAST) const;
+    void PrintInfixNotation(const std::shared_ptr<BaseAST>& logicalExprAST, std::ostream& os) const;
+    void PrintPrefixNotation(const std::shared_ptr<BaseAST>& logicalExprAST, std::ostream& os) const;
+    void PrintPostfixNotation(const std::shared_ptr<BaseAST>& logicalExprAST, std::ostream& os) const;
 };
 
 #endif // LOGICAL_EXPRESSION_PARSER_AST_HPP
@@ -0,0 +1,774 @@
+
+// LogicalExpressionParser
+// AndInverterGraph.cpp
+
+#include "AndInverterGraph.hpp"
+#include "AST.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <utility>
+
+//
+// Jbg̊֐蒼߂̕i
+//
+
+// 4ϐ̐^l\ (rbgi, ϐj̒lĩrbgjł銄蓖Ăł̒l)
+using TruthTable4 = std::uint16_t;
+
+static constexpr TruthTable4 VariableTruthTables[4] = { 0xAAAAU, 0xCCCCU, 0xF0F0U, 0xFF00U };
+static constexpr std::size_t MaxCutSize = 4U;
+static constexpr std::size_t MaxCutsPerNode = 6U;
+
+static inline TruthTable4 Cofactor0(TruthTable4 truthTable, unsigned int variable)
+{
+    TruthTable4 lower = truthTable & static_cast<TruthTable4>(~VariableTruthTables[variable]);
+    return static_cast<TruthTable4>(lower | (lower << (1U << variable)));
+}
+
+static inline TruthTable4 Cofactor1(TruthTable4 truthTable, unsigned int variable)
+{
+    TruthTable4 upper = truthTable & VariableTruthTables[variable];
+    return static_cast<TruthTable4>(upper | (upper >> (1U << variable)));
+}
+
+// ύ (mMask̃rbgĂϐ݂̂܂, ̒lmValue̓rbgɎ)
+struct Cube4 {
+    std::uint8_t mMask;
+    std::uint8_t mValue;
+};
+
+// Minato-Morreau̕@, lower  f  upper ƂȂ璷ȐϘa`f, f̐^l\Ԃ
+static TruthTable4 IrredundantSumOfProducts(TruthTable4 lower, TruthTable4 upper, std::vector<Cube4>& cubes)
+{
+    if (lower == 0U)
+        return 0U;
+
+    if (upper == 0xFFFFU) {
+        cubes.push_back(Cube4 { 0U, 0U });
+        return 0xFFFFU;
+    }
+
+    // lowerupperˑłԍ̑傫ϐŕ
+    int variable = 3;
+
+    while (variable >= 0 &&
+           Cofactor0(lower, variable) == Cofactor1(lower, variable) &&
+           Cofactor0(upper, variable) == Cofactor1(upper, variable))
+        --variable;
+
+    assert(variable >= 0);
+
+    TruthTable4 lower0 = Cofactor0(lower, variable);
+    TruthTable4 lower1 = Cofactor1(lower, variable);
+    TruthTable4 upper0 = Cofactor0(upper, variable);
+    TruthTable4 upper1 = Cofactor1(upper, variable);
+    std::uint8_t bit = static_cast<std::uint8_t>(1U << variable);
+
+    // ϐȖɂ, ^̑ɂ
+    std::size_t firstCube = cubes.size();
+    TruthTable4 result0 = IrredundantSumOfProducts(lower0 & static_cast<TruthTable4>(~upper1), upper0, cubes);
+
+    for (std::size_t i = firstCube; i < cubes.size(); ++i)
+        cubes[i].mMask |= bit;
+
+    firstCube = cubes.size();
+    TruthTable4 result1 = IrredundantSumOfProducts(lower1 & static_cast<TruthTable4>(~upper0), upper1, cubes);
+
+    for (std::size_t i = firstCube; i < cubes.size(); ++i) {
+        cubes[i].mMask |= bit;
+        cubes[i].mValue |= bit;
+    }
+
+    // c͕ϐ܂܂Ȃύŕ
+    TruthTable4 lowerRest = (lower0 & static_cast<TruthTable4>(~result0)) | (lower1 & static_cast<TruthTable4>(~result1));
+    TruthTable4 resultRest = IrredundantSumOfProducts(lowerRest, upper0 & upper1, cubes);
+
+    return (result0 & static_cast<TruthTable4>(~VariableTruthTables[variable])) |
+           (result1 & VariableTruthTables[variable]) | resultRest;
+}
+
+/*
+Jbg̊֐t邽߂̎菇
+Iyh0U, 1^, ti(i + 1) * 2, Q[gg(g + 5) * 2, ŉʃrbgے
+ */
+struct Recipe {
+    std::vector<std::pair<std::uint8_t, std::uint8_t>> mGates;
+    std::uint8_t mOutput = 0U;
+};
+
+class RecipeBuilder {
+public:
+    RecipeBuilder(Recipe& recipe) : mRecipe(recipe) { }
+
+    std::uint8_t And(std::uint8_t left, std::uint8_t right) {
+        if (left > right)
+            std::swap(left, right);
+        if (left == 0U)
+            return 0U;
+        if (left == 1U)
+            return right;
+        if (left == right)
+            return left;
+        if ((left ^ 1U) == right)
+            return 0U;
+
+        auto iter = this->mGateIndices.find({ left, right });
+
+        if (iter != this->mGateIndices.end())
+            return iter->second;
+
+        std::uint8_t gate = static_cast<std::uint8_t>((this->mRecipe.mGates.size() + 5U) * 2U);
+        this->mRecipe.mGates.emplace_back(left, right);
+        this->mGateIndices.emplace(std::make_pair(left, right), gate);
+        return gate;
+    }
+
+    std::uint8_t Or(std::uint8_t left, std::uint8_t right) {
+        return this->And(left ^ 1U, right ^ 1U) ^ 1U; }
+
+    // ł̐ύɌ郊ełoȂϘa`gݗĂ
+    std::uint8_t Factor(const std::vector<Cube4>& cubes) {
+        if (cubes.empty())
+            return 0U;
+
+        for (const auto& cube : cubes)
+            if (cube.mMask == 0U)
+                return 1U;
+
+        unsigned int literalCounts[8] = { };
+
+        for (const auto& cube : cubes)
+            for (unsigned int variable = 0; variable < 4U; ++variable)
+                if (cube.mMask & (1U << variable))
+                    ++literalCounts[variable * 2U + ((cube.mValue >> variable) & 1U)];
+
+        unsigned int bestLiteral = 0U;
+
+        for (unsigned int literal = 1; literal < 8U; ++literal)
+            if (literalCounts[literal] > literalCounts[bestLiteral])
+                bestLiteral = literal;
+
+        if (literalCounts[bestLiteral] < 2U || cubes.size() == 1U) {
+            std::uint8_t result = 0U;
+
+            for (const auto& cube : cubes)
+                result = this->Or(result, this->CubeOperand(cube));
+
+            return result;
+        }
+
+        unsigned int variable = bestLiteral / 2U;
+        std::uint8_t bit = static_cast<std::uint8_t>(1U << variable);
+        std::uint8_t value = static_cast<std::uint8_t>((bestLiteral & 1U) << variable);
+        std::vector<Cube4> quotient;
+        std::vector<Cube4> remainder;
+
+        for (const auto& cube : cubes) {
+            if ((cube.mMask & bit) && (cube.mValue & bit) == value)
+                quotient.push_back(Cube4 { static_cast<std::uint8_t>(cube.mMask & ~bit), static_cast<std::uint8_t>(cube.mValue & ~bit) });
+            else
+                remainder.push_back(cube);
+        }
+
+        std::uint8_t literalOperand = static_cast<std::uint8_t>((variable + 1U) * 2U + ((bestLiteral & 1U) ^ 1U));
+        return this->Or(this->And(literalOperand, this->Factor(quotient)), this->Factor(remainder));
+    }
+
+private:
+    std::uint8_t CubeOperand(const Cube4& cube) {
+        std::uint8_t result = 1U;
+
+        for (unsigned int variable = 0; variable < 4U; ++variable)
+            if (cube.mMask & (1U << variable))
+                result = this->And(result, static_cast<std::uint8_t>((variable + 1U) * 2U + (((cube.mValue >> variable) & 1U) ^ 1U)));
+
+        return result;
+    }
+
+    Recipe& mRecipe;
+    std::map<std::pair<std::uint8_t, std::uint8_t>, std::uint8_t> mGateIndices;
+};
+
+// ֐Ƃ̔ے̐Ϙa`, Q[g̏Ȃg
+static Recipe MakeRecipe(TruthTable4 truthTable)
+{
+    Recipe recipes[2];
+
+    for (unsigned int complemented = 0; complemented < 2U; ++complemented) {
+        TruthTable4 onSet = complemented ? static_cast<TruthTable4>(~truthTable) : truthTable;
+        std::vector<Cube4> cubes;
+        IrredundantSumOfProducts(onSet, onSet, cubes);
+
+        RecipeBuilder recipeBuilder(recipes[complemented]);
+        recipes[complemented].mOutput = static_cast<std::uint8_t>(recipeBuilder.Factor(cubes) ^ complemented);
+    }
+
+    return (recipes[1].mGates.size() < recipes[0].mGates.size()) ? recipes[1] : recipes[0];
+}
+
+// Jbg (t͔ԍ̏, ti^l\̕ϐi)
+struct Cut {
+    std::uint32_t   mLeaves[MaxCutSize];
+    std::uint8_t    mSize;
+    TruthTable4     mTruthTable;
+    float           mAreaFlow;
+
+    bool Contains(const Cut& other) const {
+        // other̗tSẴJbgɊ܂܂
+        std::size_t j = 0;
+
+        for (std::size_t i = 0; i < other.mSize; ++i) {
+            while (j < this->mSize && this->mLeaves[j] < other.mLeaves[i])
+                ++j;
+            if (j == this->mSize || this->mLeaves[j] != other.mLeaves[i])
+                return false;
+        }
+
+        return true;
+    }
+};
+
+// 2̃Jbg̗t̘aW (傫𒴂false)
+static bool MergeLeaves(const Cut& left, const Cut& right, Cut& merged)
+{
+    std::size_t i = 0;
+    std::size_t j = 0;
+    merged.mSize = 0U;
+
+    while (i < left.mSize || j < right.mSize) {
+        std::uint32_t leaf;
+
+        if (j == right.mSize || (i < left.mSize && left.mLeaves[i] < right.mLeaves[j]))
+            leaf = left.mLeaves[i++];
+        else if (i == left.mSize || right.mLeaves[j] < left.mLeaves[i])
+            leaf = right.mLeaves[j++];
+        else
+            leaf = left.mLeaves[i++], ++j;
+
+        if (merged.mSize == MaxCutSize)
+            return false;
+
+        merged.mLeaves[merged.mSize++] = leaf;
+    }
+
+    return true;
+}
+
+// Jbg̐^l\, t܂ނ傫ȃJbg̕ϐŕ\
+static TruthTable4 ExpandTruthTable(const Cut& cut, const Cut& merged)
+{
+    unsigned int positions[MaxCutSize];
+
+    for (std::size_t i = 0, j = 0; i < cut.mSize; ++i) {
+        while (j < merged.mSize && merged.mLeaves[j] != cut.mLeaves[i])
+            ++j;
+        positions[i] = static_cast<unsigned int>(j);
+    }
+
+    TruthTable4 truthTable = 0U;
+
+    for (unsigned int minterm = 0; minterm < 16U; ++minterm) {
+        unsigned int index = 0U;
+
+        for (std::size_t i = 0; i < cut.mSize; ++i)
+            index |= ((minterm >> positions[i]) & 1U) << i;
+
+        if ((cut.mTruthTable >> index) & 1U)
+            truthTable |= static_cast<TruthTable4>(1U << minterm);
+    }
+
+    return truthTable;
+}
+
+//
+// AndInverterGraphNX
+//
+
+AndInverterGraph::AndInverterGraph()
+{
+    // m[h0͒萔 (t@j͎gȂ)
+    this->mNodes.push_back(Node { FalseEdge, FalseEdge });
+}
+
+AIGEdge AndInverterGraph::Input(const std::string& name)
+{
+    auto iter = this->mInputEdges.find(name);
+
+    if (iter != this->mInputEdges.end())
+        return iter->second;
+
+    AIGEdge edge = MakeEdge(static_cast<std::uint32_t>(this->mNodes.size()), false);
+    this->mNodes.push_back(Node { InputMarker, static_cast<AIGEdge>(this->mInputNames.size()) });
+    this->mInputNames.push_back(name);
+    this->mInputEdges.emplace(name, edge);
+
+    return edge;
+}
+
+AIGEdge AndInverterGraph::And(AIGEdge left, AIGEdge right)
+{
+    // 萔͔ԍł̂, בւƍɗ
+    if (left > right)
+        std::swap(left, right);
+
+    if (left == FalseEdge)
+        return FalseEdge;
+    if (left == TrueEdge)
+        return right;
+    if (left == right)
+        return left;
+    if (left == Not(right))
+        return FalseEdge;
+
+    std::uint64_t key = (static_cast<std::uint64_t>(left) << 32) | right;
+    auto iter = this->mStructuralHash.find(key);
+
+    if (iter != this->mStructuralHash.end())
+        return MakeEdge(iter->second, false);
+
+    std::uint32_t nodeIndex = static_cast<std::uint32_t>(this->mNodes.size());
+    this->mNodes.push_back(Node { left, right });
+    this->mStructuralHash.emplace(key, nodeIndex);
+
+    return MakeEdge(nodeIndex, false);
+}
+
+AIGEdge AndInverterGraph::FromAST(const std::shared_ptr<BaseAST>& logicalExprAST)
+{
+    assert(logicalExprAST != nullptr);
+
+    switch (logicalExprAST->Type()) {
+        case ASTType::Constant:
+            return std::static_pointer_cast<ConstantAST>(logicalExprAST)->Value() ? TrueEdge : FalseEdge;
+        case ASTType::Variable:
+            return this->Input(std::static_pointer_cast<VariableAST>(logicalExprAST)->Name());
+        case ASTType::Factor:
+            return this->FromAST(std::static_pointer_cast<FactorAST>(logicalExprAST)->Expr());
+        case ASTType::NotExpression:
+            return Not(this->FromAST(std::static_pointer_cast<NotExpressionAST>(logicalExprAST)->Expr()));
+        case ASTType::AndOrExpression:
+        {
+            // OrAnd̔ےŕ\
+            const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(logicalExprAST.get());
+            bool isOr = (andOrExprAST->Operator() == "");
+            AIGEdge result = TrueEdge;
+
+            for (const auto& operand : andOrExprAST->Operands())
+                result = this->And(result, NotIf(this->FromAST(operand), isOr));
+
+            return NotIf(result, isOr);
+        }
+        case ASTType::Expression:
+        {
+            const ExpressionAST* exprAST = static_cast<const ExpressionAST*>(logicalExprAST.get());
+            AIGEdge left = this->FromAST(exprAST->Left());
+            AIGEdge right = this->FromAST(exprAST->Right());
+
+            if (exprAST->Operator() == "->")
+                return Not(this->And(left, Not(right)));
+
+            return Not(this->Xor(left, right));
+        }
+        case ASTType::XorExpression:
+        {
+            const XorExpressionAST* xorExprAST = static_cast<const XorExpressionAST*>(logicalExprAST.get());
+            AIGEdge result = this->Xor(this->FromAST(xorExprAST->Left()), this->FromAST(xorExprAST->Right()));
+            return NotIf(result, xorExprAST->Operator() != "");
+        }
+        case ASTType::NandNorExpression:
+        {
+            const NandNorExpressionAST* nandNorExprAST = static_cast<const NandNorExpressionAST*>(logicalExprAST.get());
+            AIGEdge left = this->FromAST(nandNorExprAST->Left());
+            AIGEdge right = this->FromAST(nandNorExprAST->Right());
+
+            if (nandNorExprAST->Operator() == "")
+                return this->And(Not(left), Not(right));
+
+            return Not(this->And(left, right));
+        }
+        default:
+            assert(false);
+            return FalseEdge;
+    }
+}
+
+std::shared_ptr<BaseAST> AndInverterGraph::ToAST(AIGEdge edge) const
+{
+    // o͂瓞Bł͈͂Ńt@AEg𐔂, LĂȂAnd݂̂𑽓͂Andɂ܂Ƃ߂
+    std::unordered_map<std::uint32_t, std::uint32_t> fanoutCounts;
+    std::vector<std::uint32_t> pendingNodes { NodeIndex(edge) };
+
+    while (!pendingNodes.empty()) {
+        std::uint32_t nodeIndex = pendingNodes.back();
+        pendingNodes.pop_back();
+
+        if (!this->IsAnd(nodeIndex))
+            continue;
+
+        for (AIGEdge fanin : { this->mNodes[nodeIndex].mFanin0, this->mNodes[nodeIndex].mFanin1 })
+            if (fanoutCounts[NodeIndex(fanin)]++ == 0U)
+                pendingNodes.push_back(NodeIndex(fanin));
+    }
+
+    std::unordered_map<AIGEdge, std::shared_ptr<BaseAST>> exportedEdges;
+
+    std::function<std::shared_ptr<BaseAST>(AIGEdge)> exportEdge = [&](AIGEdge currentEdge) -> std::shared_ptr<BaseAST> {
+        auto iter = exportedEdges.find(currentEdge);
+
+        if (iter != exportedEdges.end())
+            return iter->second;
+
+        std::uint32_t nodeIndex = NodeIndex(currentEdge);
+        std::shared_ptr<BaseAST> exprAST;
+
+        if (nodeIndex == 0U) {
+            exprAST = std::make_shared<ConstantAST>(currentEdge == TrueEdge);
+        } else if (this->IsInput(nodeIndex)) {
+            exprAST = std::make_shared<VariableAST>(this->mInputNames[this->mNodes[nodeIndex].mFanin1]);
+
+            if (IsComplemented(currentEdge))
+                exprAST = std::make_shared<NotExpressionAST>(exprAST);
+        } else {
+            std::vector<AIGEdge> leaves;
+            std::vector<AIGEdge> pendingEdges { this->mNodes[nodeIndex].mFanin1, this->mNodes[nodeIndex].mFanin0 };
+
+            while (!pendingEdges.empty()) {
+                AIGEdge fanin = pendingEdges.back();
+                pendingEdges.pop_back();
+
+                if (!IsComplemented(fanin) && this->IsAnd(NodeIndex(fanin)) && fanoutCounts[NodeIndex(fanin)] == 1U) {
+                    pendingEdges.push_back(this->mNodes[NodeIndex(fanin)].mFanin1);
+                    pendingEdges.push_back(this->mNodes[NodeIndex(fanin)].mFanin0);
+                } else {
+                    leaves.push_back(fanin);
+                }
+            }
+
+            // ےAnd̗tSĔےł, ےOtOrɂ
+            bool isOr = IsComplemented(currentEdge) &&
+                std::all_of(leaves.begin(), leaves.end(), [](AIGEdge leaf) { return IsComplemented(leaf); });
+            std::vector<std::shared_ptr<BaseAST>> operands;
+
+            for (AIGEdge leaf : leaves)
+                operands.push_back(exportEdge(NotIf(leaf, isOr)));
+
+            exprAST = std::make_shared<AndOrExpressionAST>(std::move(operands), isOr ? "" : "");
+
+            if (IsComplemented(currentEdge) && !isOr)
+                exprAST = std::make_shared<NotExpressionAST>(exprAST);
+        }
+
+        exportedEdges.emplace(currentEdge, exprAST);
+        return exprAST;
+    };
+
+    return exportEdge(edge);
+}
+
+std::vector<std::uint32_t> AndInverterGraph::FanoutCounts() const
+{
+    std::vector<std::uint32_t> fanoutCounts(this->mNodes.size(), 0U);
+
+    for (std::uint32_t nodeIndex = 1; nodeIndex < this->mNodes.size(); ++nodeIndex) {
+        if (this->IsAnd(nodeIndex)) {
+            ++fanoutCounts[NodeIndex(this->mNodes[nodeIndex].mFanin0)];
+            ++fanoutCounts[NodeIndex(this->mNodes[nodeIndex].mFanin1)];
+        }
+    }
+
+    for (AIGEdge output : this->mOutputs)
+        ++fanoutCounts[NodeIndex(output)];
+
+    return fanoutCounts;
+}
+
+std::vector<std::uint32_t> AndInverterGraph::Levels() const
+{
+    // t@j͕KO̔ԍȂ̂, ԍ̏ɋ܂
+    std::vector<std::uint32_t> levels(this->mNodes.size(), 0U);
+
+    for (std::uint32_t nodeIndex = 1; nodeIndex < this->mNodes.size(); ++nodeIndex)
+        if (this->IsAnd(nodeIndex))
+            levels[nodeIndex] = 1U + std::max(levels[NodeIndex(this->mNodes[nodeIndex].mFanin0)],
+                                              levels[NodeIndex(this->mNodes[nodeIndex].mFanin1)]);
+
+    return levels;
+}
+
+std::size_t AndInverterGraph::Depth() const
+{
+    std::vector<std::uint32_t> levels = this->Levels();
+    std::size_t depth = 0U;
+
+    for (AIGEdge output : this->mOutputs)
+        depth = std::max<std::size_t>(depth, levels[NodeIndex(output)]);
+
+    return depth;
+}
+
+AndInverterGraph AndInverterGraph::CopyInputs() const
+{
+    AndInverterGraph graph;
+
+    for (const auto& inputName : this->mInputNames)
+        graph.Input(inputName);
+
+    return graph;
+}
+
+std::optional<std::vector<bool>> AndInverterGraph::EvaluateOutputs(const VariableAssignment& assignment) const
+{
+    std::vector<std::uint8_t> values(this->mNodes.size(), 0U);
+
+    for (std::uint32_t nodeIndex = 1; nodeIndex < this->mNodes.size(); ++nodeIndex) {
+        const Node& node = this->mNodes[nodeIndex];
+
+        if (node.mFanin0 == InputMarker) {
+            auto iter = assignment.find(this->mInputNames[node.mFanin1]);
+
+            if (iter == assignment.end())
+                return std::nullopt;
+
+            values[nodeIndex] = iter->second ? 1U : 0U;
+        } else {
+            values[nodeIndex] = (values[NodeIndex(node.mFanin0)] ^ (node.mFanin0 & 1U)) &
+                                (values[NodeIndex(node.mFanin1)] ^ (node.mFanin1 & 1U));
+        }
+    }
+
+    std::vector<bool> outputValues;
+    outputValues.reserve(this->mOutputs.size());
+
+    for (AIGEdge output : this->mOutputs)
+        outputValues.push_back((values[NodeIndex(output)] ^ (output & 1U)) != 0U);
+
+    return outputValues;
+}
+
+AndInverterGraph AndInverterGraph::Balance() const
+{
+    std::vector<std::uint32_t> fanoutCounts = this->FanoutCounts();
+    std::size_t nodeCount = this->mNodes.size();
+
+    // o͂tɂǂ, KvAndƂɑAnd̗tW߂
+    std::vector<bool> required(nodeCount, false);
+    std::vector<std::pair<std::size_t, std::size_t>> leafRanges(nodeCount, { 0U, 0U });
+    std::vector<AIGEdge> leaves;
+    std::vector<AIGEdge> pendingEdges;
+
+    for (AIGEdge output : this->mOutputs)
+        required[NodeIndex(output)] = true;
+
+    for (std::uint32_t nodeIndex = static_cast<std::uint32_t>(nodeCount) - 1U; nodeIndex > 0U; --nodeIndex) {
+        if (!required[nodeIndex] || !this->IsAnd(nodeIndex))
+            continue;
+
+        std::size_t firstLeaf = leaves.size();
+        pendingEdges.assign({ this->mNodes[nodeIndex].mFanin0, this->mNodes[nodeIndex].mFanin1 });
+
+        while (!pendingEdges.empty()) {
+            AIGEdge fanin = pendingEdges.back();
+            pendingEdges.pop_back();
+
+            if (!IsComplemented(fanin) && this->IsAnd(NodeIndex(fanin)) && fanoutCounts[NodeIndex(fanin)] == 1U) {
+                pendingEdges.push_back(this->mNodes[NodeIndex(fanin)].mFanin0);
+                pendingEdges.push_back(this->mNodes[NodeIndex(fanin)].mFanin1);
+            } else {
+                leaves.push_back(fanin);
+                required[NodeIndex(fanin)] = true;
+            }
+        }
+
+        leafRanges[nodeIndex] = { firstLeaf, leaves.size() };
+    }
+
+    // ԍ̏ɍ蒼 (t͒ȉ2gݍ킹)
+    AndInverterGraph graph = this->CopyInputs();
+    std::vector<AIGEdge> mappedEdges(nodeCount, FalseEdge);
+    std::vector<std::uint32_t> levels(graph.NodeCount(), 0U);
+    std::vector<AIGEdge> mappedLeaves;
+
+    for (std::uint32_t nodeIndex = 1; nodeIndex < nodeCount; ++nodeIndex) {
+        if (this->IsInput(nodeIndex)) {
+            mappedEdges[nodeIndex] = graph.Input(this->mInputNames[this->mNodes[nodeIndex].mFanin1]);
+            continue;
+        }
+
+        if (!required[nodeIndex])
+            continue;
+
+        mappedLeaves.clear();
+
+        for (std::size_t i = leafRanges[nodeIndex].first; i < leafRanges[nodeIndex].second; ++i)
+            mappedLeaves.push_back(NotIf(mappedEdges[NodeIndex(leaves[i])], IsComplemented(leaves[i])));
+
+        std::sort(mappedLeaves.begin(), mappedLeaves.end());
+        mappedLeaves.erase(std::unique(mappedLeaves.begin(), mappedLeaves.end()), mappedLeaves.end());
+
+        using LevelEdge = std::pair<std::uint32_t, AIGEdge>;
+        std::priority_queue<LevelEdge, std::vector<LevelEdge>, std::greater<LevelEdge>> pendingLeaves;
+
+        for (AIGEdge leaf : mappedLeaves)
+            pendingLeaves.emplace(levels[NodeIndex(leaf)], leaf);
+
+        while (pendingLeaves.size() > 1U) {
+            LevelEdge first = pendingLeaves.top();
+            pendingLeaves.pop();
+            LevelEdge second = pendingLeaves.top();
+            pendingLeaves.pop();
+
+            AIGEdge edge = graph.And(first.second, second.second);
+
+            if (NodeIndex(edge) >= levels.size())
+                levels.push_back(1U + std::max(first.first, second.first));
+
+            pendingLeaves.emplace(levels[NodeIndex(edge)], edge);
+        }
+
+        mappedEdges[nodeIndex] = pendingLeaves.empty() ? TrueEdge : pendingLeaves.top().second;
+    }
+
+    for (AIGEdge output : this->mOutputs)
+        graph.AddOutput(NotIf(mappedEdges[NodeIndex(output)], IsComplemented(output)));
+
+    return graph;
+}
+
+AndInverterGraph AndInverterGraph::Rewrite() const
+{
+    std::vector<std::uint32_t> fanoutCounts = this->FanoutCounts();
+    std::size_t nodeCount = this->mNodes.size();
+
+    // ԍ̏ɃJbg񋓂 (m[hƂ̃Jbgcuts[cutRanges[i]]cuts[cutRanges[i + 1]]̒O܂)
+    // em[h̍Ō̃Jbg̓m[hĝ݂tƂ鎩ȃJbg
+    std::vector<Cut> cuts;
+    std::vector<std::size_t> cutRanges(nodeCount + 1U, 0U);
+    std::vector<float> areaFlows(nodeCount, 0.0F);
+    std::vector<std::size_t> bestCuts(nodeCount, 0U);
+    std::unordered_map<TruthTable4, Recipe> recipes;
+    std::vector<Cut> nodeCuts;
+
+    auto recipeFor = [&recipes](TruthTable4 truthTable) -> const Recipe& {
+        auto iter = recipes.find(truthTable);
+
+        if (iter == recipes.end())
+            iter = recipes.emplace(truthTable, MakeRecipe(truthTable)).first;
+
+        return iter->second;
+    };
+
+    for (std::uint32_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex) {
+        cutRanges[nodeIndex] = cuts.size();
+        nodeCuts.clear();
+
+        if (this->IsAnd(nodeIndex)) {
+            AIGEdge fanin0 = this->mNodes[nodeIndex].mFanin0;
+            AIGEdge fanin1 = this->mNodes[nodeIndex].mFanin1;
+
+            for (std::size_t i = cutRanges[NodeIndex(fanin0)]; i < cutRanges[NodeIndex(fanin0) + 1U]; ++i) {
+                for (std::size_t j = cutRanges[NodeIndex(fanin1)]; j < cutRanges[NodeIndex(fanin1) + 1U]; ++j) {
+                    Cut cut;
+
+                    if (!MergeLeaves(cuts[i], cuts[j], cut))
+                        continue;
+
+                    // ɂJbgɊ܂܂Jbg͗vȂ
+                    if (std::any_of(nodeCuts.begin(), nodeCuts.end(), [&cut](const Cut& other) { return cut.Contains(other); }))
+                        continue;
+
+                    nodeCuts.erase(std::remove_if(nodeCuts.begin(), nodeCuts.end(),
+                        [&cut](const Cut& other) { return other.Contains(cut); }), nodeCuts.end());
+
+                    TruthTable4 truthTable0 = ExpandTruthTable(cuts[i], cut);
+                    TruthTable4 truthTable1 = ExpandTruthTable(cuts[j], cut);
+                    cut.mTruthTable = static_cast<TruthTable4>((IsComplemented(fanin0) ? ~truthTable0 : truthTable0) &
+                                                               (IsComplemented(fanin1) ? ~truthTable1 : truthTable1));
+
+                    // GAt[ (蒼ɗvAnd̐, t̃GAt[t@AEgŕa)
+                    cut.mAreaFlow = static_cast<float>(recipeFor(cut.mTruthTable).mGates.size());
+
+                    for (std::size_t k = 0; k < cut.mSize; ++k)
+                        cut.mAreaFlow += areaFlows[cut.mLeaves[k]] / static_cast<float>(std::max(1U, fanoutCounts[cut.mLeaves[k]]));
+
+                    nodeCuts.push_back(cut);
+                }
+            }
+
+            // GAt[̏Jbgc
+            std::stable_sort(nodeCuts.begin(), nodeCuts.end(), [](const Cut& left, const Cut& right) {
+                return (left.mAreaFlow != right.mAreaFlow) ? left.mAreaFlow < right.mAreaFlow : left.mSize < right.mSize; });
+
+            if (nodeCuts.size() > MaxCutsPerNode)
+                nodeCuts.resize(MaxCutsPerNode);
+
+            assert(!nodeCuts.empty());
+            areaFlows[nodeIndex] = nodeCuts.front().mAreaFlow;
+            bestCuts[nodeIndex] = cuts.size();
+            cuts.insert(cuts.end(), nodeCuts.begin(), nodeCuts.end());
+        }
+
+        // ͂And͎gtƂJbg (萔̓JbgȂ)
+        if (nodeIndex != 0U)
+            cuts.push_back(Cut { { nodeIndex, 0U, 0U, 0U }, 1U, VariableTruthTables[0], areaFlows[nodeIndex] });
+    }
+
+    cutRanges[nodeCount] = cuts.size();
+
+    // o͂tɂǂ, I񂾃Jbg̗tKvȃm[hƂ
+    std::vector<bool> required(nodeCount, false);
+
+    for (AIGEdge output : this->mOutputs)
+        required[NodeIndex(output)] = true;
+
+    for (std::uint32_t nodeIndex = static_cast<std::uint32_t>(nodeCount) - 1U; nodeIndex > 0U; --nodeIndex) {
+        if (!required[nodeIndex] || !this->IsAnd(nodeIndex))
+            continue;
+
+        const Cut& cut = cuts[bestCuts[nodeIndex]];
+
+        for (std::size_t k = 0; k < cut.mSize; ++k)
+            required[cut.mLeaves[k]] = true;
+    }
+
+    // ԍ̏, I񂾃Jbg̊֐t (\nbVő̃m[hƋL)
+    AndInverterGraph graph = this->CopyInputs();
+    std::vector<AIGEdge> mappedEdges(nodeCount, FalseEdge);
+    std::vector<AIGEdge> operandEdges;
+
+    for (std::uint32_t nodeIndex = 1; nodeIndex < nodeCount; ++nodeIndex) {
+        if (this->IsInput(nodeIndex)) {
+            mappedEdges[nodeIndex] = graph.Input(this->mInputNames[this->mNodes[nodeIndex].mFanin1]);
+            continue;
+        }
+
+        if (!required[nodeIndex])
+            continue;
+
+        const Cut& cut = cuts[bestCuts[nodeIndex]];
+        const Recipe& recipe = recipeFor(cut.mTruthTable);
+
+        operandEdges.assign({ FalseEdge, TrueEdge });
+
+        for (std::size_t k = 0; k < MaxCutSize; ++k) {
+            AIGEdge leafEdge = (k < cut.mSize) ? mappedEdges[cut.mLeaves[k]] : FalseEdge;
+            operandEdges.push_back(leafEdge);
+            operandEdges.push_back(Not(leafEdge));
+        }
+
+        for (const auto& gate : recipe.mGates) {
+            AIGEdge edge = graph.And(operandEdges[gate.first], operandEdges[gate.second]);
+            operandEdges.push_back(edge);
+            operandEdges.push_back(Not(edge));
+        }
+
+        mappedEdges[nodeIndex] = operandEdges[recipe.mOutput];
+    }
+
+    for (AIGEdge output : this->mOutputs)
+        graph.AddOutput(NotIf(mappedEdges[NodeIndex(output)], IsComplemented(output)));
+
+    return graph;
+}
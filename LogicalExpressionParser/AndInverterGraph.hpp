@@ -0,0 +1,109 @@
+// LogicalExpressionParser
+// AndInverterGraph.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_AND_INVERTER_GRAPH_HPP
+#define LOGICAL_EXPRESSION_PARSER_AND_INVERTER_GRAPH_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Evaluator.hpp"
+
+class BaseAST;
+
+// } (m[h̔ԍ1rbgɂ炵, ŉʃrbgےƂ)
+using AIGEdge = std::uint32_t;
+
+/*
+And-Inverter Graph (2͂AndƔے̎}݂̂ŕ\_̗L񏄉Ot)
+m[h0͒萔̋U,  (ϐ) And̃m[h̓t@j̔ԍ
+And͍\nbVœt@j̑gɓm[hԂ, 萔⓯}̑g͍OɊȖ񂷂
+̋Ko͂Ƃ1̃Otɓ, K܂ŕL
+ */
+class AndInverterGraph {
+public:
+    static constexpr AIGEdge FalseEdge = 0U;
+    static constexpr AIGEdge TrueEdge = 1U;
+
+    AndInverterGraph();
+    ~AndInverterGraph() = default;
+
+    AndInverterGraph(AndInverterGraph&&) = default;
+    AndInverterGraph& operator=(AndInverterGraph&&) = default;
+
+    static inline AIGEdge Not(AIGEdge edge) { return edge ^ 1U; }
+    static inline AIGEdge NotIf(AIGEdge edge, bool complemented) { return edge ^ (complemented ? 1U : 0U); }
+    static inline std::uint32_t NodeIndex(AIGEdge edge) { return edge >> 1; }
+    static inline bool IsComplemented(AIGEdge edge) { return (edge & 1U) != 0U; }
+    static inline AIGEdge MakeEdge(std::uint32_t nodeIndex, bool complemented) { return (nodeIndex << 1) | (complemented ? 1U : 0U); }
+
+    // 萔Ɠ͂܂ރm[h̐
+    inline std::size_t NodeCount() const { return this->mNodes.size(); }
+    inline std::size_t AndCount() const { return this->mNodes.size() - 1U - this->mInputNames.size(); }
+    inline std::size_t InputCount() const { return this->mInputNames.size(); }
+    inline const std::string& InputName(std::size_t inputIndex) const { return this->mInputNames[inputIndex]; }
+    inline const std::vector<AIGEdge>& Outputs() const { return this->mOutputs; }
+
+    inline bool IsInput(std::uint32_t nodeIndex) const { return nodeIndex != 0U && this->mNodes[nodeIndex].mFanin0 == InputMarker; }
+    inline bool IsAnd(std::uint32_t nodeIndex) const { return nodeIndex != 0U && this->mNodes[nodeIndex].mFanin0 != InputMarker; }
+    inline AIGEdge Fanin0(std::uint32_t nodeIndex) const { assert(this->IsAnd(nodeIndex)); return this->mNodes[nodeIndex].mFanin0; }
+    inline AIGEdge Fanin1(std::uint32_t nodeIndex) const { assert(this->IsAnd(nodeIndex)); return this->mNodes[nodeIndex].mFanin1; }
+
+    // O̕ϐɂ͓}Ԃ
+    AIGEdge Input(const std::string& name);
+    AIGEdge And(AIGEdge left, AIGEdge right);
+    inline AIGEdge Or(AIGEdge left, AIGEdge right) { return Not(this->And(Not(left), Not(right))); }
+    inline AIGEdge Xor(AIGEdge left, AIGEdge right) {
+        return this->Or(this->And(left, Not(right)), this->And(Not(left), right)); }
+
+    // -><->, Xor, Nand, NorAndƔےɓWJ
+    AIGEdge FromAST(const std::shared_ptr<BaseAST>& logicalExprAST);
+    // And̘A1AndOrExpressionASTɂ܂Ƃ, ے̎}݂̂And̓hEK̖@Orɂ
+    // Lꂽm[h͒ۍ\؂łL
+    std::shared_ptr<BaseAST> ToAST(AIGEdge edge) const;
+
+    inline std::size_t AddOutput(AIGEdge edge) { this->mOutputs.push_back(edge); return this->mOutputs.size() - 1U; }
+
+    // o͂̒i (And̐) ̍ől
+    std::size_t Depth() const;
+
+    // o͂Ƃ̒l (Ot̓͂ɒl̖ϐstd::nullopt)
+    std::optional<std::vector<bool>> EvaluateOutputs(const VariableAssignment& assignment) const;
+
+    // ȉ̍œK, o͂瓞Błm[ĥ݂ō蒼OtԂ (͂Əo͕͂̏ςȂ)
+
+    // ے̖Pt@AEgAnd̘A1̑AndƂ݂Ȃ, ȉɑgݍ킹Ēi炷
+    AndInverterGraph Balance() const;
+    // m[hƂ4͈ȉ̃Jbg񋓂Ċ֐^l\ŋ, Ϙa`ō蒼
+    // m[ȟς (GAt[) ŏ̃JbgIŏo͂畢
+    AndInverterGraph Rewrite() const;
+
+private:
+    // ͂̃m[hmFanin0InputMarker, mFanin1ɓ͂̔ԍ
+    static constexpr AIGEdge InputMarker = ~static_cast<AIGEdge>(0U);
+
+    struct Node {
+        AIGEdge mFanin0;
+        AIGEdge mFanin1;
+    };
+
+    std::vector<std::uint32_t> FanoutCounts() const;
+    std::vector<std::uint32_t> Levels() const;
+    // ݂͂̂𓯂ŎOt
+    AndInverterGraph CopyInputs() const;
+
+    std::vector<Node> mNodes;
+    std::vector<std::string> mInputNames;
+    std::unordered_map<std::string, AIGEdge> mInputEdges;
+    std::unordered_map<std::uint64_t, std::uint32_t> mStructuralHash;
+    std::vector<AIGEdge> mOutputs;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_AND_INVERTER_GRAPH_HPP
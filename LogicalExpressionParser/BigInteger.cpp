@@ -0,0 +1,183 @@
+
+// LogicalExpressionParser
+// BigInteger.cpp
+
+#include "BigInteger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+BigInteger::BigInteger(std::uint64_t value)
+{
+    while (value != 0U) {
+        this->mLimbs.push_back(static_cast<std::uint32_t>(value));
+        value >>= 32;
+    }
+}
+
+BigInteger BigInteger::PowerOfTwo(std::size_t exponent)
+{
+    BigInteger result;
+    result.mLimbs.assign(exponent / 32U + 1U, 0U);
+    result.mLimbs.back() = static_cast<std::uint32_t>(1U) << (exponent % 32U);
+
+    return result;
+}
+
+std::size_t BigInteger::BitLength() const
+{
+    if (this->mLimbs.empty())
+        return 0U;
+
+    std::size_t bitLength = (this->mLimbs.size() - 1U) * 32U;
+
+    for (std::uint32_t topLimb = this->mLimbs.back(); topLimb != 0U; topLimb >>= 1)
+        ++bitLength;
+
+    return bitLength;
+}
+
+BigInteger& BigInteger::operator+=(const BigInteger& rhs)
+{
+    if (this->mLimbs.size() < rhs.mLimbs.size())
+        this->mLimbs.resize(rhs.mLimbs.size(), 0U);
+
+    std::uint64_t carry = 0U;
+
+    for (std::size_t i = 0; i < this->mLimbs.size(); ++i) {
+        std::uint64_t sum = static_cast<std::uint64_t>(this->mLimbs[i]) + carry +
+                            (i < rhs.mLimbs.size() ? rhs.mLimbs[i] : 0U);
+        this->mLimbs[i] = static_cast<std::uint32_t>(sum);
+        carry = sum >> 32;
+
+        // Eӂ̌g؂, JオΎč͕ςȂ
+        if (carry == 0U && i + 1U >= rhs.mLimbs.size())
+            break;
+    }
+
+    if (carry != 0U)
+        this->mLimbs.push_back(static_cast<std::uint32_t>(carry));
+
+    return *this;
+}
+
+BigInteger& BigInteger::operator*=(const BigInteger& rhs)
+{
+    if (this->IsZero() || rhs.IsZero()) {
+        this->mLimbs.clear();
+        return *this;
+    }
+
+    // MZɂZ (グ̌ʂ͍̌XSxȂ̂ŏ\)
+    std::vector<std::uint32_t> product(this->mLimbs.size() + rhs.mLimbs.size(), 0U);
+
+    for (std::size_t i = 0; i < this->mLimbs.size(); ++i) {
+        std::uint64_t carry = 0U;
+
+        for (std::size_t j = 0; j < rhs.mLimbs.size(); ++j) {
+            std::uint64_t value = static_cast<std::uint64_t>(this->mLimbs[i]) * rhs.mLimbs[j] + product[i + j] + carry;
+            product[i + j] = static_cast<std::uint32_t>(value);
+            carry = value >> 32;
+        }
+
+        product[i + rhs.mLimbs.size()] = static_cast<std::uint32_t>(carry);
+    }
+
+    this->mLimbs = std::move(product);
+    this->Normalize();
+
+    return *this;
+}
+
+BigInteger& BigInteger::operator<<=(std::size_t shift)
+{
+    if (this->IsZero() || shift == 0U)
+        return *this;
+
+    std::size_t limbShift = shift / 32U;
+    unsigned int bitShift = static_cast<unsigned int>(shift % 32U);
+
+    if (bitShift != 0U) {
+        std::uint32_t carry = 0U;
+
+        for (auto& limb : this->mLimbs) {
+            std::uint32_t nextCarry = limb >> (32U - bitShift);
+            limb = (limb << bitShift) | carry;
+            carry = nextCarry;
+        }
+
+        if (carry != 0U)
+            this->mLimbs.push_back(carry);
+    }
+
+    this->mLimbs.insert(this->mLimbs.begin(), limbShift, 0U);
+
+    return *this;
+}
+
+double BigInteger::ToScaledDouble(std::size_t exponent) const
+{
+    if (this->IsZero())
+        return 0.0;
+
+    // 64rbĝ݂ƂĎg
+    std::size_t bitLength = this->BitLength();
+    std::size_t lowBits = bitLength > 64U ? bitLength - 64U : 0U;
+    std::uint64_t mantissa = 0U;
+
+    for (std::size_t i = bitLength; i > lowBits; --i) {
+        std::size_t bit = i - 1U;
+        mantissa = (mantissa << 1) | ((this->mLimbs[bit / 32U] >> (bit % 32U)) & 1U);
+    }
+
+    return std::ldexp(static_cast<double>(mantissa),
+        static_cast<int>(static_cast<long long>(lowBits) - static_cast<long long>(exponent)));
+}
+
+std::string BigInteger::ToString() const
+{
+    if (this->IsZero())
+        return "0";
+
+    // 10^9Ŋ]ʂ珇ɋ߂
+    std::vector<std::uint32_t> limbs = this->mLimbs;
+    std::vector<std::uint32_t> chunks;
+
+    while (!limbs.empty()) {
+        std::uint64_t remainder = 0U;
+
+        for (std::size_t i = limbs.size(); i > 0; --i) {
+            std::uint64_t value = (remainder << 32) | limbs[i - 1U];
+            limbs[i - 1U] = static_cast<std::uint32_t>(value / 1000000000U);
+            remainder = value % 1000000000U;
+        }
+
+        chunks.push_back(static_cast<std::uint32_t>(remainder));
+
+        while (!limbs.empty() && limbs.back() == 0U)
+            limbs.pop_back();
+    }
+
+    std::string text = std::to_string(chunks.back());
+
+    for (std::size_t i = chunks.size() - 1U; i > 0; --i) {
+        std::string chunk = std::to_string(chunks[i - 1U]);
+        text.append(9U - chunk.size(), '0');
+        text += chunk;
+    }
+
+    return text;
+}
+
+void BigInteger::Normalize()
+{
+    while (!this->mLimbs.empty() && this->mLimbs.back() == 0U)
+        this->mLimbs.pop_back();
+}
+
+std::ostream& operator<<(std::ostream& os, const BigInteger& value)
+{
+    os << value.ToString();
+    return os;
+}
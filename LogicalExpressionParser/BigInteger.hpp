@@ -0,0 +1,51 @@
+// LogicalExpressionParser
+// BigInteger.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_BIG_INTEGER_HPP
+#define LOGICAL_EXPRESSION_PARSER_BIG_INTEGER_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// CӐx̔񕉐 ([銄蓖Ă̌Ȃ, 2̕ϐ܂ŕ\)
+class BigInteger {
+public:
+    BigInteger(std::uint64_t value = 0U);
+    ~BigInteger() = default;
+
+    // 2exponent
+    static BigInteger PowerOfTwo(std::size_t exponent);
+
+    inline bool IsZero() const { return this->mLimbs.empty(); }
+    std::size_t BitLength() const;
+
+    BigInteger& operator+=(const BigInteger& rhs);
+    BigInteger& operator*=(const BigInteger& rhs);
+    BigInteger& operator<<=(std::size_t shift);
+
+    inline BigInteger operator+(const BigInteger& rhs) const { BigInteger result = *this; return result += rhs; }
+    inline BigInteger operator*(const BigInteger& rhs) const { BigInteger result = *this; return result *= rhs; }
+    inline BigInteger operator<<(std::size_t shift) const { BigInteger result = *this; return result <<= shift; }
+
+    inline bool operator==(const BigInteger& rhs) const { return this->mLimbs == rhs.mLimbs; }
+    inline bool operator!=(const BigInteger& rhs) const { return this->mLimbs != rhs.mLimbs; }
+
+    // l2exponentŊl{xŋߎ (l傫ĂӂꂵȂ)
+    double ToScaledDouble(std::size_t exponent = 0U) const;
+    std::string ToString() const;
+
+private:
+    void Normalize();
+
+    // ʂ̌珇32rbgi[ (ŏʂ̌0łȂ)
+    std::vector<std::uint32_t> mLimbs;
+};
+
+std::ostream& operator<<(std::ostream& os, const BigInteger& value);
+
+#endif // LOGICAL_EXPRESSION_PARSER_BIG_INTEGER_HPP
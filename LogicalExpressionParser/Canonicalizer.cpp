@@ -0,0 +1,447 @@
+
+// LogicalExpressionParser
+// Canonicalizer.cpp
+
+#include "Canonicalizer.hpp"
+#include "AST.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// \nbVŃm[h̎ނʂl
+enum class NodeTag : std::uint64_t {
+    Constant = 1,
+    Variable,
+    And,
+    Or,
+    Implies,
+    Equivalent,
+    Xor,
+    Nand,
+    Nor,
+    TruthTable
+};
+
+// ے͎ẘerbg𔽓]lƂ (dے肪ɖ߂, And̒xƁxw䂾Ōt)
+static constexpr std::uint64_t NotMaskHigh = 0xC2B2AE3D27D4EB4FULL;
+static constexpr std::uint64_t NotMaskLow = 0x165667B19E3779F9ULL;
+
+// ϐƂ̒l̃rbg (rbgi, ϐj̒lĩrbgjł銄蓖)
+static constexpr std::uint64_t VariablePatterns[Canonicalizer::MaxSemanticVariables] = {
+    0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+};
+
+static inline std::uint64_t Mix64(std::uint64_t value)
+{
+    // splitmix64̎dグ
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ULL;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBULL;
+    value ^= value >> 31;
+    return value;
+}
+
+static inline Fingerprint NegateFingerprint(const Fingerprint& fingerprint)
+{
+    return Fingerprint { fingerprint.mHigh ^ NotMaskHigh, fingerprint.mLow ^ NotMaskLow };
+}
+
+// 264rbg̒lʁXɍ킹128rbg̎w
+class FingerprintBuilder {
+public:
+    FingerprintBuilder(NodeTag tag) :
+        mHigh(0x6A09E667F3BCC908ULL),
+        mLow(0xBB67AE8584CAA73BULL) { this->Add(static_cast<std::uint64_t>(tag)); }
+
+    inline void Add(std::uint64_t value) {
+        this->mLow = Mix64(this->mLow ^ value);
+        this->mHigh = Mix64((this->mHigh ^ ((value << 29) | (value >> 35))) + 0x9E3779B97F4A7C15ULL); }
+    inline void Add(const Fingerprint& fingerprint) {
+        this->Add(fingerprint.mHigh);
+        this->Add(fingerprint.mLow); }
+    void Add(const std::string& text) {
+        this->Add(static_cast<std::uint64_t>(text.size()));
+
+        for (std::size_t i = 0; i < text.size(); i += 8U) {
+            std::uint64_t chunk = 0U;
+            std::memcpy(&chunk, text.data() + i, std::min<std::size_t>(8U, text.size() - i));
+            this->Add(chunk);
+        }
+    }
+
+    inline Fingerprint Finish() const { return Fingerprint { this->mHigh, this->mLow }; }
+
+private:
+    std::uint64_t mHigh;
+    std::uint64_t mLow;
+};
+
+std::string Fingerprint::ToString() const
+{
+    char text[33];
+    std::snprintf(text, sizeof(text), "%016llx%016llx",
+                  static_cast<unsigned long long>(this->mHigh), static_cast<unsigned long long>(this->mLow));
+    return text;
+}
+
+static bool IsConstant(const std::shared_ptr<BaseAST>& exprAST, bool& value)
+{
+    if (exprAST->Type() != ASTType::Constant)
+        return false;
+
+    value = std::static_pointer_cast<ConstantAST>(exprAST)->Value();
+    return true;
+}
+
+static void CollectVariableNames(const BaseAST* exprAST, std::vector<std::string>& variableNames)
+{
+    if (exprAST->Type() == ASTType::Variable) {
+        variableNames.push_back(static_cast<const VariableAST*>(exprAST)->Name());
+        return;
+    }
+
+    for (std::size_t i = 0; i < ASTChildCount(exprAST); ++i)
+        CollectVariableNames(ASTChild(exprAST, i).get(), variableNames);
+}
+
+// ϐƂ̒l̃rbg, 64ʂ̊蓖Ă𓯎ɕ]
+static std::uint64_t EvaluateTruthTable(const BaseAST* exprAST, const std::vector<std::string>& variableNames,
+                                        const std::vector<std::uint64_t>& variableValues)
+{
+    auto evaluateChild = [&](std::size_t childIndex) {
+        return EvaluateTruthTable(ASTChild(exprAST, childIndex).get(), variableNames, variableValues); };
+
+    switch (exprAST->Type()) {
+        case ASTType::Constant:
+            return static_cast<const ConstantAST*>(exprAST)->Value() ? ~0ULL : 0ULL;
+        case ASTType::Variable:
+        {
+            auto iter = std::lower_bound(variableNames.begin(), variableNames.end(),
+                                         static_cast<const VariableAST*>(exprAST)->Name());
+            return variableValues[static_cast<std::size_t>(iter - variableNames.begin())];
+        }
+        case ASTType::Factor:
+            return evaluateChild(0);
+        case ASTType::NotExpression:
+            return ~evaluateChild(0);
+        case ASTType::AndOrExpression:
+        {
+            bool isOr = (static_cast<const AndOrExpressionAST*>(exprAST)->Operator() == "");
+            std::uint64_t value = isOr ? 0ULL : ~0ULL;
+
+            for (std::size_t i = 0; i < ASTChildCount(exprAST); ++i)
+                value = isOr ? (value | evaluateChild(i)) : (value & evaluateChild(i));
+
+            return value;
+        }
+        case ASTType::Expression:
+        {
+            std::uint64_t left = evaluateChild(0);
+            std::uint64_t right = evaluateChild(1);
+            return (static_cast<const ExpressionAST*>(exprAST)->Operator() == "->") ? (~left | right) : ~(left ^ right);
+        }
+        case ASTType::XorExpression:
+        {
+            std::uint64_t value = evaluateChild(0) ^ evaluateChild(1);
+            return (static_cast<const XorExpressionAST*>(exprAST)->Operator() == "") ? value : ~value;
+        }
+        case ASTType::NandNorExpression:
+        {
+            std::uint64_t left = evaluateChild(0);
+            std::uint64_t right = evaluateChild(1);
+            return (static_cast<const NandNorExpressionAST*>(exprAST)->Operator() == "") ? ~(left & right) : ~(left | right);
+        }
+        default:
+            assert(false);
+            return 0ULL;
+    }
+}
+
+std::shared_ptr<BaseAST> Canonicalizer::Canonicalize(const std::shared_ptr<BaseAST>& logicalExprAST, Fingerprint& fingerprint)
+{
+    assert(logicalExprAST != nullptr);
+
+    this->mHashes.clear();
+    CanonicalNode root = this->CanonicalizeNode(logicalExprAST);
+    this->mHashes.clear();
+
+    fingerprint = root.mHash;
+
+    // ϐȂ, lɉeϐƐ^l\w
+    this->mVariableNames.clear();
+    CollectVariableNames(root.mAST.get(), this->mVariableNames);
+    std::sort(this->mVariableNames.begin(), this->mVariableNames.end());
+    this->mVariableNames.erase(std::unique(this->mVariableNames.begin(), this->mVariableNames.end()), this->mVariableNames.end());
+
+    if (this->mVariableNames.size() > this->mSemanticVariableLimit)
+        return root.mAST;
+
+    std::size_t variableCount = this->mVariableNames.size();
+    this->mVariableValues.assign(VariablePatterns, VariablePatterns + variableCount);
+    std::uint64_t truthTable = EvaluateTruthTable(root.mAST.get(), this->mVariableNames, this->mVariableValues);
+
+    // lɉeȂϐ (2̗]qϐ) , c̕ϐŋߒ
+    std::vector<std::string> influentialNames;
+
+    for (std::size_t i = 0; i < variableCount; ++i) {
+        std::uint64_t cofactor0 = truthTable & ~VariablePatterns[i];
+        std::uint64_t cofactor1 = truthTable & VariablePatterns[i];
+
+        if ((cofactor1 >> (1U << i)) != cofactor0)
+            influentialNames.push_back(this->mVariableNames[i]);
+    }
+
+    if (influentialNames.size() != variableCount) {
+        for (std::size_t i = 0, j = 0; i < variableCount; ++i) {
+            bool isInfluential = (j < influentialNames.size() && influentialNames[j] == this->mVariableNames[i]);
+            this->mVariableValues[i] = isInfluential ? VariablePatterns[j++] : 0ULL;
+        }
+
+        truthTable = EvaluateTruthTable(root.mAST.get(), this->mVariableNames, this->mVariableValues);
+    }
+
+    // 蓖Ă̐ (2̕ϐ̐) 𒴂rbg, ϐ̖ʒǔJԂȂ̂ŎgȂ
+    std::size_t assignmentCount = std::size_t(1) << influentialNames.size();
+
+    if (assignmentCount < 64U)
+        truthTable &= (1ULL << assignmentCount) - 1ULL;
+
+    FingerprintBuilder builder(NodeTag::TruthTable);
+    builder.Add(static_cast<std::uint64_t>(influentialNames.size()));
+
+    for (const auto& variableName : influentialNames)
+        builder.Add(variableName);
+
+    builder.Add(truthTable);
+    fingerprint = builder.Finish();
+
+    return root.mAST;
+}
+
+Canonicalizer::CanonicalNode Canonicalizer::CanonicalizeNode(const std::shared_ptr<BaseAST>& exprAST)
+{
+    switch (exprAST->Type()) {
+        case ASTType::Constant:
+            return this->MakeConstant(std::static_pointer_cast<ConstantAST>(exprAST)->Value());
+        case ASTType::Variable:
+        {
+            FingerprintBuilder builder(NodeTag::Variable);
+            builder.Add(std::static_pointer_cast<VariableAST>(exprAST)->Name());
+            return this->Register(CanonicalNode { exprAST, builder.Finish() });
+        }
+        case ASTType::Factor:
+            return this->CanonicalizeNode(std::static_pointer_cast<FactorAST>(exprAST)->Expr());
+        case ASTType::NotExpression:
+            return this->MakeNot(this->CanonicalizeNode(std::static_pointer_cast<NotExpressionAST>(exprAST)->Expr()));
+        case ASTType::AndOrExpression:
+        {
+            const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(exprAST.get());
+            std::vector<CanonicalNode> operands;
+            operands.reserve(andOrExprAST->OperandCount());
+
+            for (const auto& operand : andOrExprAST->Operands())
+                operands.push_back(this->CanonicalizeNode(operand));
+
+            return this->MakeAndOr(std::move(operands), andOrExprAST->Operator() == "");
+        }
+        case ASTType::Expression:
+        {
+            const ExpressionAST* binaryExprAST = static_cast<const ExpressionAST*>(exprAST.get());
+            return this->MakeBinary(this->CanonicalizeNode(binaryExprAST->Left()),
+                                    this->CanonicalizeNode(binaryExprAST->Right()), binaryExprAST->Operator());
+        }
+        case ASTType::XorExpression:
+        {
+            // ߂<->ƓZȂ̂<->ɑ
+            const XorExpressionAST* xorExprAST = static_cast<const XorExpressionAST*>(exprAST.get());
+            return this->MakeBinary(this->CanonicalizeNode(xorExprAST->Left()), this->CanonicalizeNode(xorExprAST->Right()),
+                                    xorExprAST->Operator() == "" ? "" : "<->");
+        }
+        case ASTType::NandNorExpression:
+        {
+            const NandNorExpressionAST* nandNorExprAST = static_cast<const NandNorExpressionAST*>(exprAST.get());
+            return this->MakeBinary(this->CanonicalizeNode(nandNorExprAST->Left()),
+                                    this->CanonicalizeNode(nandNorExprAST->Right()), nandNorExprAST->Operator());
+        }
+        default:
+            assert(false);
+            return this->MakeConstant(false);
+    }
+}
+
+Canonicalizer::CanonicalNode Canonicalizer::Register(CanonicalNode&& node)
+{
+    this->mHashes[node.mAST.get()] = node.mHash;
+    return std::move(node);
+}
+
+Canonicalizer::CanonicalNode Canonicalizer::MakeConstant(bool value)
+{
+    FingerprintBuilder builder(NodeTag::Constant);
+    builder.Add(value ? 1ULL : 0ULL);
+    return this->Register(CanonicalNode { std::make_shared<ConstantAST>(value), builder.Finish() });
+}
+
+Canonicalizer::CanonicalNode Canonicalizer::MakeNot(CanonicalNode&& operand)
+{
+    bool value = false;
+
+    if (IsConstant(operand.mAST, value))
+        return this->MakeConstant(!value);
+
+    // dے͎菜
+    if (operand.mAST->Type() == ASTType::NotExpression)
+        return CanonicalNode { std::static_pointer_cast<NotExpressionAST>(operand.mAST)->Expr(), NegateFingerprint(operand.mHash) };
+
+    return this->Register(CanonicalNode { std::make_shared<NotExpressionAST>(operand.mAST), NegateFingerprint(operand.mHash) });
+}
+
+Canonicalizer::CanonicalNode Canonicalizer::MakeAndOr(std::vector<CanonicalNode>&& operands, bool isOr)
+{
+    // And͋U, Or͐^Ŝm肳, ̒萔͎菜
+    bool absorbingValue = isOr;
+    const std::string op = isOr ? "" : "";
+    std::vector<CanonicalNode> flatOperands;
+
+    for (auto& operand : operands) {
+        bool value = false;
+
+        if (IsConstant(operand.mAST, value)) {
+            if (value == absorbingValue)
+                return this->MakeConstant(absorbingValue);
+            continue;
+        }
+
+        // Zq̃Iyh1ɂ܂Ƃ߂
+        if (operand.mAST->Type() == ASTType::AndOrExpression &&
+            std::static_pointer_cast<AndOrExpressionAST>(operand.mAST)->Operator() == op) {
+            for (const auto& childOperand : std::static_pointer_cast<AndOrExpressionAST>(operand.mAST)->Operands())
+                flatOperands.push_back(CanonicalNode { childOperand, this->mHashes.at(childOperand.get()) });
+            continue;
+        }
+
+        flatOperands.push_back(std::move(operand));
+    }
+
+    std::sort(flatOperands.begin(), flatOperands.end(),
+        [](const CanonicalNode& left, const CanonicalNode& right) { return left.mHash < right.mHash; });
+    flatOperands.erase(std::unique(flatOperands.begin(), flatOperands.end(),
+        [](const CanonicalNode& left, const CanonicalNode& right) { return left.mHash == right.mHash; }), flatOperands.end());
+
+    // xƁx𗼕܂߂ΑŜm肷
+    for (const auto& operand : flatOperands) {
+        Fingerprint negatedHash = NegateFingerprint(operand.mHash);
+
+        if (std::binary_search(flatOperands.begin(), flatOperands.end(), CanonicalNode { nullptr, negatedHash },
+                [](const CanonicalNode& left, const CanonicalNode& right) { return left.mHash < right.mHash; }))
+            return this->MakeConstant(absorbingValue);
+    }
+
+    if (flatOperands.empty())
+        return this->MakeConstant(!absorbingValue);
+
+    if (flatOperands.size() == 1U)
+        return std::move(flatOperands.front());
+
+    FingerprintBuilder builder(isOr ? NodeTag::Or : NodeTag::And);
+    builder.Add(static_cast<std::uint64_t>(flatOperands.size()));
+
+    std::vector<std::shared_ptr<BaseAST>> operandASTs;
+    operandASTs.reserve(flatOperands.size());
+
+    for (const auto& operand : flatOperands) {
+        builder.Add(operand.mHash);
+        operandASTs.push_back(operand.mAST);
+    }
+
+    return this->Register(CanonicalNode { std::make_shared<AndOrExpressionAST>(std::move(operandASTs), op), builder.Finish() });
+}
+
+Canonicalizer::CanonicalNode Canonicalizer::MakeBinary(CanonicalNode&& left, CanonicalNode&& right, const std::string& op)
+{
+    bool leftValue = false;
+    bool rightValue = false;
+    bool isLeftConstant = IsConstant(left.mAST, leftValue);
+    bool isRightConstant = IsConstant(right.mAST, rightValue);
+    bool isSame = (left.mHash == right.mHash);
+    bool isComplement = (left.mHash == NegateFingerprint(right.mHash));
+
+    if (op == "->") {
+        if (isLeftConstant)
+            return leftValue ? std::move(right) : this->MakeConstant(true);
+        if (isRightConstant)
+            return rightValue ? this->MakeConstant(true) : this->MakeNot(std::move(left));
+        if (isSame)
+            return this->MakeConstant(true);
+        if (isComplement)
+            return std::move(right);
+
+        FingerprintBuilder builder(NodeTag::Implies);
+        builder.Add(left.mHash);
+        builder.Add(right.mHash);
+        return this->Register(CanonicalNode { std::make_shared<ExpressionAST>(left.mAST, right.mAST, op), builder.Finish() });
+    }
+
+    // c͉Ȃ̂, 萔͉E, ϐ͍\nbV̏ɕׂ
+    if (isLeftConstant || (!isRightConstant && right.mHash < left.mHash)) {
+        std::swap(left, right);
+        std::swap(leftValue, rightValue);
+        std::swap(isLeftConstant, isRightConstant);
+    }
+
+    NodeTag tag;
+
+    if (op == "<->") {
+        if (isRightConstant)
+            return rightValue ? std::move(left) : this->MakeNot(std::move(left));
+        if (isSame || isComplement)
+            return this->MakeConstant(isSame);
+
+        tag = NodeTag::Equivalent;
+    } else if (op == "") {
+        if (isRightConstant)
+            return rightValue ? this->MakeNot(std::move(left)) : std::move(left);
+        if (isSame || isComplement)
+            return this->MakeConstant(isComplement);
+
+        tag = NodeTag::Xor;
+    } else if (op == "") {
+        if (isRightConstant)
+            return rightValue ? this->MakeNot(std::move(left)) : this->MakeConstant(true);
+        if (isSame)
+            return this->MakeNot(std::move(left));
+        if (isComplement)
+            return this->MakeConstant(true);
+
+        tag = NodeTag::Nand;
+    } else {
+        assert(op == "");
+
+        if (isRightConstant)
+            return rightValue ? this->MakeConstant(false) : this->MakeNot(std::move(left));
+        if (isSame)
+            return this->MakeNot(std::move(left));
+        if (isComplement)
+            return this->MakeConstant(false);
+
+        tag = NodeTag::Nor;
+    }
+
+    FingerprintBuilder builder(tag);
+    builder.Add(left.mHash);
+    builder.Add(right.mHash);
+
+    std::shared_ptr<BaseAST> binaryAST;
+
+    if (tag == NodeTag::Equivalent)
+        binaryAST = std::make_shared<ExpressionAST>(left.mAST, right.mAST, op);
+    else if (tag == NodeTag::Xor)
+        binaryAST = std::make_shared<XorExpressionAST>(left.mAST, right.mAST, op);
+    else
+        binaryAST = std::make_shared<NandNorExpressionAST>(left.mAST, right.mAST, op);
+
+    return this->Register(CanonicalNode { binaryAST, builder.Finish() });
+}
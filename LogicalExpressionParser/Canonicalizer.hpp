@@ -0,0 +1,80 @@
+// LogicalExpressionParser
+// Canonicalizer.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_CANONICALIZER_HPP
+#define LOGICAL_EXPRESSION_PARSER_CANONICALIZER_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class BaseAST;
+
+// 128rbg̎w
+struct Fingerprint {
+    std::uint64_t   mHigh;
+    std::uint64_t   mLow;
+
+    inline bool operator==(const Fingerprint& other) const { return this->mHigh == other.mHigh && this->mLow == other.mLow; }
+    inline bool operator!=(const Fingerprint& other) const { return !(*this == other); }
+    inline bool operator<(const Fingerprint& other) const {
+        return this->mHigh != other.mHigh ? this->mHigh < other.mHigh : this->mLow < other.mLow; }
+
+    // 3216i
+    std::string ToString() const;
+};
+
+struct FingerprintHash {
+    inline std::size_t operator()(const Fingerprint& fingerprint) const {
+        return static_cast<std::size_t>(fingerprint.mLow ^ (fingerprint.mHigh * 0x9E3779B97F4A7C15ULL)); }
+};
+
+/*
+_̐K`Ǝw
+ (FactorAST) 菜, q̓And, Or1ɂ܂Ƃ, 萔Ɠdے, Iyh̏dȖ񂷂
+ȉZq (And, Or, <->, Xor, Nand, Nor) ̃Iyh͕̍\nbV̏ɕ, ߂<->ɑ
+w͐K`̍\nbV, Iyh̏, , L[[h̒Ԃ肪Ⴄ̘_͓wɂȂ
+ɕϐȂ_, lɉeϐ̖OƐ^l\ŵ, _IɓlłΓwɂȂ
+ */
+class Canonicalizer {
+public:
+    // ^l\wϐ̐̏ (^l\64rbg̐1ŕ\͈)
+    static constexpr std::size_t MaxSemanticVariables = 6U;
+
+    Canonicalizer() : mSemanticVariableLimit(MaxSemanticVariables) { }
+    ~Canonicalizer() = default;
+
+    // 0ɂƏɍ\nbVwƂ
+    inline void SetSemanticVariableLimit(std::size_t variableLimit) {
+        assert(variableLimit <= MaxSemanticVariables); this->mSemanticVariableLimit = variableLimit; }
+
+    // K`Ԃ, wfingerprintɊi[ (ϐ̃m[h͌̒ۍ\؂ƋL)
+    std::shared_ptr<BaseAST> Canonicalize(const std::shared_ptr<BaseAST>& logicalExprAST, Fingerprint& fingerprint);
+
+private:
+    struct CanonicalNode {
+        std::shared_ptr<BaseAST>    mAST;
+        Fingerprint                 mHash;
+    };
+
+    CanonicalNode CanonicalizeNode(const std::shared_ptr<BaseAST>& exprAST);
+    CanonicalNode Register(CanonicalNode&& node);
+    CanonicalNode MakeConstant(bool value);
+    CanonicalNode MakeNot(CanonicalNode&& operand);
+    CanonicalNode MakeAndOr(std::vector<CanonicalNode>&& operands, bool isOr);
+    CanonicalNode MakeBinary(CanonicalNode&& left, CanonicalNode&& right, const std::string& op);
+
+    std::size_t mSemanticVariableLimit;
+    // K`̃m[h̍\nbV (qAnd, Or܂Ƃ߂ƂɎg)
+    std::unordered_map<const BaseAST*, Fingerprint> mHashes;
+    // ^l\߂Ƃ̕ϐ̖O (Ȍ) , ϐƂ̒l̃rbg
+    std::vector<std::string> mVariableNames;
+    std::vector<std::uint64_t> mVariableValues;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_CANONICALIZER_HPP
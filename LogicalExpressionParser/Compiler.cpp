@@ -0,0 +1,291 @@
+
+// LogicalExpressionParser
+// Compiler.cpp
+
+#include "Compiler.hpp"
+#include "AST.hpp"
+#include "LatencyTracing.hpp"
+
+//
+// SymbolTableNX
+//
+
+std::uint32_t SymbolTable::Intern(const std::string& name)
+{
+    auto iter = this->mIndices.find(name);
+
+    if (iter != this->mIndices.end())
+        return iter->second;
+
+    // ߂Čꂽϐɂ͐Vԍ蓖Ă
+    std::uint32_t index = static_cast<std::uint32_t>(this->mNames.size());
+    this->mNames.push_back(name);
+    this->mIndices.emplace(name, index);
+
+    return index;
+}
+
+std::optional<std::uint32_t> SymbolTable::Find(const std::string& name) const
+{
+    auto iter = this->mIndices.find(name);
+
+    if (iter == this->mIndices.end())
+        return std::nullopt;
+
+    return iter->second;
+}
+
+//
+// ProgramViewNX
+//
+
+bool ProgramView::Evaluate(const std::uint64_t* assignment) const
+{
+    std::uint8_t localValues[LocalValueCount];
+
+    if (this->mInstructionCount <= LocalValueCount)
+        return this->Evaluate(assignment, localValues);
+
+    std::vector<std::uint8_t> heapValues(this->mInstructionCount);
+    return this->Evaluate(assignment, heapValues.data());
+}
+
+bool ProgramView::Evaluate(const std::uint64_t* assignment, std::uint8_t* values) const
+{
+    assert(this->mInstructionCount > 0);
+
+    // ߗ͌uȂ̂, 擪珇ɕ]Ύq̒l͊ɋ܂Ă
+    // (ċAȂ̂, And, Or̒ARpC[ߗłX^bNgʂȂ)
+    for (std::size_t i = 0; i < this->mInstructionCount; ++i)
+        values[i] = this->EvaluateInstruction(i, values, assignment) ? 1U : 0U;
+
+    // Ō̖߂ɑ
+    return values[this->mInstructionCount - 1] != 0U;
+}
+
+bool ProgramView::EvaluateInstruction(std::size_t index, const std::uint8_t* values, const std::uint64_t* assignment) const
+{
+    const Instruction& instruction = this->mInstructions[index];
+
+    switch (instruction.mOpCode) {
+        case OpCode::False:
+            return false;
+        case OpCode::True:
+            return true;
+        case OpCode::Variable:
+            return (assignment[instruction.mOperand0 >> 6] >> (instruction.mOperand0 & 63)) & 1U;
+        case OpCode::Not:
+            return values[instruction.mOperand0] == 0U;
+        case OpCode::And:
+            return (values[instruction.mOperand0] & values[instruction.mOperand1]) != 0U;
+        case OpCode::Or:
+            return (values[instruction.mOperand0] | values[instruction.mOperand1]) != 0U;
+        case OpCode::Then:
+            return values[instruction.mOperand0] == 0U || values[instruction.mOperand1] != 0U;
+        case OpCode::Eq:
+        case OpCode::Xnor:
+            return values[instruction.mOperand0] == values[instruction.mOperand1];
+        case OpCode::Xor:
+            return values[instruction.mOperand0] != values[instruction.mOperand1];
+        case OpCode::Nand:
+            return (values[instruction.mOperand0] & values[instruction.mOperand1]) == 0U;
+        case OpCode::Nor:
+            return (values[instruction.mOperand0] | values[instruction.mOperand1]) == 0U;
+    }
+
+    return false;
+}
+
+std::shared_ptr<BaseAST> ProgramView::ToAST(const std::function<std::string(std::uint32_t)>& variableName) const
+{
+    if (this->mInstructionCount == 0)
+        return nullptr;
+
+    // ]Ɠ擪珇ɕ؂ (߂̎QƂŌłΕ؂ڂ)
+    std::vector<std::shared_ptr<BaseAST>> nodes(this->mInstructionCount);
+    std::vector<std::uint32_t> useCounts(this->mInstructionCount, 0U);
+
+    for (std::size_t i = 0; i < this->mInstructionCount; ++i) {
+        const Instruction& instruction = this->mInstructions[i];
+
+        if (instruction.mOpCode == OpCode::Not) {
+            ++useCounts[instruction.mOperand0];
+        } else if (instruction.mOpCode != OpCode::False && instruction.mOpCode != OpCode::True &&
+                   instruction.mOpCode != OpCode::Variable) {
+            ++useCounts[instruction.mOperand0];
+            ++useCounts[instruction.mOperand1];
+        }
+    }
+
+    auto takeNode = [&nodes, &useCounts](std::uint32_t index) {
+        return (--useCounts[index] == 0U) ? std::move(nodes[index]) : nodes[index]; };
+
+    for (std::size_t i = 0; i < this->mInstructionCount; ++i)
+        nodes[i] = this->InstructionToAST(i, takeNode, variableName);
+
+    return std::move(nodes.back());
+}
+
+template <typename TakeNode>
+std::shared_ptr<BaseAST> ProgramView::InstructionToAST(
+    std::size_t index, TakeNode&& takeNode, const std::function<std::string(std::uint32_t)>& variableName) const
+{
+    // ߗ񂩂璊ۍ\؂𕜌 (ʂ͎̏Ă)
+    const Instruction& instruction = this->mInstructions[index];
+
+    switch (instruction.mOpCode) {
+        case OpCode::False:
+            return std::make_shared<ConstantAST>(false);
+        case OpCode::True:
+            return std::make_shared<ConstantAST>(true);
+        case OpCode::Variable:
+            return std::make_shared<VariableAST>(variableName(instruction.mOperand0));
+        case OpCode::Not:
+            return std::make_shared<NotExpressionAST>(takeNode(instruction.mOperand0));
+        case OpCode::And:
+        case OpCode::Or: {
+            // A2Z1̃m[hɂ܂Ƃ߂
+            std::shared_ptr<BaseAST> leftExprAST = takeNode(instruction.mOperand0);
+            return MakeAndOrExpression(std::move(leftExprAST), takeNode(instruction.mOperand1),
+                                       instruction.mOpCode == OpCode::And ? "" : "");
+        }
+        case OpCode::Then:
+        case OpCode::Eq: {
+            std::shared_ptr<BaseAST> leftExprAST = takeNode(instruction.mOperand0);
+            return std::make_shared<ExpressionAST>(leftExprAST, takeNode(instruction.mOperand1),
+                                                   instruction.mOpCode == OpCode::Then ? "->" : "<->");
+        }
+        case OpCode::Xor:
+        case OpCode::Xnor: {
+            std::shared_ptr<BaseAST> leftExprAST = takeNode(instruction.mOperand0);
+            return std::make_shared<XorExpressionAST>(leftExprAST, takeNode(instruction.mOperand1),
+                                                      instruction.mOpCode == OpCode::Xor ? "" : "");
+        }
+        case OpCode::Nand:
+        case OpCode::Nor: {
+            std::shared_ptr<BaseAST> leftExprAST = takeNode(instruction.mOperand0);
+            return std::make_shared<NandNorExpressionAST>(leftExprAST, takeNode(instruction.mOperand1),
+                                                          instruction.mOpCode == OpCode::Nand ? "" : "");
+        }
+    }
+
+    return nullptr;
+}
+
+//
+// ProgramNX
+//
+
+std::uint32_t Program::AddInstruction(OpCode opCode, std::uint32_t operand0, std::uint32_t operand1)
+{
+    Instruction instruction { opCode, { 0, 0, 0 }, operand0, operand1 };
+    this->mInstructions.push_back(instruction);
+
+    return static_cast<std::uint32_t>(this->mInstructions.size() - 1);
+}
+
+//
+// CompilerNX
+//
+
+std::shared_ptr<Program> Compiler::Compile(const std::shared_ptr<BaseAST>& logicalExprAST)
+{
+    assert(logicalExprAST != nullptr);
+    assert(this->mSymbolTable != nullptr);
+
+    ScopedPhaseTimer phaseTimer(Phase::Compile);
+
+    std::shared_ptr<Program> program = std::make_shared<Program>();
+
+    if (!this->CompileNode(logicalExprAST.get(), *program).has_value())
+        return nullptr;
+
+    return program;
+}
+
+std::optional<std::uint32_t> Compiler::CompileNode(const BaseAST* exprAST, Program& program)
+{
+    if (exprAST == nullptr)
+        return std::nullopt;
+
+    // q̖߂ɒǉ̂, ߗ͌uɂȂ
+    switch (exprAST->Type()) {
+        case ASTType::Constant:
+            return program.AddInstruction(static_cast<const ConstantAST*>(exprAST)->Value() ? OpCode::True : OpCode::False);
+        case ASTType::Variable:
+            return program.AddInstruction(OpCode::Variable,
+                this->mSymbolTable->Intern(static_cast<const VariableAST*>(exprAST)->Name()));
+        case ASTType::Factor:
+            // ʂ͖߂𐶐Ȃ
+            return this->CompileNode(static_cast<const FactorAST*>(exprAST)->Expr().get(), program);
+        case ASTType::NotExpression:
+        {
+            std::optional<std::uint32_t> operand = this->CompileNode(
+                static_cast<const NotExpressionAST*>(exprAST)->Expr().get(), program);
+
+            if (!operand.has_value())
+                return std::nullopt;
+
+            return program.AddInstruction(OpCode::Not, operand.value());
+        }
+        case ASTType::AndOrExpression:
+        {
+            // ̃Iyh2Z̘̍AɓWJ
+            const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(exprAST);
+            OpCode opCode = (andOrExprAST->Operator() == "") ? OpCode::And : OpCode::Or;
+            std::optional<std::uint32_t> leftOperand = this->CompileNode(andOrExprAST->Operand(0).get(), program);
+
+            if (!leftOperand.has_value())
+                return std::nullopt;
+
+            for (std::size_t i = 1; i < andOrExprAST->OperandCount(); ++i) {
+                std::optional<std::uint32_t> rightOperand = this->CompileNode(andOrExprAST->Operand(i).get(), program);
+
+                if (!rightOperand.has_value())
+                    return std::nullopt;
+
+                leftOperand = program.AddInstruction(opCode, leftOperand.value(), rightOperand.value());
+            }
+
+            return leftOperand;
+        }
+        case ASTType::Expression:
+        {
+            const ExpressionAST* thenEqExprAST = static_cast<const ExpressionAST*>(exprAST);
+            std::optional<std::uint32_t> leftOperand = this->CompileNode(thenEqExprAST->Left().get(), program);
+            std::optional<std::uint32_t> rightOperand = this->CompileNode(thenEqExprAST->Right().get(), program);
+
+            if (!leftOperand.has_value() || !rightOperand.has_value())
+                return std::nullopt;
+
+            return program.AddInstruction(thenEqExprAST->Operator() == "->" ? OpCode::Then : OpCode::Eq,
+                leftOperand.value(), rightOperand.value());
+        }
+        case ASTType::XorExpression:
+        {
+            const XorExpressionAST* xorExprAST = static_cast<const XorExpressionAST*>(exprAST);
+            std::optional<std::uint32_t> leftOperand = this->CompileNode(xorExprAST->Left().get(), program);
+            std::optional<std::uint32_t> rightOperand = this->CompileNode(xorExprAST->Right().get(), program);
+
+            if (!leftOperand.has_value() || !rightOperand.has_value())
+                return std::nullopt;
+
+            return program.AddInstruction(xorExprAST->Operator() == "" ? OpCode::Xor : OpCode::Xnor,
+                leftOperand.value(), rightOperand.value());
+        }
+        case ASTType::NandNorExpression:
+        {
+            const NandNorExpressionAST* nandNorExprAST = static_cast<const NandNorExpressionAST*>(exprAST);
+            std::optional<std::uint32_t> leftOperand = this->CompileNode(nandNorExprAST->Left().get(), program);
+            std::optional<std::uint32_t> rightOperand = this->CompileNode(nandNorExprAST->Right().get(), program);
+
+            if (!leftOperand.has_value() || !rightOperand.has_value())
+                return std::nullopt;
+
+            return program.AddInstruction(nandNorExprAST->Operator() == "" ? OpCode::Nand : OpCode::Nor,
+                leftOperand.value(), rightOperand.value());
+        }
+        default:
+            return std::nullopt;
+    }
+}
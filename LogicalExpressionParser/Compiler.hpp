@@ -0,0 +1,121 @@
+// LogicalExpressionParser
+// Compiler.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_COMPILER_HPP
+#define LOGICAL_EXPRESSION_PARSER_COMPILER_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class BaseAST;
+
+enum class OpCode : std::uint8_t {
+    False,
+    True,
+    Variable,
+    Not,
+    And,
+    Or,
+    Then,
+    Eq,
+    Xor,
+    Xnor,
+    Nand,
+    Nor
+};
+
+// ߂͌uɕ, Iyhɂ͎q̖߂̃CfbNX(ϐ̏ꍇ͕ϐԍ)i[
+// t@Cɂ̂܂܏ôŃCAEgŒ肷
+struct Instruction {
+    OpCode          mOpCode;
+    std::uint8_t    mReserved[3];
+    std::uint32_t   mOperand0;
+    std::uint32_t   mOperand1;
+};
+
+static_assert(sizeof(Instruction) == 12, "Instruction must be 12 bytes");
+
+class SymbolTable {
+public:
+    SymbolTable() = default;
+    ~SymbolTable() = default;
+
+    inline std::size_t Size() const { return this->mNames.size(); }
+    inline const std::string& Name(std::uint32_t index) const { return this->mNames[index]; }
+
+    std::uint32_t Intern(const std::string& name);
+    std::optional<std::uint32_t> Find(const std::string& name) const;
+
+private:
+    std::vector<std::string> mNames;
+    std::unordered_map<std::string, std::uint32_t> mIndices;
+};
+
+class ProgramView {
+public:
+    ProgramView(const Instruction* instructions, std::size_t instructionCount) :
+        mInstructions(instructions), mInstructionCount(instructionCount) { }
+    ~ProgramView() = default;
+
+    inline const Instruction* Instructions() const { return this->mInstructions; }
+    inline std::size_t InstructionCount() const { return this->mInstructionCount; }
+
+    // ϐ̒l͕ϐԍƂ1rbgŕ\
+    bool Evaluate(const std::uint64_t* assignment) const;
+    // Ăяo̍Ɨ̈ (InstructionCount()oCg) g, q[vmۂȂ
+    bool Evaluate(const std::uint64_t* assignment, std::uint8_t* values) const;
+    std::shared_ptr<BaseAST> ToAST(const std::function<std::string(std::uint32_t)>& variableName) const;
+
+private:
+    // ȉ̖ߐł, ]̖߂̒lX^bNɒu
+    static constexpr std::size_t LocalValueCount = 256U;
+
+    // q̖߂̒lvaluesǂ
+    bool EvaluateInstruction(std::size_t index, const std::uint8_t* values, const std::uint64_t* assignment) const;
+    // q̖߂̕؂takeNode(q̖߂̈ʒu)󂯎
+    template <typename TakeNode>
+    std::shared_ptr<BaseAST> InstructionToAST(std::size_t index, TakeNode&& takeNode,
+                                              const std::function<std::string(std::uint32_t)>& variableName) const;
+
+    const Instruction*  mInstructions;
+    std::size_t         mInstructionCount;
+};
+
+class Program {
+public:
+    Program() = default;
+    ~Program() = default;
+
+    inline const std::vector<Instruction>& Instructions() const { return this->mInstructions; }
+    inline ProgramView View() const { return ProgramView(this->mInstructions.data(), this->mInstructions.size()); }
+
+    std::uint32_t AddInstruction(OpCode opCode, std::uint32_t operand0 = 0U, std::uint32_t operand1 = 0U);
+
+private:
+    std::vector<Instruction> mInstructions;
+};
+
+class Compiler {
+public:
+    Compiler(const std::shared_ptr<SymbolTable>& symbolTable) : mSymbolTable(symbolTable) { }
+    ~Compiler() = default;
+
+    inline const std::shared_ptr<SymbolTable>& Symbols() const { return this->mSymbolTable; }
+
+    std::shared_ptr<Program> Compile(const std::shared_ptr<BaseAST>& logicalExprAST);
+
+private:
+    std::optional<std::uint32_t> CompileNode(const BaseAST* exprAST, Program& program);
+
+    std::shared_ptr<SymbolTable> mSymbolTable;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_COMPILER_HPP
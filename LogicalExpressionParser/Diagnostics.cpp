@@ -0,0 +1,129 @@
+
+// LogicalExpressionParser
+// Diagnostics.cpp
+
+#include "Diagnostics.hpp"
+#include "PerformanceCounters.hpp"
+#include "Token.hpp"
+
+#include <cctype>
+
+void Diagnostics::Report(DiagnosticCode code, std::size_t offset, std::size_t tokenIndex,
+                         TokenTypeSet expectedTokens, char character)
+{
+    assert(code != DiagnosticCode::None);
+
+    // ŏɌoG[ł̌Ȃ̂, ɋL^Ăꍇ͏㏑Ȃ
+    if (this->HasError())
+        return;
+
+    this->mCode = code;
+    this->mOffset = offset;
+    this->mTokenIndex = tokenIndex;
+    this->mExpectedTokens = expectedTokens;
+    this->mCharacter = character;
+
+    PerformanceCounters::CountParseFailure(code);
+}
+
+void Diagnostics::Print(std::ostream& os) const
+{
+    // ̓G[\Ƃɂ̂ݍs
+    os << DiagnosticCodeName(this->mCode);
+
+    if (this->mCode == DiagnosticCode::InvalidCharacter) {
+        // \łȂ16iŕ\
+        if (std::isprint(static_cast<unsigned char>(this->mCharacter)))
+            os << " \'" << this->mCharacter << '\'';
+        else
+            os << " 0x" << std::hex << (static_cast<unsigned int>(this->mCharacter) & 0xFFU) << std::dec;
+    }
+
+    os << " at offset " << this->mOffset << " (token " << this->mTokenIndex << ")";
+
+    if (this->mExpectedTokens != 0U) {
+        os << ", expected:";
+
+        for (unsigned int i = 0; i <= static_cast<unsigned int>(TokenType::End); ++i)
+            if (this->mExpectedTokens & ToTokenTypeSet(static_cast<TokenType>(i)))
+                os << ' ' << TokenTypeName(static_cast<TokenType>(i));
+    }
+
+    os << '\n';
+}
+
+const char* DiagnosticCodeName(DiagnosticCode code)
+{
+    switch (code) {
+        case DiagnosticCode::None:
+            return "No error";
+        case DiagnosticCode::OutOfMemory:
+            return "Out of memory";
+        case DiagnosticCode::InvalidCharacter:
+            return "Invalid character";
+        case DiagnosticCode::UnexpectedEndOfInput:
+            return "Unexpected end of input";
+        case DiagnosticCode::UnexpectedToken:
+            return "Unexpected token";
+        case DiagnosticCode::MissingRightParenthesis:
+            return "Missing right parenthesis";
+        case DiagnosticCode::TrailingTokens:
+            return "Trailing tokens";
+        case DiagnosticCode::StackUnderflow:
+            return "Missing operand";
+        case DiagnosticCode::StackNotEmpty:
+            return "Missing operator";
+        case DiagnosticCode::InputTooLarge:
+            return "Input too large";
+        case DiagnosticCode::TooManyTokens:
+            return "Too many tokens";
+        case DiagnosticCode::NestingTooDeep:
+            return "Nesting too deep";
+        case DiagnosticCode::TooManyASTNodes:
+            return "Too many AST nodes";
+        case DiagnosticCode::StepLimitExceeded:
+            return "Step limit exceeded";
+        case DiagnosticCode::InternalError:
+            return "Internal error";
+    }
+
+    return "Unknown error";
+}
+
+const char* TokenTypeName(TokenType tokenType)
+{
+    switch (tokenType) {
+        case TokenType::True:
+            return "True";
+        case TokenType::False:
+            return "False";
+        case TokenType::Variable:
+            return "Variable";
+        case TokenType::And:
+            return "And";
+        case TokenType::Or:
+            return "Or";
+        case TokenType::Not:
+            return "Not";
+        case TokenType::Then:
+            return "'->'";
+        case TokenType::Eq:
+            return "'<->'";
+        case TokenType::Xor:
+            return "Xor";
+        case TokenType::Xnor:
+            return "Xnor";
+        case TokenType::Nand:
+            return "Nand";
+        case TokenType::Nor:
+            return "Nor";
+        case TokenType::LeftParenthesis:
+            return "'('";
+        case TokenType::RightParenthesis:
+            return "')'";
+        case TokenType::End:
+            return "End";
+    }
+
+    return "Unknown";
+}
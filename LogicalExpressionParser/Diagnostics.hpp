@@ -0,0 +1,77 @@
+// LogicalExpressionParser
+// Diagnostics.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_DIAGNOSTICS_HPP
+#define LOGICAL_EXPRESSION_PARSER_DIAGNOSTICS_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+
+enum class TokenType;
+
+enum class DiagnosticCode : std::uint8_t {
+    None,
+    OutOfMemory,
+    InvalidCharacter,
+    UnexpectedEndOfInput,
+    UnexpectedToken,
+    MissingRightParenthesis,
+    TrailingTokens,
+    StackUnderflow,
+    StackNotEmpty,
+    InputTooLarge,
+    TooManyTokens,
+    NestingTooDeep,
+    TooManyASTNodes,
+    StepLimitExceeded,
+    InternalError
+};
+
+// ҂g[N̎ނ̏W (TokenType̒lɑΉrbg𗧂Ă)
+using TokenTypeSet = std::uint32_t;
+
+inline constexpr TokenTypeSet ToTokenTypeSet(TokenType tokenType)
+{
+    return static_cast<TokenTypeSet>(1U) << static_cast<unsigned int>(tokenType);
+}
+
+// G[̌oHłq[vmۂ⏑sȂ悤, l݂̂L^
+class Diagnostics {
+public:
+    Diagnostics() { this->Clear(); }
+    ~Diagnostics() = default;
+
+    inline bool HasError() const { return this->mCode != DiagnosticCode::None; }
+    inline DiagnosticCode Code() const { return this->mCode; }
+    inline std::size_t Offset() const { return this->mOffset; }
+    inline std::size_t TokenIndex() const { return this->mTokenIndex; }
+    inline TokenTypeSet ExpectedTokens() const { return this->mExpectedTokens; }
+    inline char Character() const { return this->mCharacter; }
+
+    inline void Clear() {
+        this->mCode = DiagnosticCode::None;
+        this->mOffset = 0U;
+        this->mTokenIndex = 0U;
+        this->mExpectedTokens = 0U;
+        this->mCharacter = '\0';
+    }
+
+    void Report(DiagnosticCode code, std::size_t offset, std::size_t tokenIndex,
+                TokenTypeSet expectedTokens = 0U, char character = '\0');
+    void Print(std::ostream& os) const;
+
+private:
+    DiagnosticCode  mCode;
+    std::size_t     mOffset;
+    std::size_t     mTokenIndex;
+    TokenTypeSet    mExpectedTokens;
+    char            mCharacter;
+};
+
+const char* DiagnosticCodeName(DiagnosticCode code);
+const char* TokenTypeName(TokenType tokenType);
+
+#endif // LOGICAL_EXPRESSION_PARSER_DIAGNOSTICS_HPP
@@ -0,0 +1,618 @@
+
+// LogicalExpressionParser
+// EvaluationServer.cpp
+
+#include "EvaluationServer.hpp"
+#include "AST.hpp"
+#include "Diagnostics.hpp"
+#include "Parser.hpp"
+#include "Token.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// epollɓo^҂󂯃\Pbgeventfd̎ʎq (ڑ̎ʎqƂ͏dȂȂ)
+static constexpr std::uint64_t ListenToken = ~static_cast<std::uint64_t>(0U);
+static constexpr std::uint64_t WakeToken = ~static_cast<std::uint64_t>(1U);
+
+static std::string TrimLine(std::string text)
+{
+    // 1sȂ̂, ̋󔒂Ɖs菜
+    while (!text.empty() && (text.back() == '\n' || text.back() == '\r' || text.back() == ' '))
+        text.pop_back();
+
+    return text;
+}
+
+static std::string FormatExpression(const std::shared_ptr<BaseAST>& exprAST, Notation notation)
+{
+    // otɏo͂, ؂̋󔒂̘A1ɂ܂Ƃ߂
+    std::ostringstream output;
+    ASTPrinter().PrintExpression(exprAST, notation, output);
+
+    std::string text;
+
+    for (char c : output.str()) {
+        if (c == ' ' && (text.empty() || text.back() == ' '))
+            continue;
+
+        text += c;
+    }
+
+    return TrimLine(std::move(text));
+}
+
+EvaluationServer::EvaluationServer(unsigned int workerCount) :
+    mWorkerCount(workerCount != 0U ? workerCount : std::max(1U, std::thread::hardware_concurrency())),
+    mSymbolTable(std::make_shared<SymbolTable>()),
+    mStopWorkers(false),
+    mNextConnectionId(0U),
+    mListenFd(-1),
+    mEpollFd(-1),
+    mWakeFd(-1),
+    mStopRequested(false)
+{
+}
+
+EvaluationServer::~EvaluationServer()
+{
+    assert(this->mWorkers.empty());
+}
+
+std::optional<std::uint32_t> EvaluationServer::AddRule(const std::string& logicalExpr, Diagnostics* diagnostics)
+{
+    {
+        // \͍ς݂̘_ł, ̂܂ܔԍԂ
+        std::shared_lock<std::shared_mutex> lock(this->mRulesMutex);
+        auto iter = this->mRuleIndices.find(logicalExpr);
+
+        if (iter != this->mRuleIndices.end())
+            return iter->second;
+    }
+
+    Diagnostics localDiagnostics;
+    Diagnostics& parseDiagnostics = (diagnostics != nullptr) ? *diagnostics : localDiagnostics;
+    // vƂɎ𐔂̂, [J[ƂɋLȂ
+    ResourceGovernor governor(this->mLimits);
+    std::string exprText = logicalExpr;
+    std::shared_ptr<TokenStream> tokenStream = Lexer(exprText, &parseDiagnostics, &governor);
+    std::shared_ptr<BaseAST> exprAST = (tokenStream != nullptr) ?
+        ParseLogicalExpression(tokenStream, nullptr, parseDiagnostics, &governor) : nullptr;
+
+    if (exprAST == nullptr)
+        return std::nullopt;
+
+    // V{\ɕϐǉ̂, RpC͔rIɍs
+    std::unique_lock<std::shared_mutex> lock(this->mRulesMutex);
+    auto iter = this->mRuleIndices.find(logicalExpr);
+
+    if (iter != this->mRuleIndices.end())
+        return iter->second;
+
+    Compiler compiler(this->mSymbolTable);
+    std::shared_ptr<Program> program = compiler.Compile(exprAST);
+
+    if (program == nullptr)
+        return std::nullopt;
+
+    std::uint32_t ruleIndex = static_cast<std::uint32_t>(this->mRules.size());
+    this->mRules.push_back(std::make_shared<const Rule>(Rule { exprAST, program }));
+    this->mRuleIndices.emplace(logicalExpr, ruleIndex);
+
+    return ruleIndex;
+}
+
+std::string EvaluationServer::HandleRequest(const std::string& request)
+{
+    std::size_t separator = request.find(' ');
+    std::string command = request.substr(0, separator);
+    std::size_t argumentsBegin = (separator != std::string::npos) ? request.find_first_not_of(' ', separator) : std::string::npos;
+    std::string arguments = (argumentsBegin != std::string::npos) ? request.substr(argumentsBegin) : std::string();
+
+    if (command == "PARSE")
+        return this->HandleParse(arguments);
+    if (command == "PRINT")
+        return this->HandlePrint(arguments);
+    if (command == "EVAL")
+        return this->HandleEvaluate(arguments);
+
+    return "ERR unknown command " + command;
+}
+
+std::string EvaluationServer::HandleParse(const std::string& arguments)
+{
+    if (arguments.empty())
+        return "ERR missing expression";
+
+    Diagnostics diagnostics;
+    std::optional<std::uint32_t> ruleIndex = this->AddRule(arguments, &diagnostics);
+
+    if (!ruleIndex.has_value()) {
+        std::ostringstream message;
+        message << "ERR ";
+        diagnostics.Print(message);
+        return TrimLine(message.str());
+    }
+
+    return "OK " + std::to_string(ruleIndex.value());
+}
+
+std::string EvaluationServer::HandlePrint(const std::string& arguments)
+{
+    std::istringstream argumentStream(arguments);
+    std::string ruleIndexText;
+    std::string notationName;
+    argumentStream >> ruleIndexText >> notationName;
+
+    std::shared_ptr<const Rule> rule = this->FindRule(ruleIndexText);
+
+    if (rule == nullptr)
+        return "ERR unknown rule " + ruleIndexText;
+
+    Notation notation;
+
+    if (notationName == "infix")
+        notation = Notation::Infix;
+    else if (notationName == "prefix")
+        notation = Notation::Prefix;
+    else if (notationName == "postfix")
+        notation = Notation::Postfix;
+    else
+        return "ERR unknown notation " + notationName;
+
+    return "OK " + FormatExpression(rule->mAST, notation);
+}
+
+std::string EvaluationServer::HandleEvaluate(const std::string& arguments)
+{
+    std::istringstream argumentStream(arguments);
+    std::string ruleIndexText;
+    argumentStream >> ruleIndexText;
+
+    std::shared_ptr<const Rule> rule = this->FindRule(ruleIndexText);
+
+    if (rule == nullptr)
+        return "ERR unknown rule " + ruleIndexText;
+
+    std::vector<std::uint64_t> assignment;
+    std::string variable;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(this->mRulesMutex);
+        assignment.assign(std::max<std::size_t>(1U, (this->mSymbolTable->Size() + 63U) / 64U), 0U);
+
+        while (argumentStream >> variable) {
+            std::size_t separator = variable.find('=');
+
+            if (separator == std::string::npos || separator + 2U != variable.size() ||
+                (variable[separator + 1U] != 'T' && variable[separator + 1U] != 'F'))
+                return "ERR invalid assignment " + variable;
+
+            // ǂ̋KɂȂϐ͌ʂɉeȂ
+            std::optional<std::uint32_t> index = this->mSymbolTable->Find(variable.substr(0, separator));
+
+            if (index.has_value() && variable[separator + 1U] == 'T')
+                assignment[index.value() >> 6] |= static_cast<std::uint64_t>(1U) << (index.value() & 63U);
+        }
+    }
+
+    return rule->mProgram->View().Evaluate(assignment.data()) ? "OK true" : "OK false";
+}
+
+std::shared_ptr<const EvaluationServer::Rule> EvaluationServer::FindRule(const std::string& ruleIndexText) const
+{
+    if (ruleIndexText.empty())
+        return nullptr;
+
+    char* end = nullptr;
+    unsigned long ruleIndex = std::strtoul(ruleIndexText.c_str(), &end, 10);
+
+    if (*end != '\0')
+        return nullptr;
+
+    std::shared_lock<std::shared_mutex> lock(this->mRulesMutex);
+
+    if (ruleIndex >= this->mRules.size())
+        return nullptr;
+
+    return this->mRules[ruleIndex];
+}
+
+void EvaluationServer::WorkerLoop()
+{
+    std::vector<Response> responses;
+
+    while (true) {
+        std::vector<Request> batch;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mBatchMutex);
+            this->mBatchCondition.wait(lock, [this]() { return this->mStopWorkers || !this->mBatches.empty(); });
+
+            if (this->mBatches.empty())
+                return;
+
+            batch = std::move(this->mBatches.front());
+            this->mBatches.pop_front();
+        }
+
+        responses.clear();
+
+        for (auto& request : batch)
+            responses.push_back(Response { request.mConnectionId, request.mSequence, this->HandleRequest(request.mText) });
+
+        {
+            std::lock_guard<std::mutex> lock(this->mResponseMutex);
+            this->mResponses.insert(this->mResponses.end(),
+                std::make_move_iterator(responses.begin()), std::make_move_iterator(responses.end()));
+        }
+
+#ifdef __linux__
+        // Cxg[vN
+        std::uint64_t value = 1U;
+        [[maybe_unused]] ssize_t written = ::write(this->mWakeFd, &value, sizeof(value));
+#endif
+    }
+}
+
+void EvaluationServer::DispatchBatches(std::vector<Request>& requests)
+{
+    if (requests.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mBatchMutex);
+
+        for (std::size_t i = 0; i < requests.size(); i += BatchSize) {
+            std::size_t end = std::min(requests.size(), i + BatchSize);
+            this->mBatches.emplace_back(std::make_move_iterator(requests.begin() + static_cast<std::ptrdiff_t>(i)),
+                                        std::make_move_iterator(requests.begin() + static_cast<std::ptrdiff_t>(end)));
+        }
+    }
+
+    this->mBatchCondition.notify_all();
+    requests.clear();
+}
+
+void EvaluationServer::Stop()
+{
+    this->mStopRequested.store(true);
+
+#ifdef __linux__
+    if (this->mWakeFd >= 0) {
+        std::uint64_t value = 1U;
+        [[maybe_unused]] ssize_t written = ::write(this->mWakeFd, &value, sizeof(value));
+    }
+#endif
+}
+
+#ifdef __linux__
+
+bool EvaluationServer::Run(const std::string& socketPath)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (socketPath.size() >= sizeof(address.sun_path))
+        return false;
+
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1U);
+
+    this->mListenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    this->mEpollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    this->mWakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    auto closeAll = [this]() {
+        for (int* fd : { &this->mListenFd, &this->mEpollFd, &this->mWakeFd }) {
+            if (*fd >= 0)
+                ::close(*fd);
+
+            *fd = -1;
+        }
+    };
+
+    // O̎sŎc\Pbgt@C͍폜
+    ::unlink(socketPath.c_str());
+
+    if (this->mListenFd < 0 || this->mEpollFd < 0 || this->mWakeFd < 0 ||
+        ::bind(this->mListenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(this->mListenFd, SOMAXCONN) != 0) {
+        closeAll();
+        return false;
+    }
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = ListenToken;
+    ::epoll_ctl(this->mEpollFd, EPOLL_CTL_ADD, this->mListenFd, &event);
+    event.data.u64 = WakeToken;
+    ::epoll_ctl(this->mEpollFd, EPOLL_CTL_ADD, this->mWakeFd, &event);
+
+    this->mStopWorkers = false;
+
+    for (unsigned int i = 0; i < this->mWorkerCount; ++i)
+        this->mWorkers.emplace_back(&EvaluationServer::WorkerLoop, this);
+
+    std::vector<epoll_event> events(256U);
+    std::vector<Request> requests;
+
+    while (!this->mStopRequested.load()) {
+        int eventCount = ::epoll_wait(this->mEpollFd, events.data(), static_cast<int>(events.size()), -1);
+
+        if (eventCount < 0) {
+            if (errno == EINTR)
+                continue;
+
+            break;
+        }
+
+        // 1̑ҋ@œǂݍ񂾗v͑SĂ̐ڑ̕܂Ƃ߂ăob`ɂ
+        for (int i = 0; i < eventCount; ++i) {
+            std::uint64_t token = events[i].data.u64;
+
+            if (token == ListenToken) {
+                this->AcceptConnections();
+                continue;
+            }
+
+            if (token == WakeToken) {
+                std::uint64_t value;
+
+                while (::read(this->mWakeFd, &value, sizeof(value)) > 0)
+                    ;
+
+                this->CollectResponses();
+                continue;
+            }
+
+            auto iter = this->mConnections.find(token);
+
+            if (iter == this->mConnections.end())
+                continue;
+
+            Connection& connection = iter->second;
+
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                this->ReadConnection(connection, requests);
+
+            if (!this->FlushConnection(connection)) {
+                this->CloseConnection(token);
+                continue;
+            }
+
+            this->UpdateEvents(connection);
+        }
+
+        this->DispatchBatches(requests);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->mBatchMutex);
+        this->mStopWorkers = true;
+    }
+
+    this->mBatchCondition.notify_all();
+
+    for (auto& worker : this->mWorkers)
+        worker.join();
+
+    this->mWorkers.clear();
+
+    while (!this->mConnections.empty())
+        this->CloseConnection(this->mConnections.begin()->first);
+
+    closeAll();
+    ::unlink(socketPath.c_str());
+
+    return true;
+}
+
+void EvaluationServer::AcceptConnections()
+{
+    while (true) {
+        int fd = ::accept4(this->mListenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (fd < 0)
+            return;
+
+        std::uint64_t connectionId = this->mNextConnectionId++;
+        Connection& connection = this->mConnections[connectionId];
+        connection.mId = connectionId;
+        connection.mFd = fd;
+        connection.mOutputOffset = 0U;
+        connection.mNextSequence = 0U;
+        connection.mNextResponse = 0U;
+        connection.mEvents = EPOLLIN;
+        connection.mPeerClosed = false;
+
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u64 = connectionId;
+        ::epoll_ctl(this->mEpollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+void EvaluationServer::ReadConnection(Connection& connection, std::vector<Request>& requests)
+{
+    char buffer[65536];
+
+    // ǂݍނтɍs؂oď𒲂, 𒴂ă\Pbgǂݍ܂Ȃ
+    // ̗vɒBƎc̓\PbgɎc, UpdateEventsœǂݍ݂~߂
+    while (!connection.mPeerClosed && connection.mNextSequence - connection.mNextResponse < MaxInFlightRequests) {
+        ssize_t readSize = ::read(connection.mFd, buffer, sizeof(buffer));
+
+        if (readSize > 0) {
+            // O܂ł̓͂ɂ͉ŝ, ǂݍ񂾕sT
+            std::size_t lineBegin = 0U;
+            std::size_t searchBegin = connection.mInput.size();
+            connection.mInput.append(buffer, static_cast<std::size_t>(readSize));
+
+            for (std::size_t lineEnd; (lineEnd = connection.mInput.find('\n', searchBegin)) != std::string::npos;
+                 lineBegin = searchBegin = lineEnd + 1U) {
+                std::size_t lineLength = lineEnd - lineBegin;
+
+                if (lineLength > 0U && connection.mInput[lineEnd - 1U] == '\r')
+                    --lineLength;
+
+                if (lineLength == 0U)
+                    continue;
+
+                requests.push_back(Request { connection.mId, connection.mNextSequence++, connection.mInput.substr(lineBegin, lineLength) });
+            }
+
+            connection.mInput.erase(0, lineBegin);
+
+            if (connection.mInput.size() > MaxLineLength) {
+                connection.mReadyResponses.emplace(connection.mNextSequence++, "ERR line too long");
+                connection.mInput.clear();
+                connection.mPeerClosed = true;
+            }
+
+            continue;
+        }
+
+        if (readSize < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+
+        if (readSize < 0 && errno == EINTR)
+            continue;
+
+        // 肪݂Ă, 󂯎vɂ͑Sĉ
+        connection.mPeerClosed = true;
+    }
+}
+
+bool EvaluationServer::FlushConnection(Connection& connection)
+{
+    // v̏ɑ݂̂o
+    for (auto iter = connection.mReadyResponses.begin();
+         iter != connection.mReadyResponses.end() && iter->first == connection.mNextResponse;
+         iter = connection.mReadyResponses.erase(iter), ++connection.mNextResponse) {
+        connection.mOutput += iter->second;
+        connection.mOutput += '\n';
+    }
+
+    while (connection.mOutputOffset < connection.mOutput.size()) {
+        ssize_t writtenSize = ::send(connection.mFd, connection.mOutput.data() + connection.mOutputOffset,
+            connection.mOutput.size() - connection.mOutputOffset, MSG_NOSIGNAL);
+
+        if (writtenSize > 0) {
+            connection.mOutputOffset += static_cast<std::size_t>(writtenSize);
+            continue;
+        }
+
+        if (writtenSize < 0 && errno == EINTR)
+            continue;
+
+        if (writtenSize < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+
+        return false;
+    }
+
+    if (connection.mOutputOffset == connection.mOutput.size()) {
+        connection.mOutput.clear();
+        connection.mOutputOffset = 0U;
+    }
+
+    // 肪Ă, SẲoڑ
+    return !(connection.mPeerClosed && connection.mNextResponse == connection.mNextSequence && connection.mOutput.empty());
+}
+
+void EvaluationServer::UpdateEvents(Connection& connection)
+{
+    std::uint32_t events = 0U;
+
+    if (!connection.mPeerClosed && connection.mNextSequence - connection.mNextResponse < MaxInFlightRequests)
+        events |= EPOLLIN;
+
+    if (!connection.mOutput.empty())
+        events |= EPOLLOUT;
+
+    if (events == connection.mEvents)
+        return;
+
+    // ҂CxgԂepollO (肪EPOLLHUP͗}~łȂ)
+    epoll_event event;
+    event.events = events;
+    event.data.u64 = connection.mId;
+
+    if (events == 0U)
+        ::epoll_ctl(this->mEpollFd, EPOLL_CTL_DEL, connection.mFd, nullptr);
+    else
+        ::epoll_ctl(this->mEpollFd, connection.mEvents == 0U ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, connection.mFd, &event);
+
+    connection.mEvents = events;
+}
+
+void EvaluationServer::CloseConnection(std::uint64_t connectionId)
+{
+    auto iter = this->mConnections.find(connectionId);
+
+    if (iter == this->mConnections.end())
+        return;
+
+    // ̗v̉, ڑȂ̂Ŏ̂Ă
+    ::epoll_ctl(this->mEpollFd, EPOLL_CTL_DEL, iter->second.mFd, nullptr);
+    ::close(iter->second.mFd);
+    this->mConnections.erase(iter);
+}
+
+void EvaluationServer::CollectResponses()
+{
+    std::vector<Response> responses;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mResponseMutex);
+        responses.swap(this->mResponses);
+    }
+
+    std::vector<std::uint64_t> connectionIds;
+
+    for (auto& response : responses) {
+        auto iter = this->mConnections.find(response.mConnectionId);
+
+        if (iter == this->mConnections.end())
+            continue;
+
+        iter->second.mReadyResponses.emplace(response.mSequence, std::move(response.mText));
+        connectionIds.push_back(response.mConnectionId);
+    }
+
+    std::sort(connectionIds.begin(), connectionIds.end());
+    connectionIds.erase(std::unique(connectionIds.begin(), connectionIds.end()), connectionIds.end());
+
+    for (std::uint64_t connectionId : connectionIds) {
+        Connection& connection = this->mConnections[connectionId];
+
+        if (!this->FlushConnection(connection)) {
+            this->CloseConnection(connectionId);
+            continue;
+        }
+
+        this->UpdateEvents(connection);
+    }
+}
+
+#else
+
+bool EvaluationServer::Run(const std::string& socketPath)
+{
+    // epollUnixhC\PbgĝLinux̂
+    static_cast<void>(socketPath);
+    return false;
+}
+
+#endif
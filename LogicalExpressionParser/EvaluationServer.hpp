@@ -0,0 +1,144 @@
+// LogicalExpressionParser
+// EvaluationServer.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_EVALUATION_SERVER_HPP
+#define LOGICAL_EXPRESSION_PARSER_EVALUATION_SERVER_HPP
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Compiler.hpp"
+#include "ResourceGovernor.hpp"
+
+class BaseAST;
+class Diagnostics;
+
+/*
+UnixhC\Pbgŗv󂯕t]T[o
+1s1̗v, 1sv̏ɕԂ (҂ɑėv𑗂Ă悢)
+    PARSE <_>                   OK <Kԍ> (_ɂ͓ԍԂ, ̏𒴂ERR)
+    PRINT <Kԍ> infix|prefix|postfix  OK <_>
+    EVAL <Kԍ> <ϐ>=T|F ...   OK true|false (w肵Ȃϐ͋U)
+    sꍇ                     ERR <R>
+epollɂCxg[vœǂݍ񂾗v܂Ƃ߂ă[J[Xbhɓn,
+[J[̉eventfdŒm点ăCxg[v珑o
+\͂ƃRpCς܂K̓T[oI܂ŕێ
+ */
+class EvaluationServer {
+public:
+    // 1̃ob`Ɋ܂߂v̍ő吔
+    static constexpr std::size_t BatchSize = 64U;
+    // 1̐ڑŏ̗v̐ɒB, Ԃ܂œǂݍ݂~߂
+    static constexpr std::size_t MaxInFlightRequests = 4096U;
+    static constexpr std::size_t MaxLineLength = 1U << 20;
+
+    EvaluationServer(unsigned int workerCount = 0U);
+    ~EvaluationServer();
+
+    EvaluationServer(const EvaluationServer&) = delete;
+    EvaluationServer& operator=(const EvaluationServer&) = delete;
+
+    inline std::size_t RuleCount() const {
+        std::shared_lock<std::shared_mutex> lock(this->mRulesMutex); return this->mRules.size(); }
+
+    // PARSE̗vƂɎ͂ƍ\͂Ŏg鎑̏ (Run̑Oɐݒ肷)
+    inline void SetResourceLimits(const ResourceLimits& limits) { this->mLimits = limits; }
+
+    // K\͂ăRpC, KԍԂ
+    std::optional<std::uint32_t> AddRule(const std::string& logicalExpr, Diagnostics* diagnostics = nullptr);
+    // 1̗vĉ (s܂܂Ȃ) Ԃ
+    std::string HandleRequest(const std::string& request);
+
+    // \Pbgėv (StopĂ΂܂Ŗ߂Ȃ)
+    bool Run(const std::string& socketPath);
+    // VOinhĂł悢
+    void Stop();
+
+private:
+    struct Rule {
+        std::shared_ptr<BaseAST>    mAST;
+        std::shared_ptr<Program>    mProgram;
+    };
+
+    struct Request {
+        std::uint64_t   mConnectionId;
+        std::uint64_t   mSequence;
+        std::string     mText;
+    };
+
+    struct Response {
+        std::uint64_t   mConnectionId;
+        std::uint64_t   mSequence;
+        std::string     mText;
+    };
+
+    struct Connection {
+        std::uint64_t                           mId;
+        int                                     mFd;
+        std::string                             mInput;
+        std::string                             mOutput;
+        std::size_t                             mOutputOffset;
+        std::uint64_t                           mNextSequence;
+        std::uint64_t                           mNextResponse;
+        std::map<std::uint64_t, std::string>    mReadyResponses;
+        std::uint32_t                           mEvents;        // 0łepollɓo^ĂȂ
+        bool                                    mPeerClosed;
+    };
+
+    std::string HandleParse(const std::string& arguments);
+    std::string HandlePrint(const std::string& arguments);
+    std::string HandleEvaluate(const std::string& arguments);
+    std::shared_ptr<const Rule> FindRule(const std::string& ruleIndexText) const;
+
+    void WorkerLoop();
+    void DispatchBatches(std::vector<Request>& requests);
+    void AcceptConnections();
+    void ReadConnection(Connection& connection, std::vector<Request>& requests);
+    bool FlushConnection(Connection& connection);
+    void UpdateEvents(Connection& connection);
+    void CloseConnection(std::uint64_t connectionId);
+    void CollectResponses();
+
+    unsigned int mWorkerCount;
+    ResourceLimits mLimits;
+
+    // KƃV{\ (PARSÊ݂)
+    mutable std::shared_mutex mRulesMutex;
+    std::vector<std::shared_ptr<const Rule>> mRules;
+    std::unordered_map<std::string, std::uint32_t> mRuleIndices;
+    std::shared_ptr<SymbolTable> mSymbolTable;
+
+    // [J[֓nob`
+    std::mutex mBatchMutex;
+    std::condition_variable mBatchCondition;
+    std::deque<std::vector<Request>> mBatches;
+    bool mStopWorkers;
+    std::vector<std::thread> mWorkers;
+
+    // [J[߂
+    std::mutex mResponseMutex;
+    std::vector<Response> mResponses;
+
+    std::unordered_map<std::uint64_t, Connection> mConnections;
+    std::uint64_t mNextConnectionId;
+    int mListenFd;
+    int mEpollFd;
+    int mWakeFd;
+    std::atomic<bool> mStopRequested;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_EVALUATION_SERVER_HPP
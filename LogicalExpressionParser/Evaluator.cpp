@@ -0,0 +1,444 @@
+
+// LogicalExpressionParser
+// Evaluator.cpp
+
+#include "Evaluator.hpp"
+#include "AST.hpp"
+#include "LatencyTracing.hpp"
+#include "ResourceGovernor.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+//
+// EvaluatorNX
+//
+
+std::optional<bool> Evaluator::Evaluate(const std::shared_ptr<BaseAST>& logicalExprAST, const VariableAssignment& assignment)
+{
+    assert(logicalExprAST != nullptr);
+    assert(logicalExprAST->Type() != ASTType::Base);
+
+    ScopedPhaseTimer phaseTimer(Phase::Evaluate);
+
+    // m[hƂɂ͏Ɣׂ邾ɂ, gXebv͕]̌ɂ܂Ƃ߂ĉZ
+    const std::uint64_t startNodes = this->mVisitedNodes;
+    const std::uint64_t remainingSteps = (this->mGovernor != nullptr) ?
+        this->mGovernor->RemainingSteps() : std::numeric_limits<std::uint64_t>::max();
+    this->mStepLimit = (remainingSteps > std::numeric_limits<std::uint64_t>::max() - startNodes) ?
+        std::numeric_limits<std::uint64_t>::max() : startNodes + remainingSteps;
+
+    std::optional<bool> value = this->Visit(logicalExprAST.get(), assignment);
+
+    if (this->mGovernor != nullptr && !this->mGovernor->ChargeSteps(this->mVisitedNodes - startNodes))
+        return std::nullopt;
+
+    return value;
+}
+
+std::optional<bool> Evaluator::Visit(const BaseAST* exprAST, const VariableAssignment& assignment)
+{
+    if (exprAST == nullptr)
+        return std::nullopt;
+
+    if (++this->mVisitedNodes > this->mStepLimit)
+        return std::nullopt;
+
+    // ^Type()Ŕʂł̂, dynamic_cast͎gȂ
+    switch (exprAST->Type()) {
+        case ASTType::Constant:
+            return static_cast<const ConstantAST*>(exprAST)->Value();
+        case ASTType::Variable:
+        {
+            // l^ĂȂϐ܂ޏꍇ̓G[Ԃ
+            auto iter = assignment.find(static_cast<const VariableAST*>(exprAST)->Name());
+
+            if (iter == assignment.end())
+                return std::nullopt;
+
+            return iter->second;
+        }
+        case ASTType::Factor:
+            return this->Visit(static_cast<const FactorAST*>(exprAST)->Expr().get(), assignment);
+        case ASTType::NotExpression:
+        {
+            std::optional<bool> value = this->Visit(static_cast<const NotExpressionAST*>(exprAST)->Expr().get(), assignment);
+
+            if (!value.has_value())
+                return std::nullopt;
+
+            return !value.value();
+        }
+        case ASTType::AndOrExpression:
+            return this->VisitAndOrExpression(static_cast<const AndOrExpressionAST*>(exprAST), assignment);
+        case ASTType::Expression:
+            return this->VisitExpression(static_cast<const ExpressionAST*>(exprAST), assignment);
+        case ASTType::XorExpression:
+            return this->VisitXorExpression(static_cast<const XorExpressionAST*>(exprAST), assignment);
+        case ASTType::NandNorExpression:
+            return this->VisitNandNorExpression(static_cast<const NandNorExpressionAST*>(exprAST), assignment);
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<bool> Evaluator::VisitAndOrExpression(const AndOrExpressionAST* andOrExprAST, const VariableAssignment& assignment)
+{
+    // And̏ꍇ͋U, Oȑꍇ͐^Ōʂm肷
+    bool decisiveValue = (andOrExprAST->Operator() == "");
+
+    for (const auto& operand : andOrExprAST->Operands()) {
+        std::optional<bool> value = this->Visit(operand.get(), assignment);
+
+        if (!value.has_value())
+            return std::nullopt;
+
+        // Z]
+        if (value.value() == decisiveValue)
+            return decisiveValue;
+    }
+
+    return !decisiveValue;
+}
+
+std::optional<bool> Evaluator::VisitExpression(const ExpressionAST* exprAST, const VariableAssignment& assignment)
+{
+    std::optional<bool> leftValue = this->Visit(exprAST->Left().get(), assignment);
+
+    if (!leftValue.has_value())
+        return std::nullopt;
+
+    if (exprAST->Operator() == "->") {
+        // OUłΉEӂ]ɐ^
+        if (!leftValue.value())
+            return true;
+
+        return this->Visit(exprAST->Right().get(), assignment);
+    }
+
+    std::optional<bool> rightValue = this->Visit(exprAST->Right().get(), assignment);
+
+    if (!rightValue.has_value())
+        return std::nullopt;
+
+    return leftValue.value() == rightValue.value();
+}
+
+std::optional<bool> Evaluator::VisitXorExpression(const XorExpressionAST* xorExprAST, const VariableAssignment& assignment)
+{
+    // XorXnor͗ӂ]Ȃƌʂm肵Ȃ
+    std::optional<bool> leftValue = this->Visit(xorExprAST->Left().get(), assignment);
+
+    if (!leftValue.has_value())
+        return std::nullopt;
+
+    std::optional<bool> rightValue = this->Visit(xorExprAST->Right().get(), assignment);
+
+    if (!rightValue.has_value())
+        return std::nullopt;
+
+    if (xorExprAST->Operator() == "")
+        return leftValue.value() != rightValue.value();
+
+    return leftValue.value() == rightValue.value();
+}
+
+std::optional<bool> Evaluator::VisitNandNorExpression(const NandNorExpressionAST* nandNorExprAST, const VariableAssignment& assignment)
+{
+    // Nand̏ꍇ͍ӂU, Noȑꍇ͍ӂ^Ōʂm肷
+    bool isNor = (nandNorExprAST->Operator() == "");
+    std::optional<bool> leftValue = this->Visit(nandNorExprAST->Left().get(), assignment);
+
+    if (!leftValue.has_value())
+        return std::nullopt;
+
+    // Z]
+    if (leftValue.value() == isNor)
+        return !isNor;
+
+    std::optional<bool> rightValue = this->Visit(nandNorExprAST->Right().get(), assignment);
+
+    if (!rightValue.has_value())
+        return std::nullopt;
+
+    return !rightValue.value();
+}
+
+//
+// AdaptiveEvaluatorNX
+//
+
+std::size_t AdaptiveEvaluator::AddRule(const std::shared_ptr<BaseAST>& logicalExprAST)
+{
+    assert(logicalExprAST != nullptr);
+
+    RuleStatistics rule;
+    rule.mAST = logicalExprAST;
+    this->CollectAndOrExpressions(logicalExprAST.get(), rule);
+    this->mRules.push_back(std::move(rule));
+
+    return this->mRules.size() - 1U;
+}
+
+void AdaptiveEvaluator::ClearRules()
+{
+    this->mRules.clear();
+}
+
+std::optional<bool> AdaptiveEvaluator::EvaluateRule(std::size_t ruleIndex, const VariableAssignment& assignment)
+{
+    assert(ruleIndex < this->mRules.size());
+
+    RuleStatistics& rule = this->mRules[ruleIndex];
+    this->mCurrentRule = &rule;
+    std::optional<bool> value = Evaluator::Evaluate(rule.mAST, assignment);
+    this->mCurrentRule = nullptr;
+
+    // 񐔂̕]ƂɃIyhבւ
+    if (this->mReorderInterval != 0U && ++rule.mEvaluationCount >= this->mReorderInterval) {
+        rule.mEvaluationCount = 0U;
+        this->Reorder(ruleIndex);
+    }
+
+    return value;
+}
+
+std::optional<bool> AdaptiveEvaluator::VisitAndOrExpression(const AndOrExpressionAST* andOrExprAST, const VariableAssignment& assignment)
+{
+    if (this->mCurrentRule == nullptr)
+        return Evaluator::VisitAndOrExpression(andOrExprAST, assignment);
+
+    auto iter = this->mCurrentRule->mNodeIndices.find(andOrExprAST);
+    assert(iter != this->mCurrentRule->mNodeIndices.end());
+
+    AndOrStatistics& statistics = this->mCurrentRule->mNodes[iter->second];
+    bool decisiveValue = (andOrExprAST->Operator() == "");
+
+    for (std::uint32_t sourceIndex : statistics.mOrder) {
+        OperandStatistics& operandStatistics = statistics.mOperands[sourceIndex];
+
+        // ]m[h̐RXgƂ݂Ȃ
+        std::uint64_t visitedNodes = this->mVisitedNodes;
+        std::optional<bool> value = this->Visit(andOrExprAST->Operand(sourceIndex).get(), assignment);
+
+        if (!value.has_value())
+            return std::nullopt;
+
+        ++operandStatistics.mEvaluations;
+        operandStatistics.mCost += this->mVisitedNodes - visitedNodes;
+
+        if (value.value() == decisiveValue) {
+            ++operandStatistics.mDecisive;
+            return decisiveValue;
+        }
+    }
+
+    return !decisiveValue;
+}
+
+double AdaptiveEvaluator::ExpectedCost(const AndOrStatistics& statistics, const std::vector<std::uint32_t>& order) const
+{
+    // ҃RXg = eIyh̃RXg * ÕIyhŌʂm肵Ȃm ̑a
+    double expectedCost = 0.0;
+    double undecidedProbability = 1.0;
+
+    for (std::uint32_t index : order) {
+        const OperandStatistics& operand = statistics.mOperands[index];
+        double cost = static_cast<double>(operand.mCost) / operand.mEvaluations;
+        double decisiveProbability = static_cast<double>(operand.mDecisive) / operand.mEvaluations;
+
+        expectedCost += undecidedProbability * cost;
+        undecidedProbability *= 1.0 - decisiveProbability;
+    }
+
+    return expectedCost;
+}
+
+bool AdaptiveEvaluator::FindBetterOrder(const AndOrStatistics& statistics, std::vector<std::uint32_t>& order) const
+{
+    // vȂ͕בւȂ
+    const std::uint64_t minSamples = 32U;
+
+    for (const auto& operand : statistics.mOperands)
+        if (operand.mEvaluations < minSamples)
+            return false;
+
+    // ƗȃIyh̒Z]ł, RXg / ʂm肳m ̏œK
+    order = statistics.mOrder;
+
+    auto rank = [&statistics](std::uint32_t index) {
+        const OperandStatistics& operand = statistics.mOperands[index];
+        return operand.mDecisive == 0U ? std::numeric_limits<double>::infinity() :
+            static_cast<double>(operand.mCost) / static_cast<double>(operand.mDecisive);
+    };
+
+    std::stable_sort(order.begin(), order.end(), [&rank](std::uint32_t lhs, std::uint32_t rhs) {
+        return rank(lhs) < rank(rhs); });
+
+    // בւUȂ悤, \ɈȂꍇ̂ݕבւ
+    return this->ExpectedCost(statistics, order) < this->ExpectedCost(statistics, statistics.mOrder) * 0.95;
+}
+
+std::size_t AdaptiveEvaluator::Reorder(std::size_t ruleIndex)
+{
+    assert(ruleIndex < this->mRules.size());
+
+    std::size_t reorderedCount = 0;
+    std::vector<std::uint32_t> order;
+
+    // And, Or͉Ȃ̂ŕ]̏ςĂʂ͕ςȂ (ۍ\؂͂̂܂)
+    for (AndOrStatistics& statistics : this->mRules[ruleIndex].mNodes) {
+        if (!this->FindBetterOrder(statistics, order))
+            continue;
+
+        statistics.mOrder = order;
+        ++reorderedCount;
+    }
+
+    this->mReorderedNodes += reorderedCount;
+
+    return reorderedCount;
+}
+
+void AdaptiveEvaluator::ResetStatistics()
+{
+    for (auto& rule : this->mRules) {
+        for (auto& statistics : rule.mNodes)
+            for (auto& operand : statistics.mOperands)
+                operand = OperandStatistics { };
+
+        rule.mEvaluationCount = 0U;
+    }
+}
+
+void AdaptiveEvaluator::CollectAndOrExpressions(const BaseAST* exprAST, RuleStatistics& rule) const
+{
+    if (exprAST == nullptr)
+        return;
+
+    switch (exprAST->Type()) {
+        case ASTType::Factor:
+            this->CollectAndOrExpressions(static_cast<const FactorAST*>(exprAST)->Expr().get(), rule);
+            return;
+        case ASTType::NotExpression:
+            this->CollectAndOrExpressions(static_cast<const NotExpressionAST*>(exprAST)->Expr().get(), rule);
+            return;
+        case ASTType::AndOrExpression:
+        {
+            const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(exprAST);
+
+            // Lꂽ؂1̃m[hƂēv
+            if (!rule.mNodeIndices.emplace(andOrExprAST, static_cast<std::uint32_t>(rule.mNodes.size())).second)
+                return;
+
+            rule.mNodes.emplace_back();
+            rule.mNodes.back().Reset(andOrExprAST->OperandCount());
+
+            for (const auto& operand : andOrExprAST->Operands())
+                this->CollectAndOrExpressions(operand.get(), rule);
+
+            return;
+        }
+        case ASTType::Expression:
+            this->CollectAndOrExpressions(static_cast<const ExpressionAST*>(exprAST)->Left().get(), rule);
+            this->CollectAndOrExpressions(static_cast<const ExpressionAST*>(exprAST)->Right().get(), rule);
+            return;
+        case ASTType::XorExpression:
+            this->CollectAndOrExpressions(static_cast<const XorExpressionAST*>(exprAST)->Left().get(), rule);
+            this->CollectAndOrExpressions(static_cast<const XorExpressionAST*>(exprAST)->Right().get(), rule);
+            return;
+        case ASTType::NandNorExpression:
+            this->CollectAndOrExpressions(static_cast<const NandNorExpressionAST*>(exprAST)->Left().get(), rule);
+            this->CollectAndOrExpressions(static_cast<const NandNorExpressionAST*>(exprAST)->Right().get(), rule);
+            return;
+        default:
+            return;
+    }
+}
+
+bool AdaptiveEvaluator::ExportStatistics(std::ostream& os) const
+{
+    // 1sڂ̓wb_, KƂ <K̔ԍ> <m[h> ̍s, AndOr̃m[hƂ
+    // <m[h̏o> <Iyh n> <]̏(\[Ẍʒu) * n> <] m RXg> * n ̍s
+    os << "AdaptiveEvaluator 3 " << this->mRules.size() << '\n';
+
+    for (std::size_t i = 0; i < this->mRules.size(); ++i) {
+        const RuleStatistics& rule = this->mRules[i];
+        os << i << ' ' << rule.mNodes.size() << '\n';
+
+        for (std::size_t j = 0; j < rule.mNodes.size(); ++j) {
+            const AndOrStatistics& statistics = rule.mNodes[j];
+            os << j << ' ' << statistics.mOperands.size();
+
+            for (std::uint32_t index : statistics.mOrder)
+                os << ' ' << index;
+
+            for (const auto& operand : statistics.mOperands)
+                os << ' ' << operand.mEvaluations << ' ' << operand.mDecisive << ' ' << operand.mCost;
+
+            os << '\n';
+        }
+    }
+
+    return static_cast<bool>(os);
+}
+
+bool AdaptiveEvaluator::ImportStatistics(std::istream& is)
+{
+    std::string header;
+    int version;
+    std::size_t ruleCount;
+
+    if (!(is >> header >> version >> ruleCount))
+        return false;
+
+    // ʂ̋KW̓vǂݍƂĂꍇ̓G[Ԃ
+    if (header != "AdaptiveEvaluator" || version != 3 || ruleCount != this->mRules.size())
+        return false;
+
+    std::vector<std::vector<AndOrStatistics>> importedNodes(ruleCount);
+
+    for (std::size_t i = 0; i < ruleCount; ++i) {
+        const RuleStatistics& rule = this->mRules[i];
+        std::size_t ruleIndex;
+        std::size_t nodeCount;
+
+        if (!(is >> ruleIndex >> nodeCount) || ruleIndex != i || nodeCount != rule.mNodes.size())
+            return false;
+
+        importedNodes[i].resize(nodeCount);
+
+        for (std::size_t j = 0; j < nodeCount; ++j) {
+            AndOrStatistics& statistics = importedNodes[i][j];
+            std::size_t nodeIndex;
+            std::size_t operandCount;
+
+            if (!(is >> nodeIndex >> operandCount) || nodeIndex != j || operandCount != rule.mNodes[j].mOperands.size())
+                return false;
+
+            statistics.Reset(operandCount);
+
+            // 0n - 1܂ł̒ułȂ΂ȂȂ
+            std::vector<bool> used(operandCount, false);
+
+            for (auto& sourceIndex : statistics.mOrder)
+                if (!(is >> sourceIndex) || sourceIndex >= operandCount || used[sourceIndex])
+                    return false;
+                else
+                    used[sourceIndex] = true;
+
+            for (auto& operand : statistics.mOperands)
+                if (!(is >> operand.mEvaluations >> operand.mDecisive >> operand.mCost))
+                    return false;
+        }
+    }
+
+    // Sēǂݍ߂ꍇ̂ݔf
+    for (std::size_t i = 0; i < ruleCount; ++i) {
+        this->mRules[i].mNodes = std::move(importedNodes[i]);
+        this->mRules[i].mEvaluationCount = 0U;
+    }
+
+    return true;
+}
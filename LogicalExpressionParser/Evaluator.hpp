@@ -0,0 +1,126 @@
+// LogicalExpressionParser
+// Evaluator.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_EVALUATOR_HPP
+#define LOGICAL_EXPRESSION_PARSER_EVALUATOR_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class BaseAST;
+class AndOrExpressionAST;
+class ExpressionAST;
+class XorExpressionAST;
+class NandNorExpressionAST;
+class ResourceGovernor;
+
+using VariableAssignment = std::unordered_map<std::string, bool>;
+
+class Evaluator {
+public:
+    Evaluator() : mVisitedNodes(0U), mGovernor(nullptr), mStepLimit(std::numeric_limits<std::uint64_t>::max()) { }
+    virtual ~Evaluator() { }
+
+    // Kꂽm[h̐XebvƂĉZ, 𒴂]std::nulloptԂ
+    inline void SetGovernor(ResourceGovernor* governor) { this->mGovernor = governor; }
+
+    virtual std::optional<bool> Evaluate(const std::shared_ptr<BaseAST>& logicalExprAST, const VariableAssignment& assignment);
+
+    inline std::uint64_t VisitedNodes() const { return this->mVisitedNodes; }
+
+protected:
+    std::optional<bool> Visit(const BaseAST* exprAST, const VariableAssignment& assignment);
+    virtual std::optional<bool> VisitAndOrExpression(const AndOrExpressionAST* andOrExprAST, const VariableAssignment& assignment);
+    std::optional<bool> VisitExpression(const ExpressionAST* exprAST, const VariableAssignment& assignment);
+    std::optional<bool> VisitXorExpression(const XorExpressionAST* xorExprAST, const VariableAssignment& assignment);
+    std::optional<bool> VisitNandNorExpression(const NandNorExpressionAST* nandNorExprAST, const VariableAssignment& assignment);
+
+    std::uint64_t mVisitedNodes;
+    ResourceGovernor* mGovernor;
+    // ݂̕]mVisitedNodes̒l𒴂Ƒł؂
+    std::uint64_t mStepLimit;
+};
+
+/*
+KƂ, AndOr̃m[h̊eIyhʂm肳񐔂ƕ]̃RXgL^,
+񐔂̕]ƂɊ҃RXgȂ鏇ŃIyh]
+ۍ\؂͕ύX (ƋLĂĂ悢), ]̏̓m[hƂ̃Iyḧʒu̒uƂĎ
+v͋K̔ԍ, m[h̏o, Iyh̃\[Ẍʒuŕ\̂, oĎ̋Nɓǂݍ߂
+ */
+class AdaptiveEvaluator final : public Evaluator {
+public:
+    AdaptiveEvaluator(std::uint64_t reorderInterval = 1024U) :
+        mReorderInterval(reorderInterval), mReorderedNodes(0U), mCurrentRule(nullptr) { }
+    ~AdaptiveEvaluator() { }
+
+    // KǉĔԍ (ǉ) Ԃ (ۍ\؂͋K폜܂ŕێ)
+    std::size_t AddRule(const std::shared_ptr<BaseAST>& logicalExprAST);
+    void ClearRules();
+    inline std::size_t RuleCount() const { return this->mRules.size(); }
+    // ܂łɕבւAndOr̃m[h̉א
+    inline std::uint64_t ReorderedNodes() const { return this->mReorderedNodes; }
+
+    // vL^ȂK], 񐔂̕]Ƃɂ̋Kבւ
+    std::optional<bool> EvaluateRule(std::size_t ruleIndex, const VariableAssignment& assignment);
+
+    // בւm[h̐Ԃ
+    std::size_t Reorder(std::size_t ruleIndex);
+    // ]͎̏c, v݂̂
+    void ResetStatistics();
+
+    // SĂ̋K̕]̏Ɠv (ǂݍޑO, oƂƓK𓯂ɒǉĂ)
+    bool ExportStatistics(std::ostream& os) const;
+    bool ImportStatistics(std::istream& is);
+
+private:
+    struct OperandStatistics {
+        std::uint64_t mEvaluations = 0U;
+        std::uint64_t mDecisive = 0U;
+        std::uint64_t mCost = 0U;
+    };
+
+    // Iyh̓v̓\[X̏ŕێ, mOrderɕ]̏ (iԖڂɕ]Iyh̃\[Ẍʒu) 
+    struct AndOrStatistics {
+        std::vector<OperandStatistics> mOperands;
+        std::vector<std::uint32_t> mOrder;
+
+        void Reset(std::size_t operandCount) {
+            this->mOperands.assign(operandCount, OperandStatistics { });
+            this->mOrder.resize(operandCount);
+
+            for (std::size_t i = 0; i < operandCount; ++i)
+                this->mOrder[i] = static_cast<std::uint32_t>(i);
+        }
+    };
+
+    // AndOr̃m[h̓\[X̏oɔԍt (Lꂽ؂͍ŏ̏ôݐ)
+    struct RuleStatistics {
+        std::shared_ptr<BaseAST> mAST;
+        std::vector<AndOrStatistics> mNodes;
+        std::unordered_map<const AndOrExpressionAST*, std::uint32_t> mNodeIndices;
+        std::uint64_t mEvaluationCount = 0U;
+    };
+
+    std::optional<bool> VisitAndOrExpression(const AndOrExpressionAST* andOrExprAST, const VariableAssignment& assignment) override;
+
+    void CollectAndOrExpressions(const BaseAST* exprAST, RuleStatistics& rule) const;
+    double ExpectedCost(const AndOrStatistics& statistics, const std::vector<std::uint32_t>& order) const;
+    bool FindBetterOrder(const AndOrStatistics& statistics, std::vector<std::uint32_t>& order) const;
+
+    std::vector<RuleStatistics> mRules;
+    std::uint64_t mReorderInterval;
+    std::uint64_t mReorderedNodes;
+    // ]̋K (K̊O]ꍇnullptr, vL^Ȃ)
+    RuleStatistics* mCurrentRule;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_EVALUATOR_HPP
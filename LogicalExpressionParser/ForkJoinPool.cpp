@@ -0,0 +1,135 @@
+
+// LogicalExpressionParser
+// ForkJoinPool.cpp
+
+#include "ForkJoinPool.hpp"
+
+#include <algorithm>
+
+// ݂̃Xbh[J[ł, ̃v[ƃL[̔ԍ
+static thread_local const ForkJoinPool* tCurrentPool = nullptr;
+static thread_local std::size_t tQueueIndex = 0U;
+
+ForkJoinPool::ForkJoinPool(unsigned int threadCount) :
+    mQueuedTasks(0U),
+    mStolenTasks(0U),
+    mStopping(false)
+{
+    unsigned int workerCount = (threadCount != 0U ? threadCount : std::max(1U, std::thread::hardware_concurrency())) - 1U;
+
+    for (unsigned int i = 0; i <= workerCount; ++i)
+        this->mQueues.push_back(std::make_unique<WorkQueue>());
+
+    for (unsigned int i = 0; i < workerCount; ++i)
+        this->mWorkers.emplace_back(&ForkJoinPool::WorkerLoop, this, static_cast<std::size_t>(i));
+}
+
+ForkJoinPool::~ForkJoinPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mSleepMutex);
+        this->mStopping = true;
+    }
+
+    this->mSleepCondition.notify_all();
+
+    for (auto& worker : this->mWorkers)
+        worker.join();
+}
+
+void ForkJoinPool::Push(Task&& task)
+{
+    // [J[ȊÕXbh͖̋LL[ɓ
+    std::size_t queueIndex = (tCurrentPool == this) ? tQueueIndex : this->mQueues.size() - 1U;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mQueues[queueIndex]->mMutex);
+        this->mQueues[queueIndex]->mTasks.push_back(std::move(task));
+    }
+
+    // Ă郏[J[N (ʒm肱ڂȂ悤, ҋ@Ɠ~[ebNXʂ)
+    this->mQueuedTasks.fetch_add(1U, std::memory_order_release);
+    { std::lock_guard<std::mutex> lock(this->mSleepMutex); }
+    this->mSleepCondition.notify_one();
+}
+
+bool ForkJoinPool::RunOneTask()
+{
+    if (this->mQueuedTasks.load(std::memory_order_acquire) == 0U)
+        return false;
+
+    std::size_t queueCount = this->mQueues.size();
+    std::size_t ownIndex = (tCurrentPool == this) ? tQueueIndex : queueCount - 1U;
+    Task task;
+    bool found = false;
+
+    // ̃L[͍łV^XNo
+    {
+        WorkQueue& queue = *this->mQueues[ownIndex];
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+
+        if (!queue.mTasks.empty()) {
+            task = std::move(queue.mTasks.back());
+            queue.mTasks.pop_back();
+            found = true;
+        }
+    }
+
+    // ̃L[͍łÂ^XN𓐂
+    for (std::size_t i = 1; !found && i < queueCount; ++i) {
+        WorkQueue& queue = *this->mQueues[(ownIndex + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mMutex);
+
+        if (!queue.mTasks.empty()) {
+            task = std::move(queue.mTasks.front());
+            queue.mTasks.pop_front();
+            found = true;
+            this->mStolenTasks.fetch_add(1U, std::memory_order_relaxed);
+        }
+    }
+
+    if (!found)
+        return false;
+
+    this->mQueuedTasks.fetch_sub(1U, std::memory_order_relaxed);
+    task.mFunction();
+    task.mGroup->mPendingTasks.fetch_sub(1U, std::memory_order_release);
+
+    return true;
+}
+
+void ForkJoinPool::WorkerLoop(std::size_t queueIndex)
+{
+    tCurrentPool = this;
+    tQueueIndex = queueIndex;
+
+    while (true) {
+        if (this->RunOneTask())
+            continue;
+
+        std::unique_lock<std::mutex> lock(this->mSleepMutex);
+        this->mSleepCondition.wait(lock, [this]() {
+            return this->mStopping || this->mQueuedTasks.load(std::memory_order_acquire) != 0U; });
+
+        if (this->mStopping)
+            break;
+    }
+}
+
+//
+// TaskGroupNX
+//
+
+void ForkJoinPool::TaskGroup::Spawn(std::function<void()>&& function)
+{
+    this->mPendingTasks.fetch_add(1U, std::memory_order_relaxed);
+    this->mPool.Push(Task { std::move(function), this });
+}
+
+void ForkJoinPool::TaskGroup::Wait()
+{
+    // ҂ĂԂ, ̃^XNɌ炸sł^XNs
+    while (this->mPendingTasks.load(std::memory_order_acquire) != 0U)
+        if (!this->mPool.RunOneTask())
+            std::this_thread::yield();
+}
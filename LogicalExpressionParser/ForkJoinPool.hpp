@@ -0,0 +1,88 @@
+// LogicalExpressionParser
+// ForkJoinPool.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_FORK_JOIN_POOL_HPP
+#define LOGICAL_EXPRESSION_PARSER_FORK_JOIN_POOL_HPP
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+[NXeB[OɂtH[NEWC̃Xbhv[
+[J[͂ꂼꎩ̃L[, ^XNVɎs
+̃L[ɂȂ, ̃L[łÂ^XN (̍ɋ߂傫ȃ^XN) 𓐂
+^XN̊҂Xbh, ҂ĂԂ̃^XNs
+^XN͕؂Ƃ̑ePʂȂ̂, L[̓bNŎ
+ */
+class ForkJoinPool {
+public:
+    class TaskGroup;
+
+    // Xbh0̏ꍇ̓n[hEFÃXbh (҂Xbhsɉ̂, [J[1Ȃ)
+    ForkJoinPool(unsigned int threadCount = 0U);
+    ~ForkJoinPool();
+
+    ForkJoinPool(const ForkJoinPool&) = delete;
+    ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+    inline unsigned int ThreadCount() const { return static_cast<unsigned int>(this->mWorkers.size()) + 1U; }
+    inline std::uint64_t StolenTasks() const { return this->mStolenTasks.load(std::memory_order_relaxed); }
+
+    // Ɋ҂^XN̏W܂ (jOɑSẴ^XN̊҂)
+    class TaskGroup {
+    public:
+        TaskGroup(ForkJoinPool& pool) : mPool(pool), mPendingTasks(0U) { }
+        ~TaskGroup() { this->Wait(); }
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        void Spawn(std::function<void()>&& function);
+        void Wait();
+
+    private:
+        friend class ForkJoinPool;
+
+        ForkJoinPool& mPool;
+        std::atomic<std::size_t> mPendingTasks;
+    };
+
+private:
+    struct Task {
+        std::function<void()>   mFunction;
+        TaskGroup*              mGroup;
+    };
+
+    struct WorkQueue {
+        std::mutex          mMutex;
+        std::deque<Task>    mTasks;
+    };
+
+    void Push(Task&& task);
+    // ̃L[, ̃L[̏Ƀ^XNT1s (false)
+    bool RunOneTask();
+    void WorkerLoop(std::size_t queueIndex);
+
+    // [J[Ƃ̃L[, [J[ȊÕXbh^XÑL[ ()
+    std::vector<std::unique_ptr<WorkQueue>> mQueues;
+    std::vector<std::thread> mWorkers;
+
+    // L[ɓĂ^XN̐ (0ł΃[J[͖)
+    std::atomic<std::size_t> mQueuedTasks;
+    std::atomic<std::uint64_t> mStolenTasks;
+    std::mutex mSleepMutex;
+    std::condition_variable mSleepCondition;
+    bool mStopping;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_FORK_JOIN_POOL_HPP
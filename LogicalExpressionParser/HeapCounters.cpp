@@ -0,0 +1,98 @@
+
+// LogicalExpressionParser
+// HeapCounters.cpp
+
+#include "PerformanceCounters.hpp"
+
+#include <cstdlib>
+#include <new>
+
+/*
+q[vmۂ̌v (Zqnewdelete̒u)
+vOŜ̉Zqnewû, ÓICuɂ͊܂߂Ɏst@Ĉ݂ŃN
+̃t@CNȂꍇ, q[vmۂ̃JE^0̂܂܂ƂȂ
+ACgw肷鉉Zqnew (std::align_val_t) ͒uȂ̂ŐȂ
+ */
+
+#ifndef LEP_DISABLE_PERFORMANCE_COUNTERS
+static inline void* CountedAllocate(std::size_t size) noexcept
+{
+    void* memory = std::malloc(size != 0U ? size : 1U);
+
+    if (memory != nullptr) {
+        PerformanceCounters::Add(PerformanceCounter::HeapAllocations, 0U, 1U);
+        PerformanceCounters::Add(PerformanceCounter::HeapBytes, 0U, size);
+    }
+
+    return memory;
+}
+
+static inline void CountedDeallocate(void* memory) noexcept
+{
+    if (memory == nullptr)
+        return;
+
+    PerformanceCounters::Add(PerformanceCounter::HeapDeallocations, 0U, 1U);
+    std::free(memory);
+}
+
+void* operator new(std::size_t size)
+{
+    void* memory = CountedAllocate(size);
+
+    if (memory == nullptr)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+    void* memory = CountedAllocate(size);
+
+    if (memory == nullptr)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    CountedDeallocate(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    CountedDeallocate(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    CountedDeallocate(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    CountedDeallocate(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    CountedDeallocate(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    CountedDeallocate(memory);
+}
+#endif
@@ -0,0 +1,269 @@
+
+// LogicalExpressionParser
+// IncrementalEvaluator.cpp
+
+#include "IncrementalEvaluator.hpp"
+
+#include <algorithm>
+#include <functional>
+
+static inline std::uint32_t OperandCount(OpCode opCode)
+{
+    switch (opCode) {
+        case OpCode::False:
+        case OpCode::True:
+        case OpCode::Variable:
+            return 0U;
+        case OpCode::Not:
+            return 1U;
+        default:
+            return 2U;
+    }
+}
+
+IncrementalEvaluator::IncrementalEvaluator(const ProgramView& program) :
+    mRecomputedNodes(0U)
+{
+    assert(program.InstructionCount() > 0);
+
+    const std::size_t nodeCount = program.InstructionCount();
+    const Instruction* instructions = program.Instructions();
+
+    this->mNodes.reserve(nodeCount);
+
+    for (std::size_t i = 0; i < nodeCount; ++i) {
+        Node node { instructions[i].mOpCode, instructions[i].mOperand0, instructions[i].mOperand1 };
+
+        // ϐ̖߂̃Iyh͋K̕ϐԍɒu
+        if (node.mOpCode == OpCode::Variable) {
+            auto iter = this->mLocalVariables.find(node.mOperand0);
+
+            if (iter == this->mLocalVariables.end()) {
+                iter = this->mLocalVariables.emplace(
+                    node.mOperand0, static_cast<std::uint32_t>(this->mVariables.size())).first;
+                this->mVariables.push_back(node.mOperand0);
+                this->mVariableNodes.emplace_back();
+            }
+
+            node.mOperand0 = iter->second;
+            this->mVariableNodes[iter->second].push_back(static_cast<std::uint32_t>(i));
+        }
+
+        this->mNodes.push_back(node);
+    }
+
+    // ëꗗ (߂𕡐̖߂QƂĂĂ悢)
+    this->mParentOffsets.assign(nodeCount + 1U, 0U);
+
+    for (const Node& node : this->mNodes) {
+        std::uint32_t operandCount = OperandCount(node.mOpCode);
+
+        if (operandCount >= 1U)
+            ++this->mParentOffsets[node.mOperand0 + 1U];
+        if (operandCount >= 2U)
+            ++this->mParentOffsets[node.mOperand1 + 1U];
+    }
+
+    for (std::size_t i = 0; i < nodeCount; ++i)
+        this->mParentOffsets[i + 1U] += this->mParentOffsets[i];
+
+    this->mParents.resize(this->mParentOffsets.back());
+    std::vector<std::uint32_t> parentCounts(nodeCount, 0U);
+
+    for (std::uint32_t i = 0; i < nodeCount; ++i) {
+        const Node& node = this->mNodes[i];
+        std::uint32_t operandCount = OperandCount(node.mOpCode);
+
+        if (operandCount >= 1U)
+            this->mParents[this->mParentOffsets[node.mOperand0] + parentCounts[node.mOperand0]++] = i;
+        if (operandCount >= 2U)
+            this->mParents[this->mParentOffsets[node.mOperand1] + parentCounts[node.mOperand1]++] = i;
+    }
+
+    this->mValues.assign(nodeCount, 0U);
+    this->mDirtyFlags.assign(nodeCount, 0U);
+
+    // SĂ̕ϐUƂĕ]Ă
+    std::vector<std::uint64_t> assignment(
+        this->mVariables.empty() ? 1U : (*std::max_element(this->mVariables.begin(), this->mVariables.end()) >> 6) + 1U, 0U);
+    this->Reset(assignment.data());
+}
+
+bool IncrementalEvaluator::Reset(const std::uint64_t* assignment)
+{
+    for (std::uint32_t i = 0; i < this->mNodes.size(); ++i) {
+        const Node& node = this->mNodes[i];
+
+        if (node.mOpCode == OpCode::Variable) {
+            std::uint32_t variable = this->mVariables[node.mOperand0];
+            this->mValues[i] = static_cast<std::uint8_t>((assignment[variable >> 6] >> (variable & 63U)) & 1U);
+            continue;
+        }
+
+        this->mValues[i] = this->ComputeNode(i) ? 1U : 0U;
+    }
+
+    this->mRecomputedNodes = this->mNodes.size();
+
+    return this->Value();
+}
+
+bool IncrementalEvaluator::SetVariable(std::uint32_t variable, bool value)
+{
+    this->mRecomputedNodes = 0U;
+
+    if (this->MarkVariable(variable, value))
+        this->Propagate();
+
+    return this->Value();
+}
+
+bool IncrementalEvaluator::SetVariables(const std::vector<std::pair<std::uint32_t, bool>>& updates)
+{
+    // SĂ̕ϐ̒lςĂ܂Ƃ߂ē`d̂, ʂ̑c1xČvZ
+    bool changed = false;
+    this->mRecomputedNodes = 0U;
+
+    for (const auto& update : updates)
+        changed = this->MarkVariable(update.first, update.second) || changed;
+
+    if (changed)
+        this->Propagate();
+
+    return this->Value();
+}
+
+bool IncrementalEvaluator::DependsOn(std::uint32_t variable) const
+{
+    return this->DependsOn(variable, this->mNodes.size() - 1U);
+}
+
+bool IncrementalEvaluator::DependsOn(std::uint32_t variable, std::size_t nodeIndex) const
+{
+    assert(nodeIndex < this->mNodes.size());
+
+    auto iter = this->mLocalVariables.find(variable);
+
+    if (iter == this->mLocalVariables.end())
+        return false;
+
+    // e͎qɂ̂, nodeIndex̖߂͒HȂ
+    std::vector<std::uint8_t> visited(nodeIndex + 1U, 0U);
+    std::vector<std::uint32_t> pendingNodes;
+
+    for (std::uint32_t variableNode : this->mVariableNodes[iter->second]) {
+        if (variableNode <= nodeIndex) {
+            visited[variableNode] = 1U;
+            pendingNodes.push_back(variableNode);
+        }
+    }
+
+    while (!pendingNodes.empty()) {
+        std::uint32_t currentIndex = pendingNodes.back();
+        pendingNodes.pop_back();
+
+        if (currentIndex == nodeIndex)
+            return true;
+
+        for (std::uint32_t i = this->mParentOffsets[currentIndex]; i < this->mParentOffsets[currentIndex + 1U]; ++i) {
+            std::uint32_t parentIndex = this->mParents[i];
+
+            if (parentIndex <= nodeIndex && visited[parentIndex] == 0U) {
+                visited[parentIndex] = 1U;
+                pendingNodes.push_back(parentIndex);
+            }
+        }
+    }
+
+    return false;
+}
+
+bool IncrementalEvaluator::ComputeNode(std::uint32_t nodeIndex) const
+{
+    const Node& node = this->mNodes[nodeIndex];
+
+    switch (node.mOpCode) {
+        case OpCode::False:
+            return false;
+        case OpCode::True:
+            return true;
+        case OpCode::Variable:
+            return this->mValues[nodeIndex] != 0U;
+        case OpCode::Not:
+            return this->mValues[node.mOperand0] == 0U;
+        case OpCode::And:
+            return this->mValues[node.mOperand0] != 0U && this->mValues[node.mOperand1] != 0U;
+        case OpCode::Or:
+            return this->mValues[node.mOperand0] != 0U || this->mValues[node.mOperand1] != 0U;
+        case OpCode::Then:
+            return this->mValues[node.mOperand0] == 0U || this->mValues[node.mOperand1] != 0U;
+        case OpCode::Eq:
+        case OpCode::Xnor:
+            return this->mValues[node.mOperand0] == this->mValues[node.mOperand1];
+        case OpCode::Xor:
+            return this->mValues[node.mOperand0] != this->mValues[node.mOperand1];
+        case OpCode::Nand:
+            return this->mValues[node.mOperand0] == 0U || this->mValues[node.mOperand1] == 0U;
+        case OpCode::Nor:
+            return this->mValues[node.mOperand0] == 0U && this->mValues[node.mOperand1] == 0U;
+    }
+
+    return false;
+}
+
+bool IncrementalEvaluator::MarkVariable(std::uint32_t variable, bool value)
+{
+    auto iter = this->mLocalVariables.find(variable);
+
+    if (iter == this->mLocalVariables.end())
+        return false;
+
+    bool changed = false;
+
+    for (std::uint32_t nodeIndex : this->mVariableNodes[iter->second]) {
+        if ((this->mValues[nodeIndex] != 0U) == value)
+            continue;
+
+        this->mValues[nodeIndex] = value ? 1U : 0U;
+        changed = true;
+
+        this->MarkParentsDirty(nodeIndex);
+    }
+
+    return changed;
+}
+
+void IncrementalEvaluator::MarkParentsDirty(std::uint32_t nodeIndex)
+{
+    for (std::uint32_t i = this->mParentOffsets[nodeIndex]; i < this->mParentOffsets[nodeIndex + 1U]; ++i) {
+        std::uint32_t parentIndex = this->mParents[i];
+
+        if (this->mDirtyFlags[parentIndex] == 0U) {
+            this->mDirtyFlags[parentIndex] = 1U;
+            this->mDirtyNodes.push_back(parentIndex);
+            std::push_heap(this->mDirtyNodes.begin(), this->mDirtyNodes.end(), std::greater<std::uint32_t>());
+        }
+    }
+}
+
+void IncrementalEvaluator::Propagate()
+{
+    // ԍ̏߂ČvẐ, q̍ČvZ͑Sčςł
+    while (!this->mDirtyNodes.empty()) {
+        std::pop_heap(this->mDirtyNodes.begin(), this->mDirtyNodes.end(), std::greater<std::uint32_t>());
+        std::uint32_t nodeIndex = this->mDirtyNodes.back();
+        this->mDirtyNodes.pop_back();
+        this->mDirtyFlags[nodeIndex] = 0U;
+        ++this->mRecomputedNodes;
+
+        std::uint8_t value = this->ComputeNode(nodeIndex) ? 1U : 0U;
+
+        // lςȂΐeւ͓`dȂ
+        if (value == this->mValues[nodeIndex])
+            continue;
+
+        this->mValues[nodeIndex] = value;
+
+        this->MarkParentsDirty(nodeIndex);
+    }
+}
@@ -0,0 +1,78 @@
+// LogicalExpressionParser
+// IncrementalEvaluator.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_INCREMENTAL_EVALUATOR_HPP
+#define LOGICAL_EXPRESSION_PARSER_INCREMENTAL_EVALUATOR_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Compiler.hpp"
+
+/*
+ϐ̒l̕ωɉ]
+ߗ̊e߂̒lێĂ, l̕ςϐe̖߂֌čČvZ`d
+e̒lςȂ΂œ`d~߂̂, XV̎Ԃ͉e󂯂镔̑傫ɔႷ
+߂ƂɈˑϐ̏W͎Ȃ (`d͐ëꗗ݂̂ŉe󂯂镔Ɍ̂,
+ߐ~ϐ̗̈gĂ܂ŎKvȂ)
+ */
+class IncrementalEvaluator {
+public:
+    // ϐԍProgramView::EvaluateƓV{\̔ԍg
+    IncrementalEvaluator(const ProgramView& program);
+    ~IncrementalEvaluator() = default;
+
+    inline bool Value() const { return this->mValues.back() != 0U; }
+    // KɌϐ (V{\̔ԍ)
+    inline const std::vector<std::uint32_t>& Variables() const { return this->mVariables; }
+    // O̍XVōČvZ߂̌
+    inline std::uint64_t RecomputedNodes() const { return this->mRecomputedNodes; }
+
+    // SĂ̖߂] (ϐ̒l͕ϐԍƂ1rbgŕ\)
+    bool Reset(const std::uint64_t* assignment);
+
+    // ϐ̒lςč̒lԂ (KɌȂϐ͖)
+    bool SetVariable(std::uint32_t variable, bool value);
+    bool SetVariables(const std::vector<std::pair<std::uint32_t, bool>>& updates);
+
+    // nodeIndexԖڂ̖ (ȗ͍) ̒lϐvariableɈˑ邩
+    // ϐǂޖ߂ëꗗĤ, Ԃ͕ϐ̉e󂯂镔̑傫ɔႷ
+    bool DependsOn(std::uint32_t variable) const;
+    bool DependsOn(std::uint32_t variable, std::size_t nodeIndex) const;
+
+private:
+    struct Node {
+        OpCode          mOpCode;
+        std::uint32_t   mOperand0;
+        std::uint32_t   mOperand1;
+    };
+
+    bool ComputeNode(std::uint32_t nodeIndex) const;
+    bool MarkVariable(std::uint32_t variable, bool value);
+    void MarkParentsDirty(std::uint32_t nodeIndex);
+    void Propagate();
+
+    std::vector<Node> mNodes;
+    std::vector<std::uint8_t> mValues;
+
+    // e̖߂̈ꗗ (i̐emParents[mParentOffsets[i]]mParents[mParentOffsets[i + 1]]̎O܂)
+    std::vector<std::uint32_t> mParentOffsets;
+    std::vector<std::uint32_t> mParents;
+
+    std::vector<std::uint32_t> mVariables;
+    std::unordered_map<std::uint32_t, std::uint32_t> mLocalVariables;
+    // K̕ϐƂ, ̕ϐǂޖ߂̈ꗗ
+    std::vector<std::vector<std::uint32_t>> mVariableNodes;
+
+    // ČvZ҂ (q͐eOɂ̂, ԍ̏Ɏo)
+    std::vector<std::uint32_t> mDirtyNodes;
+    std::vector<std::uint8_t> mDirtyFlags;
+    std::uint64_t mRecomputedNodes;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_INCREMENTAL_EVALUATOR_HPP
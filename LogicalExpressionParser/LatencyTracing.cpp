@@ -0,0 +1,417 @@
+
+// LogicalExpressionParser
+// LatencyTracing.cpp
+
+#include "LatencyTracing.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> LatencyTracing::sEnabled { false };
+
+const char* PhaseName(Phase phase)
+{
+    switch (phase) {
+        case Phase::Lex:
+            return "Lex";
+        case Phase::ParseInfix:
+            return "ParseInfix";
+        case Phase::ParsePrefix:
+            return "ParsePrefix";
+        case Phase::ParsePostfix:
+            return "ParsePostfix";
+        case Phase::Compile:
+            return "Compile";
+        case Phase::Evaluate:
+            return "Evaluate";
+        case Phase::Print:
+            return "Print";
+        case Phase::Minimize:
+            return "Minimize";
+    }
+
+    return "Unknown";
+}
+
+// XbhƂ̃qXgO (ނ̂͏LXbĥ)
+// Xbh̏IWvɊ܂߂邽߉Ȃ
+struct ThreadHistograms {
+    std::atomic<std::uint64_t> mBuckets[PhaseCount][LatencyHistogram::BucketCount];
+    std::atomic<std::uint64_t> mSum[PhaseCount];
+    std::atomic<std::uint64_t> mMin[PhaseCount];
+    std::atomic<std::uint64_t> mMax[PhaseCount];
+    ThreadHistograms* mNext;
+};
+
+struct TraceEvent {
+    const char*     mName;
+    std::uint64_t   mStartTime;
+    std::uint64_t   mDuration;
+};
+
+// XbhƂɕێXp̏ (͌Â̂㏑)
+static constexpr std::size_t MaxTraceEventsPerThread = static_cast<std::size_t>(1U) << 16;
+
+// XbhƂ̃Xp (oƂ̂ݑ̃Xbhǂނ̂, bN͋Ȃ)
+// ԓT[oł̈悪Ȃ悤, ̌̊obt@Ƃ
+struct ThreadTrace {
+    std::mutex              mMutex;
+    std::vector<TraceEvent> mEvents;
+    // ɒBɎɏ㏑ʒu (łÂXp)
+    std::size_t             mNextIndex;
+    std::uint64_t           mDroppedCount;
+    std::uint32_t           mThreadId;
+    ThreadTrace*            mNext;
+};
+
+static const std::chrono::steady_clock::time_point sOriginTime = std::chrono::steady_clock::now();
+
+static std::atomic<ThreadHistograms*> sThreadHistogramsHead { nullptr };
+static std::atomic<ThreadTrace*> sThreadTraceHead { nullptr };
+static std::atomic<std::uint32_t> sThreadTraceCount { 0U };
+
+static thread_local ThreadHistograms* tThreadHistograms = nullptr;
+static thread_local ThreadTrace* tThreadTrace = nullptr;
+static thread_local bool tSampled = false;
+static thread_local std::uint64_t tInputCount = 0U;
+
+static std::atomic<bool> sTraceEnabled { false };
+static double sSampleRate = 0.0;
+static std::string sTraceFileName;
+static bool sSummaryAtExit = false;
+static bool sDumpInstalled = false;
+
+template <typename T>
+static void PushFront(std::atomic<T*>& head, T* node)
+{
+    node->mNext = head.load(std::memory_order_relaxed);
+
+    while (!head.compare_exchange_weak(node->mNext, node, std::memory_order_release, std::memory_order_relaxed))
+        ;
+}
+
+static ThreadHistograms* CurrentThreadHistograms()
+{
+    if (tThreadHistograms != nullptr)
+        return tThreadHistograms;
+
+    ThreadHistograms* threadHistograms = new ThreadHistograms;
+
+    for (std::size_t i = 0; i < PhaseCount; ++i) {
+        for (auto& bucket : threadHistograms->mBuckets[i])
+            bucket.store(0U, std::memory_order_relaxed);
+
+        threadHistograms->mSum[i].store(0U, std::memory_order_relaxed);
+        threadHistograms->mMin[i].store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+        threadHistograms->mMax[i].store(0U, std::memory_order_relaxed);
+    }
+
+    PushFront(sThreadHistogramsHead, threadHistograms);
+    tThreadHistograms = threadHistograms;
+
+    return threadHistograms;
+}
+
+static ThreadTrace* CurrentThreadTrace()
+{
+    if (tThreadTrace != nullptr)
+        return tThreadTrace;
+
+    ThreadTrace* threadTrace = new ThreadTrace;
+    threadTrace->mNextIndex = 0U;
+    threadTrace->mDroppedCount = 0U;
+    threadTrace->mThreadId = sThreadTraceCount.fetch_add(1U, std::memory_order_relaxed) + 1U;
+
+    PushFront(sThreadTraceHead, threadTrace);
+    tThreadTrace = threadTrace;
+
+    return threadTrace;
+}
+
+// Xbĥ݂ނ̂, sȓǂݏŏ\
+static inline void AddRelaxed(std::atomic<std::uint64_t>& value, std::uint64_t delta)
+{
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+static void DumpAtExit()
+{
+    if (sSummaryAtExit)
+        LatencyTracing::PrintSummary(std::cerr);
+
+    if (!sTraceFileName.empty()) {
+        std::ofstream traceStream(sTraceFileName);
+
+        if (!traceStream || !LatencyTracing::WriteTrace(traceStream))
+            std::cerr << "Failed to write " << sTraceFileName << ".\n";
+    }
+}
+
+static void InstallDump()
+{
+    if (sDumpInstalled)
+        return;
+
+    sDumpInstalled = true;
+    std::atexit(DumpAtExit);
+}
+
+//
+// LatencyHistogramNX
+//
+
+std::size_t LatencyHistogram::BucketIndex(std::uint64_t value)
+{
+    if (value < SubBucketCount)
+        return static_cast<std::size_t>(value);
+
+    // ŏʃrbg̈ʒu2̙p̋Ԃ, ̒SubBucketHalfCount
+    unsigned int mostSignificantBit = 63U;
+
+    while ((value >> mostSignificantBit) == 0U)
+        --mostSignificantBit;
+
+    unsigned int shift = mostSignificantBit - (SubBucketBits - 1U);
+
+    return shift * SubBucketHalfCount + static_cast<std::size_t>(value >> shift);
+}
+
+std::uint64_t LatencyHistogram::BucketLowerBound(std::size_t index)
+{
+    if (index < SubBucketCount)
+        return index;
+
+    std::size_t shift = index / SubBucketHalfCount - 1U;
+    std::uint64_t subBucket = index - shift * SubBucketHalfCount;
+
+    return subBucket << shift;
+}
+
+std::uint64_t LatencyHistogram::BucketUpperBound(std::size_t index)
+{
+    if (index + 1U >= BucketCount)
+        return std::numeric_limits<std::uint64_t>::max();
+
+    return BucketLowerBound(index + 1U) - 1U;
+}
+
+void LatencyHistogram::Clear()
+{
+    this->mBuckets.fill(0U);
+    this->mCount = 0U;
+    this->mSum = 0U;
+    this->mMin = std::numeric_limits<std::uint64_t>::max();
+    this->mMax = 0U;
+}
+
+void LatencyHistogram::Record(std::uint64_t value, std::uint64_t count)
+{
+    this->mBuckets[BucketIndex(value)] += count;
+    this->mCount += count;
+    this->mSum += value * count;
+    this->mMin = std::min(this->mMin, value);
+    this->mMax = std::max(this->mMax, value);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& histogram)
+{
+    for (std::size_t i = 0; i < BucketCount; ++i)
+        this->mBuckets[i] += histogram.mBuckets[i];
+
+    this->mCount += histogram.mCount;
+    this->mSum += histogram.mSum;
+    this->mMin = std::min(this->mMin, histogram.mMin);
+    this->mMax = std::max(this->mMax, histogram.mMax);
+}
+
+std::uint64_t LatencyHistogram::Percentile(double quantile) const
+{
+    if (this->mCount == 0U)
+        return 0U;
+
+    // ݐς̌quantile * mCountɒBԂT
+    std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(quantile * static_cast<double>(this->mCount)));
+    rank = std::max<std::uint64_t>(1U, std::min(rank, this->mCount));
+
+    std::uint64_t cumulativeCount = 0U;
+
+    for (std::size_t i = 0; i < BucketCount; ++i) {
+        cumulativeCount += this->mBuckets[i];
+
+        if (cumulativeCount >= rank)
+            return std::min(std::max(BucketUpperBound(i), this->mMin), this->mMax);
+    }
+
+    return this->mMax;
+}
+
+//
+// LatencyTracingNX
+//
+
+std::uint64_t LatencyTracing::Now()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - sOriginTime).count());
+}
+
+void LatencyTracing::Record(Phase phase, std::uint64_t startTime, std::uint64_t endTime)
+{
+    ThreadHistograms* threadHistograms = CurrentThreadHistograms();
+    std::size_t phaseIndex = static_cast<std::size_t>(phase);
+    std::uint64_t duration = endTime - startTime;
+
+    AddRelaxed(threadHistograms->mBuckets[phaseIndex][LatencyHistogram::BucketIndex(duration)], 1U);
+    AddRelaxed(threadHistograms->mSum[phaseIndex], duration);
+
+    if (duration < threadHistograms->mMin[phaseIndex].load(std::memory_order_relaxed))
+        threadHistograms->mMin[phaseIndex].store(duration, std::memory_order_relaxed);
+    if (duration > threadHistograms->mMax[phaseIndex].load(std::memory_order_relaxed))
+        threadHistograms->mMax[phaseIndex].store(duration, std::memory_order_relaxed);
+
+    // W{ƂđI΂ꂽ͂̏ł΃XpL^
+    if (tSampled)
+        RecordSpan(PhaseName(phase), startTime, endTime);
+}
+
+LatencyHistogram LatencyTracing::Snapshot(Phase phase)
+{
+    LatencyHistogram histogram;
+    std::size_t phaseIndex = static_cast<std::size_t>(phase);
+
+    for (const ThreadHistograms* threadHistograms = sThreadHistogramsHead.load(std::memory_order_acquire);
+         threadHistograms != nullptr; threadHistograms = threadHistograms->mNext) {
+        for (std::size_t i = 0; i < LatencyHistogram::BucketCount; ++i) {
+            std::uint64_t count = threadHistograms->mBuckets[phaseIndex][i].load(std::memory_order_relaxed);
+            histogram.mBuckets[i] += count;
+            histogram.mCount += count;
+        }
+
+        histogram.mSum += threadHistograms->mSum[phaseIndex].load(std::memory_order_relaxed);
+        histogram.mMin = std::min(histogram.mMin, threadHistograms->mMin[phaseIndex].load(std::memory_order_relaxed));
+        histogram.mMax = std::max(histogram.mMax, threadHistograms->mMax[phaseIndex].load(std::memory_order_relaxed));
+    }
+
+    return histogram;
+}
+
+void LatencyTracing::PrintSummary(std::ostream& os)
+{
+    // Pʂ̓imb
+    os << "Latency (ns)    " << std::setw(10) << "Count" << std::setw(10) << "Min"
+       << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+       << std::setw(10) << "p99.9" << std::setw(10) << "Max" << std::setw(12) << "Mean" << '\n';
+
+    for (std::size_t i = 0; i < PhaseCount; ++i) {
+        LatencyHistogram histogram = Snapshot(static_cast<Phase>(i));
+
+        if (histogram.Count() == 0U)
+            continue;
+
+        os << std::left << std::setw(16) << PhaseName(static_cast<Phase>(i)) << std::right
+           << std::setw(10) << histogram.Count() << std::setw(10) << histogram.Min()
+           << std::setw(10) << histogram.Percentile(0.5) << std::setw(10) << histogram.Percentile(0.9)
+           << std::setw(10) << histogram.Percentile(0.99) << std::setw(10) << histogram.Percentile(0.999)
+           << std::setw(10) << histogram.Max()
+           << std::setw(12) << std::fixed << std::setprecision(1) << histogram.Mean() << '\n';
+    }
+}
+
+void LatencyTracing::EnableSummaryAtExit()
+{
+    Enable(true);
+    sSummaryAtExit = true;
+    InstallDump();
+}
+
+void LatencyTracing::EnableTrace(const std::string& fileName, double sampleRate)
+{
+    Enable(true);
+    sTraceFileName = fileName;
+    sSampleRate = std::min(std::max(sampleRate, 0.0), 1.0);
+    sTraceEnabled.store(true, std::memory_order_relaxed);
+    InstallDump();
+}
+
+bool LatencyTracing::WriteTrace(std::ostream& os)
+{
+    // Chromẽg[X` (̒Pʂ̓}CNb)
+    bool firstEvent = true;
+
+    os << "{\"traceEvents\":[";
+
+    for (ThreadTrace* threadTrace = sThreadTraceHead.load(std::memory_order_acquire);
+         threadTrace != nullptr; threadTrace = threadTrace->mNext) {
+        std::lock_guard<std::mutex> lock(threadTrace->mMutex);
+        std::size_t eventCount = threadTrace->mEvents.size();
+
+        if (threadTrace->mDroppedCount != 0U)
+            std::cerr << "Trace of thread " << threadTrace->mThreadId << ": "
+                      << threadTrace->mDroppedCount << " oldest spans were dropped.\n";
+
+        // obt@̌Â珇ɏo
+        for (std::size_t i = 0; i < eventCount; ++i) {
+            const TraceEvent& traceEvent = threadTrace->mEvents[(threadTrace->mNextIndex + i) % eventCount];
+            os << (firstEvent ? "\n" : ",\n")
+               << "{\"name\":\"" << traceEvent.mName << "\",\"cat\":\"phase\",\"ph\":\"X\""
+               << ",\"ts\":" << std::fixed << std::setprecision(3) << static_cast<double>(traceEvent.mStartTime) / 1000.0
+               << ",\"dur\":" << static_cast<double>(traceEvent.mDuration) / 1000.0
+               << ",\"pid\":1,\"tid\":" << threadTrace->mThreadId << '}';
+            firstEvent = false;
+        }
+    }
+
+    os << "\n]}\n";
+
+    return static_cast<bool>(os);
+}
+
+bool LatencyTracing::BeginInput()
+{
+    // ͂̌Ɋ|l̐ƂɕW{Ƃ (g킸ϓɑI)
+    if (!sTraceEnabled.load(std::memory_order_relaxed))
+        return false;
+
+    std::uint64_t inputCount = tInputCount++;
+    tSampled = std::floor(static_cast<double>(inputCount + 1U) * sSampleRate) >
+               std::floor(static_cast<double>(inputCount) * sSampleRate);
+
+    return tSampled;
+}
+
+void LatencyTracing::RecordSpan(const char* name, std::uint64_t startTime, std::uint64_t endTime)
+{
+    ThreadTrace* threadTrace = CurrentThreadTrace();
+    std::lock_guard<std::mutex> lock(threadTrace->mMutex);
+    TraceEvent traceEvent { name, startTime, endTime - startTime };
+
+    if (threadTrace->mEvents.size() < MaxTraceEventsPerThread) {
+        threadTrace->mEvents.push_back(traceEvent);
+        return;
+    }
+
+    threadTrace->mEvents[threadTrace->mNextIndex] = traceEvent;
+    threadTrace->mNextIndex = (threadTrace->mNextIndex + 1U) % MaxTraceEventsPerThread;
+    ++threadTrace->mDroppedCount;
+}
+
+//
+// TracedInputNX
+//
+
+#ifndef LEP_DISABLE_LATENCY_TRACING
+TracedInput::~TracedInput()
+{
+    if (!this->mSampled)
+        return;
+
+    tSampled = false;
+    LatencyTracing::RecordSpan("Input", this->mStartTime, LatencyTracing::Now());
+}
+#endif
@@ -0,0 +1,159 @@
+// LogicalExpressionParser
+// LatencyTracing.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_LATENCY_TRACING_HPP
+#define LOGICAL_EXPRESSION_PARSER_LATENCY_TRACING_HPP
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/*
+iKƂ̒x̃qXgOChromẽg[X`̃Xp
+qXgOHDR HistogramƓl2̙pƂ̋ԂXɓΐ`̋ԂŒl𐔂,
+Ό덷3%ɗ}܂, imb琔Sb܂łŒ̑傫ŋL^
+Xp͎w肵̓͂ɂĂ̂݋L^, XbhƂɒ߂̈݂̂ێ
+LEP_DISABLE_LATENCY_TRACING`, ṽR[h͑SĎ菜
+ */
+
+enum class Phase {
+    Lex,
+    ParseInfix,
+    ParsePrefix,
+    ParsePostfix,
+    Compile,
+    Evaluate,
+    Print,
+    Minimize
+};
+
+constexpr std::size_t PhaseCount = static_cast<std::size_t>(Phase::Minimize) + 1U;
+
+const char* PhaseName(Phase phase);
+
+class LatencyHistogram {
+public:
+    // 2̙pƂ̋Ԃ32 (64̒l͂̂܂ܐ)
+    static constexpr unsigned int SubBucketBits = 6U;
+    static constexpr std::size_t SubBucketCount = static_cast<std::size_t>(1U) << SubBucketBits;
+    static constexpr std::size_t SubBucketHalfCount = SubBucketCount / 2U;
+    static constexpr std::size_t BucketCount = (64U - SubBucketBits + 1U) * SubBucketHalfCount + SubBucketHalfCount;
+
+    LatencyHistogram() { this->Clear(); }
+    ~LatencyHistogram() = default;
+
+    inline std::uint64_t Count() const { return this->mCount; }
+    inline std::uint64_t Min() const { return this->mCount != 0U ? this->mMin : 0U; }
+    inline std::uint64_t Max() const { return this->mMax; }
+    inline double Mean() const {
+        return this->mCount != 0U ? static_cast<double>(this->mSum) / static_cast<double>(this->mCount) : 0.0; }
+    inline std::uint64_t BucketValue(std::size_t index) const { return this->mBuckets[index]; }
+
+    static std::size_t BucketIndex(std::uint64_t value);
+    static std::uint64_t BucketLowerBound(std::size_t index);
+    static std::uint64_t BucketUpperBound(std::size_t index);
+
+    void Clear();
+    void Record(std::uint64_t value, std::uint64_t count = 1U);
+    void Merge(const LatencyHistogram& histogram);
+    // l̏犄quantilëʒuɂl (Ԃ̏ŋߎ)
+    std::uint64_t Percentile(double quantile) const;
+
+private:
+    friend class LatencyTracing;
+
+    std::array<std::uint64_t, BucketCount> mBuckets;
+    std::uint64_t mCount;
+    std::uint64_t mSum;
+    std::uint64_t mMin;
+    std::uint64_t mMax;
+};
+
+class LatencyTracing {
+public:
+    LatencyTracing() = delete;
+
+    static inline bool IsEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+    static inline void Enable(bool enabled) { sEnabled.store(enabled, std::memory_order_relaxed); }
+
+    // v̋N_̌oߎ (imb)
+    static std::uint64_t Now();
+    static void Record(Phase phase, std::uint64_t startTime, std::uint64_t endTime);
+
+    // SẴXbh̃qXgOWv
+    static LatencyHistogram Snapshot(Phase phase);
+    static void PrintSummary(std::ostream& os);
+
+    // ͂̂sampleRateɂăXpL^, IɃt@C֏o
+    static void EnableSummaryAtExit();
+    static void EnableTrace(const std::string& fileName, double sampleRate);
+    static bool WriteTrace(std::ostream& os);
+
+private:
+    friend class TracedInput;
+    friend class ScopedPhaseTimer;
+
+    static bool BeginInput();
+    static void RecordSpan(const char* name, std::uint64_t startTime, std::uint64_t endTime);
+
+    static std::atomic<bool> sEnabled;
+};
+
+#ifndef LEP_DISABLE_LATENCY_TRACING
+
+// ԂiK̒xƂċL^
+class ScopedPhaseTimer final {
+public:
+    ScopedPhaseTimer(Phase phase) :
+        mPhase(phase), mEnabled(LatencyTracing::IsEnabled()),
+        mStartTime(this->mEnabled ? LatencyTracing::Now() : 0U) { }
+    ~ScopedPhaseTimer() {
+        if (this->mEnabled)
+            LatencyTracing::Record(this->mPhase, this->mStartTime, LatencyTracing::Now()); }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+private:
+    Phase           mPhase;
+    bool            mEnabled;
+    std::uint64_t   mStartTime;
+};
+
+// 1̓͂̏Ŝ͂, ̓͂̃XpL^邩ǂ߂
+class TracedInput final {
+public:
+    TracedInput() :
+        mSampled(LatencyTracing::IsEnabled() && LatencyTracing::BeginInput()),
+        mStartTime(this->mSampled ? LatencyTracing::Now() : 0U) { }
+    ~TracedInput();
+
+    TracedInput(const TracedInput&) = delete;
+    TracedInput& operator=(const TracedInput&) = delete;
+
+private:
+    bool            mSampled;
+    std::uint64_t   mStartTime;
+};
+
+#else
+
+class ScopedPhaseTimer final {
+public:
+    ScopedPhaseTimer(Phase) { }
+};
+
+class TracedInput final {
+public:
+    TracedInput() { }
+};
+
+#endif
+
+#endif // LOGICAL_EXPRESSION_PARSER_LATENCY_TRACING_HPP
@@ -0,0 +1,295 @@
+
+// LogicalExpressionParser
+// LoadGenerator.cpp
+
+#include "LoadGenerator.hpp"
+#include "LatencyTracing.hpp"
+
+#include <cstring>
+#include <deque>
+#include <random>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// ׎ŎgK (ϐAH܂)
+static const char* const LoadTestRules[] = {
+    "(A and B) or (C -> D)",
+    "A xor B xor C",
+    "not (A nand B) <-> (C nor D)",
+    "(A or B or C) and (D or E) and not F",
+    "A -> (B -> (C -> (D -> E)))",
+    "(E xnor F) or (G and H)",
+    "((A and B) or (C and D)) and ((E or F) -> (G xor H))",
+    "not not A or (B <-> not C)"
+};
+
+static constexpr std::size_t LoadTestRuleCount = sizeof(LoadTestRules) / sizeof(LoadTestRules[0]);
+
+struct ClientConnection {
+    int                         mFd;
+    std::string                 mInput;
+    std::string                 mOutput;
+    std::size_t                 mOutputOffset;
+    std::deque<std::uint64_t>   mSendTimes;
+    std::size_t                 mSentCount;
+    std::size_t                 mReceivedCount;
+    std::mt19937                mRandom;
+};
+
+static int ConnectSocket(const std::string& socketPath)
+{
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (socketPath.size() >= sizeof(address.sun_path))
+        return -1;
+
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1U);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (fd < 0)
+        return -1;
+
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static bool ExchangeLines(int fd, const std::string& requests, std::size_t lineCount, std::vector<std::string>& responses)
+{
+    // ڑO̓Iȗv (K̓o^) Ɏg
+    for (std::size_t offset = 0; offset < requests.size(); ) {
+        ssize_t writtenSize = ::send(fd, requests.data() + offset, requests.size() - offset, MSG_NOSIGNAL);
+
+        if (writtenSize <= 0)
+            return false;
+
+        offset += static_cast<std::size_t>(writtenSize);
+    }
+
+    std::string input;
+    char buffer[4096];
+
+    while (responses.size() < lineCount) {
+        ssize_t readSize = ::read(fd, buffer, sizeof(buffer));
+
+        if (readSize <= 0)
+            return false;
+
+        input.append(buffer, static_cast<std::size_t>(readSize));
+
+        for (std::size_t lineEnd; (lineEnd = input.find('\n')) != std::string::npos; input.erase(0, lineEnd + 1U))
+            responses.push_back(input.substr(0, lineEnd));
+    }
+
+    return true;
+}
+
+static void AppendRequest(ClientConnection& connection, const std::vector<std::uint32_t>& ruleIndices)
+{
+    static const char* const Notations[] = { "infix", "prefix", "postfix" };
+    std::uint32_t kind = connection.mRandom() % 10U;
+    std::uint32_t rule = connection.mRandom() % LoadTestRuleCount;
+
+    // 1͓o^ς݂̋K̍ēo^, 1͕\, c͕]
+    if (kind == 0U) {
+        connection.mOutput += "PARSE ";
+        connection.mOutput += LoadTestRules[rule];
+    } else if (kind == 1U) {
+        connection.mOutput += "PRINT " + std::to_string(ruleIndices[rule]) + ' ' + Notations[connection.mRandom() % 3U];
+    } else {
+        connection.mOutput += "EVAL " + std::to_string(ruleIndices[rule]);
+        std::uint32_t values = connection.mRandom();
+
+        for (char variable = 'A'; variable <= 'H'; ++variable) {
+            connection.mOutput += ' ';
+            connection.mOutput += variable;
+            connection.mOutput += (values & 1U) ? "=T" : "=F";
+            values >>= 1;
+        }
+    }
+
+    connection.mOutput += '\n';
+}
+
+bool LoadGenerator::Run(std::ostream& report)
+{
+    // Ko^Ĕԍ𓾂
+    int setupFd = ConnectSocket(this->mSocketPath);
+
+    if (setupFd < 0) {
+        report << "Failed to connect to " << this->mSocketPath << ".\n";
+        return false;
+    }
+
+    std::string parseRequests;
+    std::vector<std::string> parseResponses;
+    std::vector<std::uint32_t> ruleIndices;
+
+    for (const char* rule : LoadTestRules)
+        parseRequests += std::string("PARSE ") + rule + '\n';
+
+    bool registered = ExchangeLines(setupFd, parseRequests, LoadTestRuleCount, parseResponses);
+    ::close(setupFd);
+
+    for (const auto& response : parseResponses) {
+        if (response.compare(0, 3, "OK ") != 0) {
+            registered = false;
+            break;
+        }
+
+        ruleIndices.push_back(static_cast<std::uint32_t>(std::stoul(response.substr(3))));
+    }
+
+    if (!registered) {
+        report << "Failed to register rules.\n";
+        return false;
+    }
+
+    std::vector<ClientConnection> connections(this->mConnectionCount);
+    std::vector<pollfd> pollFds(this->mConnectionCount);
+
+    for (std::size_t i = 0; i < connections.size(); ++i) {
+        ClientConnection& connection = connections[i];
+        connection.mFd = ConnectSocket(this->mSocketPath);
+        connection.mOutputOffset = 0U;
+        connection.mSentCount = 0U;
+        connection.mReceivedCount = 0U;
+        connection.mRandom.seed(this->mSeed + static_cast<std::uint32_t>(i));
+
+        if (connection.mFd < 0) {
+            report << "Failed to connect to " << this->mSocketPath << ".\n";
+
+            for (std::size_t j = 0; j < i; ++j)
+                ::close(connections[j].mFd);
+
+            return false;
+        }
+
+        ::fcntl(connection.mFd, F_SETFL, ::fcntl(connection.mFd, F_GETFL) | O_NONBLOCK);
+    }
+
+    LatencyHistogram latencies;
+    std::size_t errorCount = 0U;
+    std::size_t finishedCount = 0U;
+    bool failed = false;
+    std::uint64_t startTime = LatencyTracing::Now();
+    char buffer[65536];
+
+    while (finishedCount < connections.size() && !failed) {
+        for (std::size_t i = 0; i < connections.size(); ++i) {
+            ClientConnection& connection = connections[i];
+
+            // ҂ĂvɒB܂őđ (Ԃ͑M҂̎Ԃ܂)
+            while (connection.mSentCount < this->mRequestCount && connection.mSendTimes.size() < this->mPipelineDepth) {
+                AppendRequest(connection, ruleIndices);
+                connection.mSendTimes.push_back(LatencyTracing::Now());
+                ++connection.mSentCount;
+            }
+
+            while (connection.mOutputOffset < connection.mOutput.size()) {
+                ssize_t writtenSize = ::send(connection.mFd, connection.mOutput.data() + connection.mOutputOffset,
+                    connection.mOutput.size() - connection.mOutputOffset, MSG_NOSIGNAL);
+
+                if (writtenSize <= 0) {
+                    failed = (writtenSize < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+                    break;
+                }
+
+                connection.mOutputOffset += static_cast<std::size_t>(writtenSize);
+            }
+
+            if (connection.mOutputOffset == connection.mOutput.size()) {
+                connection.mOutput.clear();
+                connection.mOutputOffset = 0U;
+            }
+
+            pollFds[i].fd = connection.mFd;
+            pollFds[i].events = static_cast<short>((connection.mReceivedCount < this->mRequestCount ? POLLIN : 0) |
+                                                   (connection.mOutput.empty() ? 0 : POLLOUT));
+            pollFds[i].revents = 0;
+        }
+
+        if (failed || ::poll(pollFds.data(), pollFds.size(), 1000) < 0) {
+            failed = failed || errno != EINTR;
+            continue;
+        }
+
+        for (std::size_t i = 0; i < connections.size(); ++i) {
+            ClientConnection& connection = connections[i];
+
+            if ((pollFds[i].revents & (POLLIN | POLLHUP | POLLERR)) == 0)
+                continue;
+
+            ssize_t readSize = ::read(connection.mFd, buffer, sizeof(buffer));
+
+            if (readSize <= 0) {
+                failed = (readSize == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR));
+                continue;
+            }
+
+            connection.mInput.append(buffer, static_cast<std::size_t>(readSize));
+            std::uint64_t now = LatencyTracing::Now();
+            std::size_t lineBegin = 0U;
+
+            for (std::size_t lineEnd; (lineEnd = connection.mInput.find('\n', lineBegin)) != std::string::npos; lineBegin = lineEnd + 1U) {
+                if (connection.mSendTimes.empty()) {
+                    failed = true;
+                    break;
+                }
+
+                latencies.Record(now - connection.mSendTimes.front());
+                connection.mSendTimes.pop_front();
+
+                if (connection.mInput.compare(lineBegin, 3, "OK ") != 0)
+                    ++errorCount;
+
+                if (++connection.mReceivedCount == this->mRequestCount)
+                    ++finishedCount;
+            }
+
+            connection.mInput.erase(0, lineBegin);
+        }
+    }
+
+    double elapsedSeconds = static_cast<double>(LatencyTracing::Now() - startTime) * 1e-9;
+
+    for (auto& connection : connections)
+        ::close(connection.mFd);
+
+    if (failed) {
+        report << "Connection to " << this->mSocketPath << " failed.\n";
+        return false;
+    }
+
+    report << "Requests:   " << latencies.Count() << " (" << errorCount << " errors) over "
+           << connections.size() << " connections, pipeline depth " << this->mPipelineDepth << '\n';
+    report << "Elapsed:    " << elapsedSeconds << " s (" << static_cast<double>(latencies.Count()) / elapsedSeconds << " requests/s)\n";
+    report << "Latency us: p50 " << latencies.Percentile(0.5) / 1000U << ", p90 " << latencies.Percentile(0.9) / 1000U
+           << ", p99 " << latencies.Percentile(0.99) / 1000U << ", max " << latencies.Max() / 1000U << '\n';
+
+    return errorCount == 0U;
+}
+
+#else
+
+bool LoadGenerator::Run(std::ostream& report)
+{
+    // UnixhC\PbgĝLinux̂
+    report << "The load generator is not supported on this platform.\n";
+    return false;
+}
+
+#endif
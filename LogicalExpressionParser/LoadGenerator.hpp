@@ -0,0 +1,47 @@
+// LogicalExpressionParser
+// LoadGenerator.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_LOAD_GENERATOR_HPP
+#define LOGICAL_EXPRESSION_PARSER_LOAD_GENERATOR_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/*
+]T[o̕׎p̃NCAg
+̐ڑ牞҂ɗv𑗂葱, vƂ̉ԂƃX[vbg\
+vPARSE, PRINT, EVAL, SOKł邱Ƃm߂
+ */
+class LoadGenerator {
+public:
+    LoadGenerator(const std::string& socketPath) :
+        mSocketPath(socketPath),
+        mConnectionCount(4U),
+        mRequestCount(100000U),
+        mPipelineDepth(64U),
+        mSeed(1U) { }
+    ~LoadGenerator() = default;
+
+    inline void SetConnectionCount(std::size_t connectionCount) { this->mConnectionCount = connectionCount; }
+    // ڑƂɑv̐
+    inline void SetRequestCount(std::size_t requestCount) { this->mRequestCount = requestCount; }
+    // ڑƂɉ҂ɑĂ悢v̐
+    inline void SetPipelineDepth(std::size_t pipelineDepth) { this->mPipelineDepth = pipelineDepth; }
+    inline void SetSeed(std::uint32_t seed) { this->mSeed = seed; }
+
+    // SẲ󂯎trueԂ (ڑłȂ, ܂͎s̉false)
+    bool Run(std::ostream& report);
+
+private:
+    std::string mSocketPath;
+    std::size_t mConnectionCount;
+    std::size_t mRequestCount;
+    std::size_t mPipelineDepth;
+    std::uint32_t mSeed;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_LOAD_GENERATOR_HPP
@@ -0,0 +1,276 @@
+
+// LogicalExpressionParser
+// LogicalExpressionEngine.cpp
+
+#include "LogicalExpressionEngine.h"
+#include "AST.hpp"
+#include "Compiler.hpp"
+#include "Diagnostics.hpp"
+#include "Parser.hpp"
+#include "ResourceGovernor.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <sstream>
+
+// OAPI̊OɏoȂ (N肤̂̓̊mۂ̎ŝ)
+
+struct CompiledExpression {
+    std::shared_ptr<BaseAST>    mAST;
+    std::shared_ptr<Program>    mProgram;
+};
+
+struct LEPEngine {
+    LEPEngine() :
+        mSymbolTable(std::make_shared<SymbolTable>()),
+        mCompiler(mSymbolTable),
+        mMaxInstructionCount(0U),
+        mLastNotation(LEP_ERROR_INVALID_ARGUMENT) { }
+
+    ParserSession mParserSession;
+    Diagnostics mDiagnostics;
+    std::shared_ptr<SymbolTable> mSymbolTable;
+    Compiler mCompiler;
+    std::vector<CompiledExpression> mExpressions;
+    std::optional<ResourceLimits> mResourceLimits;
+    ResourceGovernor mGovernor;
+    // ]̍Ɨ̈ɕKvȃoCg (_̖ߐ̍ő)
+    std::size_t mMaxInstructionCount;
+    std::int32_t mLastNotation;
+};
+
+static bool IsValidExpressionId(const LEPEngine* engine, std::int32_t expressionId)
+{
+    return expressionId >= 0 && static_cast<std::size_t>(expressionId) < engine->mExpressions.size();
+}
+
+static std::int32_t CopyString(const std::string& text, char* buffer, std::size_t bufferSize, std::size_t* length)
+{
+    if (length != nullptr)
+        *length = text.size();
+
+    if (buffer == nullptr || bufferSize <= text.size())
+        return LEP_ERROR_BUFFER_TOO_SMALL;
+
+    std::memcpy(buffer, text.data(), text.size());
+    buffer[text.size()] = '\0';
+
+    return LEP_OK;
+}
+
+LEPEngine* LEPCreateEngine(void)
+{
+    return new (std::nothrow) LEPEngine();
+}
+
+void LEPDestroyEngine(LEPEngine* engine)
+{
+    delete engine;
+}
+
+std::int32_t LEPSetResourceLimits(LEPEngine* engine, const char* limitsText)
+{
+    if (engine == nullptr)
+        return LEP_ERROR_INVALID_ARGUMENT;
+
+    if (limitsText == nullptr) {
+        engine->mResourceLimits.reset();
+        engine->mParserSession.SetGovernor(nullptr);
+        return LEP_OK;
+    }
+
+    std::optional<ResourceLimits> resourceLimits = ParseResourceLimits(limitsText);
+
+    if (!resourceLimits.has_value())
+        return LEP_ERROR_INVALID_ARGUMENT;
+
+    engine->mResourceLimits = resourceLimits;
+    engine->mGovernor = ResourceGovernor(resourceLimits.value());
+    engine->mParserSession.SetGovernor(&engine->mGovernor);
+
+    return LEP_OK;
+}
+
+std::int32_t LEPInternVariable(LEPEngine* engine, const char* name, std::size_t nameLength)
+{
+    if (engine == nullptr || name == nullptr)
+        return LEP_ERROR_INVALID_ARGUMENT;
+
+    try {
+        return static_cast<std::int32_t>(engine->mSymbolTable->Intern(std::string(name, nameLength)));
+    } catch (const std::bad_alloc&) {
+        return LEP_ERROR_OUT_OF_MEMORY;
+    }
+}
+
+std::int32_t LEPFindVariable(const LEPEngine* engine, const char* name, std::size_t nameLength)
+{
+    if (engine == nullptr || name == nullptr)
+        return LEP_ERROR_INVALID_ARGUMENT;
+
+    try {
+        std::optional<std::uint32_t> index = engine->mSymbolTable->Find(std::string(name, nameLength));
+        return index.has_value() ? static_cast<std::int32_t>(index.value()) : LEP_ERROR_INVALID_ARGUMENT;
+    } catch (const std::bad_alloc&) {
+        return LEP_ERROR_OUT_OF_MEMORY;
+    }
+}
+
+std::size_t LEPVariableCount(const LEPEngine* engine)
+{
+    return (engine != nullptr) ? engine->mSymbolTable->Size() : 0U;
+}
+
+std::size_t LEPCompileExpressions(LEPEngine* engine, const char* const* texts, const std::size_t* textLengths,
+                                  std::size_t count, std::uint32_t flags, std::int32_t* results)
+{
+    if (engine == nullptr || texts == nullptr || textLengths == nullptr || results == nullptr)
+        return 0U;
+
+    static_cast<void>(flags);
+
+    std::size_t compiledCount = 0;
+    Diagnostics diagnostics;
+
+    engine->mDiagnostics.Clear();
+    engine->mLastNotation = LEP_ERROR_INVALID_ARGUMENT;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (texts[i] == nullptr) {
+            results[i] = LEP_ERROR_INVALID_ARGUMENT;
+            continue;
+        }
+
+        try {
+            // ͂̃g[Nƍ\͊͘_ƂɎg
+            diagnostics.Clear();
+            engine->mGovernor.Reset();
+
+            if (!engine->mParserSession.Lex(std::string(texts[i], textLengths[i]), &diagnostics)) {
+                engine->mDiagnostics = diagnostics;
+                results[i] = LEP_ERROR_LEXICAL;
+                continue;
+            }
+
+            Notation lastNotation = Notation::Infix;
+            std::shared_ptr<BaseAST> exprAST = engine->mParserSession.Parse(&lastNotation, diagnostics);
+            engine->mLastNotation = static_cast<std::int32_t>(lastNotation);
+
+            if (exprAST == nullptr) {
+                engine->mDiagnostics = diagnostics;
+                results[i] = LEP_ERROR_SYNTAX;
+                continue;
+            }
+
+            std::shared_ptr<Program> program = engine->mCompiler.Compile(exprAST);
+
+            if (program == nullptr) {
+                engine->mDiagnostics.Clear();
+                results[i] = LEP_ERROR_COMPILE;
+                continue;
+            }
+
+            engine->mExpressions.push_back(CompiledExpression { exprAST, program });
+            engine->mMaxInstructionCount = std::max(engine->mMaxInstructionCount, program->Instructions().size());
+            results[i] = static_cast<std::int32_t>(engine->mExpressions.size() - 1U);
+            ++compiledCount;
+        } catch (const std::bad_alloc&) {
+            results[i] = LEP_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    return compiledCount;
+}
+
+std::size_t LEPExpressionCount(const LEPEngine* engine)
+{
+    return (engine != nullptr) ? engine->mExpressions.size() : 0U;
+}
+
+void LEPClearExpressions(LEPEngine* engine)
+{
+    if (engine != nullptr) {
+        engine->mExpressions.clear();
+        engine->mMaxInstructionCount = 0U;
+    }
+}
+
+std::int32_t LEPEvaluate(const LEPEngine* engine, const std::int32_t* expressionIds, std::size_t expressionCount,
+                         const std::uint64_t* assignment, std::size_t assignmentWords, std::uint8_t* results)
+{
+    return LEPEvaluateBatch(engine, expressionIds, expressionCount, assignment, assignmentWords, 1U, results);
+}
+
+std::int32_t LEPEvaluateBatch(const LEPEngine* engine, const std::int32_t* expressionIds, std::size_t expressionCount,
+                              const std::uint64_t* assignments, std::size_t assignmentWords, std::size_t assignmentCount,
+                              std::uint8_t* results)
+{
+    if (engine == nullptr || expressionIds == nullptr || assignments == nullptr || results == nullptr)
+        return LEP_ERROR_INVALID_ARGUMENT;
+
+    if (assignmentWords < (engine->mSymbolTable->Size() + 63U) / 64U)
+        return LEP_ERROR_BUFFER_TOO_SMALL;
+
+    for (std::size_t i = 0; i < expressionCount; ++i)
+        if (!IsValidExpressionId(engine, expressionIds[i]))
+            return LEP_ERROR_INVALID_ARGUMENT;
+
+    // ]̂тɊmۂȂ悤, Ɨ̈̓XbhI܂ŕێ
+    // (_̖ߐ̍ő傪Ƃ̂݊mۂ)
+    static thread_local std::vector<std::uint8_t> tScratch;
+
+    try {
+        if (tScratch.size() < engine->mMaxInstructionCount)
+            tScratch.resize(engine->mMaxInstructionCount);
+    } catch (const std::bad_alloc&) {
+        return LEP_ERROR_OUT_OF_MEMORY;
+    }
+
+    // _ƂɑSĂ̊蓖Ă] (ߗLbVɒu܂܎g)
+    for (std::size_t i = 0; i < expressionCount; ++i) {
+        ProgramView programView = engine->mExpressions[expressionIds[i]].mProgram->View();
+
+        for (std::size_t j = 0; j < assignmentCount; ++j)
+            results[j * expressionCount + i] =
+                programView.Evaluate(assignments + j * assignmentWords, tScratch.data()) ? 1U : 0U;
+    }
+
+    return LEP_OK;
+}
+
+std::int32_t LEPFormatExpression(const LEPEngine* engine, std::int32_t expressionId, std::int32_t notation,
+                                 char* buffer, std::size_t bufferSize, std::size_t* length)
+{
+    if (engine == nullptr || !IsValidExpressionId(engine, expressionId) ||
+        notation < LEP_NOTATION_INFIX || notation > LEP_NOTATION_POSTFIX)
+        return LEP_ERROR_INVALID_ARGUMENT;
+
+    try {
+        // nh瓯ɌĂ΂Ă悢悤, nh̏Ԃ͓ǂނ݂̂Ƃ
+        std::ostringstream outputStream;
+        ASTPrinter().Print(engine->mExpressions[expressionId].mAST, static_cast<Notation>(notation), outputStream);
+        return CopyString(outputStream.str(), buffer, bufferSize, length);
+    } catch (const std::bad_alloc&) {
+        return LEP_ERROR_OUT_OF_MEMORY;
+    }
+}
+
+std::int32_t LEPFormatDiagnostic(const LEPEngine* engine, char* buffer, std::size_t bufferSize, std::size_t* length)
+{
+    if (engine == nullptr)
+        return LEP_ERROR_INVALID_ARGUMENT;
+
+    try {
+        std::ostringstream outputStream;
+        engine->mDiagnostics.Print(outputStream);
+        return CopyString(outputStream.str(), buffer, bufferSize, length);
+    } catch (const std::bad_alloc&) {
+        return LEP_ERROR_OUT_OF_MEMORY;
+    }
+}
+
+std::int32_t LEPLastNotation(const LEPEngine* engine)
+{
+    return (engine != nullptr) ? engine->mLastNotation : LEP_ERROR_INVALID_ARGUMENT;
+}
@@ -0,0 +1,112 @@
+// LogicalExpressionParser
+// LogicalExpressionEngine.h
+
+#ifndef LOGICAL_EXPRESSION_PARSER_LOGICAL_EXPRESSION_ENGINE_H
+#define LOGICAL_EXPRESSION_PARSER_LOGICAL_EXPRESSION_ENGINE_H
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+_̍\, RpC, ]vZXōs߂CAPI
+1̌Ăяoŕ̘_, ʂ͌Ăяomۂzɏ
+] (LEPEvaluate, LEPEvaluateBatch) ̓XbhƂ̍Ɨ̈g, _̖ߐ̍ő傪
+Ƃ̂݃q[vmۂ (mۂɎsꍇLEP_ERROR_OUT_OF_MEMORY)
+GWɑ΂_̒ǉƍ폜, ϐ̒ǉ (LEPInternVariable), ̏̐ݒ͓1̃Xbĥ݌Ăяo
+ȊO̊֐, ƓłȂΕ̃XbhĂяoĂ悢
+ */
+
+/* LCuƂărhꍇLEP_SHARED, ̋LCû̃rhłLEP_BUILD` */
+#if defined(LEP_SHARED) && defined(_WIN32)
+#if defined(LEP_BUILD)
+#define LEP_API __declspec(dllexport)
+#else
+#define LEP_API __declspec(dllimport)
+#endif
+#elif defined(LEP_SHARED) && defined(__GNUC__)
+#define LEP_API __attribute__((visibility("default")))
+#else
+#define LEP_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct LEPEngine LEPEngine;
+
+/* ʂ̃R[h (_ƕϐ̔ԍ0ȏ, s͕̒l) */
+#define LEP_OK                          0
+#define LEP_ERROR_INVALID_ARGUMENT      (-1)
+#define LEP_ERROR_LEXICAL               (-2)
+#define LEP_ERROR_SYNTAX                (-3)
+#define LEP_ERROR_COMPILE               (-4)
+#define LEP_ERROR_BUFFER_TOO_SMALL      (-5)
+#define LEP_ERROR_OUT_OF_MEMORY         (-6)
+
+/* \L */
+#define LEP_NOTATION_INFIX              0
+#define LEP_NOTATION_PREFIX             1
+#define LEP_NOTATION_POSTFIX            2
+
+/* sꍇNULL */
+LEP_API LEPEngine* LEPCreateEngine(void);
+LEP_API void LEPDestroyEngine(LEPEngine* engine);
+
+/* ȍ~̘_Ƃ̎͂ƍ\͂̏ ("tokens=100000,depth=256" ̌`, NULL͐Ȃ) */
+LEP_API int32_t LEPSetResourceLimits(LEPEngine* engine, const char* limitsText);
+
+/*
+ϐ̔ԍ (]̊蓖Ăł, ϐn̒lassignment[n / 64]̉n % 64rbg)
+LEPInternVariable͖ϐǉ, LEPFindVariable͖ϐLEP_ERROR_INVALID_ARGUMENTԂ
+ */
+LEP_API int32_t LEPInternVariable(LEPEngine* engine, const char* name, size_t nameLength);
+LEP_API int32_t LEPFindVariable(const LEPEngine* engine, const char* name, size_t nameLength);
+LEP_API size_t LEPVariableCount(const LEPEngine* engine);
+
+/*
+count̘_ (texts[i]textLengths[i]oCg) \͂ăRpC,
+results[i]ɘ_̔ԍ܂̓G[̃R[h (߂l͐_̐)
+_Ɍϐ, ꂽɔԍt (flags͗\, 0n)
+ */
+LEP_API size_t LEPCompileExpressions(LEPEngine* engine, const char* const* texts, const size_t* textLengths,
+                                     size_t count, uint32_t flags, int32_t* results);
+LEP_API size_t LEPExpressionCount(const LEPEngine* engine);
+/* SĂ̘_폜 (ϐ̔ԍ͕ςȂ) */
+LEP_API void LEPClearExpressions(LEPEngine* engine);
+
+/*
+expressionIds[i]̘_], results[i]0܂1
+assignmentWords͊蓖Ă̌ꐔ, SĂ̕ϐ܂ޕKv (ȂLEP_ERROR_BUFFER_TOO_SMALL)
+ */
+LEP_API int32_t LEPEvaluate(const LEPEngine* engine, const int32_t* expressionIds, size_t expressionCount,
+                            const uint64_t* assignment, size_t assignmentWords, uint8_t* results);
+/* assignmentCount̊蓖 (assignmentWordsꂸׂ) ɂĕ], results[j * expressionCount + i]ɏ */
+LEP_API int32_t LEPEvaluateBatch(const LEPEngine* engine, const int32_t* expressionIds, size_t expressionCount,
+                                 const uint64_t* assignments, size_t assignmentWords, size_t assignmentCount,
+                                 uint8_t* results);
+
+/*
+͏I[NULtď, I[*lengthɕԂ
+obt@ȂꍇLEP_ERROR_BUFFER_TOO_SMALLԂ (*length͕KvȒ)
+LEPFormatExpressionASTPrinter::PrintƓ1s (oƉs܂) 
+ */
+LEP_API int32_t LEPFormatExpression(const LEPEngine* engine, int32_t expressionId, int32_t notation,
+                                    char* buffer, size_t bufferSize, size_t* length);
+/* OLEPCompileExpressionsōŌɎs_̐ff (Diagnostics::PrintƓ1s) */
+LEP_API int32_t LEPFormatDiagnostic(const LEPEngine* engine, char* buffer, size_t bufferSize, size_t* length);
+
+/*
+OLEPCompileExpressionsōŌɍ\͂_ɂ, ŌɎ\L (LEP_NOTATION_*) Ԃ
+\L͒uL@, OuL@, uL@̏Ɏ, ꍇ͂̕\LԂ
+\͂_ꍇLEP_ERROR_INVALID_ARGUMENT
+ */
+LEP_API int32_t LEPLastNotation(const LEPEngine* engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOGICAL_EXPRESSION_PARSER_LOGICAL_EXPRESSION_ENGINE_H */
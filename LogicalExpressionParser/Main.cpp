@@ -2,17 +2,1757 @@
 // LogicalExpressionParser
 // Main.cpp
 
+#include <algorithm>
+#include <atomic>
+#include <csignal>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
 
+#include "AndInverterGraph.hpp"
 #include "AST.hpp"
+#include "Canonicalizer.hpp"
+#include "Compiler.hpp"
+#include "EvaluationServer.hpp"
+#include "Evaluator.hpp"
+#include "ForkJoinPool.hpp"
+#include "IncrementalEvaluator.hpp"
+#include "LatencyTracing.hpp"
+#include "LoadGenerator.hpp"
+#include "LogicalExpressionEngine.h"
+#include "Minimizer.hpp"
+#include "ModelCounter.hpp"
+#include "ParallelParser.hpp"
+#include "ParallelTraversal.hpp"
+#include "PartialEvaluator.hpp"
+#include "PerformanceCounters.hpp"
+#include "ProbabilityEvaluator.hpp"
+#include "ResourceGovernor.hpp"
+#include "RuleBatch.hpp"
+#include "RuleSnapshot.hpp"
+#include "TruthTable.hpp"
+#include "RuleSet.hpp"
 #include "Token.hpp"
 #include "Parser.hpp"
 
-int main(int argc, char** argv)
+static EvaluationServer* sEvaluationServer = nullptr;
+// 1s (1̗v) ƂɎg鎑̏ (--limitsw肵Ȃꍇ͐Ȃ)
+static std::optional<ResourceLimits> sResourceLimits;
+static const char* sResourceLimitsText = nullptr;
+
+static void StopEvaluationServer(int)
+{
+    if (sEvaluationServer != nullptr)
+        sEvaluationServer->Stop();
+}
+
+static int Serve(const std::string& socketPath, const char* rulesFileName, unsigned int workerCount)
+{
+    // Kێ܂, SIGINT܂SIGTERM󂯎܂ŗv
+    EvaluationServer evaluationServer(workerCount);
+
+    if (sResourceLimits.has_value())
+        evaluationServer.SetResourceLimits(sResourceLimits.value());
+
+    if (rulesFileName != nullptr) {
+        // K̃t@Cns (s) ̋Kɂ, n - 1̋KԍU
+        std::ifstream inputStream(rulesFileName);
+        std::string logicalExpr;
+        std::size_t lineNumber = 0;
+
+        if (!inputStream) {
+            std::cout << "Failed to open " << rulesFileName << ".\n";
+            return EXIT_FAILURE;
+        }
+
+        while (std::getline(inputStream, logicalExpr)) {
+            ++lineNumber;
+
+            if (logicalExpr.empty())
+                continue;
+
+            Diagnostics diagnostics;
+
+            if (!evaluationServer.AddRule(logicalExpr, &diagnostics).has_value()) {
+                std::cout << "Failed to parse line " << lineNumber << ": ";
+                diagnostics.Print(std::cout);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    sEvaluationServer = &evaluationServer;
+    std::signal(SIGINT, StopEvaluationServer);
+    std::signal(SIGTERM, StopEvaluationServer);
+
+    std::cout << "Serving " << evaluationServer.RuleCount() << " rules on " << socketPath << std::endl;
+    bool succeeded = evaluationServer.Run(socketPath);
+
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    sEvaluationServer = nullptr;
+
+    if (!succeeded) {
+        std::cout << "Failed to listen on " << socketPath << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int CompileRules(const std::string& inputFileName, const std::string& outputFileName)
+{
+    // 1s1̋Kꂽt@Cǂݍ, RpCăoCi`ŏo
+    std::ifstream inputStream(inputFileName);
+
+    if (!inputStream) {
+        std::cout << "Failed to open " << inputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    std::shared_ptr<SymbolTable> symbolTable = std::make_shared<SymbolTable>();
+    Compiler compiler(symbolTable);
+    RuleSetWriter ruleSetWriter;
+    ParserSession parserSession;
+    Diagnostics diagnostics;
+    std::string logicalExpr;
+    std::size_t lineNumber = 0;
+
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    parserSession.SetGovernor(sResourceLimits.has_value() ? &governor : nullptr);
+
+    while (std::getline(inputStream, logicalExpr)) {
+        ++lineNumber;
+        PerformanceCounters::DumpIfRequested(std::cerr);
+
+        if (logicalExpr.empty())
+            continue;
+
+        TracedInput tracedInput;
+        diagnostics.Clear();
+        governor.Reset();
+
+        std::shared_ptr<BaseAST> exprAST = parserSession.Parse(logicalExpr, nullptr, diagnostics);
+        std::shared_ptr<Program> program = (exprAST != nullptr) ? compiler.Compile(exprAST) : nullptr;
+
+        if (program == nullptr) {
+            std::cout << "Failed to compile line " << lineNumber << ": ";
+            diagnostics.Print(std::cout);
+            return EXIT_FAILURE;
+        }
+
+        ruleSetWriter.AddRule(program);
+    }
+
+    if (!ruleSetWriter.Write(outputFileName, *symbolTable)) {
+        std::cout << "Failed to write " << outputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << ruleSetWriter.RuleCount() << " rules, " << symbolTable->Size() << " variables written.\n";
+
+    return EXIT_SUCCESS;
+}
+
+static int LoadRules(const std::string& fileName)
+{
+    // }bvKŴ܂܎g
+    MappedRuleSet ruleSet;
+
+    if (!ruleSet.Open(fileName)) {
+        std::cout << "Failed to load " << fileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    std::shared_ptr<ASTPrinter> astPrinter = std::make_shared<ASTPrinter>();
+    auto variableName = [&ruleSet](std::uint32_t index) { return std::string(ruleSet.SymbolName(index)); };
+
+    for (std::size_t i = 0; i < ruleSet.RuleCount(); ++i)
+        astPrinter->Print(ruleSet.Rule(i).ToAST(variableName), Notation::Infix);
+
+    return EXIT_SUCCESS;
+}
+
+static int EvaluateRuleBatch(const std::string& fileName, const std::string& assignmentText, std::size_t repeatCount)
+{
+    // KW̑SĂ̋K1̊蓖Ăɑ΂Ă܂Ƃ߂ĕ], ^ɂȂK̐\
+    // ("O=T" ܂ "O=F" 󔒂ŋ؂ĕ, w肵Ȃϐ͋UƂ)
+    MappedRuleSet ruleSet;
+
+    if (!ruleSet.Open(fileName)) {
+        std::cout << "Failed to load " << fileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    RuleBatch ruleBatch;
+
+    for (std::size_t i = 0; i < ruleSet.RuleCount(); ++i)
+        ruleBatch.AddRule(ruleSet.Rule(i));
+
+    std::vector<std::uint64_t> assignment(std::max(ruleBatch.AssignmentWordCount(), ruleSet.SymbolCount() / 64U + 1U), 0U);
+    std::istringstream assignmentStream(assignmentText);
+    std::string variableValue;
+
+    while (assignmentStream >> variableValue) {
+        std::size_t separator = variableValue.find('=');
+        std::optional<std::uint32_t> variable = (separator != std::string::npos) ?
+            ruleSet.FindSymbol(std::string_view(variableValue).substr(0, separator)) : std::nullopt;
+
+        if (!variable.has_value() || separator + 2U != variableValue.size()) {
+            std::cout << "Invalid assignment: " << variableValue << '\n';
+            return EXIT_FAILURE;
+        }
+
+        if (variableValue[separator + 1U] == 'T')
+            assignment[variable.value() >> 6] |= static_cast<std::uint64_t>(1U) << (variable.value() & 63U);
+    }
+
+    std::vector<std::uint64_t> result(ruleBatch.ResultWordCount());
+    std::vector<std::uint64_t> scratch(ruleBatch.ScratchWordCount());
+    std::uint64_t startTime = LatencyTracing::Now();
+
+    for (std::size_t i = 0; i < std::max<std::size_t>(repeatCount, 1U); ++i)
+        ruleBatch.Evaluate(assignment.data(), result.data(), scratch.data());
+
+    double elapsedMicroseconds = static_cast<double>(LatencyTracing::Now() - startTime) * 1e-3 /
+        static_cast<double>(std::max<std::size_t>(repeatCount, 1U));
+    std::size_t trueCount = 0U;
+
+    for (std::uint64_t word : result)
+        for (; word != 0U; word &= word - 1U)
+            ++trueCount;
+
+    std::cout << trueCount << " of " << ruleBatch.RuleCount() << " rules are true (" << ruleBatch.ShapeCount() << " shapes, "
+              << SimdLevelName(ruleBatch.Level()) << ", " << elapsedMicroseconds << " us per evaluation)\n";
+
+    return EXIT_SUCCESS;
+}
+
+static int WatchRules(const std::string& fileName)
+{
+    // ϐ̒l̕ω ("O=T" ܂ "O=F" 󔒂ŋ؂ĕׂs) W͂ǂ,
+    // l̕ςK\ (ϐ̏l͑SċU)
+    MappedRuleSet ruleSet;
+
+    if (!ruleSet.Open(fileName)) {
+        std::cout << "Failed to load " << fileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<IncrementalEvaluator> evaluators;
+    std::vector<bool> ruleValues;
+    std::vector<std::vector<std::uint32_t>> variableRules(ruleSet.SymbolCount());
+
+    for (std::size_t i = 0; i < ruleSet.RuleCount(); ++i) {
+        evaluators.emplace_back(ruleSet.Rule(i));
+        ruleValues.push_back(evaluators.back().Value());
+
+        for (std::uint32_t variable : evaluators.back().Variables())
+            variableRules[variable].push_back(static_cast<std::uint32_t>(i));
+    }
+
+    std::string line;
+    std::vector<std::pair<std::uint32_t, bool>> updates;
+    std::vector<std::uint32_t> affectedRules;
+
+    while (std::getline(std::cin, line)) {
+        updates.clear();
+        affectedRules.clear();
+
+        std::istringstream lineStream(line);
+        std::string update;
+
+        while (lineStream >> update) {
+            std::size_t separator = update.find('=');
+            std::optional<std::uint32_t> variable = (separator != std::string::npos) ?
+                ruleSet.FindSymbol(std::string_view(update).substr(0, separator)) : std::nullopt;
+
+            if (!variable.has_value() || separator + 2U != update.size() ||
+                (update[separator + 1U] != 'T' && update[separator + 1U] != 'F')) {
+                std::cout << "Ignored " << update << '\n';
+                continue;
+            }
+
+            updates.emplace_back(variable.value(), update[separator + 1U] == 'T');
+            affectedRules.insert(affectedRules.end(),
+                variableRules[variable.value()].begin(), variableRules[variable.value()].end());
+        }
+
+        // ωϐ܂ދK݂̂]
+        std::sort(affectedRules.begin(), affectedRules.end());
+        affectedRules.erase(std::unique(affectedRules.begin(), affectedRules.end()), affectedRules.end());
+
+        for (std::uint32_t ruleIndex : affectedRules) {
+            bool value = evaluators[ruleIndex].SetVariables(updates);
+
+            if (value != ruleValues[ruleIndex]) {
+                ruleValues[ruleIndex] = value;
+                std::cout << "Rule " << ruleIndex << ": " << (value ? "true" : "false") << '\n';
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int MinimizeRules(const std::string& inputFileName)
+{
+    // 1s1̋Kꂽt@Cǂݍ, KƂɍŏϘa`\
+    std::ifstream inputStream(inputFileName);
+
+    if (!inputStream) {
+        std::cout << "Failed to open " << inputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    std::shared_ptr<ASTPrinter> astPrinter = std::make_shared<ASTPrinter>();
+    Minimizer minimizer;
+    ParserSession parserSession;
+    Diagnostics diagnostics;
+    std::string logicalExpr;
+    std::size_t lineNumber = 0;
+
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    ResourceGovernor* requestGovernor = sResourceLimits.has_value() ? &governor : nullptr;
+    parserSession.SetGovernor(requestGovernor);
+    minimizer.SetGovernor(requestGovernor);
+
+    while (std::getline(inputStream, logicalExpr)) {
+        ++lineNumber;
+
+        if (logicalExpr.empty())
+            continue;
+
+        diagnostics.Clear();
+        governor.Reset();
+
+        std::shared_ptr<BaseAST> exprAST = parserSession.Parse(logicalExpr, nullptr, diagnostics);
+
+        if (exprAST == nullptr) {
+            std::cout << "Failed to parse line " << lineNumber << ": ";
+            diagnostics.Print(std::cout);
+            continue;
+        }
+
+        std::shared_ptr<BaseAST> minimizedAST = minimizer.Minimize(exprAST);
+
+        if (minimizedAST == nullptr) {
+            if (governor.IsExhausted())
+                std::cout << "Line " << lineNumber << ": " << DiagnosticCodeName(ResourceDiagnosticCode(governor.Exhausted())) << '\n';
+            else
+                std::cout << "Line " << lineNumber << ": too many variables or product terms\n";
+            continue;
+        }
+
+        std::cout << "Line " << lineNumber << ": " << minimizer.CubeCount() << " product terms, "
+                  << minimizer.LiteralCount() << " literals\n";
+        astPrinter->Print(minimizedAST, Notation::Infix);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int CountModels(const std::string& inputFileName, long timeoutMilliseconds)
+{
+    // 1s1̋Kꂽt@Cǂݍ, KƂɏ[銄蓖Ă̌𐔂
+    std::ifstream inputStream(inputFileName);
+
+    if (!inputStream) {
+        std::cout << "Failed to open " << inputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    ModelCounter modelCounter;
+    ParserSession parserSession;
+    Diagnostics diagnostics;
+    std::string logicalExpr;
+    std::size_t lineNumber = 0;
+
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    ResourceGovernor* requestGovernor = sResourceLimits.has_value() ? &governor : nullptr;
+    parserSession.SetGovernor(requestGovernor);
+    modelCounter.SetGovernor(requestGovernor);
+
+    modelCounter.SetTimeout(std::chrono::milliseconds(timeoutMilliseconds));
+    modelCounter.SetProgressCallback([](const ModelCounterProgress& progress) {
+        std::cerr << "  " << progress.mDecisions << " decisions, " << progress.mCacheHits << " cache hits, "
+                  << progress.mCacheEntries << " cache entries, " << progress.mElapsedSeconds << " s\n"; }, 1U << 20);
+
+    while (std::getline(inputStream, logicalExpr)) {
+        ++lineNumber;
+
+        if (logicalExpr.empty())
+            continue;
+
+        diagnostics.Clear();
+        governor.Reset();
+
+        std::shared_ptr<BaseAST> exprAST = parserSession.Parse(logicalExpr, nullptr, diagnostics);
+
+        if (exprAST == nullptr) {
+            std::cout << "Failed to parse line " << lineNumber << ": ";
+            diagnostics.Print(std::cout);
+            continue;
+        }
+
+        std::optional<BigInteger> modelCount = modelCounter.Count(exprAST);
+
+        if (!modelCount.has_value()) {
+            std::cout << "Line " << lineNumber << (governor.IsExhausted() ? ": step limit exceeded after " : ": timed out after ")
+                      << modelCounter.Decisions() << " decisions\n";
+            continue;
+        }
+
+        // I ([銄蓖Ă̊)
+        std::size_t variableCount = modelCounter.Variables().size();
+        std::cout << "Line " << lineNumber << ": " << modelCount.value() << " of 2^" << variableCount
+                  << " assignments (selectivity " << modelCount.value().ToScaledDouble(variableCount) << ")\n";
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int CheckTautologies(const std::string& inputFileName)
+{
+    // 1s1̋Kꂽt@Cǂݍ, KƂɍP^PU𔻒肷
+    std::ifstream inputStream(inputFileName);
+
+    if (!inputStream) {
+        std::cout << "Failed to open " << inputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    ParserSession parserSession;
+    Diagnostics diagnostics;
+    std::string logicalExpr;
+    std::size_t lineNumber = 0;
+
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    ResourceGovernor* requestGovernor = sResourceLimits.has_value() ? &governor : nullptr;
+    parserSession.SetGovernor(requestGovernor);
+
+    while (std::getline(inputStream, logicalExpr)) {
+        ++lineNumber;
+
+        if (logicalExpr.empty())
+            continue;
+
+        diagnostics.Clear();
+        governor.Reset();
+
+        std::shared_ptr<BaseAST> exprAST = parserSession.Parse(logicalExpr, nullptr, diagnostics);
+
+        if (exprAST == nullptr) {
+            std::cout << "Failed to parse line " << lineNumber << ": ";
+            diagnostics.Print(std::cout);
+            continue;
+        }
+
+        TruthTableEngine truthTableEngine(exprAST);
+        truthTableEngine.SetGovernor(requestGovernor);
+
+        if (!truthTableEngine.IsValid()) {
+            std::cout << "Line " << lineNumber << ": too many variables ("
+                      << truthTableEngine.Variables().size() << ")\n";
+            continue;
+        }
+
+        std::optional<VariableAssignment> counterexample;
+        std::optional<TruthTableVerdict> verdict = truthTableEngine.Classify(&counterexample);
+
+        if (!verdict.has_value()) {
+            std::cout << "Line " << lineNumber << ": " << DiagnosticCodeName(ResourceDiagnosticCode(governor.Exhausted())) << '\n';
+            continue;
+        }
+
+        switch (verdict.value()) {
+            case TruthTableVerdict::Tautology:
+                std::cout << "Line " << lineNumber << ": tautology\n";
+                break;
+            case TruthTableVerdict::Contradiction:
+                std::cout << "Line " << lineNumber << ": contradiction\n";
+                break;
+            case TruthTableVerdict::Contingent:
+                // UɂȂ銄蓖Ă𔽗Ƃĕ\
+                std::cout << "Line " << lineNumber << ": contingent, counterexample:";
+
+                for (const auto& variableName : truthTableEngine.Variables())
+                    std::cout << ' ' << variableName << '=' << (counterexample.value().at(variableName) ? 'T' : 'F');
+
+                std::cout << '\n';
+                break;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int WriteTruthTable(std::string logicalExpr, const std::string& outputFileName)
+{
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    ResourceGovernor* requestGovernor = sResourceLimits.has_value() ? &governor : nullptr;
+    Diagnostics diagnostics;
+    std::shared_ptr<TokenStream> tokenStream = Lexer(logicalExpr, &diagnostics, requestGovernor);
+    std::shared_ptr<BaseAST> exprAST = (tokenStream != nullptr) ?
+        ParseLogicalExpression(tokenStream, nullptr, diagnostics, requestGovernor) : nullptr;
+
+    if (exprAST == nullptr) {
+        std::cout << "Failed to parse expression: ";
+        diagnostics.Print(std::cout);
+        return EXIT_FAILURE;
+    }
+
+    TruthTableEngine truthTableEngine(exprAST);
+    truthTableEngine.SetGovernor(requestGovernor);
+
+    if (!truthTableEngine.IsValid()) {
+        std::cout << "Too many variables (" << truthTableEngine.Variables().size() << ").\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream outputStream(outputFileName, std::ios::binary);
+
+    if (!outputStream) {
+        std::cout << "Failed to open " << outputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    std::optional<TruthTableSummary> summary = truthTableEngine.Enumerate(&outputStream);
+
+    if (!summary.has_value() && governor.IsExhausted()) {
+        std::cout << DiagnosticCodeName(ResourceDiagnosticCode(governor.Exhausted())) << " (" << truthTableEngine.Variables().size()
+                  << " variables).\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!summary.has_value()) {
+        std::cout << "Failed to write " << outputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << summary.value().mTrueCount << " of " << summary.value().mAssignmentCount
+              << " assignments are true (" << truthTableEngine.Variables().size() << " variables, "
+              << truthTableEngine.ThreadCount() << " threads)\n";
+
+    return EXIT_SUCCESS;
+}
+
+static bool ParseAssignment(const std::string& assignmentText, VariableAssignment& assignment)
+{
+    // "A=T B=F" ̌`̕ϐ̒l
+    std::istringstream assignmentStream(assignmentText);
+    std::string variableValue;
+
+    while (assignmentStream >> variableValue) {
+        std::size_t separator = variableValue.find('=');
+
+        if (separator == std::string::npos || separator + 2U != variableValue.size() ||
+            (variableValue[separator + 1U] != 'T' && variableValue[separator + 1U] != 'F')) {
+            std::cout << "Invalid assignment: " << variableValue << '\n';
+            return false;
+        }
+
+        assignment[variableValue.substr(0, separator)] = (variableValue[separator + 1U] == 'T');
+    }
+
+    return true;
+}
+
+static int EvaluateAdaptively(const std::string& inputFileName, const char* statisticsFileName)
+{
+    // 1s1̋Kꂽt@Cǂݍ, W͂̊蓖 ("A=T B=F" ̍s) ƂɑSĂ̋K]
+    // ṽt@C΋Nɕ]̏Ɠvǂݍ, Iɏo
+    std::ifstream inputStream(inputFileName);
+
+    if (!inputStream) {
+        std::cout << "Failed to open " << inputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    AdaptiveEvaluator evaluator;
+    ParserSession parserSession;
+    Diagnostics diagnostics;
+    std::string logicalExpr;
+    std::size_t lineNumber = 0;
+    std::vector<std::size_t> ruleLineNumbers;
+
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    ResourceGovernor* requestGovernor = sResourceLimits.has_value() ? &governor : nullptr;
+    parserSession.SetGovernor(requestGovernor);
+    evaluator.SetGovernor(requestGovernor);
+
+    while (std::getline(inputStream, logicalExpr)) {
+        ++lineNumber;
+
+        if (logicalExpr.empty())
+            continue;
+
+        diagnostics.Clear();
+        governor.Reset();
+
+        std::shared_ptr<BaseAST> exprAST = parserSession.Parse(logicalExpr, nullptr, diagnostics);
+
+        if (exprAST == nullptr) {
+            std::cout << "Failed to parse line " << lineNumber << ": ";
+            diagnostics.Print(std::cout);
+            continue;
+        }
+
+        evaluator.AddRule(exprAST);
+        ruleLineNumbers.push_back(lineNumber);
+    }
+
+    if (statisticsFileName != nullptr) {
+        std::ifstream statisticsStream(statisticsFileName);
+
+        // Kςꍇ͓ǂݍ܂, v蒼
+        if (statisticsStream && !evaluator.ImportStatistics(statisticsStream))
+            std::cout << "Ignored " << statisticsFileName << " (the rules have changed).\n";
+    }
+
+    std::string assignmentText;
+
+    while (std::getline(std::cin, assignmentText)) {
+        VariableAssignment assignment;
+
+        if (!ParseAssignment(assignmentText, assignment))
+            continue;
+
+        for (std::size_t i = 0; i < evaluator.RuleCount(); ++i) {
+            governor.Reset();
+            std::optional<bool> value = evaluator.EvaluateRule(i, assignment);
+
+            std::cout << "Line " << ruleLineNumbers[i] << ": ";
+
+            if (value.has_value())
+                std::cout << (value.value() ? "true" : "false") << '\n';
+            else if (governor.IsExhausted())
+                std::cout << DiagnosticCodeName(ResourceDiagnosticCode(governor.Exhausted())) << '\n';
+            else
+                std::cout << "some variables are not assigned\n";
+        }
+    }
+
+    std::cout << evaluator.ReorderedNodes() << " And/Or nodes reordered\n";
+
+    if (statisticsFileName != nullptr) {
+        std::ofstream statisticsStream(statisticsFileName);
+
+        if (!statisticsStream || !evaluator.ExportStatistics(statisticsStream)) {
+            std::cout << "Failed to write " << statisticsFileName << ".\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static bool ParseProbabilities(const std::string& probabilitiesText, VariableProbabilities& probabilities)
+{
+    // "A=0.5 B=0.25" ̌`̕ϐ̊m
+    std::istringstream probabilitiesStream(probabilitiesText);
+    std::string variableProbability;
+
+    while (probabilitiesStream >> variableProbability) {
+        std::size_t separator = variableProbability.find('=');
+        char* valueEnd = nullptr;
+        double probability = (separator != std::string::npos) ?
+            std::strtod(variableProbability.c_str() + separator + 1U, &valueEnd) : -1.0;
+
+        if (separator == std::string::npos || valueEnd == variableProbability.c_str() + separator + 1U ||
+            *valueEnd != '\0' || !(probability >= 0.0 && probability <= 1.0)) {
+            std::cout << "Invalid probability: " << variableProbability << '\n';
+            return false;
+        }
+
+        probabilities[variableProbability.substr(0, separator)] = probability;
+    }
+
+    return true;
+}
+
+static int ComputeProbabilities(const std::string& inputFileName, const std::vector<std::string>& probabilitiesTexts)
+{
+    // 1s1̋Kꂽt@Cǂݍ, m̑gƂɊeK^ɂȂm\
+    // K1x\z, m̑g΂܂Ƃ߂ČvZ
+    std::ifstream inputStream(inputFileName);
+
+    if (!inputStream) {
+        std::cout << "Failed to open " << inputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    ProbabilityEvaluator probabilityEvaluator;
+    ParserSession parserSession;
+    Diagnostics diagnostics;
+    std::vector<std::size_t> ruleLineNumbers;
+    std::string logicalExpr;
+    std::size_t lineNumber = 0;
+
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    ResourceGovernor* requestGovernor = sResourceLimits.has_value() ? &governor : nullptr;
+    parserSession.SetGovernor(requestGovernor);
+    probabilityEvaluator.SetGovernor(requestGovernor);
+
+    while (std::getline(inputStream, logicalExpr)) {
+        ++lineNumber;
+
+        if (logicalExpr.empty())
+            continue;
+
+        diagnostics.Clear();
+        governor.Reset();
+
+        std::shared_ptr<BaseAST> exprAST = parserSession.Parse(logicalExpr, nullptr, diagnostics);
+
+        if (exprAST == nullptr) {
+            std::cout << "Failed to parse line " << lineNumber << ": ";
+            diagnostics.Print(std::cout);
+            continue;
+        }
+
+        if (!probabilityEvaluator.AddRule(exprAST).has_value()) {
+            if (governor.IsExhausted())
+                std::cout << "Line " << lineNumber << ": " << DiagnosticCodeName(ResourceDiagnosticCode(governor.Exhausted())) << '\n';
+            else
+                std::cout << "Line " << lineNumber << ": too many decision diagram nodes\n";
+            continue;
+        }
+
+        ruleLineNumbers.push_back(lineNumber);
+    }
+
+    std::vector<std::vector<double>> probabilitySets;
+
+    for (const auto& probabilitiesText : probabilitiesTexts) {
+        VariableProbabilities probabilities;
+
+        if (!ParseProbabilities(probabilitiesText, probabilities))
+            return EXIT_FAILURE;
+
+        std::vector<double> probabilitySet;
+
+        for (const auto& variableName : probabilityEvaluator.Variables()) {
+            auto iter = probabilities.find(variableName);
+
+            if (iter == probabilities.end()) {
+                std::cout << "No probability for " << variableName << ".\n";
+                return EXIT_FAILURE;
+            }
+
+            probabilitySet.push_back(iter->second);
+        }
+
+        probabilitySets.push_back(std::move(probabilitySet));
+    }
+
+    std::vector<std::vector<double>> ruleProbabilities;
+    probabilityEvaluator.EvaluateBatch(probabilitySets, ruleProbabilities);
+
+    std::size_t readOnceRuleCount = 0;
+
+    for (std::size_t i = 0; i < probabilityEvaluator.RuleCount(); ++i)
+        readOnceRuleCount += probabilityEvaluator.IsReadOnce(i) ? 1U : 0U;
+
+    std::cout << probabilityEvaluator.RuleCount() << " rules (" << readOnceRuleCount << " read-once), "
+              << probabilityEvaluator.BDDNodeCount() << " decision diagram nodes\n";
+
+    for (std::size_t i = 0; i < ruleLineNumbers.size(); ++i) {
+        std::cout << "Line " << ruleLineNumbers[i] << ":";
+
+        for (const auto& setProbabilities : ruleProbabilities)
+            std::cout << ' ' << setProbabilities[i];
+
+        std::cout << '\n';
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int EvaluateOnce(const std::string& inputFileName, const std::string& assignmentText)
+{
+    // t@CŜ1̘_Ƃ݂Ȃ1񂾂]
+    // ]ŎQƂȂʂ̒g͍\͂Ȃ
+    std::ifstream inputStream(inputFileName);
+
+    if (!inputStream) {
+        std::cout << "Failed to open " << inputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    VariableAssignment assignment;
+
+    if (!ParseAssignment(assignmentText, assignment))
+        return EXIT_FAILURE;
+
+    std::string logicalExpr((std::istreambuf_iterator<char>(inputStream)), std::istreambuf_iterator<char>());
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    ResourceGovernor* requestGovernor = sResourceLimits.has_value() ? &governor : nullptr;
+    Diagnostics diagnostics;
+    std::shared_ptr<TokenStream> tokenStream = Lexer(logicalExpr, &diagnostics, requestGovernor);
+
+    if (tokenStream == nullptr) {
+        std::cout << "Failed to parse expression: ";
+        diagnostics.Print(std::cout);
+        return EXIT_FAILURE;
+    }
+
+    std::shared_ptr<BaseAST> exprAST;
+
+    // Ǘꍇ, [ƃm[h\͂̏ɐ邽ߒxɍ\͂
+    if (requestGovernor == nullptr) {
+        PerformanceCounters::CountParseAttempt(Notation::Infix);
+        exprAST = InfixParser(tokenStream, &diagnostics).ParseLazy();
+    }
+
+    // uL@łȂꍇ, ߂đSĂ̋L@
+    if (exprAST == nullptr && (requestGovernor == nullptr || !governor.IsExhausted())) {
+        tokenStream->SetCurrentIndex(0U);
+        diagnostics.Clear();
+        exprAST = ParseLogicalExpression(tokenStream, nullptr, diagnostics, requestGovernor);
+    }
+
+    if (exprAST == nullptr) {
+        std::cout << "Failed to parse expression: ";
+        diagnostics.Print(std::cout);
+        return EXIT_FAILURE;
+    }
+
+    Evaluator evaluator;
+    evaluator.SetGovernor(requestGovernor);
+    std::optional<bool> value = evaluator.Evaluate(exprAST, assignment);
+
+    if (!value.has_value() && governor.IsExhausted()) {
+        std::cout << DiagnosticCodeName(ResourceDiagnosticCode(governor.Exhausted())) << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    // ]ɍ\͂ʂ̒g̃G[͐ffɋL^
+    if (!value.has_value() && diagnostics.HasError()) {
+        std::cout << "Failed to parse expression: ";
+        diagnostics.Print(std::cout);
+        return EXIT_FAILURE;
+    }
+
+    if (!value.has_value()) {
+        std::cout << "Some variables are not assigned.\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << (value.value() ? "true" : "false") << " (" << evaluator.VisitedNodes() << " nodes visited)\n";
+
+    return EXIT_SUCCESS;
+}
+
+static int EvaluateParallel(const std::string& inputFileName, const std::string& assignmentText, unsigned int threadCount)
+{
+    // t@CŜ1̘_Ƃ݂Ȃ, ͂ƍ\, 傫ȕ؂̕]𕡐̃Xbhōs
+    // ؂̑傫𐔂̂, x\͎͂gȂ
+    std::ifstream inputStream(inputFileName);
+
+    if (!inputStream) {
+        std::cout << "Failed to open " << inputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    VariableAssignment assignment;
+
+    if (!ParseAssignment(assignmentText, assignment))
+        return EXIT_FAILURE;
+
+    std::string logicalExpr((std::istreambuf_iterator<char>(inputStream)), std::istreambuf_iterator<char>());
+    ForkJoinPool forkJoinPool(threadCount);
+    ParallelParser parallelParser(forkJoinPool);
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    Diagnostics diagnostics;
+    std::shared_ptr<BaseAST> exprAST = parallelParser.Parse(logicalExpr, nullptr, diagnostics,
+        sResourceLimits.has_value() ? &governor : nullptr);
+
+    if (exprAST == nullptr) {
+        std::cout << "Failed to parse expression: ";
+        diagnostics.Print(std::cout);
+        return EXIT_FAILURE;
+    }
+
+    ParallelTraversal parallelTraversal(exprAST, forkJoinPool);
+
+    // ̃Xbhŕ]̂, SẴm[h̐XebvƂĕ]̑OɉZ
+    if (!governor.ChargeSteps(parallelTraversal.NodeCount())) {
+        std::cout << DiagnosticCodeName(ResourceDiagnosticCode(governor.Exhausted())) << " ("
+                  << parallelTraversal.NodeCount() << " nodes).\n";
+        return EXIT_FAILURE;
+    }
+    std::optional<bool> value = parallelTraversal.Evaluate(assignment);
+
+    if (!value.has_value()) {
+        std::cout << "Some variables are not assigned.\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << (value.value() ? "true" : "false") << " (" << parallelTraversal.NodeCount() << " nodes, "
+              << parallelTraversal.SplitNodeCount() << " split nodes, " << forkJoinPool.ThreadCount() << " threads, "
+              << forkJoinPool.StolenTasks() << " stolen tasks)\n";
+
+    return EXIT_SUCCESS;
+}
+
+static std::size_t CountASTNodes(const std::shared_ptr<BaseAST>& exprAST)
+{
+    // [_łX^bNg؂Ȃ悤, IȃX^bNłǂ
+    std::vector<const BaseAST*> pendingNodes { exprAST.get() };
+    std::size_t nodeCount = 0;
+
+    while (!pendingNodes.empty()) {
+        const BaseAST* currentAST = pendingNodes.back();
+        pendingNodes.pop_back();
+        ++nodeCount;
+
+        for (std::size_t i = 0; i < ASTChildCount(currentAST); ++i)
+            pendingNodes.push_back(ASTChild(currentAST, i).get());
+    }
+
+    return nodeCount;
+}
+
+static int OptimizeRules(const std::string& inputFileName)
+{
+    // 1s1̋Kꂽt@Cǂݍ, SĂ̋Ko͂Ƃ1And-Inverter Graphɂ
+    // ύtƏ̑Õm[hƒi\, K𒊏ۍ\؂ɖ߂ĕ\
+    std::ifstream inputStream(inputFileName);
+
+    if (!inputStream) {
+        std::cout << "Failed to open " << inputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    std::shared_ptr<ASTPrinter> astPrinter = std::make_shared<ASTPrinter>();
+    ParserSession parserSession;
+    Diagnostics diagnostics;
+    AndInverterGraph graph;
+    std::string logicalExpr;
+    std::size_t lineNumber = 0;
+    std::size_t astNodeCount = 0;
+
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    parserSession.SetGovernor(sResourceLimits.has_value() ? &governor : nullptr);
+
+    while (std::getline(inputStream, logicalExpr)) {
+        ++lineNumber;
+
+        if (logicalExpr.empty())
+            continue;
+
+        diagnostics.Clear();
+        governor.Reset();
+
+        std::shared_ptr<BaseAST> exprAST = parserSession.Parse(logicalExpr, nullptr, diagnostics);
+
+        if (exprAST == nullptr) {
+            std::cout << "Failed to parse line " << lineNumber << ": ";
+            diagnostics.Print(std::cout);
+            continue;
+        }
+
+        astNodeCount += CountASTNodes(exprAST);
+        graph.AddOutput(graph.FromAST(exprAST));
+    }
+
+    auto printStatistics = [](const char* stage, const AndInverterGraph& stageGraph) {
+        std::cout << stage << ": " << stageGraph.AndCount() << " and nodes, depth " << stageGraph.Depth() << '\n'; };
+
+    std::cout << graph.Outputs().size() << " rules, " << graph.InputCount() << " variables, "
+              << astNodeCount << " syntax tree nodes\n";
+    printStatistics("Structural hashing", graph);
+
+    AndInverterGraph balancedGraph = graph.Balance();
+    printStatistics("Balancing", balancedGraph);
+
+    AndInverterGraph rewrittenGraph = balancedGraph.Rewrite();
+    printStatistics("Rewriting", rewrittenGraph);
+
+    // Œi, xύtĖ߂
+    AndInverterGraph optimizedGraph = rewrittenGraph.Balance();
+    printStatistics("Rebalancing", optimizedGraph);
+
+    for (AIGEdge output : optimizedGraph.Outputs())
+        astPrinter->Print(optimizedGraph.ToAST(output), Notation::Infix);
+
+    return EXIT_SUCCESS;
+}
+
+static int DeduplicateRules(const std::string& inputFileName, const std::string& outputFileName)
+{
+    // 1s1̋Kꂽt@C1񂾂ǂ, K`̎w䂪ɌꂽK菜
+    // cK͌̕\L̂܂܏o̓t@Cɏo
+    std::ifstream inputStream(inputFileName);
+
+    if (!inputStream) {
+        std::cout << "Failed to open " << inputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream outputStream(outputFileName);
+
+    if (!outputStream) {
+        std::cout << "Failed to open " << outputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    ParserSession parserSession;
+    Diagnostics diagnostics;
+    Canonicalizer canonicalizer;
+    std::unordered_set<Fingerprint, FingerprintHash> fingerprints;
+    std::string logicalExpr;
+    std::size_t lineNumber = 0;
+    std::size_t ruleCount = 0;
+    std::size_t failureCount = 0;
+
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    parserSession.SetGovernor(sResourceLimits.has_value() ? &governor : nullptr);
+
+    while (std::getline(inputStream, logicalExpr)) {
+        ++lineNumber;
+
+        if (logicalExpr.empty())
+            continue;
+
+        ++ruleCount;
+        diagnostics.Clear();
+        governor.Reset();
+
+        std::shared_ptr<BaseAST> exprAST = parserSession.Parse(logicalExpr, nullptr, diagnostics);
+
+        if (exprAST == nullptr) {
+            std::cout << "Failed to parse line " << lineNumber << ": ";
+            diagnostics.Print(std::cout);
+            ++failureCount;
+            continue;
+        }
+
+        Fingerprint fingerprint;
+        canonicalizer.Canonicalize(exprAST, fingerprint);
+
+        if (fingerprints.insert(fingerprint).second)
+            outputStream << logicalExpr << '\n';
+    }
+
+    std::size_t uniqueCount = fingerprints.size();
+    std::cout << ruleCount << " rules, " << uniqueCount << " unique, "
+              << (ruleCount - failureCount - uniqueCount) << " duplicates, " << failureCount << " parse failures\n";
+
+    return outputStream ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int HotSwapRules(const std::string& inputFileName, unsigned int readerCount, std::size_t updateCount)
+{
+    // ǂݎ̃XbhSĂ̋K_Ȋ蓖Ăŕ]Ԃ,
+    // K1/16ےɏĂ͖߂XibvVbgJ
+    std::ifstream inputStream(inputFileName);
+
+    if (!inputStream) {
+        std::cout << "Failed to open " << inputFileName << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> originalExprs;
+    std::vector<std::size_t> lineNumbers;
+    std::string logicalExpr;
+
+    for (std::size_t lineNumber = 1; std::getline(inputStream, logicalExpr); ++lineNumber) {
+        if (logicalExpr.empty())
+            continue;
+
+        originalExprs.push_back(logicalExpr);
+        lineNumbers.push_back(lineNumber);
+    }
+
+    readerCount = (readerCount != 0U) ? readerCount : std::max(1U, std::thread::hardware_concurrency());
+
+    RuleSnapshotStore snapshotStore(std::max<std::size_t>(readerCount, RuleSnapshotStore::DefaultMaxReaders));
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    Diagnostics diagnostics;
+
+    snapshotStore.SetGovernor(sResourceLimits.has_value() ? &governor : nullptr);
+
+    if (!snapshotStore.Publish(originalExprs, &diagnostics).has_value()) {
+        std::cout << "Failed to parse line " << lineNumbers[snapshotStore.FailedRule()] << ": ";
+        diagnostics.Print(std::cout);
+        return EXIT_FAILURE;
+    }
+
+    std::atomic<bool> stopReaders(false);
+    std::vector<std::uint64_t> evaluationCounts(readerCount, 0U);
+    std::vector<std::thread> readers;
+
+    for (unsigned int i = 0; i < readerCount; ++i) {
+        readers.emplace_back([&snapshotStore, &stopReaders, &evaluationCounts, i]() {
+            RuleSnapshotReader reader(snapshotStore);
+            std::mt19937_64 random(i);
+            std::vector<std::uint64_t> assignment;
+            std::uint64_t evaluationCount = 0U;
+
+            // XibvVbg͊蓖ĂƂɎQƂ (QƂĂԂɍւĂǂݑĂ悢)
+            while (!stopReaders.load(std::memory_order_relaxed)) {
+                const RuleSnapshot* snapshot = reader.Pin();
+                assignment.resize(snapshot->AssignmentWordCount());
+
+                for (std::uint64_t& word : assignment)
+                    word = random();
+
+                for (std::size_t j = 0; j < snapshot->RuleCount(); ++j)
+                    snapshot->Rule(j).Evaluate(assignment.data());
+
+                evaluationCount += snapshot->RuleCount();
+                reader.Unpin();
+            }
+
+            evaluationCounts[i] = evaluationCount;
+        });
+    }
+
+    std::vector<std::string> logicalExprs = originalExprs;
+    std::size_t parsedRuleCount = 0U;
+    std::uint64_t startTime = LatencyTracing::Now();
+    std::uint64_t maxPublishTime = 0U;
+
+    for (std::size_t update = 0; update < updateCount; ++update) {
+        for (std::size_t i = update % 16U; i < logicalExprs.size(); i += 16U)
+            logicalExprs[i] = (logicalExprs[i] == originalExprs[i]) ? "not (" + originalExprs[i] + ")" : originalExprs[i];
+
+        std::uint64_t publishStartTime = LatencyTracing::Now();
+
+        if (!snapshotStore.Publish(logicalExprs, &diagnostics).has_value()) {
+            std::cout << "Failed to parse rule " << snapshotStore.FailedRule() << ": ";
+            diagnostics.Print(std::cout);
+            break;
+        }
+
+        maxPublishTime = std::max(maxPublishTime, LatencyTracing::Now() - publishStartTime);
+        parsedRuleCount += snapshotStore.ParsedRuleCount();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    stopReaders.store(true, std::memory_order_relaxed);
+
+    for (auto& reader : readers)
+        reader.join();
+
+    double elapsedSeconds = static_cast<double>(LatencyTracing::Now() - startTime) * 1e-9;
+    std::uint64_t evaluationCount = 0U;
+
+    for (std::uint64_t count : evaluationCounts)
+        evaluationCount += count;
+
+    snapshotStore.Reclaim();
+
+    std::cout << originalExprs.size() << " rules, " << updateCount << " updates (" << parsedRuleCount << " rules re-parsed, "
+              << static_cast<double>(maxPublishTime) * 1e-6 << " ms max per update), "
+              << snapshotStore.ReclaimedCount() << " snapshots reclaimed, " << snapshotStore.RetiredCount() << " pending\n"
+              << readerCount << " readers evaluated " << evaluationCount << " rules ("
+              << static_cast<double>(evaluationCount) / std::max(elapsedSeconds, 1e-9) << " rules/s)\n";
+
+    return EXIT_SUCCESS;
+}
+
+static int SpecializeExpression(std::string logicalExpr, const std::string& partialAssignmentText)
+{
+    // ꕔ̕ϐ̒l ("A=T B=F" ̌`) Œ肵c̘_, c̕ϐ\
+    ResourceGovernor governor(sResourceLimits.value_or(ResourceLimits()));
+    ResourceGovernor* requestGovernor = sResourceLimits.has_value() ? &governor : nullptr;
+    Diagnostics diagnostics;
+    std::shared_ptr<TokenStream> tokenStream = Lexer(logicalExpr, &diagnostics, requestGovernor);
+    std::shared_ptr<BaseAST> exprAST = (tokenStream != nullptr) ?
+        ParseLogicalExpression(tokenStream, nullptr, diagnostics, requestGovernor) : nullptr;
+
+    if (exprAST == nullptr) {
+        std::cout << "Failed to parse expression: ";
+        diagnostics.Print(std::cout);
+        return EXIT_FAILURE;
+    }
+
+    VariableAssignment partialAssignment;
+
+    if (!ParseAssignment(partialAssignmentText, partialAssignment))
+        return EXIT_FAILURE;
+
+    PartialEvaluator partialEvaluator(exprAST);
+    std::shared_ptr<const ResidualFormula> residual = partialEvaluator.Specialize(partialAssignment);
+    std::shared_ptr<ASTPrinter> astPrinter = std::make_shared<ASTPrinter>();
+
+    astPrinter->Print(residual->AST(), Notation::Infix);
+    std::cout << residual->FreeVariableCount() << " free variables:";
+
+    for (std::uint32_t i = 0; i < residual->FreeVariableCount(); ++i)
+        std::cout << ' ' << residual->FreeVariable(i);
+
+    std::cout << '\n';
+
+    return EXIT_SUCCESS;
+}
+
+static int ParseStream(std::istream& inputStream, Notation notation)
 {
+    // ͑Ŝ1̘_Ƃ݂Ȃ, `NƂɓǂݍ݂Ȃ\
+    Diagnostics diagnostics;
+    std::shared_ptr<StreamLexer> streamLexer = std::make_shared<StreamLexer>(inputStream, 4096U, &diagnostics);
+    std::shared_ptr<TokenStream> tokenStream = std::make_shared<TokenStream>(streamLexer);
+    std::shared_ptr<BaseAST> exprAST;
+    TracedInput tracedInput;
+
+    PerformanceCounters::CountParseAttempt(notation);
+
+    if (notation == Notation::Prefix)
+        exprAST = std::make_shared<PrefixParser>(tokenStream, &diagnostics)->Parse();
+    else
+        exprAST = std::make_shared<PostfixParser>(tokenStream, &diagnostics)->Parse();
+
+    if (streamLexer->HasError()) {
+        std::cout << "Lexical analysis failed: ";
+        diagnostics.Print(std::cout);
+        return EXIT_FAILURE;
+    }
+
+    if (exprAST == nullptr) {
+        std::cout << "Parse failed: ";
+        diagnostics.Print(std::cout);
+        return EXIT_FAILURE;
+    }
+
     std::shared_ptr<ASTPrinter> astPrinter = std::make_shared<ASTPrinter>();
+    astPrinter->Print(exprAST, Notation::Infix);
+
+    return EXIT_SUCCESS;
+}
+
+static int CheckOperators()
+{
+    // 2Zq̗D揇ʂƌ, ]ƃRpCߗ̕]̌ʂ,
+    // ϐA, B, C̑SĂ̊蓖ĂɂĊ҂lƏƂ炵킹
+    struct OperatorCheck {
+        const char* mLogicalExpr;
+        bool        (*mExpected)(bool a, bool b, bool c);
+    };
+
+    static const OperatorCheck operatorChecks[] = {
+        { "A nand B",               [](bool a, bool b, bool) { return !(a && b); } },
+        { "A nor B",                [](bool a, bool b, bool) { return !(a || b); } },
+        { "A xor B",                [](bool a, bool b, bool) { return a != b; } },
+        { "A xnor B",               [](bool a, bool b, bool) { return a == b; } },
+        { "not A nor B",            [](bool a, bool b, bool) { return !(!a || b); } },
+        { "A nor B nor C",          [](bool a, bool b, bool c) { return !(!(a || b) || c); } },
+        { "A nand B nand C",        [](bool a, bool b, bool c) { return !(!(a && b) && c); } },
+        { "A or B and C",           [](bool a, bool b, bool c) { return (a || b) && c; } },
+        { "A nor B xor C",          [](bool a, bool b, bool c) { return !(a || b) != c; } },
+        { "A and B -> C",           [](bool a, bool b, bool c) { return !(a && b) || c; } },
+        { "A -> B -> C",            [](bool a, bool b, bool c) { return !a || !b || c; } },
+        { "A <-> B -> C",           [](bool a, bool b, bool c) { return a == (!b || c); } },
+        { "A nor (B -> C)",         [](bool a, bool b, bool c) { return !(a || !b || c); } },
+        { "A xnor B <-> C nand A",  [](bool a, bool b, bool c) { return (a == b) == !(c && a); } }
+    };
+
+    const std::string variableNames[] = { "A", "B", "C" };
+    std::size_t failureCount = 0;
+
+    for (const auto& operatorCheck : operatorChecks) {
+        Diagnostics diagnostics;
+        std::string logicalExpr = operatorCheck.mLogicalExpr;
+        std::shared_ptr<TokenStream> tokenStream = Lexer(logicalExpr, &diagnostics);
+        std::shared_ptr<BaseAST> exprAST = (tokenStream != nullptr) ?
+            ParseLogicalExpression(tokenStream, nullptr, diagnostics) : nullptr;
+        std::shared_ptr<SymbolTable> symbolTable = std::make_shared<SymbolTable>();
+        std::shared_ptr<Program> program = (exprAST != nullptr) ? Compiler(symbolTable).Compile(exprAST) : nullptr;
+
+        if (program == nullptr) {
+            std::cout << "Failed to parse " << operatorCheck.mLogicalExpr << ": ";
+            diagnostics.Print(std::cout);
+            ++failureCount;
+            continue;
+        }
+
+        Evaluator evaluator;
+
+        for (unsigned int bits = 0; bits < 8U; ++bits) {
+            bool values[] = { (bits & 1U) != 0U, (bits & 2U) != 0U, (bits & 4U) != 0U };
+            VariableAssignment assignment;
+            std::uint64_t compiledAssignment = 0U;
+
+            for (std::size_t i = 0; i < 3U; ++i) {
+                std::optional<std::uint32_t> variable = symbolTable->Find(variableNames[i]);
+                assignment[variableNames[i]] = values[i];
+
+                if (variable.has_value() && values[i])
+                    compiledAssignment |= static_cast<std::uint64_t>(1U) << variable.value();
+            }
+
+            bool expected = operatorCheck.mExpected(values[0], values[1], values[2]);
+            std::optional<bool> value = evaluator.Evaluate(exprAST, assignment);
+            bool compiledValue = program->View().Evaluate(&compiledAssignment);
+
+            if (!value.has_value() || value.value() != expected || compiledValue != expected) {
+                std::cout << operatorCheck.mLogicalExpr << " with A=" << values[0] << " B=" << values[1] << " C=" << values[2]
+                          << ": expected " << expected << ", evaluated " << value.value_or(!expected)
+                          << ", compiled " << compiledValue << '\n';
+                ++failureCount;
+                break;
+            }
+        }
+    }
+
+    std::size_t checkCount = sizeof(operatorChecks) / sizeof(operatorChecks[0]);
+    std::cout << (checkCount - failureCount) << " of " << checkCount << " operator checks passed\n";
+
+    return (failureCount == 0U) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int CheckChains()
+{
+    // EɓqɂȂAnd̘AOuL@ƌuL@ō\͂, 1̃m[hɂ܂Ƃ܂邱Ƃ,
+    // 4{ɂƂ̎Ԃ`͈̔ (8{) Ɏ܂邱Ƃm߂
+    constexpr std::size_t ShortLength = 20000U;
+    constexpr std::size_t LongLength = ShortLength * 4U;
+
+    auto makeChain = [](std::size_t length, bool prefix) {
+        std::string logicalExpr;
+
+        for (std::size_t i = 0; i < length; ++i) {
+            if (prefix && i + 1U < length)
+                logicalExpr += "and ";
+
+            logicalExpr += "V" + std::to_string(i) + " ";
+        }
+
+        if (!prefix)
+            for (std::size_t i = 1; i < length; ++i)
+                logicalExpr += "and ";
+
+        return logicalExpr; };
+
+    // \͂ɂ (imb, sꍇstd::nullopt)
+    auto parseChain = [](const std::string& logicalExpr, std::size_t length) -> std::optional<std::uint64_t> {
+        ParserSession parserSession;
+        Diagnostics diagnostics;
+        std::uint64_t startTime = LatencyTracing::Now();
+        std::shared_ptr<BaseAST> exprAST = parserSession.Parse(logicalExpr, nullptr, diagnostics);
+        std::uint64_t elapsedTime = LatencyTracing::Now() - startTime;
+
+        if (exprAST == nullptr || exprAST->Type() != ASTType::AndOrExpression)
+            return std::nullopt;
+
+        const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(exprAST.get());
+
+        if (andOrExprAST->OperandCount() != length)
+            return std::nullopt;
+
+        for (std::size_t i = 0; i < length; ++i) {
+            const BaseAST* operandAST = andOrExprAST->Operand(i).get();
+
+            if (operandAST->Type() != ASTType::Variable ||
+                static_cast<const VariableAST*>(operandAST)->Name() != "V" + std::to_string(i))
+                return std::nullopt;
+        }
+
+        return std::max<std::uint64_t>(elapsedTime, 1U); };
+
+    std::size_t failureCount = 0;
+
+    for (bool prefix : { true, false }) {
+        const char* notationName = prefix ? "prefix" : "postfix";
+        std::optional<std::uint64_t> shortTime = parseChain(makeChain(ShortLength, prefix), ShortLength);
+        std::optional<std::uint64_t> longTime = parseChain(makeChain(LongLength, prefix), LongLength);
+
+        if (!shortTime.has_value() || !longTime.has_value()) {
+            std::cout << "Right-nested " << notationName << " chain was not merged into one node\n";
+            ++failureCount;
+            continue;
+        }
+
+        double ratio = static_cast<double>(longTime.value()) / static_cast<double>(shortTime.value());
+        std::cout << "Right-nested " << notationName << " chain: " << ShortLength << " operands in "
+                  << shortTime.value() / 1000U << " us, " << LongLength << " operands in "
+                  << longTime.value() / 1000U << " us\n";
+
+        if (ratio >= 8.0) {
+            std::cout << "Parsing time grows faster than linearly (x" << ratio << ")\n";
+            ++failureCount;
+        }
+    }
+
+    std::cout << (2U - failureCount) << " of 2 chain checks passed\n";
+    return (failureCount == 0U) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static std::string RandomLogicalExpr(std::mt19937& random, std::size_t variableCount)
+{
+    // ϐV0V(variableCount - 1)S1ȏg, ꕔ̕ϐ͕g
+    static const char* const binaryOperators[] = { "and", "or", "xor", "xnor", "nand", "nor", "->", "<->" };
+    std::vector<std::string> operands;
+
+    for (std::size_t i = 0; i < variableCount + variableCount / 3U; ++i) {
+        std::size_t variable = (i < variableCount) ? i : random() % variableCount;
+        operands.push_back(((random() % 4U == 0U) ? "not V" : "V") + std::to_string(variable));
+    }
+
+    std::shuffle(operands.begin(), operands.end(), random);
+
+    // ׂ荇2̃Iyhʂň͂1ɂ܂Ƃ߂邱ƂJԂ
+    while (operands.size() > 1U) {
+        std::size_t index = random() % (operands.size() - 1U);
+        const char* binaryOperator = binaryOperators[random() % (sizeof(binaryOperators) / sizeof(binaryOperators[0]))];
+        operands[index] = "(" + operands[index] + " " + binaryOperator + " " + operands[index + 1U] + ")";
+        operands.erase(operands.begin() + static_cast<std::ptrdiff_t>(index) + 1);
+    }
+
+    return operands.front();
+}
+
+static int CheckMinimizer(std::size_t formulaCount, std::uint32_t seed)
+{
+    // ϐ114̘_𗐐ōčŏ, ̘_ƌʂ̔rI_a
+    // [銄蓖Ă (0ł) Ƃm߂
+    // ȍŏ (ϐ10ȉ) ƃq[XeBbNȍŏ (1114) ̗𒲂ׂ
+    constexpr std::size_t MaxVariableCount = 14U;
+
+    struct PathResult {
+        std::size_t mChecked = 0;
+        std::size_t mSkipped = 0;
+        std::size_t mFailed = 0;
+    };
+
+    std::mt19937 random(seed);
+    Minimizer minimizer;
+    ModelCounter modelCounter;
+    ParserSession parserSession;
+    Diagnostics diagnostics;
+    PathResult pathResults[2];
+
+    for (std::size_t i = 0; i < formulaCount; ++i) {
+        std::size_t variableCount = i % MaxVariableCount + 1U;
+        PathResult& pathResult = pathResults[variableCount <= Minimizer::ExactVariableLimit ? 0 : 1];
+        std::string logicalExpr = RandomLogicalExpr(random, variableCount);
+
+        diagnostics.Clear();
+        std::shared_ptr<BaseAST> exprAST = parserSession.Parse(logicalExpr, nullptr, diagnostics);
+
+        if (exprAST == nullptr) {
+            std::cout << "Failed to parse " << logicalExpr << ": ";
+            diagnostics.Print(std::cout);
+            ++pathResult.mFailed;
+            continue;
+        }
+
+        std::shared_ptr<BaseAST> minimizedAST = minimizer.Minimize(exprAST);
+
+        // ύčŏ߂_݂͐̂Ƃ
+        if (minimizedAST == nullptr) {
+            ++pathResult.mSkipped;
+            continue;
+        }
+
+        ++pathResult.mChecked;
+
+        std::shared_ptr<BaseAST> differenceAST = std::make_shared<XorExpressionAST>(exprAST, minimizedAST, "");
+        std::optional<BigInteger> modelCount = modelCounter.Count(differenceAST);
+
+        if (!modelCount.has_value() || !modelCount.value().IsZero()) {
+            std::cout << "Not equivalent after minimization: " << logicalExpr << '\n';
+            ++pathResult.mFailed;
+        }
+    }
+
+    const char* pathNames[] = { "Exact (up to 10 variables)", "Heuristic (11 to 14 variables)" };
+
+    for (std::size_t i = 0; i < 2U; ++i) {
+        std::cout << pathNames[i] << ": " << (pathResults[i].mChecked - pathResults[i].mFailed) << " of "
+                  << pathResults[i].mChecked << " minimized formulas are equivalent ("
+                  << pathResults[i].mSkipped << " skipped)\n";
+    }
+
+    return (pathResults[0].mFailed == 0U && pathResults[1].mFailed == 0U) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int CheckAdaptiveEvaluator(std::size_t ruleCount, std::uint32_t seed)
+{
+    // ōAndOr̘A܂ދK, ϐƂɕ΂蓖Ăŕ], בւȂ]ʂ
+    // Evaluatorƈv邱, ۍ\؂ςȂ, ovǂݍނƓvɂȂ邱Ƃm߂
+    constexpr std::size_t MaxVariableCount = 8U;
+    constexpr std::size_t AssignmentCount = 512U;
+
+    std::mt19937 random(seed);
+    AdaptiveEvaluator adaptiveEvaluator(16U);
+    Evaluator evaluator;
+    ParserSession parserSession;
+    Diagnostics diagnostics;
+    std::vector<std::string> logicalExprs;
+    std::vector<std::string> printedASTs;
+    std::vector<std::shared_ptr<BaseAST>> exprASTs;
+
+    auto printAST = [](const std::shared_ptr<BaseAST>& exprAST) {
+        std::ostringstream outputStream;
+        ASTPrinter().Print(exprAST, Notation::Infix, outputStream);
+        return outputStream.str(); };
+
+    for (std::size_t i = 0; i < ruleCount; ++i) {
+        // RandomLogicalExpr̘_OrłȂ, AndłȂ
+        std::size_t termCount = random() % 4U + 2U;
+        std::string logicalExpr;
+
+        for (std::size_t term = 0; term < termCount; ++term) {
+            std::size_t factorCount = random() % 3U + 1U;
+            logicalExpr += (term > 0U) ? " and " : "";
+            logicalExpr += (factorCount > 1U) ? "(" : "";
+
+            for (std::size_t factor = 0; factor < factorCount; ++factor)
+                logicalExpr += ((factor > 0U) ? " or " : "") + RandomLogicalExpr(random, random() % MaxVariableCount + 1U);
+
+            logicalExpr += (factorCount > 1U) ? ")" : "";
+        }
+
+        diagnostics.Clear();
+        std::shared_ptr<BaseAST> exprAST = parserSession.Parse(logicalExpr, nullptr, diagnostics);
+
+        if (exprAST == nullptr) {
+            std::cout << "Failed to parse " << logicalExpr << ": ";
+            diagnostics.Print(std::cout);
+            return EXIT_FAILURE;
+        }
+
+        adaptiveEvaluator.AddRule(exprAST);
+        logicalExprs.push_back(logicalExpr);
+        printedASTs.push_back(printAST(exprAST));
+        exprASTs.push_back(exprAST);
+    }
+
+    // ϐƂɐ^ɂȂm΂点, בւŊ҃RXgς悤ɂ
+    std::vector<VariableAssignment> assignments(AssignmentCount);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    double probabilities[MaxVariableCount];
+
+    for (double& probability : probabilities)
+        probability = distribution(random);
+
+    for (auto& assignment : assignments)
+        for (std::size_t variable = 0; variable < MaxVariableCount; ++variable)
+            assignment["V" + std::to_string(variable)] = distribution(random) < probabilities[variable];
+
+    std::size_t mismatchCount = 0;
+
+    for (std::size_t i = 0; i < ruleCount; ++i)
+        for (const auto& assignment : assignments)
+            if (adaptiveEvaluator.EvaluateRule(i, assignment) != evaluator.Evaluate(exprASTs[i], assignment))
+                ++mismatchCount;
+
+    std::size_t changedCount = 0;
+
+    for (std::size_t i = 0; i < ruleCount; ++i)
+        if (printAST(exprASTs[i]) != printedASTs[i])
+            ++changedCount;
+
+    // K\͂]ɓvǂݍ, ovv邱Ƃm߂
+    std::ostringstream exportedStream;
+    adaptiveEvaluator.ExportStatistics(exportedStream);
+
+    AdaptiveEvaluator importedEvaluator(16U);
+
+    for (const std::string& logicalExpr : logicalExprs)
+        importedEvaluator.AddRule(parserSession.Parse(logicalExpr, nullptr, diagnostics));
+
+    std::istringstream importStream(exportedStream.str());
+    std::ostringstream reexportedStream;
+    bool roundTripped = importedEvaluator.ImportStatistics(importStream) &&
+        importedEvaluator.ExportStatistics(reexportedStream) && reexportedStream.str() == exportedStream.str();
+
+    // ǂݍ񂾏ŕ]Ăʂ͕ςȂ
+    for (std::size_t i = 0; i < ruleCount; ++i)
+        for (std::size_t j = 0; j < AssignmentCount; j += 8U)
+            if (importedEvaluator.EvaluateRule(i, assignments[j]) != evaluator.Evaluate(exprASTs[i], assignments[j]))
+                ++mismatchCount;
+
+    std::cout << "Adaptive evaluation: " << mismatchCount << " mismatches with Evaluator, "
+              << adaptiveEvaluator.ReorderedNodes() << " And/Or nodes reordered\n";
+    std::cout << "Shared ASTs: " << changedCount << " of " << ruleCount << " changed by reordering\n";
+    std::cout << "Statistics round trip: " << (roundTripped ? "identical" : "different") << '\n';
+
+    return (mismatchCount == 0U && changedCount == 0U && roundTripped) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void PrintEngineText(const std::function<std::int32_t(char*, std::size_t, std::size_t*)>& formatText,
+                            std::vector<char>& outputBuffer)
+{
+    // obt@Ȃ, KvȒɍLď
+    std::size_t length = 0;
+
+    if (formatText(outputBuffer.data(), outputBuffer.size(), &length) == LEP_ERROR_BUFFER_TOO_SMALL) {
+        outputBuffer.resize(length + 1U);
+
+        if (formatText(outputBuffer.data(), outputBuffer.size(), &length) != LEP_OK)
+            return;
+    }
+
+    std::cout.write(outputBuffer.data(), static_cast<std::streamsize>(length));
+}
+
+int main(int argc, char** argv)
+{
+    // vƎ̏̃IvV͑̃IvVOɎw肷
+    while (argc >= 2) {
+        if (argc >= 3 && std::strcmp(argv[1], "--counters") == 0) {
+            // \JE^IƃVOi̎Mɏo (--counters text ܂ --counters json)
+            PerformanceCounters::InstallDump(std::strcmp(argv[2], "json") == 0 ?
+                PerformanceDumpFormat::Json : PerformanceDumpFormat::Text);
+            argc -= 2;
+            argv += 2;
+        } else if (std::strcmp(argv[1], "--latency") == 0) {
+            // iKƂ̒x̕zIɏo
+            LatencyTracing::EnableSummaryAtExit();
+            argc -= 1;
+            argv += 1;
+        } else if (argc >= 4 && std::strcmp(argv[1], "--trace") == 0) {
+            // ͂̂w肵ɂăXpL^ (--trace <t@C> <>)
+            LatencyTracing::EnableTrace(argv[2], std::atof(argv[3]));
+            argc -= 3;
+            argv += 3;
+        } else if (argc >= 3 && std::strcmp(argv[1], "--limits") == 0) {
+            // 1sƂ̎̏ (--limits bytes=..,tokens=..,depth=..,nodes=..,steps=..)
+            sResourceLimits = ParseResourceLimits(argv[2]);
+            sResourceLimitsText = argv[2];
+
+            if (!sResourceLimits.has_value()) {
+                std::cout << "Invalid resource limits " << argv[2] << ".\n";
+                return EXIT_FAILURE;
+            }
+
+            argc -= 2;
+            argv += 2;
+        } else {
+            break;
+        }
+    }
+
+    // Zq̗D揇ʂƕ]̌ (--check-operators)
+    if (argc >= 2 && std::strcmp(argv[1], "--check-operators") == 0)
+        return CheckOperators();
+
+    // EɓqɂȂAndOr̘A̍\͂`Ԃł邱Ƃ̌ (--check-chains)
+    if (argc >= 2 && std::strcmp(argv[1], "--check-chains") == 0)
+        return CheckChains();
+
+    // ŏ_̘_Ɠł邱Ƃ̌ (--check-minimizer [_̌] [̎])
+    if (argc >= 2 && std::strcmp(argv[1], "--check-minimizer") == 0)
+        return CheckMinimizer(argc >= 3 ? static_cast<std::size_t>(std::atol(argv[2])) : 280U,
+                              argc >= 4 ? static_cast<std::uint32_t>(std::atol(argv[3])) : 1U);
+
+    // בւȂ]ʂƓv̏ǒ (--check-adaptive [Ǩ] [̎])
+    if (argc >= 2 && std::strcmp(argv[1], "--check-adaptive") == 0)
+        return CheckAdaptiveEvaluator(argc >= 3 ? static_cast<std::size_t>(std::atol(argv[2])) : 200U,
+                                      argc >= 4 ? static_cast<std::uint32_t>(std::atol(argv[3])) : 1U);
+
+    // Xg[~Oł̍\ (߂łȂ̂ŋL@w肷)
+    if (argc >= 2 && std::strcmp(argv[1], "--stream-prefix") == 0)
+        return ParseStream(std::cin, Notation::Prefix);
+
+    if (argc >= 2 && std::strcmp(argv[1], "--stream-postfix") == 0)
+        return ParseStream(std::cin, Notation::Postfix);
+
+    // KW̃RpCƓǂݍ
+    if (argc >= 4 && std::strcmp(argv[1], "--compile-rules") == 0)
+        return CompileRules(argv[2], argv[3]);
+
+    if (argc >= 3 && std::strcmp(argv[1], "--load-rules") == 0)
+        return LoadRules(argv[2]);
+
+    // ]T[o (--serve <\Pbg̃pX> [K̃t@C] [[J[Xbh])
+    if (argc >= 3 && std::strcmp(argv[1], "--serve") == 0)
+        return Serve(argv[2], argc >= 4 ? argv[3] : nullptr, argc >= 5 ? static_cast<unsigned int>(std::atoi(argv[4])) : 0U);
+
+    // ]T[o̕׎ (--load-test <\Pbg̃pX> [ڑ] [ڑƂ̗v] [pCvC̐[])
+    if (argc >= 3 && std::strcmp(argv[1], "--load-test") == 0) {
+        LoadGenerator loadGenerator(argv[2]);
+
+        if (argc >= 4)
+            loadGenerator.SetConnectionCount(static_cast<std::size_t>(std::atol(argv[3])));
+        if (argc >= 5)
+            loadGenerator.SetRequestCount(static_cast<std::size_t>(std::atol(argv[4])));
+        if (argc >= 6)
+            loadGenerator.SetPipelineDepth(static_cast<std::size_t>(std::atol(argv[5])));
+
+        return loadGenerator.Run(std::cout) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // 1̊蓖Ăɑ΂KẄꊇ] (--evaluate-batch <KW̃t@C> <"A=T B=F ..."> [JԂ])
+    if (argc >= 4 && std::strcmp(argv[1], "--evaluate-batch") == 0)
+        return EvaluateRuleBatch(argv[2], argv[3], argc >= 5 ? static_cast<std::size_t>(std::atol(argv[4])) : 1U);
+
+    // ϐ̒l̕ωɉK̍] (--watch-rules <KW̃t@C>)
+    if (argc >= 3 && std::strcmp(argv[1], "--watch-rules") == 0)
+        return WatchRules(argv[2]);
+
+    // [銄蓖Ă̌ (--count-models <t@C> [(~b)])
+    if (argc >= 3 && std::strcmp(argv[1], "--count-models") == 0)
+        return CountModels(argv[2], argc >= 4 ? std::atol(argv[3]) : 0L);
+
+    // Ϙa`ւ̍ŏ (--minimize <t@C>)
+    if (argc >= 3 && std::strcmp(argv[1], "--minimize") == 0)
+        return MinimizeRules(argv[2]);
+
+    // P^̔ (--tautology <t@C>)
+    if (argc >= 3 && std::strcmp(argv[1], "--tautology") == 0)
+        return CheckTautologies(argv[2]);
+
+    // k^l\̏o (--truth-table <_> <o̓t@C>)
+    if (argc >= 4 && std::strcmp(argv[1], "--truth-table") == 0)
+        return WriteTruthTable(argv[2], argv[3]);
+
+    // K^ɂȂm (--probability <t@C> <"A=0.5 B=0.25 ..."> [<"A=0.1 B=0.9 ..."> ...])
+    if (argc >= 4 && std::strcmp(argv[1], "--probability") == 0)
+        return ComputeProbabilities(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+
+    // IyhבւȂ̋K̕] (--adaptive <t@C> [ṽt@C])
+    if (argc >= 3 && std::strcmp(argv[1], "--adaptive") == 0)
+        return EvaluateAdaptively(argv[2], argc >= 4 ? argv[3] : nullptr);
+
+    // Ș_1̕] (--evaluate <t@C> <"A=T B=F ...">)
+    if (argc >= 4 && std::strcmp(argv[1], "--evaluate") == 0)
+        return EvaluateOnce(argv[2], argv[3]);
+
+    // Ș_̕] (--evaluate-parallel <t@C> <"A=T B=F ..."> [Xbh])
+    if (argc >= 4 && std::strcmp(argv[1], "--evaluate-parallel") == 0)
+        return EvaluateParallel(argv[2], argv[3], argc >= 5 ? static_cast<unsigned int>(std::atoi(argv[4])) : 0U);
+
+    // And-Inverter GraphɂK̍œK (--aig <t@C>)
+    if (argc >= 3 && std::strcmp(argv[1], "--aig") == 0)
+        return OptimizeRules(argv[2]);
+
+    // _IɓK̏d̏ (--dedup <̓t@C> <o̓t@C>)
+    if (argc >= 4 && std::strcmp(argv[1], "--dedup") == 0)
+        return DeduplicateRules(argv[2], argv[3]);
+
+    // ]~߂ɋKWւ (--hot-swap <t@C> [ǂݎ̃Xbh] [XV])
+    if (argc >= 3 && std::strcmp(argv[1], "--hot-swap") == 0)
+        return HotSwapRules(argv[2], argc >= 4 ? static_cast<unsigned int>(std::atoi(argv[3])) : 0U,
+                            argc >= 5 ? static_cast<std::size_t>(std::atol(argv[4])) : 100U);
+
+    // ꕔ̕ϐ̒lŒ肵c̘_ (--specialize <_> <"A=T B=F ...">)
+    if (argc >= 4 && std::strcmp(argv[1], "--specialize") == 0)
+        return SpecializeExpression(argv[2], argv[3]);
+
+    // Θb[h̓CuCAPÎ݂g
+    LEPEngine* engine = LEPCreateEngine();
+
+    if (engine == nullptr || LEPSetResourceLimits(engine, sResourceLimitsText) != LEP_OK) {
+        std::cout << "Failed to create the engine.\n";
+        LEPDestroyEngine(engine);
+        return EXIT_FAILURE;
+    }
+
     std::string logicalExpr;
-    
+    std::vector<char> outputBuffer(256U);
+
     while (true) {
         std::cout << "Enter logical expression (infix or prefix)> ";
 
@@ -22,52 +1762,44 @@ int main(int argc, char** argv)
         if (logicalExpr == "")
             break;
 
-        // 
-        std::shared_ptr<TokenStream> tokenStream = Lexer(logicalExpr);
-        
-        if (tokenStream == nullptr) {
-            std::cout << "Lexical analysis failed.\n";
+        PerformanceCounters::DumpIfRequested(std::cerr);
+
+        TracedInput tracedInput;
+
+        // O̘̓͂_͎cȂ (g[Nƍ\͊̓GWg)
+        const char* text = logicalExpr.c_str();
+        std::size_t textLength = logicalExpr.size();
+        std::int32_t expressionId = LEP_ERROR_INVALID_ARGUMENT;
+
+        LEPClearExpressions(engine);
+        LEPCompileExpressions(engine, &text, &textLength, 1U, 0U, &expressionId);
+
+        // \͂\Lɕ\ (uL@, OuL@, uL@̏Ɏ)
+        static const char* const notationNames[] = { "infix", "prefix", "postfix" };
+        std::int32_t lastNotation = LEPLastNotation(engine);
+
+        for (std::int32_t notation = LEP_NOTATION_INFIX; notation <= lastNotation; ++notation)
+            std::cout << "Parsing " << notationNames[notation] << " expression...\n";
+
+        if (expressionId == LEP_ERROR_LEXICAL || expressionId == LEP_ERROR_SYNTAX) {
+            std::cout << (expressionId == LEP_ERROR_LEXICAL ? "Lexical analysis failed: " : "Parse failed: ");
+            PrintEngineText([engine](char* buffer, std::size_t bufferSize, std::size_t* length) {
+                return LEPFormatDiagnostic(engine, buffer, bufferSize, length); }, outputBuffer);
             continue;
         }
 
-        // Infix ExpressionƉ肵č\
-        std::cout << "Parsing infix expression...\n";
-        std::shared_ptr<InfixParser> infixExprParser = std::make_shared<InfixParser>(tokenStream);
-        std::shared_ptr<BaseAST> exprAST = infixExprParser->Parse();
-
-        // Infix ExpressionƉ肵č\͂肭Ȃꍇ
-        if (exprAST == nullptr) {
-            // g[N߂
-            tokenStream->SetCurrentIndex(0U);
-            
-            // Prefix ExpressionƉ肵č\
-            std::cout << "Parsing prefix expression...\n";
-            std::shared_ptr<PrefixParser> prefixExprParser = std::make_shared<PrefixParser>(tokenStream);
-            exprAST = prefixExprParser->Parse();
-
-            // Prefix ExpressionƉ肵č\͂肭Ȃꍇ
-            if (exprAST == nullptr) {
-                // g[N߂
-                tokenStream->SetCurrentIndex(0U);
-
-                // Postfix ExpressionƉ肵č\
-                std::cout << "Parsing postfix expression...\n";
-                std::shared_ptr<PostfixParser> postfixExprParser = std::make_shared<PostfixParser>(tokenStream);
-                exprAST = postfixExprParser->Parse();
-
-                // Postfix ExpressionƉ肵č\͂肭Ȃꍇ
-                if (exprAST == nullptr) {
-                    std::cout << "Parse failed.\n";
-                    continue;
-                }
-            }
+        if (expressionId < 0) {
+            std::cout << "Compilation failed.\n";
+            continue;
         }
 
-        astPrinter->Print(exprAST, Notation::Infix);
-        astPrinter->Print(exprAST, Notation::Prefix);
-        astPrinter->Print(exprAST, Notation::Postfix);
+        for (std::int32_t notation : { LEP_NOTATION_INFIX, LEP_NOTATION_PREFIX, LEP_NOTATION_POSTFIX })
+            PrintEngineText([engine, expressionId, notation](char* buffer, std::size_t bufferSize, std::size_t* length) {
+                return LEPFormatExpression(engine, expressionId, notation, buffer, bufferSize, length); }, outputBuffer);
     }
 
+    LEPDestroyEngine(engine);
+
     std::getchar();
 
     return EXIT_SUCCESS;
@@ -0,0 +1,669 @@
+
+// LogicalExpressionParser
+// Minimizer.cpp
+
+#include "Minimizer.hpp"
+#include "AST.hpp"
+#include "LatencyTracing.hpp"
+#include "ResourceGovernor.hpp"
+
+#include <algorithm>
+#include <set>
+
+static inline unsigned int PopulationCount(std::uint64_t value)
+{
+    unsigned int count = 0U;
+
+    for (; value != 0U; value &= value - 1U)
+        ++count;
+
+    return count;
+}
+
+static inline bool CubeContains(const Cube& outer, const Cube& inner)
+{
+    // outer̕ϐ͑SinnerɂlŊ܂܂Ă
+    return (outer.mCare & ~inner.mCare) == 0U && ((outer.mValue ^ inner.mValue) & outer.mCare) == 0U;
+}
+
+static inline bool CubesIntersect(const Cube& lhs, const Cube& rhs)
+{
+    return ((lhs.mValue ^ rhs.mValue) & lhs.mCare & rhs.mCare) == 0U;
+}
+
+static inline std::pair<std::size_t, std::size_t> CoverCost(const Cover& cover)
+{
+    // ύ̌D悵, ł΃ěŔׂ
+    std::size_t literalCount = 0U;
+
+    for (const Cube& cube : cover)
+        literalCount += PopulationCount(cube.mCare);
+
+    return { cover.size(), literalCount };
+}
+
+static void RemoveContainedCubes(Cover& cover)
+{
+    // 傫ύ珇Ɏc, ɎcύɊ܂܂͎̂̂Ă
+    std::stable_sort(cover.begin(), cover.end(), [](const Cube& lhs, const Cube& rhs) {
+        return PopulationCount(lhs.mCare) < PopulationCount(rhs.mCare); });
+
+    Cover result;
+
+    for (const Cube& cube : cover)
+        if (std::none_of(result.begin(), result.end(), [&cube](const Cube& kept) { return CubeContains(kept, cube); }))
+            result.push_back(cube);
+
+    cover = std::move(result);
+}
+
+static Cover Cofactor(const Cover& cover, const Cube& cube)
+{
+    Cover result;
+
+    for (const Cube& other : cover)
+        if (CubesIntersect(other, cube))
+            result.push_back(Cube { other.mCare & ~cube.mCare, other.mValue & ~cube.mCare });
+
+    return result;
+}
+
+static bool IsTautology(const Cover& cover, ResourceGovernor* governor)
+{
+    if (cover.empty())
+        return false;
+
+    // Xebv̏𒴂͍P^łȂƂ݂Ȃ (ύL菜肵Ȃ̂, Jo[͓Ȃ܂)
+    if (governor != nullptr && !governor->ChargeSteps(cover.size()))
+        return false;
+
+    std::uint64_t positive = 0U;
+    std::uint64_t negative = 0U;
+
+    for (const Cube& cube : cover) {
+        if (cube.mCare == 0U)
+            return true;
+
+        positive |= cube.mCare & cube.mValue;
+        negative |= cube.mCare & ~cube.mValue;
+    }
+
+    // PȃJo[͑S̐ύ܂ނƂ̂ݍP^
+    std::uint64_t binate = positive & negative;
+
+    if (binate == 0U)
+        return false;
+
+    // ł̐ύɌ闼ɐ̕ϐŕ
+    unsigned int splitVariable = 0U;
+    std::size_t maxOccurrences = 0U;
+
+    for (unsigned int i = 0; i < 64U; ++i) {
+        if (((binate >> i) & 1U) == 0U)
+            continue;
+
+        std::size_t occurrences = static_cast<std::size_t>(std::count_if(cover.begin(), cover.end(),
+            [i](const Cube& cube) { return ((cube.mCare >> i) & 1U) != 0U; }));
+
+        if (occurrences > maxOccurrences) {
+            maxOccurrences = occurrences;
+            splitVariable = i;
+        }
+    }
+
+    std::uint64_t bit = static_cast<std::uint64_t>(1U) << splitVariable;
+
+    return IsTautology(Cofactor(cover, Cube { bit, bit }), governor) && IsTautology(Cofactor(cover, Cube { bit, 0U }), governor);
+}
+
+static inline bool IsCovered(const Cube& cube, const Cover& cover, ResourceGovernor* governor)
+{
+    // ύJo[Ɋ܂܂  Jo[̐ύɂ]qP^
+    return IsTautology(Cofactor(cover, cube), governor);
+}
+
+// 區ɂŏ핢̕}@
+struct CoverSearch {
+    const std::vector<Cube>*                mPrimes;
+    std::vector<std::vector<std::uint32_t>> mMintermPrimes;
+    std::vector<std::vector<std::uint32_t>> mPrimeMinterms;
+    std::vector<std::uint32_t>              mCoverCounts;
+    std::vector<std::uint32_t>              mChosen;
+    std::vector<std::uint32_t>              mBest;
+    std::pair<std::size_t, std::size_t>     mBestCost;
+    std::size_t                             mUncovered;
+    std::uint64_t                           mNodes;
+};
+
+static std::pair<std::size_t, std::size_t> ChosenCost(const CoverSearch& search, const std::vector<std::uint32_t>& chosen)
+{
+    std::size_t literalCount = 0U;
+
+    for (std::uint32_t prime : chosen)
+        literalCount += PopulationCount((*search.mPrimes)[prime].mCare);
+
+    return { chosen.size(), literalCount };
+}
+
+static void ChoosePrime(CoverSearch& search, std::uint32_t prime, int delta)
+{
+    for (std::uint32_t minterm : search.mPrimeMinterms[prime]) {
+        if (delta > 0 && search.mCoverCounts[minterm]++ == 0U)
+            --search.mUncovered;
+        else if (delta < 0 && --search.mCoverCounts[minterm] == 0U)
+            ++search.mUncovered;
+    }
+}
+
+static void SearchCover(CoverSearch& search)
+{
+    // T̎Ԃ傫Ȃ肷, ܂ł̍ŗǉőł؂
+    if (++search.mNodes > 200000U)
+        return;
+
+    std::pair<std::size_t, std::size_t> cost = ChosenCost(search, search.mChosen);
+
+    if (search.mUncovered == 0U) {
+        if (cost < search.mBestCost) {
+            search.mBestCost = cost;
+            search.mBest = search.mChosen;
+        }
+
+        return;
+    }
+
+    // ȂƂ1͎區ǉ̂, ŗǉύȂȂ蓾ȂΎ}肷
+    if (cost.first + 1U > search.mBestCost.first)
+        return;
+
+    // 핢區łȂŏŕ򂷂
+    std::uint32_t branchMinterm = 0U;
+    std::size_t minPrimeCount = SIZE_MAX;
+
+    for (std::uint32_t i = 0; i < search.mCoverCounts.size(); ++i) {
+        if (search.mCoverCounts[i] == 0U && search.mMintermPrimes[i].size() < minPrimeCount) {
+            minPrimeCount = search.mMintermPrimes[i].size();
+            branchMinterm = i;
+        }
+    }
+
+    for (std::uint32_t prime : search.mMintermPrimes[branchMinterm]) {
+        search.mChosen.push_back(prime);
+        ChoosePrime(search, prime, 1);
+        SearchCover(search);
+        ChoosePrime(search, prime, -1);
+        search.mChosen.pop_back();
+    }
+}
+
+//
+// MinimizerNX
+//
+
+std::size_t Minimizer::LiteralCount() const
+{
+    return CoverCost(this->mCover).second;
+}
+
+void Minimizer::Reset()
+{
+    this->mVariableNames.clear();
+    this->mVariableIndices.clear();
+    this->mNegationNormalForms.clear();
+    this->mCovers.clear();
+    this->mCover.clear();
+}
+
+std::shared_ptr<BaseAST> Minimizer::ToNegationNormalForm(const std::shared_ptr<BaseAST>& logicalExprAST)
+{
+    assert(logicalExprAST != nullptr);
+
+    this->Reset();
+
+    return this->NegationNormalForm(logicalExprAST.get(), false);
+}
+
+std::shared_ptr<BaseAST> Minimizer::NegationNormalForm(const BaseAST* exprAST, bool negated)
+{
+    auto iter = this->mNegationNormalForms.find(std::make_pair(exprAST, negated));
+
+    if (iter != this->mNegationNormalForms.end())
+        return iter->second;
+
+    std::shared_ptr<BaseAST> normalForm;
+
+    // 2ZqAndOrŕ\, ے͕ϐ̒O܂ŉ
+    auto makeAndOr = [](const std::shared_ptr<BaseAST>& left, const std::shared_ptr<BaseAST>& right, bool isAnd) {
+        return std::make_shared<AndOrExpressionAST>(left, right, isAnd ? "" : ""); };
+
+    switch (exprAST->Type()) {
+        case ASTType::Constant:
+            normalForm = std::make_shared<ConstantAST>(static_cast<const ConstantAST*>(exprAST)->Value() != negated);
+            break;
+        case ASTType::Variable:
+        {
+            std::shared_ptr<BaseAST> variableAST = std::make_shared<VariableAST>(static_cast<const VariableAST*>(exprAST)->Name());
+            normalForm = negated ? std::make_shared<NotExpressionAST>(variableAST) : variableAST;
+            break;
+        }
+        case ASTType::Factor:
+            normalForm = this->NegationNormalForm(static_cast<const FactorAST*>(exprAST)->Expr().get(), negated);
+            break;
+        case ASTType::NotExpression:
+            normalForm = this->NegationNormalForm(static_cast<const NotExpressionAST*>(exprAST)->Expr().get(), !negated);
+            break;
+        case ASTType::AndOrExpression:
+        {
+            // hEK̖@
+            const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(exprAST);
+            bool isAnd = (andOrExprAST->Operator() == "") != negated;
+            std::vector<std::shared_ptr<BaseAST>> operands;
+
+            for (const auto& operand : andOrExprAST->Operands())
+                operands.push_back(this->NegationNormalForm(operand.get(), negated));
+
+            normalForm = std::make_shared<AndOrExpressionAST>(std::move(operands), isAnd ? "" : "");
+            break;
+        }
+        case ASTType::Expression:
+        {
+            const ExpressionAST* thenEqExprAST = static_cast<const ExpressionAST*>(exprAST);
+            const BaseAST* left = thenEqExprAST->Left().get();
+            const BaseAST* right = thenEqExprAST->Right().get();
+
+            if (thenEqExprAST->Operator() == "->") {
+                // a -> b́a  b, ̔ےa  b
+                normalForm = makeAndOr(this->NegationNormalForm(left, !negated), this->NegationNormalForm(right, negated), negated);
+            } else {
+                // a <-> b(a  b)  (a  b), ̔ے(a  b)  (a  b)
+                normalForm = makeAndOr(
+                    makeAndOr(this->NegationNormalForm(left, false), this->NegationNormalForm(right, negated), true),
+                    makeAndOr(this->NegationNormalForm(left, true), this->NegationNormalForm(right, !negated), true), false);
+            }
+
+            break;
+        }
+        case ASTType::XorExpression:
+        {
+            // a  b́(a  b)
+            const XorExpressionAST* xorExprAST = static_cast<const XorExpressionAST*>(exprAST);
+            bool isXor = (xorExprAST->Operator() == "") != negated;
+            const BaseAST* left = xorExprAST->Left().get();
+            const BaseAST* right = xorExprAST->Right().get();
+
+            normalForm = makeAndOr(
+                makeAndOr(this->NegationNormalForm(left, false), this->NegationNormalForm(right, isXor), true),
+                makeAndOr(this->NegationNormalForm(left, true), this->NegationNormalForm(right, !isXor), true), false);
+            break;
+        }
+        case ASTType::NandNorExpression:
+        {
+            // a  b́a  b, a  b́a  b
+            const NandNorExpressionAST* nandNorExprAST = static_cast<const NandNorExpressionAST*>(exprAST);
+            bool isNand = nandNorExprAST->Operator() == "";
+
+            normalForm = makeAndOr(this->NegationNormalForm(nandNorExprAST->Left().get(), !negated),
+                                   this->NegationNormalForm(nandNorExprAST->Right().get(), !negated), isNand == negated);
+            break;
+        }
+        default:
+            break;
+    }
+
+    this->mNegationNormalForms.emplace(std::make_pair(exprAST, negated), normalForm);
+
+    return normalForm;
+}
+
+std::optional<Cover> Minimizer::NodeToCover(const BaseAST* exprAST)
+{
+    auto iter = this->mCovers.find(exprAST);
+
+    if (iter != this->mCovers.end())
+        return iter->second;
+
+    Cover cover;
+
+    switch (exprAST->Type()) {
+        case ASTType::Constant:
+            if (static_cast<const ConstantAST*>(exprAST)->Value())
+                cover.push_back(Cube { 0U, 0U });
+            break;
+        case ASTType::Variable:
+        case ASTType::NotExpression:
+        {
+            // ےW`ł͔ے͕̒Kϐ
+            bool negated = (exprAST->Type() == ASTType::NotExpression);
+            const BaseAST* variableAST = negated ? static_cast<const NotExpressionAST*>(exprAST)->Expr().get() : exprAST;
+            const std::string& name = static_cast<const VariableAST*>(variableAST)->Name();
+            auto indexIter = this->mVariableIndices.find(name);
+
+            if (indexIter == this->mVariableIndices.end()) {
+                if (this->mVariableNames.size() >= MaxVariableCount)
+                    return std::nullopt;
+
+                indexIter = this->mVariableIndices.emplace(name, static_cast<std::uint32_t>(this->mVariableNames.size())).first;
+                this->mVariableNames.push_back(name);
+            }
+
+            std::uint64_t bit = static_cast<std::uint64_t>(1U) << indexIter->second;
+            cover.push_back(Cube { bit, negated ? 0U : bit });
+            break;
+        }
+        case ASTType::AndOrExpression:
+        {
+            const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(exprAST);
+            bool isAnd = (andOrExprAST->Operator() == "");
+
+            if (isAnd)
+                cover.push_back(Cube { 0U, 0U });
+
+            for (const auto& operand : andOrExprAST->Operands()) {
+                std::optional<Cover> operandCover = this->NodeToCover(operand.get());
+
+                if (!operandCover.has_value())
+                    return std::nullopt;
+
+                if (isAnd) {
+                    // ύǂ̐ςWJ
+                    if (cover.size() * operandCover.value().size() > this->mMaxCubeCount * 16U)
+                        return std::nullopt;
+
+                    if (this->mGovernor != nullptr && !this->mGovernor->ChargeSteps(cover.size() * operandCover.value().size()))
+                        return std::nullopt;
+
+                    Cover product;
+
+                    for (const Cube& lhs : cover)
+                        for (const Cube& rhs : operandCover.value())
+                            if (CubesIntersect(lhs, rhs))
+                                product.push_back(Cube { lhs.mCare | rhs.mCare, lhs.mValue | rhs.mValue });
+
+                    cover = std::move(product);
+                } else {
+                    cover.insert(cover.end(), operandCover.value().begin(), operandCover.value().end());
+                }
+
+                RemoveContainedCubes(cover);
+
+                if (cover.size() > this->mMaxCubeCount)
+                    return std::nullopt;
+            }
+
+            break;
+        }
+        default:
+            return std::nullopt;
+    }
+
+    this->mCovers.emplace(exprAST, cover);
+
+    return cover;
+}
+
+std::shared_ptr<BaseAST> Minimizer::Minimize(const std::shared_ptr<BaseAST>& logicalExprAST)
+{
+    assert(logicalExprAST != nullptr);
+
+    ScopedPhaseTimer phaseTimer(Phase::Minimize);
+
+    std::shared_ptr<BaseAST> normalForm = this->ToNegationNormalForm(logicalExprAST);
+
+    if (normalForm == nullptr)
+        return nullptr;
+
+    std::optional<Cover> cover = this->NodeToCover(normalForm.get());
+
+    if (!cover.has_value())
+        return nullptr;
+
+    if (this->mVariableNames.size() <= ExactVariableLimit)
+        this->mCover = this->MinimizeExact(cover.value());
+    else
+        this->mCover = this->MinimizeHeuristic(cover.value());
+
+    // rŃXebv̏𒴂ꍇ, ŏςłȂ̂ŎsƂ
+    if (this->mGovernor != nullptr && this->mGovernor->IsExhausted())
+        return nullptr;
+
+    return this->CoverToAST(this->mCover);
+}
+
+Cover Minimizer::MinimizeExact(const Cover& cover) const
+{
+    // Quine-McCluskey@: ŏ區, 區ɂŏ핢T
+    const std::size_t variableCount = this->mVariableNames.size();
+    const std::uint64_t fullCare = (static_cast<std::uint64_t>(1U) << variableCount) - 1U;
+    std::vector<std::uint64_t> minterms;
+
+    if (this->mGovernor != nullptr && !this->mGovernor->ChargeSteps((fullCare + 1U) * cover.size()))
+        return cover;
+
+    for (std::uint64_t minterm = 0; minterm <= fullCare; ++minterm)
+        if (std::any_of(cover.begin(), cover.end(), [minterm](const Cube& cube) {
+                return ((minterm ^ cube.mValue) & cube.mCare) == 0U; }))
+            minterms.push_back(minterm);
+
+    if (minterms.empty() || minterms.size() == fullCare + 1U)
+        return minterms.empty() ? Cover() : Cover { Cube { 0U, 0U } };
+
+    std::vector<Cube> primes;
+    std::set<std::pair<std::uint64_t, std::uint64_t>> implicants;
+
+    for (std::uint64_t minterm : minterms)
+        implicants.emplace(fullCare, minterm);
+
+    while (!implicants.empty()) {
+        std::set<std::pair<std::uint64_t, std::uint64_t>> merged;
+        std::set<std::pair<std::uint64_t, std::uint64_t>> used;
+
+        // 1ϐl̈قȂ܈Ӎ̑g܂Ƃ߂
+        for (const auto& implicant : implicants) {
+            for (std::uint64_t care = implicant.first; care != 0U; care &= care - 1U) {
+                std::uint64_t bit = care & (~care + 1U);
+
+                if ((implicant.second & bit) != 0U || implicants.count({ implicant.first, implicant.second | bit }) == 0U)
+                    continue;
+
+                merged.emplace(implicant.first & ~bit, implicant.second);
+                used.insert(implicant);
+                used.emplace(implicant.first, implicant.second | bit);
+            }
+        }
+
+        for (const auto& implicant : implicants)
+            if (used.count(implicant) == 0U)
+                primes.push_back(Cube { implicant.first, implicant.second });
+
+        implicants = std::move(merged);
+    }
+
+    CoverSearch search;
+    search.mPrimes = &primes;
+    search.mMintermPrimes.resize(minterms.size());
+    search.mPrimeMinterms.resize(primes.size());
+    search.mCoverCounts.assign(minterms.size(), 0U);
+    search.mUncovered = minterms.size();
+    search.mNodes = 0U;
+
+    for (std::uint32_t i = 0; i < minterms.size(); ++i) {
+        for (std::uint32_t j = 0; j < primes.size(); ++j) {
+            if (((minterms[i] ^ primes[j].mValue) & primes[j].mCare) == 0U) {
+                search.mMintermPrimes[i].push_back(j);
+                search.mPrimeMinterms[j].push_back(i);
+            }
+        }
+    }
+
+    // ×~@ɂŏ̏EƂ
+    std::vector<std::uint32_t> greedy;
+
+    while (search.mUncovered != 0U) {
+        std::uint32_t bestPrime = 0U;
+        std::pair<std::size_t, std::size_t> bestGain { 0U, 0U };
+
+        for (std::uint32_t j = 0; j < primes.size(); ++j) {
+            std::size_t gain = static_cast<std::size_t>(std::count_if(search.mPrimeMinterms[j].begin(), search.mPrimeMinterms[j].end(),
+                [&search](std::uint32_t minterm) { return search.mCoverCounts[minterm] == 0U; }));
+            std::pair<std::size_t, std::size_t> candidate { gain, 64U - PopulationCount(primes[j].mCare) };
+
+            if (candidate > bestGain) {
+                bestGain = candidate;
+                bestPrime = j;
+            }
+        }
+
+        greedy.push_back(bestPrime);
+        ChoosePrime(search, bestPrime, 1);
+    }
+
+    search.mBest = greedy;
+    search.mBestCost = ChosenCost(search, greedy);
+
+    for (std::uint32_t prime : greedy)
+        ChoosePrime(search, prime, -1);
+
+    SearchCover(search);
+
+    Cover result;
+
+    for (std::uint32_t prime : search.mBest)
+        result.push_back(primes[prime]);
+
+    return result;
+}
+
+Cover Minimizer::MinimizeHeuristic(const Cover& cover) const
+{
+    // expand, irredundantœreduceŏk߂ĂĂэL, PȂȂ܂ŌJԂ
+    Cover best = this->Irredundant(this->Expand(cover));
+    std::pair<std::size_t, std::size_t> bestCost = CoverCost(best);
+
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        Cover candidate = this->Irredundant(this->Expand(this->Reduce(best)));
+        std::pair<std::size_t, std::size_t> candidateCost = CoverCost(candidate);
+
+        if (candidateCost >= bestCost)
+            break;
+
+        best = std::move(candidate);
+        bestCost = candidateCost;
+    }
+
+    return best;
+}
+
+Cover Minimizer::Expand(const Cover& cover) const
+{
+    // eύ烊e1菜, ֐Ɋ܂܂͈͂ōő܂ōL
+    Cover sorted = cover;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Cube& lhs, const Cube& rhs) {
+        return PopulationCount(lhs.mCare) < PopulationCount(rhs.mCare); });
+
+    Cover result;
+
+    for (Cube cube : sorted) {
+        if (std::any_of(result.begin(), result.end(), [&cube](const Cube& expanded) { return CubeContains(expanded, cube); }))
+            continue;
+
+        for (std::uint64_t care = cube.mCare; care != 0U; care &= care - 1U) {
+            std::uint64_t bit = care & (~care + 1U);
+            Cube expanded { cube.mCare & ~bit, cube.mValue & ~bit };
+
+            if (IsCovered(expanded, cover, this->mGovernor))
+                cube = expanded;
+        }
+
+        result.erase(std::remove_if(result.begin(), result.end(), [&cube](const Cube& expanded) {
+            return CubeContains(cube, expanded); }), result.end());
+        result.push_back(cube);
+    }
+
+    return result;
+}
+
+Cover Minimizer::Irredundant(const Cover& cover) const
+{
+    // ̐ύ̘aɊ܂܂ύ, ȇ̂菜
+    Cover result = cover;
+    std::stable_sort(result.begin(), result.end(), [](const Cube& lhs, const Cube& rhs) {
+        return PopulationCount(lhs.mCare) > PopulationCount(rhs.mCare); });
+
+    for (std::size_t i = 0; i < result.size(); ) {
+        Cover others;
+        others.reserve(result.size() - 1U);
+
+        for (std::size_t j = 0; j < result.size(); ++j)
+            if (j != i)
+                others.push_back(result[j]);
+
+        if (IsCovered(result[i], others, this->mGovernor))
+            result.erase(result.begin() + static_cast<std::ptrdiff_t>(i));
+        else
+            ++i;
+    }
+
+    return result;
+}
+
+Cover Minimizer::Reduce(const Cover& cover) const
+{
+    // ̐ύŕĂ镔Ċeύk߂ (expandŕʂ̕ɍL)
+    Cover result = cover;
+    const std::uint64_t allVariables = (this->mVariableNames.size() >= 64U) ?
+        ~static_cast<std::uint64_t>(0U) : (static_cast<std::uint64_t>(1U) << this->mVariableNames.size()) - 1U;
+
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        Cover others;
+
+        for (std::size_t j = 0; j < result.size(); ++j)
+            if (j != i)
+                others.push_back(result[j]);
+
+        Cube& cube = result[i];
+
+        for (std::uint64_t free = allVariables & ~cube.mCare; free != 0U; free &= free - 1U) {
+            std::uint64_t bit = free & (~free + 1U);
+            Cube positive { cube.mCare | bit, cube.mValue | bit };
+            Cube negative { cube.mCare | bit, cube.mValue };
+
+            if (IsCovered(positive, others, this->mGovernor))
+                cube = negative;
+            else if (IsCovered(negative, others, this->mGovernor))
+                cube = positive;
+        }
+    }
+
+    return result;
+}
+
+std::shared_ptr<BaseAST> Minimizer::CoverToAST(const Cover& cover) const
+{
+    if (cover.empty())
+        return std::make_shared<ConstantAST>(false);
+
+    std::vector<std::shared_ptr<BaseAST>> terms;
+
+    for (const Cube& cube : cover) {
+        if (cube.mCare == 0U)
+            return std::make_shared<ConstantAST>(true);
+
+        std::vector<std::shared_ptr<BaseAST>> literals;
+
+        for (std::uint32_t i = 0; i < this->mVariableNames.size(); ++i) {
+            if (((cube.mCare >> i) & 1U) == 0U)
+                continue;
+
+            std::shared_ptr<BaseAST> variableAST = std::make_shared<VariableAST>(this->mVariableNames[i]);
+            literals.push_back(((cube.mValue >> i) & 1U) != 0U ? variableAST : std::make_shared<NotExpressionAST>(variableAST));
+        }
+
+        terms.push_back(literals.size() == 1U ? literals.front() :
+            std::make_shared<AndOrExpressionAST>(std::move(literals), ""));
+    }
+
+    if (terms.size() == 1U)
+        return terms.front();
+
+    return std::make_shared<AndOrExpressionAST>(std::move(terms), "");
+}
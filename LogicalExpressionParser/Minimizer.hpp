@@ -0,0 +1,87 @@
+// LogicalExpressionParser
+// Minimizer.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_MINIMIZER_HPP
+#define LOGICAL_EXPRESSION_PARSER_MINIMIZER_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class BaseAST;
+class ResourceGovernor;
+
+// ύ (mCarẽrbgĂϐ݂̂܂, ̒lmValue̓rbgɎ)
+struct Cube {
+    std::uint64_t   mCare;
+    std::uint64_t   mValue;
+};
+
+using Cover = std::vector<Cube>;
+
+/*
+2i_̍ŏ (Ϙa`)
+_ےW` (NNF) ɕϊĂύ̏W (Jo[) ɂ, ϐȂ
+Quine-McCluskey@Ō, EspressoƓlexpand, irredundant, reducěJԂ
+q[XeBbNɍŏ
+ύ̕ܔ̓Jo[̗]qP^ǂŒׂ̂, ے (OFFW) ͍Ȃ
+ */
+class Minimizer {
+public:
+    // ύ64rbgŕ\̂, ϐ64܂
+    static constexpr std::size_t MaxVariableCount = 64U;
+    // ȉ̕ϐ̌łΌɍŏ
+    static constexpr std::size_t ExactVariableLimit = 10U;
+
+    Minimizer() :
+        mMaxCubeCount(4096U),
+        mGovernor(nullptr) { }
+    ~Minimizer() = default;
+
+    // ےW`ւ̕ϊ̓rŃJo[̐ύ̌𒴂ƍŏ߂
+    inline void SetMaxCubeCount(std::size_t maxCubeCount) { this->mMaxCubeCount = maxCubeCount; }
+    // ύ̓WJƍP^̔ňύ̐XebvƂĉZ, 𒴂MinimizenullptrԂ
+    inline void SetGovernor(ResourceGovernor* governor) { this->mGovernor = governor; }
+
+    inline const std::vector<std::string>& Variables() const { return this->mVariableNames; }
+    // Oɍŏʂ̐ύƃě
+    inline std::size_t CubeCount() const { return this->mCover.size(); }
+    std::size_t LiteralCount() const;
+
+    // And, Or, ϐ̔ے, 萔݂̂Ȃ_ɕϊ (ʂ͋̕L)
+    std::shared_ptr<BaseAST> ToNegationNormalForm(const std::shared_ptr<BaseAST>& logicalExprAST);
+
+    // ȐϘa`̘_Ԃ (ϐ, ܂͐ύꍇnullptr)
+    std::shared_ptr<BaseAST> Minimize(const std::shared_ptr<BaseAST>& logicalExprAST);
+
+private:
+    void Reset();
+    std::shared_ptr<BaseAST> NegationNormalForm(const BaseAST* exprAST, bool negated);
+    std::optional<Cover> NodeToCover(const BaseAST* exprAST);
+    std::shared_ptr<BaseAST> CoverToAST(const Cover& cover) const;
+
+    Cover MinimizeExact(const Cover& cover) const;
+    Cover MinimizeHeuristic(const Cover& cover) const;
+    Cover Expand(const Cover& cover) const;
+    Cover Irredundant(const Cover& cover) const;
+    Cover Reduce(const Cover& cover) const;
+
+    std::size_t mMaxCubeCount;
+    ResourceGovernor* mGovernor;
+
+    std::vector<std::string> mVariableNames;
+    std::unordered_map<std::string, std::uint32_t> mVariableIndices;
+    std::map<std::pair<const BaseAST*, bool>, std::shared_ptr<BaseAST>> mNegationNormalForms;
+    std::unordered_map<const BaseAST*, Cover> mCovers;
+    Cover mCover;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_MINIMIZER_HPP
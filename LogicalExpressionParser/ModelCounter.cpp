@@ -0,0 +1,503 @@
+
+// LogicalExpressionParser
+// ModelCounter.cpp
+
+#include "ModelCounter.hpp"
+#include "AST.hpp"
+#include "ResourceGovernor.hpp"
+
+#include <algorithm>
+#include <limits>
+
+std::size_t ModelCounter::CacheKeyHash::operator()(const std::vector<std::uint32_t>& key) const
+{
+    // FNV-1a
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    for (std::uint32_t value : key) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    }
+
+    return static_cast<std::size_t>(hash);
+}
+
+std::optional<BigInteger> ModelCounter::Count(const std::shared_ptr<BaseAST>& logicalExprAST)
+{
+    assert(logicalExprAST != nullptr);
+
+    this->Reset();
+
+    // _Ŝ\e^łƂ߂
+    Literal rootLiteral = this->EncodeNode(logicalExprAST.get());
+    this->AddClause({ rootLiteral });
+
+    std::size_t variableCount = this->mValues.size();
+    this->mOccurrences.assign(variableCount * 2U, std::vector<std::uint32_t>());
+    this->mVariableMarks.assign(variableCount, 0U);
+    this->mClauseMarks.assign(this->mClauses.size(), 0U);
+
+    for (std::uint32_t i = 0; i < this->mClauses.size(); ++i)
+        for (Literal literal : this->mClauses[i])
+            this->mOccurrences[literal].push_back(i);
+
+    // Pʐ߂`d (߂͍Ȃ̂, ͒Pʐ߂ǂł̂݋N)
+    for (const auto& clause : this->mClauses) {
+        if (clause.size() != 1U)
+            continue;
+
+        int value = this->LiteralValue(clause[0]);
+
+        if (value == 0)
+            return BigInteger(0U);
+        if (value < 0)
+            this->Assign(clause[0]);
+    }
+
+    if (!this->Propagate())
+        return BigInteger(0U);
+
+    std::vector<std::uint32_t> clauseIndices(this->mClauses.size());
+    std::vector<std::uint32_t> variables(variableCount);
+
+    for (std::uint32_t i = 0; i < clauseIndices.size(); ++i)
+        clauseIndices[i] = i;
+    for (std::uint32_t i = 0; i < variables.size(); ++i)
+        variables[i] = i;
+
+    BigInteger modelCount = this->CountResidual(clauseIndices, variables);
+
+    if (this->mTimedOut)
+        return std::nullopt;
+
+    return modelCount;
+}
+
+void ModelCounter::Reset()
+{
+    this->mVariableNames.clear();
+    this->mVariableIndices.clear();
+    this->mClauses.clear();
+    this->mOccurrences.clear();
+    this->mValues.clear();
+    this->mTrail.clear();
+    this->mPropagationHead = 0U;
+    this->mClauseMarks.clear();
+    this->mVariableMarks.clear();
+    this->mMark = 0U;
+    this->mTrueLiteral.reset();
+    this->mCache.clear();
+    this->mStartTime = std::chrono::steady_clock::now();
+    this->mDecisions = 0U;
+    this->mNextLimitCheck = 0U;
+    this->mChargedDecisions = 0U;
+    this->mNextProgress = this->mProgressInterval;
+    this->mCacheHits = 0U;
+    this->mDepth = 0U;
+    this->mTimedOut = false;
+}
+
+ModelCounter::Literal ModelCounter::NewVariable()
+{
+    this->mValues.push_back(-1);
+    return static_cast<Literal>((this->mValues.size() - 1U) << 1);
+}
+
+void ModelCounter::AddClause(std::vector<Literal> clause)
+{
+    // de菜, P^Ȑ߂͉Ȃ
+    std::sort(clause.begin(), clause.end());
+    clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+
+    for (std::size_t i = 1; i < clause.size(); ++i)
+        if ((clause[i] ^ clause[i - 1U]) == 1U)
+            return;
+
+    this->mClauses.push_back(std::move(clause));
+}
+
+ModelCounter::Literal ModelCounter::EncodeNode(const BaseAST* exprAST)
+{
+    // Ƃɕ⏕ϐg𓱓, g <-> () \߂ (Tseitinϊ)
+    switch (exprAST->Type()) {
+        case ASTType::Constant:
+        {
+            if (!this->mTrueLiteral.has_value()) {
+                this->mTrueLiteral = this->NewVariable();
+                this->AddClause({ this->mTrueLiteral.value() });
+            }
+
+            bool value = static_cast<const ConstantAST*>(exprAST)->Value();
+            return value ? this->mTrueLiteral.value() : (this->mTrueLiteral.value() ^ 1U);
+        }
+        case ASTType::Variable:
+        {
+            // ̕ϐ͖OƂ1̕ϐɑΉ
+            const std::string& name = static_cast<const VariableAST*>(exprAST)->Name();
+            auto iter = this->mVariableIndices.find(name);
+
+            if (iter != this->mVariableIndices.end())
+                return static_cast<Literal>(iter->second << 1);
+
+            Literal literal = this->NewVariable();
+            this->mVariableIndices.emplace(name, literal >> 1);
+            this->mVariableNames.push_back(name);
+
+            return literal;
+        }
+        case ASTType::Factor:
+            return this->EncodeNode(static_cast<const FactorAST*>(exprAST)->Expr().get());
+        case ASTType::NotExpression:
+            // ے͕⏕ϐg킸Ƀe𔽓]
+            return this->EncodeNode(static_cast<const NotExpressionAST*>(exprAST)->Expr().get()) ^ 1U;
+        case ASTType::AndOrExpression:
+        {
+            // Or̓hEK̖@Andɒ: g <-> (a1  ...  an)
+            const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(exprAST);
+            Literal polarity = (andOrExprAST->Operator() == "") ? 1U : 0U;
+            std::vector<Literal> operandLiterals;
+
+            for (const auto& operand : andOrExprAST->Operands())
+                operandLiterals.push_back(this->EncodeNode(operand.get()) ^ polarity);
+
+            Literal gateLiteral = this->NewVariable();
+            std::vector<Literal> longClause { gateLiteral };
+
+            for (Literal operandLiteral : operandLiterals) {
+                this->AddClause({ gateLiteral ^ 1U, operandLiteral });
+                longClause.push_back(operandLiteral ^ 1U);
+            }
+
+            this->AddClause(std::move(longClause));
+
+            return gateLiteral ^ polarity;
+        }
+        case ASTType::Expression:
+        case ASTType::XorExpression:
+        case ASTType::NandNorExpression:
+            break;
+        default:
+            assert(false);
+            return this->NewVariable();
+    }
+
+    // 2Zq
+    std::shared_ptr<BaseAST> leftExprAST;
+    std::shared_ptr<BaseAST> rightExprAST;
+    std::string op;
+
+    if (exprAST->Type() == ASTType::Expression) {
+        leftExprAST = static_cast<const ExpressionAST*>(exprAST)->Left();
+        rightExprAST = static_cast<const ExpressionAST*>(exprAST)->Right();
+        op = static_cast<const ExpressionAST*>(exprAST)->Operator();
+    } else if (exprAST->Type() == ASTType::XorExpression) {
+        leftExprAST = static_cast<const XorExpressionAST*>(exprAST)->Left();
+        rightExprAST = static_cast<const XorExpressionAST*>(exprAST)->Right();
+        op = static_cast<const XorExpressionAST*>(exprAST)->Operator();
+    } else {
+        leftExprAST = static_cast<const NandNorExpressionAST*>(exprAST)->Left();
+        rightExprAST = static_cast<const NandNorExpressionAST*>(exprAST)->Right();
+        op = static_cast<const NandNorExpressionAST*>(exprAST)->Operator();
+    }
+
+    Literal leftLiteral = this->EncodeNode(leftExprAST.get());
+    Literal rightLiteral = this->EncodeNode(rightExprAST.get());
+    Literal gateLiteral = this->NewVariable();
+
+    if (op == "<->" || op == "" || op == "") {
+        // g <-> (a <-> b), Xor͂̔ے
+        this->AddClause({ gateLiteral ^ 1U, leftLiteral ^ 1U, rightLiteral });
+        this->AddClause({ gateLiteral ^ 1U, leftLiteral, rightLiteral ^ 1U });
+        this->AddClause({ gateLiteral, leftLiteral, rightLiteral });
+        this->AddClause({ gateLiteral, leftLiteral ^ 1U, rightLiteral ^ 1U });
+
+        return (op == "") ? (gateLiteral ^ 1U) : gateLiteral;
+    }
+
+    // a -> ba  b̔ے, NandAnd̔ے, Noŕa  bƂ g <-> (x  y) 
+    Literal x = leftLiteral;
+    Literal y = rightLiteral;
+    Literal polarity = 1U;
+
+    if (op == "->") {
+        y ^= 1U;
+    } else if (op == "") {
+        x ^= 1U;
+        y ^= 1U;
+        polarity = 0U;
+    }
+
+    this->AddClause({ gateLiteral ^ 1U, x });
+    this->AddClause({ gateLiteral ^ 1U, y });
+    this->AddClause({ gateLiteral, x ^ 1U, y ^ 1U });
+
+    return gateLiteral ^ polarity;
+}
+
+void ModelCounter::Assign(Literal literal)
+{
+    assert(this->mValues[literal >> 1] < 0);
+
+    this->mValues[literal >> 1] = static_cast<std::int8_t>((literal & 1U) ^ 1U);
+    this->mTrail.push_back(literal);
+}
+
+bool ModelCounter::Propagate()
+{
+    // UɂȂe܂ސ߂݂̂𒲂ׂ
+    while (this->mPropagationHead < this->mTrail.size()) {
+        Literal falseLiteral = this->mTrail[this->mPropagationHead++] ^ 1U;
+
+        for (std::uint32_t clauseIndex : this->mOccurrences[falseLiteral]) {
+            const std::vector<Literal>& clause = this->mClauses[clauseIndex];
+            std::size_t unassignedCount = 0U;
+            Literal unassignedLiteral = 0U;
+            bool satisfied = false;
+
+            for (Literal literal : clause) {
+                int value = this->LiteralValue(literal);
+
+                if (value > 0) {
+                    satisfied = true;
+                    break;
+                }
+
+                if (value < 0) {
+                    ++unassignedCount;
+                    unassignedLiteral = literal;
+                }
+            }
+
+            if (satisfied)
+                continue;
+            if (unassignedCount == 0U)
+                return false;
+            if (unassignedCount == 1U)
+                this->Assign(unassignedLiteral);
+        }
+    }
+
+    return true;
+}
+
+void ModelCounter::Undo(std::size_t trailSize)
+{
+    while (this->mTrail.size() > trailSize) {
+        this->mValues[this->mTrail.back() >> 1] = -1;
+        this->mTrail.pop_back();
+    }
+
+    this->mPropagationHead = std::min(this->mPropagationHead, trailSize);
+}
+
+bool ModelCounter::IsSatisfied(std::uint32_t clauseIndex) const
+{
+    for (Literal literal : this->mClauses[clauseIndex])
+        if (this->LiteralValue(literal) > 0)
+            return true;
+
+    return false;
+}
+
+BigInteger ModelCounter::CountComponent(const std::vector<std::uint32_t>& clauseIndices)
+{
+    if (!this->CheckLimits())
+        return BigInteger(0U);
+
+    // c̐߂̏W͓̂, LbV
+    std::vector<std::uint32_t> cacheKey;
+    this->MakeCacheKey(clauseIndices, cacheKey);
+
+    auto iter = this->mCache.find(cacheKey);
+
+    if (iter != this->mCache.end()) {
+        ++this->mCacheHits;
+        return iter->second;
+    }
+
+    // ł̐߂Ɍϐŕ򂷂
+    std::vector<std::uint32_t> variables;
+    std::uint32_t mark = ++this->mMark;
+
+    for (std::uint32_t clauseIndex : clauseIndices) {
+        for (Literal literal : this->mClauses[clauseIndex]) {
+            std::uint32_t variable = literal >> 1;
+
+            if (this->mValues[variable] < 0 && this->mVariableMarks[variable] != mark) {
+                this->mVariableMarks[variable] = mark;
+                variables.push_back(variable);
+            }
+        }
+    }
+
+    std::uint32_t branchVariable = variables.front();
+    std::size_t branchOccurrences = 0U;
+
+    for (std::uint32_t variable : variables) {
+        std::size_t occurrences = this->mOccurrences[variable << 1].size() + this->mOccurrences[(variable << 1) | 1U].size();
+
+        if (occurrences > branchOccurrences) {
+            branchVariable = variable;
+            branchOccurrences = occurrences;
+        }
+    }
+
+    ++this->mDecisions;
+    ++this->mDepth;
+
+    BigInteger modelCount;
+
+    for (Literal polarity = 0U; polarity < 2U && !this->mTimedOut; ++polarity) {
+        std::size_t trailSize = this->mTrail.size();
+        this->Assign((branchVariable << 1) | polarity);
+
+        if (this->Propagate())
+            modelCount += this->CountResidual(clauseIndices, variables);
+
+        this->Undo(trailSize);
+    }
+
+    --this->mDepth;
+
+    if (this->mTimedOut)
+        return BigInteger(0U);
+
+    if (this->mCache.size() >= this->mCacheLimit)
+        this->mCache.clear();
+
+    this->mCache.emplace(std::move(cacheKey), modelCount);
+
+    return modelCount;
+}
+
+BigInteger ModelCounter::CountResidual(const std::vector<std::uint32_t>& clauseIndices,
+                                       const std::vector<std::uint32_t>& variables)
+{
+    // [ĂȂ߂LϐłȂAɕ, Ƃ̌̐ς
+    std::uint32_t remainingMark = ++this->mMark;
+    std::uint32_t visitedMark = ++this->mMark;
+    std::vector<std::uint32_t> remainingClauses;
+
+    for (std::uint32_t clauseIndex : clauseIndices) {
+        if (!this->IsSatisfied(clauseIndex)) {
+            this->mClauseMarks[clauseIndex] = remainingMark;
+            remainingClauses.push_back(clauseIndex);
+        }
+    }
+
+    std::vector<std::vector<std::uint32_t>> components;
+
+    for (std::uint32_t firstClause : remainingClauses) {
+        if (this->mClauseMarks[firstClause] != remainingMark)
+            continue;
+
+        std::vector<std::uint32_t> component { firstClause };
+        this->mClauseMarks[firstClause] = visitedMark;
+
+        for (std::size_t i = 0; i < component.size(); ++i) {
+            for (Literal literal : this->mClauses[component[i]]) {
+                std::uint32_t variable = literal >> 1;
+
+                if (this->mValues[variable] >= 0 || this->mVariableMarks[variable] == visitedMark)
+                    continue;
+
+                this->mVariableMarks[variable] = visitedMark;
+
+                for (Literal variableLiteral : { variable << 1, (variable << 1) | 1U }) {
+                    for (std::uint32_t clauseIndex : this->mOccurrences[variableLiteral]) {
+                        if (this->mClauseMarks[clauseIndex] == remainingMark) {
+                            this->mClauseMarks[clauseIndex] = visitedMark;
+                            component.push_back(clauseIndex);
+                        }
+                    }
+                }
+            }
+        }
+
+        components.push_back(std::move(component));
+    }
+
+    // ǂ̐߂ɂȂȂϐ͎RɒlIׂ
+    std::size_t freeVariableCount = 0U;
+
+    for (std::uint32_t variable : variables)
+        if (this->mValues[variable] < 0 && this->mVariableMarks[variable] != visitedMark)
+            ++freeVariableCount;
+
+    BigInteger modelCount = BigInteger::PowerOfTwo(freeVariableCount);
+
+    for (const auto& component : components) {
+        BigInteger componentCount = this->CountComponent(component);
+
+        if (componentCount.IsZero())
+            return BigInteger(0U);
+
+        modelCount *= componentCount;
+    }
+
+    return modelCount;
+}
+
+void ModelCounter::MakeCacheKey(const std::vector<std::uint32_t>& clauseIndices, std::vector<std::uint32_t>& cacheKey) const
+{
+    // e߂̖蓖Ẵe, ߂̏ɈˑȂ悤ɐ񂷂
+    std::vector<std::vector<std::uint32_t>> clauses;
+    clauses.reserve(clauseIndices.size());
+
+    for (std::uint32_t clauseIndex : clauseIndices) {
+        std::vector<std::uint32_t> clause;
+
+        for (Literal literal : this->mClauses[clauseIndex])
+            if (this->LiteralValue(literal) < 0)
+                clause.push_back(literal);
+
+        clauses.push_back(std::move(clause));
+    }
+
+    std::sort(clauses.begin(), clauses.end());
+
+    for (const auto& clause : clauses) {
+        cacheKey.insert(cacheKey.end(), clause.begin(), clause.end());
+        cacheKey.push_back(std::numeric_limits<std::uint32_t>::max());
+    }
+}
+
+bool ModelCounter::CheckLimits()
+{
+    if (this->mTimedOut)
+        return false;
+
+    // ̎擾͕256񂲂Ƃɍs
+    if (this->mDecisions < this->mNextLimitCheck)
+        return true;
+
+    this->mNextLimitCheck = this->mDecisions + 256U;
+
+    if (this->mGovernor != nullptr) {
+        bool charged = this->mGovernor->ChargeSteps(this->mDecisions - this->mChargedDecisions);
+        this->mChargedDecisions = this->mDecisions;
+
+        if (!charged) {
+            this->mTimedOut = true;
+            return false;
+        }
+    }
+
+    auto elapsedTime = std::chrono::steady_clock::now() - this->mStartTime;
+
+    if (this->mTimeout != std::chrono::milliseconds::zero() && elapsedTime >= this->mTimeout) {
+        this->mTimedOut = true;
+        return false;
+    }
+
+    if (this->mProgressCallback && this->mProgressInterval != 0U && this->mDecisions >= this->mNextProgress) {
+        this->mNextProgress = this->mDecisions + this->mProgressInterval;
+
+        ModelCounterProgress progress {
+            this->mDecisions, this->mCacheHits, this->mCache.size(), this->mDepth,
+            std::chrono::duration<double>(elapsedTime).count() };
+        this->mProgressCallback(progress);
+    }
+
+    return true;
+}
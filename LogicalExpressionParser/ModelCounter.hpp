@@ -0,0 +1,123 @@
+// LogicalExpressionParser
+// ModelCounter.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_MODEL_COUNTER_HPP
+#define LOGICAL_EXPRESSION_PARSER_MODEL_COUNTER_HPP
+
+#pragma once
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BigInteger.hpp"
+
+class BaseAST;
+class ResourceGovernor;
+
+struct ModelCounterProgress {
+    std::uint64_t   mDecisions;
+    std::uint64_t   mCacheHits;
+    std::size_t     mCacheEntries;
+    std::size_t     mDepth;
+    double          mElapsedSeconds;
+};
+
+/*
+[銄蓖Ă̌̌Ȑグ (#SAT)
+_TseitinϊŘAW`ɂ, , Pʓ`d, Aւ̕, Ƃ̌ʂ
+LbVgݍ킹TŐ (Tseitinϊ̕⏕ϐ͌̕ϐňӂɌ܂̂Ō͕ςȂ)
+Ɨɕ_ł, Sϐł^l\炸ɐ
+ */
+class ModelCounter {
+public:
+    ModelCounter() :
+        mTimeout(std::chrono::milliseconds::zero()),
+        mProgressInterval(0U),
+        mCacheLimit(1U << 20),
+        mGovernor(nullptr) { }
+    ~ModelCounter() = default;
+
+    // Ԑ؂ɂȂCountstd::nulloptԂ (0͎ԐȂ)
+    inline void SetTimeout(std::chrono::milliseconds timeout) { this->mTimeout = timeout; }
+    // ̉񐔂interval񑝂邲Ƃɐiʒm
+    inline void SetProgressCallback(const std::function<void(const ModelCounterProgress&)>& progressCallback,
+                                    std::uint64_t interval) {
+        this->mProgressCallback = progressCallback; this->mProgressInterval = interval; }
+    // LbV̍ڐ𒴂ƑSĔj
+    inline void SetCacheLimit(std::size_t cacheLimit) { this->mCacheLimit = cacheLimit; }
+    // ̉񐔂XebvƂĉZ, 𒴂ƎԐ؂Ɠł؂ (Z͎̊mFƓԊuōs)
+    inline void SetGovernor(ResourceGovernor* governor) { this->mGovernor = governor; }
+
+    // _Ɍϐ (グ̑ΏۂƂȂϐ)
+    inline const std::vector<std::string>& Variables() const { return this->mVariableNames; }
+    inline std::uint64_t Decisions() const { return this->mDecisions; }
+    inline std::uint64_t CacheHits() const { return this->mCacheHits; }
+    // Ԃ܂̓Xebv̏𒴂đł؂ꍇtrue
+    inline bool TimedOut() const { return this->mTimedOut; }
+
+    std::optional<BigInteger> Count(const std::shared_ptr<BaseAST>& logicalExprAST);
+
+private:
+    // e͕ϐԍ * 2 + (ےł1)
+    using Literal = std::uint32_t;
+
+    struct CacheKeyHash {
+        std::size_t operator()(const std::vector<std::uint32_t>& key) const;
+    };
+
+    void Reset();
+    Literal EncodeNode(const BaseAST* exprAST);
+    Literal NewVariable();
+    void AddClause(std::vector<Literal> clause);
+
+    inline int LiteralValue(Literal literal) const {
+        std::int8_t value = this->mValues[literal >> 1];
+        return value < 0 ? -1 : (value ^ static_cast<int>(literal & 1U)); }
+    void Assign(Literal literal);
+    bool Propagate();
+    void Undo(std::size_t trailSize);
+    bool IsSatisfied(std::uint32_t clauseIndex) const;
+
+    BigInteger CountComponent(const std::vector<std::uint32_t>& clauseIndices);
+    BigInteger CountResidual(const std::vector<std::uint32_t>& clauseIndices,
+                             const std::vector<std::uint32_t>& variables);
+    void MakeCacheKey(const std::vector<std::uint32_t>& clauseIndices, std::vector<std::uint32_t>& cacheKey) const;
+    bool CheckLimits();
+
+    std::chrono::milliseconds mTimeout;
+    std::function<void(const ModelCounterProgress&)> mProgressCallback;
+    std::uint64_t mProgressInterval;
+    std::size_t mCacheLimit;
+    ResourceGovernor* mGovernor;
+
+    std::vector<std::string> mVariableNames;
+    std::unordered_map<std::string, std::uint32_t> mVariableIndices;
+    std::vector<std::vector<Literal>> mClauses;
+    std::vector<std::vector<std::uint32_t>> mOccurrences;
+    std::vector<std::int8_t> mValues;
+    std::vector<Literal> mTrail;
+    std::size_t mPropagationHead;
+    std::vector<std::uint32_t> mClauseMarks;
+    std::vector<std::uint32_t> mVariableMarks;
+    std::uint32_t mMark;
+    std::optional<Literal> mTrueLiteral;
+
+    std::unordered_map<std::vector<std::uint32_t>, BigInteger, CacheKeyHash> mCache;
+    std::chrono::steady_clock::time_point mStartTime;
+    std::uint64_t mDecisions;
+    std::uint64_t mNextLimitCheck;
+    std::uint64_t mChargedDecisions;
+    std::uint64_t mNextProgress;
+    std::uint64_t mCacheHits;
+    std::size_t mDepth;
+    bool mTimedOut;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_MODEL_COUNTER_HPP
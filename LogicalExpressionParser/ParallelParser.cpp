@@ -0,0 +1,579 @@
+
+// LogicalExpressionParser
+// ParallelParser.cpp
+
+#include "ParallelParser.hpp"
+#include "AST.hpp"
+#include "LatencyTracing.hpp"
+#include "Parser.hpp"
+#include "PerformanceCounters.hpp"
+#include "ResourceGovernor.hpp"
+#include "Token.hpp"
+
+#include <algorithm>
+#include <limits>
+
+// g[N̈ʒuƒ, ʂ̐[32rbgŎ (͂͒ɏ)
+static constexpr std::size_t MaxParallelSize = std::numeric_limits<std::uint32_t>::max();
+
+static inline bool IsBinaryOperatorToken(TokenType tokenType)
+{
+    return FindBinaryOperator(tokenType) != nullptr;
+}
+
+// ɃIyhg[N (͂̐擪)
+static inline bool ExpectsOperand(TokenType tokenType)
+{
+    return tokenType == TokenType::LeftParenthesis || tokenType == TokenType::Not || IsBinaryOperatorToken(tokenType);
+}
+
+// Iyh̐擪ɂȂ肤g[N
+static inline bool StartsOperand(TokenType tokenType)
+{
+    return tokenType == TokenType::LeftParenthesis || tokenType == TokenType::Not ||
+           tokenType == TokenType::True || tokenType == TokenType::False || tokenType == TokenType::Variable;
+}
+
+// Õg[NɑĂ悢g[N (BracketIndex::Build̏ԑJڂƓ)
+static inline bool CanFollow(TokenType previousType, TokenType tokenType)
+{
+    return ExpectsOperand(previousType) ? StartsOperand(tokenType) :
+           (tokenType == TokenType::RightParenthesis || IsBinaryOperatorToken(tokenType));
+}
+
+ParallelParser::ParallelParser(ForkJoinPool& pool, std::size_t grainSize, std::size_t lexChunkSize) :
+    mPool(pool),
+    mGrainSize(std::max<std::size_t>(grainSize, 1U)),
+    mLexChunkSize(std::max<std::size_t>(lexChunkSize, 1U)),
+    mRelexedChunks(0U),
+    mFellBack(false),
+    mTokenStream(std::make_shared<TokenStream>()),
+    mParsingTokens(nullptr)
+{
+}
+
+void ParallelParser::ForEachChunk(std::size_t chunkCount, const std::function<void(std::size_t)>& runChunk)
+{
+    if (chunkCount == 0U)
+        return;
+
+    ForkJoinPool::TaskGroup taskGroup(this->mPool);
+
+    for (std::size_t i = chunkCount - 1U; i > 0U; --i)
+        taskGroup.Spawn([&runChunk, i]() { runChunk(i); });
+
+    runChunk(0U);
+    taskGroup.Wait();
+}
+
+//
+// 
+//
+
+template <typename AddToken>
+bool ParallelParser::LexRange(const std::string& logicalExpr, std::size_t beginOffset, std::size_t endOffset,
+                              AddToken&& addToken, LexError& error)
+{
+    // ̖͂ɂ͋؂̋󔒂1̂ƂĈ
+    std::size_t inputSize = logicalExpr.size();
+    auto charAt = [&logicalExpr, inputSize](std::size_t index) {
+        return (index < inputSize) ? logicalExpr[index] : (index == inputSize) ? ' ' : '\0'; };
+
+    std::size_t i = beginOffset;
+
+    while (i < endOffset) {
+        char currentChar = logicalExpr[i];
+
+        if (std::isspace(currentChar)) {
+            ++i;
+        } else if (std::isalpha(currentChar) || currentChar == '_') {
+            std::size_t tokenEnd = i + 1U;
+
+            while (tokenEnd < inputSize && (std::isalnum(logicalExpr[tokenEnd]) || logicalExpr[tokenEnd] == '_'))
+                ++tokenEnd;
+
+            addToken(i, tokenEnd - i, IdentifierTokenType(std::string_view(logicalExpr.data() + i, tokenEnd - i)));
+            i = tokenEnd;
+        } else if (currentChar == '(') {
+            addToken(i++, 1U, TokenType::LeftParenthesis);
+        } else if (currentChar == ')') {
+            addToken(i++, 1U, TokenType::RightParenthesis);
+        } else if (currentChar == '-' && charAt(i + 1U) == '>') {
+            addToken(i, 2U, TokenType::Then);
+            i += 2U;
+        } else if (currentChar == '<' && charAt(i + 1U) == '-' && charAt(i + 2U) == '>') {
+            addToken(i, 3U, TokenType::Eq);
+            i += 3U;
+        } else if (currentChar == '<') {
+            // LexerƓ, l̋LłȂ̈ʒu񍐂
+            std::size_t errorOffset = (charAt(i + 1U) != '-') ? i + 1U : i + 2U;
+            error = LexError { DiagnosticCode::InvalidCharacter, errorOffset, charAt(errorOffset) };
+            return false;
+        } else {
+            error = LexError { DiagnosticCode::InvalidCharacter, i, currentChar };
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ParallelParser::CountTokens(const std::string& logicalExpr, std::size_t beginOffset, std::size_t endOffset,
+                                 LexedChunk& chunk)
+{
+    chunk.mBeginOffset = beginOffset;
+    chunk.mEndOffset = beginOffset;
+    chunk.mTokenCount = 0U;
+    chunk.mError = LexError { DiagnosticCode::None, 0U, '\0' };
+
+    LexRange(logicalExpr, beginOffset, endOffset, [&chunk](std::size_t offset, std::size_t length, TokenType) {
+        ++chunk.mTokenCount;
+        chunk.mEndOffset = offset + length;
+    }, chunk.mError);
+}
+
+bool ParallelParser::Lex(const std::string& logicalExpr, TokenStream& tokenStream, Diagnostics* diagnostics,
+                         ResourceGovernor* governor)
+{
+    this->mRelexedChunks = 0U;
+
+    if (logicalExpr.size() > MaxParallelSize)
+        return Lexer(logicalExpr, tokenStream, diagnostics, governor);
+
+    ScopedPhaseTimer phaseTimer(Phase::Lex);
+
+    if (governor != nullptr && !governor->CheckInputBytes(logicalExpr.size())) {
+        if (diagnostics != nullptr)
+            diagnostics->Report(DiagnosticCode::InputTooLarge, governor->Limits().mMaxInputBytes, 0U);
+        return false;
+    }
+
+    // e`Ñg[N𓊋@Iɐ
+    std::size_t chunkCount = std::max<std::size_t>((logicalExpr.size() + this->mLexChunkSize - 1U) / this->mLexChunkSize, 1U);
+    this->mLexedChunks.resize(chunkCount);
+
+    this->ForEachChunk(chunkCount, [this, &logicalExpr](std::size_t chunkIndex) {
+        std::size_t beginOffset = chunkIndex * this->mLexChunkSize;
+        std::size_t endOffset = std::min(beginOffset + this->mLexChunkSize, logicalExpr.size());
+        CountTokens(logicalExpr, beginOffset, endOffset, this->mLexedChunks[chunkIndex]);
+    });
+
+    std::size_t tokenCount = 0U;
+
+    if (!this->Stitch(logicalExpr, diagnostics, governor, tokenCount))
+        return false;
+
+    // `NƂ, p킹Ō߂g[N̋؂肩玚͂ăg[Nɏ
+    tokenStream.Resize(tokenCount);
+
+    this->ForEachChunk(chunkCount, [this, &logicalExpr, &tokenStream](std::size_t chunkIndex) {
+        const LexedChunk& chunk = this->mLexedChunks[chunkIndex];
+        std::size_t endOffset = std::min((chunkIndex + 1U) * this->mLexChunkSize, logicalExpr.size());
+        std::size_t tokenIndex = chunk.mFirstIndex;
+        LexError error;
+
+        LexRange(logicalExpr, chunk.mBeginOffset, endOffset,
+            [&logicalExpr, &tokenStream, &tokenIndex](std::size_t offset, std::size_t length, TokenType tokenType) {
+                tokenStream.SetToken(tokenIndex++, std::string_view(logicalExpr.data() + offset, length), tokenType, offset);
+            }, error);
+
+        assert(tokenIndex == chunk.mFirstIndex + chunk.mTokenCount);
+    });
+
+    if (governor != nullptr)
+        governor->ChargeTokens(tokenCount);
+
+    return true;
+}
+
+bool ParallelParser::Stitch(const std::string& logicalExpr, Diagnostics* diagnostics, ResourceGovernor* governor,
+                            std::size_t& tokenCount)
+{
+    // Õ`N珇, Oɍ̗pg[N̖ (g[N̋؂) gg[N߂
+    std::size_t resumeOffset = 0U;
+    tokenCount = 0U;
+
+    for (std::size_t chunkIndex = 0; chunkIndex < this->mLexedChunks.size(); ++chunkIndex) {
+        LexedChunk& chunk = this->mLexedChunks[chunkIndex];
+        std::size_t beginOffset = chunkIndex * this->mLexChunkSize;
+        std::size_t endOffset = std::min(beginOffset + this->mLexChunkSize, logicalExpr.size());
+
+        chunk.mFirstIndex = tokenCount;
+
+        // Õg[N`NŜ𕢂Ă
+        if (resumeOffset >= endOffset) {
+            CountTokens(logicalExpr, endOffset, endOffset, chunk);
+            continue;
+        }
+
+        if (resumeOffset > beginOffset) {
+            // @IȎ͂̂resumeOffsetOŎn܂g[N𐔂,
+            // resumeOffset܂g[NG[, ȍ~̃g[N͓@IȌʂƈv
+            LexedChunk prefixChunk;
+            CountTokens(logicalExpr, beginOffset, resumeOffset, prefixChunk);
+
+            if (prefixChunk.mEndOffset <= resumeOffset && prefixChunk.mError.mCode == DiagnosticCode::None) {
+                chunk.mBeginOffset = resumeOffset;
+                chunk.mTokenCount -= prefixChunk.mTokenCount;
+            } else {
+                CountTokens(logicalExpr, resumeOffset, endOffset, chunk);
+                ++this->mRelexedChunks;
+            }
+        }
+
+        tokenCount += chunk.mTokenCount;
+
+        if (chunk.mError.mCode != DiagnosticCode::None) {
+            if (diagnostics != nullptr)
+                diagnostics->Report(chunk.mError.mCode, chunk.mError.mOffset, tokenCount, 0U, chunk.mError.mCharacter);
+            return false;
+        }
+
+        if (chunk.mTokenCount > 0U)
+            resumeOffset = std::max(resumeOffset, chunk.mEndOffset);
+    }
+
+    if (governor != nullptr) {
+        std::size_t maxTokenCount = (governor->TokenCount() < governor->Limits().mMaxTokens) ?
+            governor->Limits().mMaxTokens - governor->TokenCount() : 0U;
+
+        if (tokenCount > maxTokenCount) {
+            // 𒴂ŏ̃g[N̈ʒu񍐂
+            std::size_t excessOffset = logicalExpr.size();
+
+            for (const auto& chunk : this->mLexedChunks) {
+                if (maxTokenCount < chunk.mFirstIndex + chunk.mTokenCount) {
+                    std::size_t tokenIndex = chunk.mFirstIndex;
+                    LexError error;
+
+                    LexRange(logicalExpr, chunk.mBeginOffset, chunk.mEndOffset,
+                        [&](std::size_t offset, std::size_t, TokenType) {
+                            if (tokenIndex++ == maxTokenCount)
+                                excessOffset = offset;
+                        }, error);
+                    break;
+                }
+            }
+
+            governor->ChargeTokens(maxTokenCount + 1U);
+
+            if (diagnostics != nullptr)
+                diagnostics->Report(DiagnosticCode::TooManyTokens, excessOffset, maxTokenCount + 1U, 0U);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//
+// \
+//
+
+std::shared_ptr<BaseAST> ParallelParser::Parse(const std::string& logicalExpr, Notation* lastNotation, Diagnostics& diagnostics,
+                                               ResourceGovernor* governor)
+{
+    if (!this->Lex(logicalExpr, *this->mTokenStream, &diagnostics, governor))
+        return nullptr;
+
+    return this->Parse(this->mTokenStream, lastNotation, diagnostics, governor);
+}
+
+std::shared_ptr<BaseAST> ParallelParser::Parse(const std::shared_ptr<TokenStream>& tokenStream, Notation* lastNotation,
+                                               Diagnostics& diagnostics, ResourceGovernor* governor)
+{
+    assert(tokenStream != nullptr);
+
+    // Ǘꍇ, [ƃm[h\͂̏ɐ邽ߒɍ\͂
+    this->mFellBack = governor != nullptr || tokenStream->IsStreaming() ||
+        tokenStream->TokenCount() == 0U || tokenStream->TokenCount() >= MaxParallelSize || !this->IndexBrackets(*tokenStream);
+
+    if (this->mFellBack) {
+        tokenStream->SetCurrentIndex(0U);
+        return ParseLogicalExpression(tokenStream, lastNotation, diagnostics, governor);
+    }
+
+    if (lastNotation != nullptr)
+        *lastNotation = Notation::Infix;
+
+    ScopedPhaseTimer phaseTimer(Phase::ParseInfix);
+    PerformanceCounters::CountParseAttempt(Notation::Infix);
+
+    this->mParsingTokens = tokenStream.get();
+    std::shared_ptr<BaseAST> logicalExprAST = this->ParseRange(0U, tokenStream->TokenCount());
+    this->mParsingTokens = nullptr;
+
+    // ̍\͂Ɠ, g[N̈ʒu͖ɐi߂Ă
+    tokenStream->SetCurrentIndex(tokenStream->TokenCount());
+
+    return logicalExprAST;
+}
+
+bool ParallelParser::IndexBrackets(const TokenStream& tokenStream)
+{
+    // g[Ñ`NƂɍ\Ɗʂ̐[̑𒲂, `NŊʂ̑Ή
+    std::size_t tokenCount = tokenStream.TokenCount();
+    std::size_t chunkSize = std::max<std::size_t>(this->mGrainSize, tokenCount / (this->mPool.ThreadCount() * 4U) + 1U);
+    std::size_t chunkCount = (tokenCount + chunkSize - 1U) / chunkSize;
+
+    this->mTypes.resize(tokenCount);
+    this->mDepths.resize(tokenCount);
+    this->mMatches.resize(tokenCount);
+    this->mBracketChunks.resize(chunkCount);
+
+    this->ForEachChunk(chunkCount, [this, &tokenStream, tokenCount, chunkSize](std::size_t chunkIndex) {
+        BracketChunk& chunk = this->mBracketChunks[chunkIndex];
+        std::size_t beginIndex = chunkIndex * chunkSize;
+        std::size_t endIndex = std::min(beginIndex + chunkSize, tokenCount);
+        std::int64_t depth = 0;
+
+        chunk.mMinDepth = 0;
+        chunk.mOpenRights.clear();
+        chunk.mOpenLefts.clear();
+        chunk.mValid = true;
+
+        for (std::size_t i = beginIndex; i < endIndex; ++i)
+            this->mTypes[i] = tokenStream.TokenAt(i)->Type();
+
+        for (std::size_t i = beginIndex; i < endIndex; ++i) {
+            TokenType tokenType = this->mTypes[i];
+            TokenType previousType = (i == beginIndex && i > 0U) ? tokenStream.TokenAt(i - 1U)->Type() :
+                                     (i > 0U) ? this->mTypes[i - 1U] : TokenType::LeftParenthesis;
+
+            // ׂ荇g[N̑gō\ (擪̓Iyh̐擪, ̓Iyh̖)
+            if (!CanFollow(previousType, tokenType) ||
+                (i + 1U == tokenCount && ExpectsOperand(tokenType))) {
+                chunk.mValid = false;
+                return;
+            }
+
+            if (tokenType == TokenType::LeftParenthesis) {
+                chunk.mOpenLefts.push_back(static_cast<std::uint32_t>(i));
+                ++depth;
+            } else if (tokenType == TokenType::RightParenthesis) {
+                if (!chunk.mOpenLefts.empty()) {
+                    this->mMatches[chunk.mOpenLefts.back()] = static_cast<std::uint32_t>(i);
+                    chunk.mOpenLefts.pop_back();
+                } else {
+                    chunk.mOpenRights.push_back(static_cast<std::uint32_t>(i));
+                }
+
+                chunk.mMinDepth = std::min(chunk.mMinDepth, --depth);
+            }
+        }
+
+        chunk.mDepthDelta = depth;
+    });
+
+    // ʂ̐[̗ݐϘa, [ɂȂ炸0ɖ߂邱Ƃm߂
+    // `N܂ʂ, Õ`NcʂƐ擪珇ɑΉ
+    std::vector<std::uint32_t> openLefts;
+    std::vector<std::int64_t> chunkDepths(chunkCount);
+    std::int64_t depth = 0;
+
+    for (std::size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex) {
+        const BracketChunk& chunk = this->mBracketChunks[chunkIndex];
+
+        if (!chunk.mValid || depth + chunk.mMinDepth < 0)
+            return false;
+
+        for (std::uint32_t rightIndex : chunk.mOpenRights) {
+            this->mMatches[openLefts.back()] = rightIndex;
+            openLefts.pop_back();
+        }
+
+        openLefts.insert(openLefts.end(), chunk.mOpenLefts.begin(), chunk.mOpenLefts.end());
+        chunkDepths[chunkIndex] = depth;
+        depth += chunk.mDepthDelta;
+    }
+
+    if (depth != 0)
+        return false;
+
+    // eg[N̒O̊ʂ̐[
+    this->ForEachChunk(chunkCount, [this, &chunkDepths, tokenCount, chunkSize](std::size_t chunkIndex) {
+        std::size_t beginIndex = chunkIndex * chunkSize;
+        std::size_t endIndex = std::min(beginIndex + chunkSize, tokenCount);
+        std::uint32_t depth = static_cast<std::uint32_t>(chunkDepths[chunkIndex]);
+
+        for (std::size_t i = beginIndex; i < endIndex; ++i) {
+            if (this->mTypes[i] == TokenType::RightParenthesis)
+                --depth;
+
+            this->mDepths[i] = depth;
+
+            if (this->mTypes[i] == TokenType::LeftParenthesis)
+                ++depth;
+        }
+    });
+
+    return true;
+}
+
+void ParallelParser::FindOperators(std::size_t beginIndex, std::size_t endIndex, std::vector<std::size_t>& operatorIndices)
+{
+    // IyhƂ, ےǂݔ΂, ʂ͑ΉEʂ܂Ŕ΂Ď̉ZqT
+    std::size_t index = beginIndex;
+
+    while (true) {
+        while (this->mTypes[index] == TokenType::Not)
+            ++index;
+
+        index = (this->mTypes[index] == TokenType::LeftParenthesis) ? this->mMatches[index] + 1U : index + 1U;
+
+        if (index >= endIndex)
+            return;
+
+        operatorIndices.push_back(index++);
+
+        // [̃Iyh (L) ꍇ, cʂ̐[ŕɒT
+        if (operatorIndices.size() >= this->mGrainSize && endIndex - index >= this->mGrainSize) {
+            this->FindOperatorsByDepth(index, endIndex, operatorIndices);
+            return;
+        }
+    }
+}
+
+void ParallelParser::FindOperatorsByDepth(std::size_t beginIndex, std::size_t endIndex, std::vector<std::size_t>& operatorIndices)
+{
+    // ͈͂̐擪Ɠ[ɂ2Zq, ͈̔͂̉Zq
+    std::uint32_t depth = this->mDepths[beginIndex];
+    std::size_t chunkSize = std::max<std::size_t>(this->mGrainSize, (endIndex - beginIndex) / (this->mPool.ThreadCount() * 4U) + 1U);
+    std::size_t chunkCount = (endIndex - beginIndex + chunkSize - 1U) / chunkSize;
+    std::vector<std::vector<std::size_t>> chunkOperators(chunkCount);
+
+    this->ForEachChunk(chunkCount, [&](std::size_t chunkIndex) {
+        std::size_t chunkBegin = beginIndex + chunkIndex * chunkSize;
+        std::size_t chunkEnd = std::min(chunkBegin + chunkSize, endIndex);
+
+        for (std::size_t i = chunkBegin; i < chunkEnd; ++i)
+            if (this->mDepths[i] == depth && IsBinaryOperatorToken(this->mTypes[i]))
+                chunkOperators[chunkIndex].push_back(i);
+    });
+
+    for (const auto& operators : chunkOperators)
+        operatorIndices.insert(operatorIndices.end(), operators.begin(), operators.end());
+}
+
+std::shared_ptr<BaseAST> ParallelParser::ParseRange(std::size_t beginIndex, std::size_t endIndex)
+{
+    // [beginIndex, endIndex)͍\ς݂̒uL@̘_
+    // x͈̔͂, InfixParserƓD揇ʖ@Œɍ\͂
+    if (endIndex - beginIndex < this->mGrainSize) {
+        std::size_t index = beginIndex;
+        std::shared_ptr<BaseAST> exprAST = this->ParseExpression(index, endIndex, 0);
+        assert(index == endIndex);
+        return exprAST;
+    }
+
+    std::vector<std::size_t> operatorIndices;
+    this->FindOperators(beginIndex, endIndex, operatorIndices);
+
+    std::size_t operandCount = operatorIndices.size() + 1U;
+    std::vector<std::shared_ptr<BaseAST>> operands(operandCount);
+    auto operandBegin = [&](std::size_t i) { return (i == 0U) ? beginIndex : operatorIndices[i - 1U] + 1U; };
+    auto operandEnd = [&](std::size_t i) { return (i + 1U == operandCount) ? endIndex : operatorIndices[i]; };
+
+    // g[ŇxxɂȂ悤ɃIyh܂Ƃ߂ă^XNɂ
+    std::vector<std::size_t> chunkEnds;
+
+    for (std::size_t i = 0, chunkBegin = 0; i < operandCount; ++i) {
+        if (operandEnd(i) - operandBegin(chunkBegin) >= this->mGrainSize || i + 1U == operandCount) {
+            chunkEnds.push_back(i + 1U);
+            chunkBegin = i + 1U;
+        }
+    }
+
+    this->ForEachChunk(chunkEnds.size(), [&](std::size_t chunkIndex) {
+        for (std::size_t i = (chunkIndex == 0U) ? 0U : chunkEnds[chunkIndex - 1U]; i < chunkEnds[chunkIndex]; ++i) {
+            std::size_t index = operandBegin(i);
+            operands[i] = this->ParseOperand(index);
+            assert(index == operandEnd(i));
+        }
+    });
+
+    // InfixParser̗D揇ʖ@Ɠ؂ɂȂ悤, Zq̃X^bNőgݗĂ
+    // ̉Zq͓D揇ʂ̉Zqΐɑgݗ, ẺZq͌납gݗĂ
+    std::vector<std::shared_ptr<BaseAST>> operandStack;
+    std::vector<const BinaryOperator*> operatorStack;
+
+    auto reduce = [&operandStack, &operatorStack]() {
+        std::shared_ptr<BaseAST> rightExprAST = std::move(operandStack.back());
+        operandStack.pop_back();
+        operandStack.back() = MakeBinaryExpression(*operatorStack.back(), std::move(operandStack.back()), rightExprAST);
+        operatorStack.pop_back(); };
+
+    operandStack.push_back(std::move(operands[0]));
+
+    for (std::size_t i = 0; i < operatorIndices.size(); ++i) {
+        const BinaryOperator* binaryOperator = FindBinaryOperator(this->mTypes[operatorIndices[i]]);
+
+        while (!operatorStack.empty() &&
+               (operatorStack.back()->mPrecedence > binaryOperator->mPrecedence ||
+                (operatorStack.back()->mPrecedence == binaryOperator->mPrecedence && !binaryOperator->mRightAssociative)))
+            reduce();
+
+        operatorStack.push_back(binaryOperator);
+        operandStack.push_back(std::move(operands[i + 1U]));
+    }
+
+    while (!operatorStack.empty())
+        reduce();
+
+    return operandStack.front();
+}
+
+std::shared_ptr<BaseAST> ParallelParser::ParseExpression(std::size_t& index, std::size_t endIndex, int minPrecedence)
+{
+    // InfixParser::VisitExpressionƓ (\͌ς݂Ȃ̂ŎsȂ)
+    std::shared_ptr<BaseAST> leftExprAST = this->ParseOperand(index);
+
+    while (index < endIndex) {
+        const BinaryOperator* binaryOperator = FindBinaryOperator(this->mTypes[index]);
+
+        if (binaryOperator == nullptr || binaryOperator->mPrecedence < minPrecedence)
+            break;
+
+        std::shared_ptr<BaseAST> rightExprAST = this->ParseExpression(++index, endIndex,
+            binaryOperator->mRightAssociative ? binaryOperator->mPrecedence : binaryOperator->mPrecedence + 1);
+        leftExprAST = MakeBinaryExpression(*binaryOperator, std::move(leftExprAST), rightExprAST);
+    }
+
+    return leftExprAST;
+}
+
+std::shared_ptr<BaseAST> ParallelParser::ParseOperand(std::size_t& index)
+{
+    // <NotExpression>: ے̕т̌, 萔, ϐ, ʂ̂ꂩ (index̓Iyh̎ɐi߂)
+    std::size_t beginIndex = index;
+    std::size_t factorIndex = index;
+
+    while (this->mTypes[factorIndex] == TokenType::Not)
+        ++factorIndex;
+
+    std::shared_ptr<BaseAST> exprAST;
+    const std::shared_ptr<Token>& token = this->mParsingTokens->TokenAt(factorIndex);
+
+    switch (this->mTypes[factorIndex]) {
+        case TokenType::True:
+        case TokenType::False:
+            exprAST = std::make_shared<ConstantAST>(token->Value());
+            index = factorIndex + 1U;
+            break;
+        case TokenType::Variable:
+            exprAST = std::make_shared<VariableAST>(token->Text());
+            index = factorIndex + 1U;
+            break;
+        default:
+            assert(this->mTypes[factorIndex] == TokenType::LeftParenthesis);
+            exprAST = std::make_shared<FactorAST>(this->ParseRange(factorIndex + 1U, this->mMatches[factorIndex]));
+            index = this->mMatches[factorIndex] + 1U;
+            break;
+    }
+
+    // ̔ے肩珇ɍ
+    for (std::size_t i = factorIndex; i > beginIndex; --i)
+        exprAST = std::make_shared<NotExpressionAST>(exprAST);
+
+    return exprAST;
+}
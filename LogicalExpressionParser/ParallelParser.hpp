@@ -0,0 +1,131 @@
+// LogicalExpressionParser
+// ParallelParser.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_PARALLEL_PARSER_HPP
+#define LOGICAL_EXPRESSION_PARSER_PARALLEL_PARSER_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Diagnostics.hpp"
+#include "ForkJoinPool.hpp"
+
+class BaseAST;
+class TokenStream;
+class ResourceGovernor;
+enum class TokenType;
+enum class Notation;
+
+/*
+1̘_̕Ȏ͂ƍ\
+͓͂͂`Nɕ, e`N̐擪g[N̋؂łƉ肵ē@IɎ͂
+g[N͊Jnʒu܂ރ`N, `N̖܂g[N͑̓͂ǂŊ
+`N̐擪Õg[N̓rłꍇ, ̃g[N̖œ@IȎ͂g[N̋؂ɂ
+ȍ~̃g[N̂܂܎g, łȂ (ʎqL̓rǂݎn߂Ă) ̈ʒu玚͂
+\͂͒uL@݂̂ɍs
+g[Ñ`NƂɊʂ̐[̑WvėݐϘa, ʂ̑Ήƍ\Ċeg[N̐[߂
+[2Zqŋ؂ꂽIyh͓Ɨ؂Ȃ̂, 傫Ȕ͈͂ł̓^XNɕč\͂,
+ŌɉZq̗D揇ʂƌɏ]đgݗĂ (ۍ\؂InfixParseřʂƓɂȂ)
+uL@ƂĐȂꍇ, ̏ݒ肵ꍇ, ̍\ (ParseLogicalExpression) ɔC
+ */
+class ParallelParser {
+public:
+    // ͂1̃^XN󂯎͂̃oCg, \͂1̃^XN󂯎g[Ň̖ڈ
+    static constexpr std::size_t DefaultLexChunkSize = 1U << 20;
+    static constexpr std::size_t DefaultGrainSize = 1U << 14;
+
+    ParallelParser(ForkJoinPool& pool, std::size_t grainSize = DefaultGrainSize,
+                   std::size_t lexChunkSize = DefaultLexChunkSize);
+    ~ParallelParser() = default;
+
+    ParallelParser(const ParallelParser&) = delete;
+    ParallelParser& operator=(const ParallelParser&) = delete;
+
+    // O̎͂, @IȌʂgɎ͂`N̐
+    inline std::size_t RelexedChunks() const { return this->mRelexedChunks; }
+    // O̍\͂𒀎̍\͂ɔCꍇtrue
+    inline bool FellBack() const { return this->mFellBack; }
+
+    // LexerƓg[N (̏𒴂ꍇ̃G[̈ʒû݈قȂꍇ)
+    bool Lex(const std::string& logicalExpr, TokenStream& tokenStream, Diagnostics* diagnostics = nullptr,
+             ResourceGovernor* governor = nullptr);
+    // ParseLogicalExpressionƓۍ\؂Ԃ (lastNotationɂParseLogicalExpressionƓŌɎL@)
+    std::shared_ptr<BaseAST> Parse(const std::shared_ptr<TokenStream>& tokenStream, Notation* lastNotation, Diagnostics& diagnostics,
+                                   ResourceGovernor* governor = nullptr);
+    std::shared_ptr<BaseAST> Parse(const std::string& logicalExpr, Notation* lastNotation, Diagnostics& diagnostics,
+                                   ResourceGovernor* governor = nullptr);
+
+private:
+    struct LexError {
+        DiagnosticCode  mCode;
+        std::size_t     mOffset;
+        char            mCharacter;
+    };
+
+    // ͂̃`NƂ̎͂̌
+    // ŏɓ@IɃg[N𐔂, p킹mBeginOffset玚͂ăg[Nɏ
+    struct LexedChunk {
+        std::size_t     mBeginOffset;   // ŏ̃g[NTn߂ʒu (g[N̋؂)
+        std::size_t     mEndOffset;     // Ō̃g[N̖
+        std::size_t     mTokenCount;
+        std::size_t     mFirstIndex;    // ŏ̃g[Ñg[Nł̈ʒu
+        LexError        mError;         // G[mCodeNone
+    };
+
+    // g[Ñ`NƂ̊ʂ̏Wv
+    struct BracketChunk {
+        // ʂ̐[̑, `Nł̐[̍ŏl (`N̐擪̐[̍)
+        std::int64_t                mDepthDelta;
+        std::int64_t                mMinDepth;
+        // `NőΉ̎ȂE (擪珇) ƍ (擪珇)
+        std::vector<std::uint32_t>  mOpenRights;
+        std::vector<std::uint32_t>  mOpenLefts;
+        bool                        mValid;
+    };
+
+    // [beginOffset, endOffset)Ŏn܂g[N, beginOffsetg[N̋؂łƉ肵Ď͂
+    // ͈̖͂܂g[N͔͈͂̊O܂œǂ (LexerƓg[NƃG[ɂȂ)
+    // g[NƂaddToken(ʒu, , )Ăяo
+    template <typename AddToken>
+    static bool LexRange(const std::string& logicalExpr, std::size_t beginOffset, std::size_t endOffset,
+                         AddToken&& addToken, LexError& error);
+    // [beginOffset, endOffset)Ŏn܂g[N𐔂
+    static void CountTokens(const std::string& logicalExpr, std::size_t beginOffset, std::size_t endOffset,
+                            LexedChunk& chunk);
+    // chunkCount̃`Nɏ (擪̃`N͌ĂяoXbhŏ)
+    void ForEachChunk(std::size_t chunkCount, const std::function<void(std::size_t)>& runChunk);
+
+    bool Stitch(const std::string& logicalExpr, Diagnostics* diagnostics, ResourceGovernor* governor,
+                std::size_t& tokenCount);
+    bool IndexBrackets(const TokenStream& tokenStream);
+    void FindOperators(std::size_t beginIndex, std::size_t endIndex, std::vector<std::size_t>& operatorIndices);
+    void FindOperatorsByDepth(std::size_t beginIndex, std::size_t endIndex, std::vector<std::size_t>& operatorIndices);
+    std::shared_ptr<BaseAST> ParseRange(std::size_t beginIndex, std::size_t endIndex);
+    std::shared_ptr<BaseAST> ParseExpression(std::size_t& index, std::size_t endIndex, int minPrecedence);
+    std::shared_ptr<BaseAST> ParseOperand(std::size_t& index);
+
+    ForkJoinPool& mPool;
+    std::size_t mGrainSize;
+    std::size_t mLexChunkSize;
+    std::size_t mRelexedChunks;
+    bool mFellBack;
+
+    // ͂̍Ɨ̈, 񂩂\͂ꍇ̃g[N (̓͂ōėp)
+    std::vector<LexedChunk> mLexedChunks;
+    std::shared_ptr<TokenStream> mTokenStream;
+
+    // \͒̃g[N, g[N̎, g[N̒O̊ʂ̐[, ʂɑΉEʂ̈ʒu
+    const TokenStream* mParsingTokens;
+    std::vector<TokenType> mTypes;
+    std::vector<std::uint32_t> mDepths;
+    std::vector<std::uint32_t> mMatches;
+    std::vector<BracketChunk> mBracketChunks;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_PARALLEL_PARSER_HPP
@@ -0,0 +1,380 @@
+
+// LogicalExpressionParser
+// ParallelTraversal.cpp
+
+#include "ParallelTraversal.hpp"
+#include "LatencyTracing.hpp"
+#include "PartialEvaluator.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+// x̕؂EvaluatorŒɕ] (]̒iK̒x̓`NƂɂ͋L^Ȃ)
+class SubtreeEvaluator final : public Evaluator {
+public:
+    using Evaluator::Visit;
+};
+
+static const std::string& BinaryOperator(const BaseAST* exprAST)
+{
+    switch (exprAST->Type()) {
+        case ASTType::Expression:
+            return static_cast<const ExpressionAST*>(exprAST)->Operator();
+        case ASTType::XorExpression:
+            return static_cast<const XorExpressionAST*>(exprAST)->Operator();
+        default:
+            return static_cast<const NandNorExpressionAST*>(exprAST)->Operator();
+    }
+}
+
+// 2Zq̃m[h̒l (EvaluatorƓ, Zq̋LŔʂ)
+static bool ApplyBinary(const BaseAST* exprAST, bool leftValue, bool rightValue)
+{
+    const std::string& op = BinaryOperator(exprAST);
+
+    switch (exprAST->Type()) {
+        case ASTType::Expression:
+            return (op == "->") ? (!leftValue || rightValue) : (leftValue == rightValue);
+        case ASTType::XorExpression:
+            return (op == "") ? (leftValue != rightValue) : (leftValue == rightValue);
+        default:
+            return (op == "") ? !(leftValue || rightValue) : !(leftValue && rightValue);
+    }
+}
+
+// ӂ̒l݂̂Ńm[h̒lm肷ꍇ͂̒l
+static std::optional<bool> ShortCircuitBinary(const BaseAST* exprAST, bool leftValue)
+{
+    const std::string& op = BinaryOperator(exprAST);
+
+    if (exprAST->Type() == ASTType::Expression && op == "->" && !leftValue)
+        return true;
+
+    if (exprAST->Type() == ASTType::NandNorExpression)
+        if (leftValue == (op == ""))
+            return op != "";
+
+    return std::nullopt;
+}
+
+static void LowerStopIndex(std::atomic<std::size_t>& stopIndex, std::size_t chunkIndex)
+{
+    std::size_t currentIndex = stopIndex.load(std::memory_order_relaxed);
+
+    while (chunkIndex < currentIndex &&
+           !stopIndex.compare_exchange_weak(currentIndex, chunkIndex, std::memory_order_relaxed))
+        ;
+}
+
+bool ParallelTraversal::CancelScope::IsCancelled() const
+{
+    for (const CancelScope* scope = this; scope != nullptr; scope = scope->mParent)
+        if (scope->mStopIndex != nullptr && scope->mStopIndex->load(std::memory_order_relaxed) < scope->mChunkIndex)
+            return true;
+
+    return false;
+}
+
+ParallelTraversal::ParallelTraversal(const std::shared_ptr<BaseAST>& logicalExprAST, ForkJoinPool& pool,
+                                     std::uint64_t grainSize) :
+    mAST(logicalExprAST),
+    mPool(pool),
+    mGrainSize(std::max<std::uint64_t>(grainSize, 1U))
+{
+    assert(logicalExprAST != nullptr);
+
+    // ̓m[h̃AhXŕ̂, \zɘ_Ă͂ȂȂ
+    std::vector<std::uint64_t> childSizes;
+    this->mNodeCount = this->Measure(logicalExprAST, childSizes);
+}
+
+std::uint64_t ParallelTraversal::Measure(const std::shared_ptr<BaseAST>& exprAST, std::vector<std::uint64_t>& childSizes)
+{
+    // q̑傫childSizesɃX^bN̂悤ɐς, ߂OɎ菜
+    const BaseAST* node = exprAST.get();
+    const std::size_t childCount = ASTChildCount(node);
+    const std::size_t firstChild = childSizes.size();
+    std::uint64_t nodeCount = 1U;
+
+    for (std::size_t i = 0; i < childCount; ++i) {
+        std::uint64_t childSize = this->Measure(ASTChild(node, i), childSizes);
+        childSizes.push_back(childSize);
+        nodeCount += childSize;
+    }
+
+    if (childCount > 0U && nodeCount >= this->mGrainSize) {
+        // 擪珇, 傫̍vxɒB܂Ŏq`Nɂ܂Ƃ߂
+        std::vector<std::size_t> chunkEnds;
+        std::uint64_t chunkSize = 0U;
+
+        for (std::size_t i = 0; i < childCount; ++i) {
+            chunkSize += childSizes[firstChild + i];
+
+            if (chunkSize >= this->mGrainSize) {
+                chunkEnds.push_back(i + 1U);
+                chunkSize = 0U;
+            }
+        }
+
+        // xɖȂ̎q͒Õ`NɊ܂߂
+        if (chunkEnds.empty())
+            chunkEnds.push_back(childCount);
+        else
+            chunkEnds.back() = childCount;
+
+        this->mChunkEnds.emplace(node, std::move(chunkEnds));
+    }
+
+    childSizes.resize(firstChild);
+
+    return nodeCount;
+}
+
+const std::vector<std::size_t>* ParallelTraversal::FindChunks(const BaseAST* exprAST) const
+{
+    auto iter = this->mChunkEnds.find(exprAST);
+    return (iter != this->mChunkEnds.end()) ? &iter->second : nullptr;
+}
+
+//
+// ]
+//
+
+std::optional<bool> ParallelTraversal::Evaluate(const VariableAssignment& assignment) const
+{
+    ScopedPhaseTimer phaseTimer(Phase::Evaluate);
+
+    if (this->FindChunks(this->mAST.get()) == nullptr) {
+        SubtreeEvaluator evaluator;
+        return evaluator.Visit(this->mAST.get(), assignment);
+    }
+
+    CancelScope rootScope { nullptr, nullptr, 0U };
+    return this->EvaluateNode(this->mAST.get(), assignment, rootScope);
+}
+
+std::optional<bool> ParallelTraversal::EvaluateNode(const BaseAST* exprAST, const VariableAssignment& assignment,
+                                                    const CancelScope& scope) const
+{
+    const std::vector<std::size_t>& chunkEnds = *this->FindChunks(exprAST);
+    const std::size_t chunkCount = chunkEnds.size();
+
+    if (chunkCount == 1U) {
+        ChunkResult result = this->EvaluateChunk(exprAST, 0U, chunkEnds[0], assignment, scope);
+
+        if (result.mState == ChunkState::Completed || result.mState == ChunkState::Determined)
+            return result.mValue;
+
+        return std::nullopt;
+    }
+
+    // ̃`Nςނ̂, Xbh͑Õ`N珇Ɏs
+    std::atomic<std::size_t> stopIndex { chunkCount };
+    std::vector<ChunkResult> results(chunkCount);
+
+    auto runChunk = [&](std::size_t chunkIndex) {
+        CancelScope chunkScope { &scope, &stopIndex, chunkIndex };
+
+        if (chunkScope.IsCancelled())
+            return;
+
+        std::size_t beginChild = (chunkIndex > 0U) ? chunkEnds[chunkIndex - 1U] : 0U;
+        results[chunkIndex] = this->EvaluateChunk(exprAST, beginChild, chunkEnds[chunkIndex], assignment, chunkScope);
+
+        if (results[chunkIndex].mState == ChunkState::Determined || results[chunkIndex].mState == ChunkState::Failed)
+            LowerStopIndex(stopIndex, chunkIndex);
+    };
+
+    {
+        ForkJoinPool::TaskGroup taskGroup(this->mPool);
+
+        for (std::size_t i = chunkCount - 1U; i > 0U; --i)
+            taskGroup.Spawn([&runChunk, i]() { runChunk(i); });
+
+        runChunk(0U);
+        taskGroup.Wait();
+    }
+
+    // ̕]Ɠ, Õ`N珇Ɍʂm肳
+    // ł؂ꂽ`N̑Oɂ, Kʂm肳`N (ΐeł؂Ă)
+    for (const auto& result : results) {
+        if (result.mState == ChunkState::Determined)
+            return result.mValue;
+        if (result.mState != ChunkState::Completed)
+            return std::nullopt;
+    }
+
+    if (exprAST->Type() == ASTType::AndOrExpression)
+        return static_cast<const AndOrExpressionAST*>(exprAST)->Operator() != "";
+
+    // 2Zq̓`NӂƉEӂɕĂ
+    assert(chunkCount == 2U);
+    return ApplyBinary(exprAST, results[0].mValue, results[1].mValue);
+}
+
+ParallelTraversal::ChunkResult ParallelTraversal::EvaluateChunk(
+    const BaseAST* exprAST, std::size_t beginChild, std::size_t endChild,
+    const VariableAssignment& assignment, const CancelScope& scope) const
+{
+    SubtreeEvaluator evaluator;
+    ChunkResult result;
+    bool leftValue = false;
+
+    for (std::size_t i = beginChild; i < endChild; ++i) {
+        if (scope.IsCancelled())
+            return ChunkResult { ChunkState::Cancelled, false };
+
+        const BaseAST* childAST = ASTChild(exprAST, i).get();
+        std::optional<bool> value = (this->FindChunks(childAST) != nullptr) ?
+            this->EvaluateNode(childAST, assignment, scope) : evaluator.Visit(childAST, assignment);
+
+        if (!value.has_value())
+            return ChunkResult { scope.IsCancelled() ? ChunkState::Cancelled : ChunkState::Failed, false };
+
+        switch (exprAST->Type()) {
+            case ASTType::Factor:
+                result = ChunkResult { ChunkState::Completed, value.value() };
+                break;
+            case ASTType::NotExpression:
+                result = ChunkResult { ChunkState::Completed, !value.value() };
+                break;
+            case ASTType::AndOrExpression:
+            {
+                // And̏ꍇ͋U, Oȑꍇ͐^Ōʂm肷
+                bool decisiveValue = (static_cast<const AndOrExpressionAST*>(exprAST)->Operator() == "");
+
+                if (value.value() == decisiveValue)
+                    return ChunkResult { ChunkState::Determined, decisiveValue };
+
+                result = ChunkResult { ChunkState::Completed, !decisiveValue };
+                break;
+            }
+            default:
+            {
+                if (i == 0U) {
+                    std::optional<bool> shortCircuitValue = ShortCircuitBinary(exprAST, value.value());
+
+                    if (shortCircuitValue.has_value())
+                        return ChunkResult { ChunkState::Determined, shortCircuitValue.value() };
+
+                    leftValue = value.value();
+                }
+
+                // ӂƉEӂ̗܂ރ`N̓m[h̒l, łȂΎq̒lԂ
+                bool nodeValue = (i == 1U && beginChild == 0U) ?
+                    ApplyBinary(exprAST, leftValue, value.value()) : value.value();
+                result = ChunkResult { ChunkState::Completed, nodeValue };
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+//
+// o
+//
+
+void ParallelTraversal::Print(Notation notation, std::ostream& os) const
+{
+    ScopedPhaseTimer phaseTimer(Phase::Print);
+    this->PrintNode(this->mAST, notation, os);
+}
+
+void ParallelTraversal::PrintNode(const std::shared_ptr<BaseAST>& exprAST, Notation notation, std::ostream& os) const
+{
+    const std::vector<std::size_t>* chunkEnds = this->FindChunks(exprAST.get());
+
+    if (chunkEnds == nullptr) {
+        this->mPrinter.PrintExpression(exprAST, notation, os);
+        return;
+    }
+
+    auto printChild = [this, notation](const std::shared_ptr<BaseAST>& childAST, std::ostream& childStream) {
+        this->PrintNode(childAST, notation, childStream); };
+
+    // 擪̃`N͏o͐ɒڏ, c̃`N̓obt@ɏĂ珇ɘA
+    const std::size_t chunkCount = chunkEnds->size();
+    std::vector<std::ostringstream> chunkStreams(chunkCount - 1U);
+
+    {
+        ForkJoinPool::TaskGroup taskGroup(this->mPool);
+
+        for (std::size_t i = chunkCount - 1U; i > 0U; --i)
+            taskGroup.Spawn([&, i]() {
+                this->mPrinter.PrintNodeRange(exprAST.get(), notation, (*chunkEnds)[i - 1U], (*chunkEnds)[i],
+                                              chunkStreams[i - 1U], printChild); });
+
+        this->mPrinter.PrintNodeRange(exprAST.get(), notation, 0U, (*chunkEnds)[0], os, printChild);
+        taskGroup.Wait();
+    }
+
+    for (const auto& chunkStream : chunkStreams)
+        os << chunkStream.str();
+}
+
+//
+// Ȗ
+//
+
+std::shared_ptr<BaseAST> ParallelTraversal::Cofactor(const VariableAssignment& partialAssignment) const
+{
+    CancelScope rootScope { nullptr, nullptr, 0U };
+    return this->CofactorNode(this->mAST, partialAssignment, rootScope);
+}
+
+std::shared_ptr<BaseAST> ParallelTraversal::CofactorNode(const std::shared_ptr<BaseAST>& exprAST,
+                                                         const VariableAssignment& partialAssignment,
+                                                         const CancelScope& scope) const
+{
+    const std::vector<std::size_t>* chunkEnds = this->FindChunks(exprAST.get());
+
+    if (chunkEnds == nullptr)
+        return PartialEvaluator::Cofactor(exprAST, partialAssignment);
+
+    // AndOrőŜm肳萔̃Iyhꂽꍇ, Ɋ֌WȂʂ܂
+    // `N̔ԍ1U, ~ʒu0ɂƑSẴ`Nł؂
+    const bool isAndOr = (exprAST->Type() == ASTType::AndOrExpression);
+    const bool isAnd = isAndOr && static_cast<const AndOrExpressionAST*>(exprAST.get())->Operator() == "";
+    const std::size_t chunkCount = chunkEnds->size();
+    std::atomic<std::size_t> stopIndex { chunkCount + 1U };
+    std::vector<std::shared_ptr<BaseAST>> cofactors(ASTChildCount(exprAST.get()));
+
+    auto runChunk = [&](std::size_t chunkIndex) {
+        CancelScope chunkScope { &scope, &stopIndex, chunkIndex + 1U };
+        std::size_t beginChild = (chunkIndex > 0U) ? (*chunkEnds)[chunkIndex - 1U] : 0U;
+
+        for (std::size_t i = beginChild; i < (*chunkEnds)[chunkIndex]; ++i) {
+            if (chunkScope.IsCancelled())
+                return;
+
+            cofactors[i] = this->CofactorNode(ASTChild(exprAST.get(), i), partialAssignment, chunkScope);
+
+            if (isAndOr && cofactors[i] != nullptr && cofactors[i]->Type() == ASTType::Constant &&
+                static_cast<const ConstantAST*>(cofactors[i].get())->Value() != isAnd) {
+                stopIndex.store(0U, std::memory_order_relaxed);
+                return;
+            }
+        }
+    };
+
+    {
+        ForkJoinPool::TaskGroup taskGroup(this->mPool);
+
+        for (std::size_t i = chunkCount - 1U; i > 0U; --i)
+            taskGroup.Spawn([&runChunk, i]() { runChunk(i); });
+
+        runChunk(0U);
+        taskGroup.Wait();
+    }
+
+    if (stopIndex.load(std::memory_order_relaxed) == 0U)
+        return std::make_shared<ConstantAST>(!isAnd);
+
+    // eł؂ꂽꍇ͗]qĂȂ (ʂ͎gȂ)
+    if (scope.IsCancelled())
+        return nullptr;
+
+    return PartialEvaluator::Fold(exprAST, cofactors.data());
+}
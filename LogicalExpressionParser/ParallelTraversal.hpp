@@ -0,0 +1,95 @@
+// LogicalExpressionParser
+// ParallelTraversal.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_PARALLEL_TRAVERSAL_HPP
+#define LOGICAL_EXPRESSION_PARSER_PARALLEL_TRAVERSAL_HPP
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "AST.hpp"
+#include "Evaluator.hpp"
+#include "ForkJoinPool.hpp"
+
+/*
+1̘_ɑ΂tH[NEWC̕񑖍
+\zɕ؂̑傫 (m[h) 𐔂, xȏ̕؂m[h̎q
+傫xxɂȂ͈ (`N) ɕĂ
+ł̓`NƂɃ^XN𐶐, And, Or, ->, <-> Ȃǂ̃m[hŌʂgݍ킹
+x̕؂1̃^XN̒Œɏ
+], o, Ȗ (]q) ͓ĝ, \z͘_Ƃ1ł悢
+ */
+class ParallelTraversal {
+public:
+    // 1̃^XNŒɏ镔؂̑傫̖ڈ
+    static constexpr std::uint64_t DefaultGrainSize = 1U << 14;
+
+    ParallelTraversal(const std::shared_ptr<BaseAST>& logicalExprAST, ForkJoinPool& pool,
+                      std::uint64_t grainSize = DefaultGrainSize);
+    ~ParallelTraversal() = default;
+
+    inline std::uint64_t NodeCount() const { return this->mNodeCount; }
+    // q𕪊m[h̐
+    inline std::size_t SplitNodeCount() const { return this->mChunkEnds.size(); }
+
+    // EvaluatorƓʂԂ (l̖ϐ܂ޏꍇ, ̕]QƂ͈͂Ŕ肷)
+    // Z]Ōʂm肵`Ñ`N͑ł؂
+    std::optional<bool> Evaluate(const VariableAssignment& assignment) const;
+    // ASTPrinter::PrintExpressionƓo (oƉs͕tȂ)
+    void Print(Notation notation, std::ostream& os) const;
+    // PartialEvaluator::CofactorƓ_Ԃ
+    // IyhŜm肳萔ɂȂꍇ, ̃`Nł؂
+    std::shared_ptr<BaseAST> Cofactor(const VariableAssignment& partialAssignment) const;
+
+private:
+    // Z̃`N̂, ʂm肳ŏ̃`N̔ԍL
+    // Õ`Nʂm肳ꍇ, ẽ`Nł؂ꂽꍇɑł؂
+    struct CancelScope {
+        const CancelScope*                  mParent;
+        const std::atomic<std::size_t>*     mStopIndex;
+        std::size_t                         mChunkIndex;
+
+        bool IsCancelled() const;
+    };
+
+    enum class ChunkState {
+        Cancelled,
+        Completed,      // mValue̓`NqSĊ܂ޏꍇ̓m[h̒l, łȂΎq̒l
+        Determined,     // mValue͒Z]Ŋm肵m[h̒l
+        Failed
+    };
+
+    struct ChunkResult {
+        ChunkState  mState = ChunkState::Cancelled;
+        bool        mValue = false;
+    };
+
+    std::uint64_t Measure(const std::shared_ptr<BaseAST>& exprAST, std::vector<std::uint64_t>& childSizes);
+    const std::vector<std::size_t>* FindChunks(const BaseAST* exprAST) const;
+
+    std::optional<bool> EvaluateNode(const BaseAST* exprAST, const VariableAssignment& assignment,
+                                     const CancelScope& scope) const;
+    ChunkResult EvaluateChunk(const BaseAST* exprAST, std::size_t beginChild, std::size_t endChild,
+                              const VariableAssignment& assignment, const CancelScope& scope) const;
+    void PrintNode(const std::shared_ptr<BaseAST>& exprAST, Notation notation, std::ostream& os) const;
+    std::shared_ptr<BaseAST> CofactorNode(const std::shared_ptr<BaseAST>& exprAST, const VariableAssignment& partialAssignment,
+                                          const CancelScope& scope) const;
+
+    std::shared_ptr<BaseAST> mAST;
+    ForkJoinPool& mPool;
+    std::uint64_t mGrainSize;
+    std::uint64_t mNodeCount;
+    ASTPrinter mPrinter;
+    // ؂̑傫xȏ̃m[hɂ, e`N̖̎q̔ԍ (̎)
+    std::unordered_map<const BaseAST*, std::vector<std::size_t>> mChunkEnds;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_PARALLEL_TRAVERSAL_HPP
@@ -4,12 +4,236 @@
 
 #include "Parser.hpp"
 #include "AST.hpp"
+#include "LatencyTracing.hpp"
+#include "PerformanceCounters.hpp"
 #include "Token.hpp"
 
+#include <algorithm>
+
+// e\vf̐擪Ɍꂤg[N̏W
+static constexpr TokenTypeSet ConstantTokens =
+    ToTokenTypeSet(TokenType::True) | ToTokenTypeSet(TokenType::False);
+static constexpr TokenTypeSet FactorTokens =
+    ConstantTokens | ToTokenTypeSet(TokenType::Variable) | ToTokenTypeSet(TokenType::LeftParenthesis);
+static constexpr TokenTypeSet NotExpressionTokens =
+    FactorTokens | ToTokenTypeSet(TokenType::Not);
+static constexpr TokenTypeSet BinaryOperatorTokens =
+    ToTokenTypeSet(TokenType::And) | ToTokenTypeSet(TokenType::Or) |
+    ToTokenTypeSet(TokenType::Xor) | ToTokenTypeSet(TokenType::Xnor) |
+    ToTokenTypeSet(TokenType::Nand) | ToTokenTypeSet(TokenType::Nor) |
+    ToTokenTypeSet(TokenType::Then) | ToTokenTypeSet(TokenType::Eq);
+static constexpr TokenTypeSet PrefixTokens =
+    ConstantTokens | ToTokenTypeSet(TokenType::Variable) | ToTokenTypeSet(TokenType::Not) | BinaryOperatorTokens;
+static constexpr TokenTypeSet PostfixTokens = PrefixTokens;
+
+// 2Zq̕\ (D揇ʂ傫قǋ)
+// AndOr͏]ʂ蓯D揇ʂƂ, VZqɑ
+static const BinaryOperator BinaryOperators[] = {
+    { TokenType::And,   2, false,   "" },
+    { TokenType::Or,    2, false,   "" },
+    { TokenType::Xor,   2, false,   "" },
+    { TokenType::Xnor,  2, false,   "" },
+    { TokenType::Nand,  2, false,   "" },
+    { TokenType::Nor,   2, false,   "" },
+    { TokenType::Then,  1, true,    "->" },
+    { TokenType::Eq,    1, true,    "<->" }
+};
+
+const BinaryOperator* FindBinaryOperator(TokenType tokenType)
+{
+    switch (tokenType) {
+        case TokenType::And:
+            return &BinaryOperators[0];
+        case TokenType::Or:
+            return &BinaryOperators[1];
+        case TokenType::Xor:
+            return &BinaryOperators[2];
+        case TokenType::Xnor:
+            return &BinaryOperators[3];
+        case TokenType::Nand:
+            return &BinaryOperators[4];
+        case TokenType::Nor:
+            return &BinaryOperators[5];
+        case TokenType::Then:
+            return &BinaryOperators[6];
+        case TokenType::Eq:
+            return &BinaryOperators[7];
+        default:
+            return nullptr;
+    }
+}
+
+std::shared_ptr<BaseAST> MakeBinaryExpression(
+    const BinaryOperator& binaryOperator, std::shared_ptr<BaseAST> left, const std::shared_ptr<BaseAST>& right)
+{
+    switch (binaryOperator.mTokenType) {
+        case TokenType::And:
+        case TokenType::Or:
+            // ZqAꍇ1̃m[hɂ܂Ƃ߂
+            return MakeAndOrExpression(std::move(left), right, binaryOperator.mSymbol);
+        case TokenType::Xor:
+        case TokenType::Xnor:
+            return std::make_shared<XorExpressionAST>(left, right, binaryOperator.mSymbol);
+        case TokenType::Nand:
+        case TokenType::Nor:
+            return std::make_shared<NandNorExpressionAST>(left, right, binaryOperator.mSymbol);
+        case TokenType::Then:
+        case TokenType::Eq:
+            return std::make_shared<ExpressionAST>(left, right, binaryOperator.mSymbol);
+        default:
+            return nullptr;
+    }
+}
+
+// ӂ̓[û, MakeBinaryExpressionĂԑOɋ߂
+static std::size_t BinaryExpressionDepth(const BinaryOperator& binaryOperator,
+    const std::shared_ptr<BaseAST>& left, const std::shared_ptr<BaseAST>& right, std::size_t leftDepth, std::size_t rightDepth)
+{
+    // AndOr͓Zq̃m[hɃIyh܂Ƃ߂̂, ܂Ƃ߂ꂽ̐[͑Ȃ
+    if (binaryOperator.mTokenType == TokenType::And || binaryOperator.mTokenType == TokenType::Or) {
+        const char* op = binaryOperator.mSymbol;
+        bool leftMerged = left->Type() == ASTType::AndOrExpression &&
+            static_cast<const AndOrExpressionAST*>(left.get())->Operator() == op;
+        bool rightMerged = right->Type() == ASTType::AndOrExpression &&
+            static_cast<const AndOrExpressionAST*>(right.get())->Operator() == op;
+        std::size_t leftOperandDepth = leftMerged ? leftDepth - 1U : leftDepth;
+        std::size_t rightOperandDepth = rightMerged ? rightDepth - 1U : rightDepth;
+
+        return std::max(leftOperandDepth, rightOperandDepth) + 1U;
+    }
+
+    return std::max(leftDepth, rightDepth) + 1U;
+}
+
+// \͂̍ċA̐[𐔂 (ƂɌɖ߂)
+class NestingScope {
+public:
+    NestingScope(std::size_t& nestingLevel) : mNestingLevel(nestingLevel) { ++this->mNestingLevel; }
+    ~NestingScope() { --this->mNestingLevel; }
+
+private:
+    std::size_t& mNestingLevel;
+};
+
+//
+// BracketIndexNX
+//
+
+std::shared_ptr<BracketIndex> BracketIndex::Build(const TokenStream& tokenStream)
+{
+    // Iyh҂ԂƉZq҂Ԃ݂ɑJڂ, ʂ̈ʒu̓X^bNɐς
+    // D揇ʂ͍\̐ɉeȂ̂, ̌ʂg[N͍\͂ɎsȂ
+    std::shared_ptr<BracketIndex> bracketIndex = std::make_shared<BracketIndex>();
+    std::vector<std::size_t> leftIndices;
+    bool expectOperand = true;
+
+    bracketIndex->mMatches.resize(tokenStream.TokenCount(), 0U);
+
+    for (std::size_t i = tokenStream.CurrentIndex(); i < tokenStream.TokenCount(); ++i) {
+        TokenType tokenType = tokenStream.TokenAt(i)->Type();
+
+        if (expectOperand) {
+            if (tokenType == TokenType::LeftParenthesis)
+                leftIndices.push_back(i);
+            else if (tokenType == TokenType::True || tokenType == TokenType::False || tokenType == TokenType::Variable)
+                expectOperand = false;
+            else if (tokenType != TokenType::Not)
+                return nullptr;
+        } else {
+            if (tokenType == TokenType::RightParenthesis) {
+                if (leftIndices.empty())
+                    return nullptr;
+
+                bracketIndex->mMatches[leftIndices.back()] = i;
+                leftIndices.pop_back();
+            } else if (FindBinaryOperator(tokenType) != nullptr) {
+                expectOperand = true;
+            } else {
+                return nullptr;
+            }
+        }
+    }
+
+    if (expectOperand || !leftIndices.empty())
+        return nullptr;
+
+    return bracketIndex;
+}
+
+//
+// LazyInfixSourceNX
+//
+
+// x\͂ۍ\؂QƂg[N
+class LazyInfixSource final : public LazyExpressionSource, public std::enable_shared_from_this<LazyInfixSource> {
+public:
+    LazyInfixSource(const std::shared_ptr<TokenStream>& tokenStream, const std::shared_ptr<BracketIndex>& bracketIndex,
+                    Diagnostics* diagnostics) :
+        mTokenStream(tokenStream), mBracketIndex(bracketIndex), mDiagnostics(diagnostics) { }
+    ~LazyInfixSource() { }
+
+    inline const BracketIndex& Brackets() const { return *this->mBracketIndex; }
+
+    std::shared_ptr<BaseAST> ParseRange(std::size_t beginIndex, std::size_t endIndex) override;
+
+private:
+    std::shared_ptr<TokenStream> mTokenStream;
+    std::shared_ptr<BracketIndex> mBracketIndex;
+    // ʂ̒g̍\͂Ɏsꍇ̃G[̋L^ (nullptrł΋L^Ȃ)
+    Diagnostics* mDiagnostics;
+    // قȂ銇ʂʂ̃Xbh瓯ɍ\͂ꍇ, g[N̈ʒu1Ȃ
+    std::mutex mMutex;
+};
+
+std::shared_ptr<BaseAST> LazyInfixSource::ParseRange(std::size_t beginIndex, std::size_t endIndex)
+{
+    std::lock_guard<std::mutex> lock(this->mMutex);
+
+    // qɂȂʂx̂, \͂̂͂̊ʂ̒̃g[N̂
+    std::size_t currentIndex = this->mTokenStream->CurrentIndex();
+    this->mTokenStream->SetCurrentIndex(beginIndex);
+
+    InfixParser infixParser(this->mTokenStream, this->mDiagnostics);
+    infixParser.mLazySource = this->shared_from_this();
+    std::shared_ptr<BaseAST> exprAST = infixParser.VisitExpression(0);
+
+    // \͌ς݂Ȃ̂, ΉEʂ̒OŎ~܂͂
+    // ~܂Ȃ΃G[L^nullptrԂ (ʂ̒ĝ͖ƂĈ)
+    if (exprAST != nullptr && this->mTokenStream->CurrentIndex() != endIndex)
+        exprAST = infixParser.ReportError(DiagnosticCode::InternalError);
+
+    this->mTokenStream->SetCurrentIndex(currentIndex);
+
+    return exprAST;
+}
+
 //
 // ParserNX
 //
 
+std::nullptr_t Parser::ReportError(DiagnosticCode code, TokenTypeSet expectedTokens)
+{
+    if (this->mDiagnostics == nullptr)
+        return nullptr;
+
+    // ݂̃g[N̈ʒu (g[N̖ɒBĂꍇ͓̖͂) L^
+    const std::shared_ptr<Token> currentToken = this->mTokenStream->CurrentToken();
+    std::size_t offset = (currentToken != nullptr) ? currentToken->Offset() : this->mTokenStream->EndOffset();
+
+    this->mDiagnostics->Report(code, offset, this->mTokenStream->CurrentIndex(), expectedTokens);
+
+    return nullptr;
+}
+
+bool Parser::ReportExhausted()
+{
+    assert(this->mGovernor != nullptr && this->mGovernor->IsExhausted());
+
+    this->ReportError(ResourceDiagnosticCode(this->mGovernor->Exhausted()));
+
+    return false;
+}
+
 std::shared_ptr<ConstantAST> Parser::VisitConstant()
 {
     /*
@@ -17,19 +241,23 @@ std::shared_ptr<ConstantAST> Parser::VisitConstant()
     */
 
     if (this->mTokenStream->CurrentToken() == nullptr)
-        return nullptr;
+        return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, ConstantTokens);
 
     // ݂̃g[N萔łƉ肵Ă
     if ((this->mTokenStream->CurrentToken()->Type() != TokenType::True) &&
         (this->mTokenStream->CurrentToken()->Type() != TokenType::False))
-        return nullptr;
+        return this->ReportError(DiagnosticCode::UnexpectedToken, ConstantTokens);
 
     // g[N萔Ȃ̂ɒl܂܂Ȃꍇ̓G[Ԃ
     if (!this->mTokenStream->CurrentToken()->HasValue())
+        return this->ReportError(DiagnosticCode::InternalError);
+
+    if (!this->ChargeASTNode())
         return nullptr;
 
     // Constant쐬
     std::shared_ptr<ConstantAST> newAST = std::make_shared<ConstantAST>(this->mTokenStream->CurrentToken()->Value());
+    this->mSubtreeDepth = 1U;
 
     // g[N1ɐi߂
     this->mTokenStream->MoveNext();
@@ -44,18 +272,22 @@ std::shared_ptr<VariableAST> Parser::VisitVariable()
     */
 
     if (this->mTokenStream->CurrentToken() == nullptr)
-        return nullptr;
+        return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, ToTokenTypeSet(TokenType::Variable));
 
     // ݂̃g[NϐłƉ肵Ă
     if (this->mTokenStream->CurrentToken()->Type() != TokenType::Variable)
-        return nullptr;
+        return this->ReportError(DiagnosticCode::UnexpectedToken, ToTokenTypeSet(TokenType::Variable));
 
     // g[NϐȂ̂ɕϐꍇ̓G[Ԃ
     if (this->mTokenStream->CurrentToken()->Text().empty())
+        return this->ReportError(DiagnosticCode::InternalError);
+
+    if (!this->ChargeASTNode())
         return nullptr;
 
     // Variable쐬
     std::shared_ptr<VariableAST> newAST = std::make_shared<VariableAST>(this->mTokenStream->CurrentToken()->Text());
+    this->mSubtreeDepth = 1U;
 
     // g[N1ɐi߂
     this->mTokenStream->MoveNext();
@@ -70,12 +302,36 @@ std::shared_ptr<VariableAST> Parser::VisitVariable()
 std::shared_ptr<BaseAST> InfixParser::Parse()
 {
     assert(this->mTokenStream != nullptr);
+
+    ScopedPhaseTimer phaseTimer(Phase::ParseInfix);
     
-    std::shared_ptr<BaseAST> logicalExprAST = this->VisitExpression();
+    std::shared_ptr<BaseAST> logicalExprAST = this->VisitExpression(0);
 
     // ͂ĂȂg[NcĂꍇ̓G[Ԃ
     if (this->mTokenStream->CurrentToken() != nullptr)
-        return nullptr;
+        return this->ReportError(DiagnosticCode::TrailingTokens, ToTokenTypeSet(TokenType::End));
+
+    return logicalExprAST;
+}
+
+std::shared_ptr<BaseAST> InfixParser::ParseLazy()
+{
+    assert(this->mTokenStream != nullptr);
+
+    // Xg[~O̓g[NێłȂ̂, ʏʂ\͂
+    // Ǘꍇ, ʂ̒̐[ƃm[h\͂̎_Ő邽ߒʏʂ\͂
+    if (this->mTokenStream->IsStreaming() || this->mGovernor != nullptr)
+        return this->Parse();
+
+    std::shared_ptr<BracketIndex> bracketIndex = BracketIndex::Build(*this->mTokenStream);
+
+    // \Ɍ肪ꍇ, G[̈ʒu񍐂邽ߒʏʂ\͂
+    if (bracketIndex == nullptr)
+        return this->Parse();
+
+    this->mLazySource = std::make_shared<LazyInfixSource>(this->mTokenStream, bracketIndex, this->mDiagnostics);
+    std::shared_ptr<BaseAST> logicalExprAST = this->Parse();
+    this->mLazySource = nullptr;
 
     return logicalExprAST;
 }
@@ -90,7 +346,7 @@ std::shared_ptr<BaseAST> InfixParser::VisitFactor()
     */
 
     if (this->mTokenStream->CurrentToken() == nullptr)
-        return nullptr;
+        return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, FactorTokens);
 
     if ((this->mTokenStream->CurrentToken()->Type() == TokenType::True) ||
         (this->mTokenStream->CurrentToken()->Type() == TokenType::False))
@@ -100,97 +356,100 @@ std::shared_ptr<BaseAST> InfixParser::VisitFactor()
         return this->VisitVariable();
 
     if (this->mTokenStream->CurrentToken()->Type() == TokenType::LeftParenthesis) {
+        // x\͂ł, ʂ̒gg[N͈̔͂ƂĎcđΉEʂ̎ɐi
+        if (this->mLazySource != nullptr) {
+            std::size_t leftIndex = this->mTokenStream->CurrentIndex();
+            std::size_t rightIndex = this->mLazySource->Brackets().Match(leftIndex);
+            this->mTokenStream->SetCurrentIndex(rightIndex + 1U);
+
+            return std::make_shared<FactorAST>(this->mLazySource, leftIndex + 1U, rightIndex);
+        }
+
         if (!this->mTokenStream->MoveNext())
+            return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, NotExpressionTokens);
+
+        NestingScope nestingScope(this->mNestingLevel);
+
+        if (!this->CheckNestingDepth(this->mNestingLevel))
             return nullptr;
 
-        std::shared_ptr<BaseAST> exprAST = this->VisitExpression();
+        std::shared_ptr<BaseAST> exprAST = this->VisitExpression(0);
 
         if (exprAST == nullptr)
             return nullptr;
 
         // ΉEʂ݂Ȃ (Ƀg[N̖ɒBĂ)
         if (this->mTokenStream->CurrentToken() == nullptr)
-            return nullptr;
+            return this->ReportError(DiagnosticCode::MissingRightParenthesis, ToTokenTypeSet(TokenType::RightParenthesis));
 
         if (this->mTokenStream->CurrentToken()->Type() != TokenType::RightParenthesis)
-            return nullptr;
+            return this->ReportError(DiagnosticCode::UnexpectedToken, ToTokenTypeSet(TokenType::RightParenthesis));
 
         this->mTokenStream->MoveNext();
 
+        if (!this->CheckNestingDepth(++this->mSubtreeDepth) || !this->ChargeASTNode())
+            return nullptr;
+
         return std::make_shared<FactorAST>(exprAST);
     }
 
-    return nullptr;
+    return this->ReportError(DiagnosticCode::UnexpectedToken, FactorTokens);
 }
 
-std::shared_ptr<BaseAST> InfixParser::VisitExpression()
+std::shared_ptr<BaseAST> InfixParser::VisitExpression(int minPrecedence)
 {
     /*
-    <Expression> ::=
-        <AndOrExpression> |
-        <AndOrExpression> '->' <AndOrExpression> |
-        <AndOrExpression> '<->' <AndOrExpression>
+    <Expression> ::= <NotExpression> { <BinaryOperator> <Expression> }
+    Zq̗D揇ʂƌ͉Zq̕\ɏ] (D揇ʖ@)
     */
 
-    std::shared_ptr<BaseAST> leftAndOrExprAST = this->VisitAndOrExpression();
+    std::shared_ptr<BaseAST> leftExprAST = this->VisitNotExpression();
 
-    if (leftAndOrExprAST == nullptr)
+    if (leftExprAST == nullptr)
         return nullptr;
 
-    if (this->mTokenStream->CurrentToken() == nullptr)
-        return leftAndOrExprAST;
-
-    if ((this->mTokenStream->CurrentToken()->Type() == TokenType::Then) ||
-        (this->mTokenStream->CurrentToken()->Type() == TokenType::Eq)) {
-        std::string op = (this->mTokenStream->CurrentToken()->Type() == TokenType::Then) ? "->" : "<->";
-
-        if (!this->mTokenStream->MoveNext())
-            return nullptr;
+    std::size_t leftDepth = this->mSubtreeDepth;
 
-        std::shared_ptr<BaseAST> rightAndOrExprAST = this->VisitAndOrExpression();
+    while (this->mTokenStream->CurrentToken() != nullptr) {
+        const BinaryOperator* binaryOperator = FindBinaryOperator(this->mTokenStream->CurrentToken()->Type());
 
-        if (rightAndOrExprAST == nullptr)
-            return nullptr;
+        // 2ZqłȂ, D揇ʂႢZq͌Ăяoŏ
+        if (binaryOperator == nullptr || binaryOperator->mPrecedence < minPrecedence)
+            break;
 
-        return std::make_shared<ExpressionAST>(leftAndOrExprAST, rightAndOrExprAST, op);
-    } else {
-        return leftAndOrExprAST;
-    }
-}
+        if (!this->mTokenStream->MoveNext())
+            return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, NotExpressionTokens);
 
-std::shared_ptr<BaseAST> InfixParser::VisitAndOrExpression()
-{
-    /*
-    <AndOrExpression> ::=
-        <NotExpression> |
-        <NotExpression> 'And' <NotExpression> |
-        <NotExpression> 'Or' <NotExpression>
-    */
+        std::shared_ptr<BaseAST> rightExprAST;
 
-    std::shared_ptr<BaseAST> leftNotExprAST = this->VisitNotExpression();
+        {
+            NestingScope nestingScope(this->mNestingLevel);
 
-    if (leftNotExprAST == nullptr)
-        return nullptr;
+            if (!this->CheckNestingDepth(this->mNestingLevel))
+                return nullptr;
 
-    if (this->mTokenStream->CurrentToken() == nullptr)
-        return leftNotExprAST;
+            // ̏ꍇ, Eӂɂ͂D揇ʂ̍Zq݂̂܂߂
+            rightExprAST = this->VisitExpression(
+                binaryOperator->mRightAssociative ? binaryOperator->mPrecedence : binaryOperator->mPrecedence + 1);
+        }
 
-    if ((this->mTokenStream->CurrentToken()->Type() == TokenType::And) ||
-        (this->mTokenStream->CurrentToken()->Type() == TokenType::Or)) {
-        std::string op = (this->mTokenStream->CurrentToken()->Type() == TokenType::And) ? "" : "";
+        if (rightExprAST == nullptr)
+            return nullptr;
 
-        if (!this->mTokenStream->MoveNext())
+        if (!this->ChargeASTNode())
             return nullptr;
 
-        std::shared_ptr<BaseAST> rightNotExprAST = this->VisitNotExpression();
+        // ̉Zq̘A͍ċAɐ[Ȃ̂, ؂̐[ׂ
+        leftDepth = BinaryExpressionDepth(*binaryOperator, leftExprAST, rightExprAST, leftDepth, this->mSubtreeDepth);
+        leftExprAST = MakeBinaryExpression(*binaryOperator, std::move(leftExprAST), rightExprAST);
 
-        if (rightNotExprAST == nullptr)
+        if (!this->CheckNestingDepth(leftDepth))
             return nullptr;
-
-        return std::make_shared<AndOrExpressionAST>(leftNotExprAST, rightNotExprAST, op);
-    } else {
-        return leftNotExprAST;
     }
+
+    this->mSubtreeDepth = leftDepth;
+
+    return leftExprAST;
 }
 
 std::shared_ptr<BaseAST> InfixParser::VisitNotExpression()
@@ -198,22 +457,30 @@ std::shared_ptr<BaseAST> InfixParser::VisitNotExpression()
     /*
     <NotExpression> ::=
         <Factor> |
-        'Not' <Factor>
+        'Not' <NotExpression>
     */
 
     if (this->mTokenStream->CurrentToken() == nullptr)
-        return nullptr;
+        return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, NotExpressionTokens);
 
     if (this->mTokenStream->CurrentToken()->Type() == TokenType::Not) {
         if (!this->mTokenStream->MoveNext())
+            return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, NotExpressionTokens);
+
+        NestingScope nestingScope(this->mNestingLevel);
+
+        if (!this->CheckNestingDepth(this->mNestingLevel))
             return nullptr;
 
-        std::shared_ptr<BaseAST> factorAST = this->VisitFactor();
+        std::shared_ptr<BaseAST> exprAST = this->VisitNotExpression();
+
+        if (exprAST == nullptr)
+            return nullptr;
 
-        if (factorAST == nullptr)
+        if (!this->CheckNestingDepth(++this->mSubtreeDepth) || !this->ChargeASTNode())
             return nullptr;
 
-        return std::make_shared<NotExpressionAST>(factorAST);
+        return std::make_shared<NotExpressionAST>(exprAST);
     } else {
         return this->VisitFactor();
     }
@@ -227,248 +494,132 @@ std::shared_ptr<BaseAST> PrefixParser::Parse()
 {
     assert(this->mTokenStream != nullptr);
 
-    if (this->mTokenStream->CurrentToken() == nullptr)
-        return nullptr;
+    ScopedPhaseTimer phaseTimer(Phase::ParsePrefix);
 
-    std::shared_ptr<BaseAST> logicalExprAST;
+    std::shared_ptr<BaseAST> logicalExprAST = this->VisitOperand();
 
-    switch (this->mTokenStream->CurrentToken()->Type()) {
-        case TokenType::True:
-        case TokenType::False:
-            logicalExprAST = this->VisitConstant();
-            break;
-        case TokenType::Variable:
-            logicalExprAST = this->VisitVariable();
-            break;
-        case TokenType::And:
-        case TokenType::Or:
-            logicalExprAST = this->VisitAndOrExpression();
-            break;
-        case TokenType::Not:
-            logicalExprAST = this->VisitNotExpression();
-            break;
-        case TokenType::Then:
-        case TokenType::Eq:
-            logicalExprAST = this->VisitThenOrEqExpression();
-            break;
-        default:
-            return nullptr;
-    }
+    if (logicalExprAST == nullptr)
+        return nullptr;
 
     // ͂ĂȂg[NcĂꍇ̓G[Ԃ
     if (this->mTokenStream->CurrentToken() != nullptr)
-        return nullptr;
+        return this->ReportError(DiagnosticCode::TrailingTokens, ToTokenTypeSet(TokenType::End));
 
     return logicalExprAST;
 }
 
-std::shared_ptr<BaseAST> PrefixParser::VisitThenOrEqExpression()
+std::shared_ptr<BaseAST> PrefixParser::VisitOperand()
 {
+    // ̃g[Nꍇ̓G[Ԃ
     if (this->mTokenStream->CurrentToken() == nullptr)
-        return nullptr;
+        return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, PrefixTokens);
 
-    std::shared_ptr<ExpressionAST> exprAST = std::make_shared<ExpressionAST>();
-
-    // Zq̃g[N
-    if (this->mTokenStream->CurrentToken()->Type() == TokenType::Then ||
-        this->mTokenStream->CurrentToken()->Type() == TokenType::Eq) {
-        std::string op = (this->mTokenStream->CurrentToken()->Type() == TokenType::Then) ? "->" : "<->";
-
-        // ̃g[Nꍇ̓G[Ԃ
-        if (!this->mTokenStream->MoveNext())
-            return nullptr;
-
-        exprAST->SetOperator(op);
-    } else {
-        return nullptr;
-    }
-
-    // 
     switch (this->mTokenStream->CurrentToken()->Type()) {
         case TokenType::True:
         case TokenType::False:
-            exprAST->SetLeft(this->VisitConstant());
-            break;
+            return this->VisitConstant();
         case TokenType::Variable:
-            exprAST->SetLeft(this->VisitVariable());
-            break;
-        case TokenType::And:
-        case TokenType::Or:
-            exprAST->SetLeft(this->VisitAndOrExpression());
-            break;
+            return this->VisitVariable();
         case TokenType::Not:
-            exprAST->SetLeft(this->VisitNotExpression());
-            break;
-        case TokenType::Then:
-        case TokenType::Eq:
-            exprAST->SetLeft(this->VisitThenOrEqExpression());
-            break;
+            return this->VisitNotExpression();
         default:
-            return nullptr;
+            break;
     }
 
-    if (exprAST->Left() == nullptr)
-        return nullptr;
+    const BinaryOperator* binaryOperator = FindBinaryOperator(this->mTokenStream->CurrentToken()->Type());
 
-    // ̃g[Nꍇ̓G[Ԃ
-    if (this->mTokenStream->CurrentToken() == nullptr)
-        return nullptr;
+    if (binaryOperator == nullptr)
+        return this->ReportError(DiagnosticCode::UnexpectedToken, PrefixTokens);
 
-    // E
-    switch (this->mTokenStream->CurrentToken()->Type()) {
-        case TokenType::True:
-        case TokenType::False:
-            exprAST->SetRight(this->VisitConstant());
-            break;
-        case TokenType::Variable:
-            exprAST->SetRight(this->VisitVariable());
-            break;
-        case TokenType::And:
-        case TokenType::Or:
-            exprAST->SetRight(this->VisitAndOrExpression());
-            break;
-        case TokenType::Not:
-            exprAST->SetRight(this->VisitNotExpression());
-            break;
-        case TokenType::Then:
-        case TokenType::Eq:
-            exprAST->SetRight(this->VisitThenOrEqExpression());
-            break;
-        default:
-            return nullptr;
-    }
+    return this->VisitBinaryExpression(*binaryOperator);
+}
+
+std::shared_ptr<BaseAST> PrefixParser::VisitBinaryExpression(const BinaryOperator& binaryOperator)
+{
+    // Zq̃g[N̎̃g[Nꍇ̓G[Ԃ
+    if (!this->mTokenStream->MoveNext())
+        return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, PrefixTokens);
+
+    NestingScope nestingScope(this->mNestingLevel);
 
-    if (exprAST->Right() == nullptr)
+    if (!this->CheckNestingDepth(this->mNestingLevel))
         return nullptr;
 
-    return exprAST;
-}
+    // 
+    std::shared_ptr<BaseAST> leftExprAST = this->VisitOperand();
 
-std::shared_ptr<BaseAST> PrefixParser::VisitAndOrExpression()
-{
-    if (this->mTokenStream->CurrentToken() == nullptr)
+    if (leftExprAST == nullptr)
         return nullptr;
 
-    std::shared_ptr<AndOrExpressionAST> andOrExprAST = std::make_shared<AndOrExpressionAST>();
+    std::size_t leftDepth = this->mSubtreeDepth;
 
-    // Zq̃g[N
-    if (this->mTokenStream->CurrentToken()->Type() == TokenType::And ||
-        this->mTokenStream->CurrentToken()->Type() == TokenType::Or) {
-        std::string op = (this->mTokenStream->CurrentToken()->Type() == TokenType::And) ? "" : "";
+    // AndOr̉E؂ZqŎn܂ꍇ (EɓqɂȂA) , ċA
+    // q̍؂ɍӂւ܂Ƃ߂ (AŜ1̃m[h1񂾂)
+    if (binaryOperator.mTokenType == TokenType::And || binaryOperator.mTokenType == TokenType::Or) {
+        while (this->mTokenStream->CurrentToken() != nullptr &&
+               this->mTokenStream->CurrentToken()->Type() == binaryOperator.mTokenType) {
+            if (!this->mTokenStream->MoveNext())
+                return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, PrefixTokens);
 
-        // ̃g[Nꍇ̓G[Ԃ
-        if (!this->mTokenStream->MoveNext())
-            return nullptr;
+            std::shared_ptr<BaseAST> operandAST = this->VisitOperand();
 
-        andOrExprAST->SetOperator(op);
-    } else {
-        return nullptr;
-    }
+            if (operandAST == nullptr || !this->ChargeASTNode())
+                return nullptr;
 
-    // 
-    switch (this->mTokenStream->CurrentToken()->Type()) {
-        case TokenType::True:
-        case TokenType::False:
-            andOrExprAST->SetLeft(this->VisitConstant());
-            break;
-        case TokenType::Variable:
-            andOrExprAST->SetLeft(this->VisitVariable());
-            break;
-        case TokenType::And:
-        case TokenType::Or:
-            andOrExprAST->SetLeft(this->VisitAndOrExpression());
-            break;
-        case TokenType::Not:
-            andOrExprAST->SetLeft(this->VisitNotExpression());
-            break;
-        case TokenType::Then:
-        case TokenType::Eq:
-            andOrExprAST->SetLeft(this->VisitThenOrEqExpression());
-            break;
-        default:
-            return nullptr;
+            leftDepth = BinaryExpressionDepth(binaryOperator, leftExprAST, operandAST, leftDepth, this->mSubtreeDepth);
+            leftExprAST = MakeBinaryExpression(binaryOperator, std::move(leftExprAST), operandAST);
+
+            if (!this->CheckNestingDepth(leftDepth))
+                return nullptr;
+        }
     }
 
-    if (andOrExprAST->Left() == nullptr)
+    // E
+    std::shared_ptr<BaseAST> rightExprAST = this->VisitOperand();
+
+    if (rightExprAST == nullptr)
         return nullptr;
 
-    // ̃g[Nꍇ̓G[Ԃ
-    if (this->mTokenStream->CurrentToken() == nullptr)
+    if (!this->ChargeASTNode())
         return nullptr;
 
-    // E
-    switch (this->mTokenStream->CurrentToken()->Type()) {
-        case TokenType::True:
-        case TokenType::False:
-            andOrExprAST->SetRight(this->VisitConstant());
-            break;
-        case TokenType::Variable:
-            andOrExprAST->SetRight(this->VisitVariable());
-            break;
-        case TokenType::And:
-        case TokenType::Or:
-            andOrExprAST->SetRight(this->VisitAndOrExpression());
-            break;
-        case TokenType::Not:
-            andOrExprAST->SetRight(this->VisitNotExpression());
-            break;
-        case TokenType::Then:
-        case TokenType::Eq:
-            andOrExprAST->SetRight(this->VisitThenOrEqExpression());
-            break;
-        default:
-            return nullptr;
-    }
+    this->mSubtreeDepth = BinaryExpressionDepth(binaryOperator, leftExprAST, rightExprAST, leftDepth, this->mSubtreeDepth);
+    std::shared_ptr<BaseAST> exprAST = MakeBinaryExpression(binaryOperator, std::move(leftExprAST), rightExprAST);
 
-    if (andOrExprAST->Right() == nullptr)
+    if (!this->CheckNestingDepth(this->mSubtreeDepth))
         return nullptr;
 
-    return andOrExprAST;
+    return exprAST;
 }
 
 std::shared_ptr<BaseAST> PrefixParser::VisitNotExpression()
 {
     if (this->mTokenStream->CurrentToken() == nullptr)
-        return nullptr;
+        return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, ToTokenTypeSet(TokenType::Not));
 
     // Zq̃g[N
     if (this->mTokenStream->CurrentToken()->Type() != TokenType::Not)
-        return nullptr;
+        return this->ReportError(DiagnosticCode::UnexpectedToken, ToTokenTypeSet(TokenType::Not));
 
     // ̃g[Nꍇ̓G[Ԃ
     if (!this->mTokenStream->MoveNext())
-        return nullptr;
+        return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, PrefixTokens);
 
-    std::shared_ptr<NotExpressionAST> notExprAST = std::make_shared<NotExpressionAST>();
+    NestingScope nestingScope(this->mNestingLevel);
+
+    if (!this->CheckNestingDepth(this->mNestingLevel))
+        return nullptr;
 
     // Iyh
-    switch (this->mTokenStream->CurrentToken()->Type()) {
-        case TokenType::True:
-        case TokenType::False:
-            notExprAST->SetExpr(this->VisitConstant());
-            break;
-        case TokenType::Variable:
-            notExprAST->SetExpr(this->VisitVariable());
-            break;
-        case TokenType::And:
-        case TokenType::Or:
-            notExprAST->SetExpr(this->VisitAndOrExpression());
-            break;
-        case TokenType::Not:
-            notExprAST->SetExpr(this->VisitNotExpression());
-            break;
-        case TokenType::Then:
-        case TokenType::Eq:
-            notExprAST->SetExpr(this->VisitThenOrEqExpression());
-            break;
-        default:
-            return nullptr;
-    }
+    std::shared_ptr<BaseAST> exprAST = this->VisitOperand();
+
+    if (exprAST == nullptr)
+        return nullptr;
 
-    if (notExprAST->Expr() == nullptr)
+    if (!this->CheckNestingDepth(++this->mSubtreeDepth) || !this->ChargeASTNode())
         return nullptr;
 
-    return notExprAST;
+    return std::make_shared<NotExpressionAST>(exprAST);
 }
 
 //
@@ -478,102 +629,283 @@ std::shared_ptr<BaseAST> PostfixParser::Parse()
 {
     assert(this->mTokenStream != nullptr);
 
+    ScopedPhaseTimer phaseTimer(Phase::ParsePostfix);
+
+    // O̍\͂rŎsꍇ̐ςݎĉĂ (͍̈ėp)
+    this->mASTStack.clear();
+    this->mDepthStack.clear();
+    this->mRunOperator = nullptr;
+    this->mRunLength = 0U;
+
     if (this->mTokenStream->CurrentToken() == nullptr)
-        return nullptr;
+        return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, PostfixTokens);
 
     while (this->mTokenStream->CurrentToken() != nullptr) {
+        // ۗĂAnd܂Or̘A, ZqȊÕg[NꂽƂɂ܂Ƃ߂
+        if (this->mRunLength != 0U && this->mTokenStream->CurrentToken()->Type() != this->mRunOperator->mTokenType &&
+            !this->ReduceRun())
+            return nullptr;
+
         switch (this->mTokenStream->CurrentToken()->Type()) {
             case TokenType::True:
             case TokenType::False:
             {
-                this->mASTStack.push(this->VisitConstant());
+                std::shared_ptr<BaseAST> constantAST = this->VisitConstant();
+
+                if (constantAST == nullptr)
+                    return nullptr;
+
+                this->mASTStack.push_back(std::move(constantAST));
+                this->mDepthStack.push_back(1U);
                 continue;
             }
             case TokenType::Variable:
             {
-                this->mASTStack.push(this->VisitVariable());
-                continue;
-            }
-            case TokenType::And:
-            case TokenType::Or:
-            {
-                if (this->mASTStack.empty())
-                    return nullptr;
-
-                std::shared_ptr<BaseAST> rightExprAST = this->mASTStack.top();
-                this->mASTStack.pop();
+                std::shared_ptr<BaseAST> variableAST = this->VisitVariable();
 
-                if (this->mASTStack.empty())
+                if (variableAST == nullptr)
                     return nullptr;
 
-                std::shared_ptr<BaseAST> leftExprAST = this->mASTStack.top();
-                this->mASTStack.pop();
-
-                std::shared_ptr<AndOrExpressionAST> andOrExprAST = std::make_shared<AndOrExpressionAST>();
-
-                andOrExprAST->SetOperator((this->mTokenStream->CurrentToken()->Type() == TokenType::And) ? "" : "");
-                andOrExprAST->SetLeft(leftExprAST);
-                andOrExprAST->SetRight(rightExprAST);
-
-                this->mASTStack.push(andOrExprAST);
-                break;
+                this->mASTStack.push_back(std::move(variableAST));
+                this->mDepthStack.push_back(1U);
+                continue;
             }
             case TokenType::Not:
             {
                 if (this->mASTStack.empty())
+                    return this->ReportError(DiagnosticCode::StackUnderflow, PostfixTokens);
+
+                // uL@͍ċAȂ̂, [͕؂̐[݂̂𒲂ׂ
+                if (!this->CheckNestingDepth(++this->mDepthStack.back()) || !this->ChargeASTNode())
                     return nullptr;
 
-                std::shared_ptr<BaseAST> exprAST = this->mASTStack.top();
-                this->mASTStack.pop();
+                std::shared_ptr<BaseAST> exprAST = std::move(this->mASTStack.back());
+                this->mASTStack.pop_back();
 
                 std::shared_ptr<NotExpressionAST> notExprAST = std::make_shared<NotExpressionAST>();
                 notExprAST->SetExpr(exprAST);
 
-                this->mASTStack.push(notExprAST);
+                this->mASTStack.push_back(notExprAST);
                 break;
             }
-            case TokenType::Then:
-            case TokenType::Eq:
+            default:
             {
-                if (this->mASTStack.empty())
-                    return nullptr;
+                // 2Zq
+                const BinaryOperator* binaryOperator = FindBinaryOperator(this->mTokenStream->CurrentToken()->Type());
 
-                std::shared_ptr<BaseAST> rightExprAST = this->mASTStack.top();
-                this->mASTStack.pop();
+                if (binaryOperator == nullptr)
+                    return this->ReportError(DiagnosticCode::UnexpectedToken, PostfixTokens);
 
-                if (this->mASTStack.empty())
+                // Iyh2ς܂ĂȂ (ۗĂ鉉ZqgIyh)
+                if (this->mASTStack.size() - this->mRunLength < 2U)
+                    return this->ReportError(DiagnosticCode::StackUnderflow, PostfixTokens);
+
+                if (!this->ChargeASTNode())
                     return nullptr;
 
-                std::shared_ptr<BaseAST> leftExprAST = this->mASTStack.top();
-                this->mASTStack.pop();
+                // AndOr̘A (EɓqɂȂA) 1񂸂m[hƃIyh̕
+                // A̒2ɂȂ̂, AI܂ŕۗ1̃m[hɂ܂Ƃ߂
+                if (binaryOperator->mTokenType == TokenType::And || binaryOperator->mTokenType == TokenType::Or) {
+                    this->mRunOperator = binaryOperator;
+                    ++this->mRunLength;
+                    break;
+                }
 
-                std::shared_ptr<ExpressionAST> exprAST = std::make_shared<ExpressionAST>();
+                std::shared_ptr<BaseAST> rightExprAST = std::move(this->mASTStack.back());
+                this->mASTStack.pop_back();
+                std::size_t rightDepth = this->mDepthStack.back();
+                this->mDepthStack.pop_back();
 
-                exprAST->SetOperator((this->mTokenStream->CurrentToken()->Type() == TokenType::Then) ? "->" : "<->");
-                exprAST->SetLeft(leftExprAST);
-                exprAST->SetRight(rightExprAST);
+                std::shared_ptr<BaseAST> leftExprAST = std::move(this->mASTStack.back());
+                this->mASTStack.pop_back();
 
-                this->mASTStack.push(exprAST);
+                this->mDepthStack.back() = BinaryExpressionDepth(*binaryOperator, leftExprAST, rightExprAST, this->mDepthStack.back(), rightDepth);
+                std::shared_ptr<BaseAST> exprAST = MakeBinaryExpression(*binaryOperator, std::move(leftExprAST), rightExprAST);
+
+                if (!this->CheckNestingDepth(this->mDepthStack.back()))
+                    return nullptr;
+
+                this->mASTStack.push_back(std::move(exprAST));
                 break;
             }
-            default:
-                return nullptr;
         }
 
         if (!this->mTokenStream->MoveNext())
             break;
     }
 
+    if (!this->ReduceRun())
+        return nullptr;
+
     // X^bNɂ͊ۍ\؂1ς܂Ă
     if (this->mASTStack.empty())
-        return nullptr;
+        return this->ReportError(DiagnosticCode::UnexpectedEndOfInput, PostfixTokens);
 
-    std::shared_ptr<BaseAST> logicalExprAST = this->mASTStack.top();
-    this->mASTStack.pop();
+    std::shared_ptr<BaseAST> logicalExprAST = std::move(this->mASTStack.back());
+    this->mASTStack.pop_back();
 
     // X^bNɐςݎcꍇ̓G[Ԃ
     if (!this->mASTStack.empty())
-        return nullptr;
+        return this->ReportError(DiagnosticCode::StackNotEmpty, BinaryOperatorTokens);
 
     return logicalExprAST;
 }
+
+bool PostfixParser::ReduceRun()
+{
+    if (this->mRunLength == 0U)
+        return true;
+
+    // AmRunLength̉Zq̓X^bN̏ォmRunLength + 1̃IyhE珇ɂ܂Ƃ߂
+    // AndOr͌ɂIyhׂ1̃m[hɂȂ̂, 珇ɂ܂Ƃ߂Ă؂ɂȂ
+    const BinaryOperator& binaryOperator = *this->mRunOperator;
+    std::size_t firstIndex = this->mASTStack.size() - this->mRunLength - 1U;
+    std::shared_ptr<BaseAST> exprAST = std::move(this->mASTStack[firstIndex]);
+    std::size_t depth = this->mDepthStack[firstIndex];
+
+    for (std::size_t i = firstIndex + 1U; i < this->mASTStack.size(); ++i) {
+        depth = BinaryExpressionDepth(binaryOperator, exprAST, this->mASTStack[i], depth, this->mDepthStack[i]);
+        exprAST = MakeBinaryExpression(binaryOperator, std::move(exprAST), this->mASTStack[i]);
+    }
+
+    this->mASTStack.resize(firstIndex + 1U);
+    this->mDepthStack.resize(firstIndex + 1U);
+    this->mASTStack.back() = std::move(exprAST);
+    this->mDepthStack.back() = depth;
+    this->mRunOperator = nullptr;
+    this->mRunLength = 0U;
+
+    return this->CheckNestingDepth(depth);
+}
+
+static bool KeepFarthestError(Diagnostics& diagnostics, const Diagnostics& notationDiagnostics, const ResourceGovernor* governor)
+{
+    // s͑̋L@, s̃G[c
+    if (governor != nullptr && governor->IsExhausted()) {
+        diagnostics = notationDiagnostics;
+        return false;
+    }
+
+    // ł܂ō\͂łL@̃G[c
+    if (!diagnostics.HasError() || notationDiagnostics.TokenIndex() > diagnostics.TokenIndex())
+        diagnostics = notationDiagnostics;
+
+    return true;
+}
+
+static std::shared_ptr<BaseAST> ParseAllNotations(TokenStream& tokenStream, InfixParser& infixParser,
+    PrefixParser& prefixParser, PostfixParser& postfixParser, Notation* lastNotation, Diagnostics& diagnostics, const ResourceGovernor* governor)
+{
+    Diagnostics notationDiagnostics;
+
+    // Infix ExpressionƉ肵č\
+    if (lastNotation != nullptr)
+        *lastNotation = Notation::Infix;
+
+    PerformanceCounters::CountParseAttempt(Notation::Infix);
+    infixParser.SetDiagnostics(&notationDiagnostics);
+    std::shared_ptr<BaseAST> exprAST = infixParser.Parse();
+
+    if (exprAST != nullptr)
+        return exprAST;
+
+    if (!KeepFarthestError(diagnostics, notationDiagnostics, governor))
+        return nullptr;
+
+    notationDiagnostics.Clear();
+
+    // Infix ExpressionƉ肵č\͂肭Ȃꍇ, g[N߂
+    tokenStream.SetCurrentIndex(0U);
+
+    // Prefix ExpressionƉ肵č\
+    if (lastNotation != nullptr)
+        *lastNotation = Notation::Prefix;
+
+    PerformanceCounters::CountParseAttempt(Notation::Prefix);
+    prefixParser.SetDiagnostics(&notationDiagnostics);
+    exprAST = prefixParser.Parse();
+
+    if (exprAST != nullptr)
+        return exprAST;
+
+    if (!KeepFarthestError(diagnostics, notationDiagnostics, governor))
+        return nullptr;
+
+    notationDiagnostics.Clear();
+
+    // Prefix ExpressionƉ肵č\͂肭Ȃꍇ, g[N߂
+    tokenStream.SetCurrentIndex(0U);
+
+    // Postfix ExpressionƉ肵č\
+    if (lastNotation != nullptr)
+        *lastNotation = Notation::Postfix;
+
+    PerformanceCounters::CountParseAttempt(Notation::Postfix);
+    postfixParser.SetDiagnostics(&notationDiagnostics);
+    exprAST = postfixParser.Parse();
+
+    if (exprAST != nullptr) {
+        diagnostics.Clear();
+        return exprAST;
+    }
+
+    KeepFarthestError(diagnostics, notationDiagnostics, governor);
+
+    return nullptr;
+}
+
+std::shared_ptr<BaseAST> ParseLogicalExpression(
+    const std::shared_ptr<TokenStream>& tokenStream, Notation* lastNotation, Diagnostics& diagnostics, ResourceGovernor* governor)
+{
+    InfixParser infixParser(tokenStream);
+    PrefixParser prefixParser(tokenStream);
+    PostfixParser postfixParser(tokenStream);
+
+    infixParser.SetGovernor(governor);
+    prefixParser.SetGovernor(governor);
+    postfixParser.SetGovernor(governor);
+
+    return ParseAllNotations(*tokenStream, infixParser, prefixParser, postfixParser, lastNotation, diagnostics, governor);
+}
+
+//
+// ParserSessionNX
+//
+
+ParserSession::ParserSession() :
+    mTokenStream(std::make_shared<TokenStream>()),
+    mInfixParser(mTokenStream),
+    mPrefixParser(mTokenStream),
+    mPostfixParser(mTokenStream),
+    mGovernor(nullptr)
+{
+}
+
+void ParserSession::SetGovernor(ResourceGovernor* governor)
+{
+    this->mGovernor = governor;
+    this->mInfixParser.SetGovernor(governor);
+    this->mPrefixParser.SetGovernor(governor);
+    this->mPostfixParser.SetGovernor(governor);
+}
+
+bool ParserSession::Lex(const std::string& logicalExpr, Diagnostics* diagnostics)
+{
+    return Lexer(logicalExpr, *this->mTokenStream, diagnostics, this->mGovernor);
+}
+
+std::shared_ptr<BaseAST> ParserSession::Parse(Notation* lastNotation, Diagnostics& diagnostics)
+{
+    this->mTokenStream->SetCurrentIndex(0U);
+
+    return ParseAllNotations(*this->mTokenStream, this->mInfixParser,
+        this->mPrefixParser, this->mPostfixParser, lastNotation, diagnostics, this->mGovernor);
+}
+
+std::shared_ptr<BaseAST> ParserSession::Parse(const std::string& logicalExpr, Notation* lastNotation, Diagnostics& diagnostics)
+{
+    if (!this->Lex(logicalExpr, &diagnostics))
+        return nullptr;
+
+    return this->Parse(lastNotation, diagnostics);
+}
@@ -10,67 +10,176 @@
 #include <cassert>
 #include <functional>
 #include <memory>
-#include <stack>
 #include <string>
 #include <vector>
 
+#include "Diagnostics.hpp"
+#include "ResourceGovernor.hpp"
+
 class Token;
 class TokenStream;
+enum class TokenType;
+enum class Notation;
 class BaseAST;
 class ExpressionAST;
 class ConstantAST;
 class VariableAST;
 
+struct BinaryOperator {
+    TokenType   mTokenType;
+    int         mPrecedence;
+    bool        mRightAssociative;
+    const char* mSymbol;
+};
+
+const BinaryOperator* FindBinaryOperator(TokenType tokenType);
+// ӂ[uœn, AndOr̘Aōӂ̃m[h𕡐ɍėp
+std::shared_ptr<BaseAST> MakeBinaryExpression(
+    const BinaryOperator& binaryOperator, std::shared_ptr<BaseAST> left, const std::shared_ptr<BaseAST>& right);
+
+// uL@̃g[N̊ʂ̑Ή\
+// 1̑ō\Ȃ, ʂ̈ʒuΉEʂ̈ʒu悤ɂ
+class BracketIndex {
+public:
+    BracketIndex() = default;
+    ~BracketIndex() = default;
+
+    // ݂̈ʒu疖܂łuL@ƂĐȂꍇnullptrԂ
+    static std::shared_ptr<BracketIndex> Build(const TokenStream& tokenStream);
+
+    inline std::size_t Match(std::size_t leftIndex) const { return this->mMatches[leftIndex]; }
+
+private:
+    std::vector<std::size_t> mMatches;
+};
+
+class LazyInfixSource;
+
 class Parser {
 public:
-    Parser(const std::shared_ptr<TokenStream>& tokenStream) : mTokenStream(tokenStream) { }
+    Parser(const std::shared_ptr<TokenStream>& tokenStream, Diagnostics* diagnostics = nullptr) :
+        mTokenStream(tokenStream), mDiagnostics(diagnostics), mGovernor(nullptr), mNestingLevel(0U), mSubtreeDepth(0U) { }
     virtual ~Parser() { }
 
+    inline void SetDiagnostics(Diagnostics* diagnostics) { this->mDiagnostics = diagnostics; }
+    // ۍ\؂̃m[h, ċAђۍ\؂̐[ɏ݂
+    inline void SetGovernor(ResourceGovernor* governor) { this->mGovernor = governor; }
+
     virtual std::shared_ptr<BaseAST> Parse() { return nullptr; }
     virtual std::shared_ptr<ConstantAST> VisitConstant();
     virtual std::shared_ptr<VariableAST> VisitVariable();
 
 protected:
+    std::nullptr_t ReportError(DiagnosticCode code, TokenTypeSet expectedTokens = 0U);
+
+    // 𒴂ꍇ͐s̃G[L^falseԂ
+    inline bool ChargeASTNode() {
+        return this->mGovernor == nullptr || this->mGovernor->ChargeASTNodes(1U) || this->ReportExhausted(); }
+    inline bool CheckNestingDepth(std::size_t depth) {
+        return this->mGovernor == nullptr || this->mGovernor->CheckNestingDepth(depth) || this->ReportExhausted(); }
+    bool ReportExhausted();
+
     std::shared_ptr<TokenStream> mTokenStream;
+    Diagnostics* mDiagnostics;
+    ResourceGovernor* mGovernor;
+    // ݂̍ċA̐[, Oɍ\͂؂̐[
+    std::size_t mNestingLevel;
+    std::size_t mSubtreeDepth;
 };
 
 class InfixParser final : public Parser {
 public:
-    InfixParser(const std::shared_ptr<TokenStream>& tokenStream) : Parser(tokenStream) { }
+    InfixParser(const std::shared_ptr<TokenStream>& tokenStream, Diagnostics* diagnostics = nullptr) :
+        Parser(tokenStream, diagnostics) { }
     ~InfixParser() { }
 
     std::shared_ptr<BaseAST> Parse() override;
+    // ʂ̒g͍ŏɎQƂ܂ō\͂Ȃ (ۍ\؂g[Nێ)
+    // QƂʂ̒g̍\͂Ɏs, ̒gnullptrƂȂG[ffɋL^
+    // (ff͒ۍ\؂gI܂ŔjȂ)
+    std::shared_ptr<BaseAST> ParseLazy();
 
 private:
+    friend class LazyInfixSource;
+
     std::shared_ptr<BaseAST> VisitFactor();
-    std::shared_ptr<BaseAST> VisitExpression();
-    std::shared_ptr<BaseAST> VisitAndOrExpression();
+    std::shared_ptr<BaseAST> VisitExpression(int minPrecedence);
     std::shared_ptr<BaseAST> VisitNotExpression();
+
+    std::shared_ptr<LazyInfixSource> mLazySource;
 };
 
 class PrefixParser final : public Parser {
 public:
-    PrefixParser(const std::shared_ptr<TokenStream>& tokenStream) : Parser(tokenStream) { }
+    PrefixParser(const std::shared_ptr<TokenStream>& tokenStream, Diagnostics* diagnostics = nullptr) :
+        Parser(tokenStream, diagnostics) { }
     ~PrefixParser() { }
 
     std::shared_ptr<BaseAST> Parse() override;
 
 private:
-    std::shared_ptr<BaseAST> VisitThenOrEqExpression();
-    std::shared_ptr<BaseAST> VisitAndOrExpression();
+    std::shared_ptr<BaseAST> VisitOperand();
+    std::shared_ptr<BaseAST> VisitBinaryExpression(const BinaryOperator& binaryOperator);
     std::shared_ptr<BaseAST> VisitNotExpression();
 };
 
 
 class PostfixParser final : public Parser {
 public:
-    PostfixParser(const std::shared_ptr<TokenStream>& tokenStream) : Parser(tokenStream) { }
+    PostfixParser(const std::shared_ptr<TokenStream>& tokenStream, Diagnostics* diagnostics = nullptr) :
+        Parser(tokenStream, diagnostics) { }
     ~PostfixParser() { }
 
     std::shared_ptr<BaseAST> Parse() override;
 
 private:
-    std::stack<std::shared_ptr<BaseAST>> mASTStack;
+    // ۗĂAnd܂Or̘AX^bN̏̃Iyh1̃m[hɂ܂Ƃ߂
+    bool ReduceRun();
+
+    // \͊g񂷂Ƃɗ̈Ȃ悤, X^bNvectorŎ
+    std::vector<std::shared_ptr<BaseAST>> mASTStack;
+    // X^bN̊e؂̐[
+    std::vector<std::size_t> mDepthStack;
+    // ۗĂ铯Zq (And܂Or) ̘AƂ̌
+    const BinaryOperator* mRunOperator = nullptr;
+    std::size_t mRunLength = 0U;
+};
+
+// uL@, OuL@, uL@̏ɍ\͂, SĎsꍇ͍ł܂ŉ͂łL@̃G[c
+// sꍇ͎c̋L@, s̃G[c
+// lastNotationnullptrłȂ, ŌɎL@ (ꍇ͂̋L@) 
+std::shared_ptr<BaseAST> ParseLogicalExpression(
+    const std::shared_ptr<TokenStream>& tokenStream, Notation* lastNotation, Diagnostics& diagnostics,
+    ResourceGovernor* governor = nullptr);
+
+/*
+͂ƂɎg񂷍\͂̃ZbV
+g[N, eL@̍\͊, uL@̃X^bNێ, ͂ςĂ̈Ȃ
+Ԃł, 1s̎͂ƍ\͂Ńq[vmۂŝ͌ʂ̒ۍ\؂݂̂ƂȂ
+ */
+class ParserSession {
+public:
+    ParserSession();
+    ~ParserSession() = default;
+
+    // ȍ~̎͂ƍ\͂ŎZ (vƂReset͌Ăяoōs)
+    void SetGovernor(ResourceGovernor* governor);
+
+    // g[NɂĂ玚͂ (sꍇfalse)
+    bool Lex(const std::string& logicalExpr, Diagnostics* diagnostics = nullptr);
+    // ͂g[NParseLogicalExpressionƓō\͂
+    std::shared_ptr<BaseAST> Parse(Notation* lastNotation, Diagnostics& diagnostics);
+    std::shared_ptr<BaseAST> Parse(const std::string& logicalExpr, Notation* lastNotation, Diagnostics& diagnostics);
+
+    // OɎ͂g[N (Ɏ͂܂ŗL)
+    inline const TokenStream& Tokens() const { return *this->mTokenStream; }
+
+private:
+    std::shared_ptr<TokenStream> mTokenStream;
+    InfixParser mInfixParser;
+    PrefixParser mPrefixParser;
+    PostfixParser mPostfixParser;
+    ResourceGovernor* mGovernor;
 };
 
 #endif // LOGICAL_EXPRESSION_PARSER_PARSER_HPP
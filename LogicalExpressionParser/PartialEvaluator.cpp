@@ -0,0 +1,358 @@
+
+// LogicalExpressionParser
+// PartialEvaluator.cpp
+
+#include "PartialEvaluator.hpp"
+#include "AST.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+static std::optional<bool> ConstantValue(const std::shared_ptr<BaseAST>& exprAST)
+{
+    if (exprAST->Type() != ASTType::Constant)
+        return std::nullopt;
+
+    return std::static_pointer_cast<ConstantAST>(exprAST)->Value();
+}
+
+static bool ApplyOperator(const std::string& op, bool left, bool right)
+{
+    if (op == "->")
+        return !left || right;
+    if (op == "<->" || op == "")
+        return left == right;
+    if (op == "")
+        return left != right;
+    if (op == "")
+        return !(left && right);
+    if (op == "")
+        return !(left || right);
+
+    assert(false);
+    return false;
+}
+
+static void CollectVariables(const BaseAST* exprAST, std::vector<std::string>& variableNames,
+                             std::unordered_set<std::string>& seenNames)
+{
+    switch (exprAST->Type()) {
+        case ASTType::Variable:
+        {
+            const std::string& name = static_cast<const VariableAST*>(exprAST)->Name();
+
+            if (seenNames.insert(name).second)
+                variableNames.push_back(name);
+
+            break;
+        }
+        case ASTType::Factor:
+            CollectVariables(static_cast<const FactorAST*>(exprAST)->Expr().get(), variableNames, seenNames);
+            break;
+        case ASTType::NotExpression:
+            CollectVariables(static_cast<const NotExpressionAST*>(exprAST)->Expr().get(), variableNames, seenNames);
+            break;
+        case ASTType::AndOrExpression:
+            for (const auto& operand : static_cast<const AndOrExpressionAST*>(exprAST)->Operands())
+                CollectVariables(operand.get(), variableNames, seenNames);
+            break;
+        case ASTType::Expression:
+            CollectVariables(static_cast<const ExpressionAST*>(exprAST)->Left().get(), variableNames, seenNames);
+            CollectVariables(static_cast<const ExpressionAST*>(exprAST)->Right().get(), variableNames, seenNames);
+            break;
+        case ASTType::XorExpression:
+            CollectVariables(static_cast<const XorExpressionAST*>(exprAST)->Left().get(), variableNames, seenNames);
+            CollectVariables(static_cast<const XorExpressionAST*>(exprAST)->Right().get(), variableNames, seenNames);
+            break;
+        case ASTType::NandNorExpression:
+            CollectVariables(static_cast<const NandNorExpressionAST*>(exprAST)->Left().get(), variableNames, seenNames);
+            CollectVariables(static_cast<const NandNorExpressionAST*>(exprAST)->Right().get(), variableNames, seenNames);
+            break;
+        default:
+            break;
+    }
+}
+
+template <typename BinaryAST>
+static std::shared_ptr<BaseAST> FoldBinary(const std::shared_ptr<BaseAST>& exprAST,
+                                           const std::shared_ptr<BaseAST>& left, const std::shared_ptr<BaseAST>& right)
+{
+    const BinaryAST* binaryAST = static_cast<const BinaryAST*>(exprAST.get());
+    std::optional<bool> leftValue = ConstantValue(left);
+    std::optional<bool> rightValue = ConstantValue(right);
+    const std::string& op = binaryAST->Operator();
+
+    if (leftValue.has_value() && rightValue.has_value())
+        return std::make_shared<ConstantAST>(ApplyOperator(op, leftValue.value(), rightValue.value()));
+
+    if (leftValue.has_value() || rightValue.has_value()) {
+        // Е萔ł, c̃Iyhx̊֐ƂĒ萔, x, x̂ꂩɂȂ
+        const std::shared_ptr<BaseAST>& operand = leftValue.has_value() ? right : left;
+        auto apply = [&](bool value) {
+            return leftValue.has_value() ? ApplyOperator(op, leftValue.value(), value) : ApplyOperator(op, value, rightValue.value()); };
+        bool valueIfFalse = apply(false);
+        bool valueIfTrue = apply(true);
+
+        if (valueIfFalse == valueIfTrue)
+            return std::make_shared<ConstantAST>(valueIfTrue);
+
+        return valueIfTrue ? operand : std::make_shared<NotExpressionAST>(operand);
+    }
+
+    if (left == binaryAST->Left() && right == binaryAST->Right())
+        return exprAST;
+
+    return std::make_shared<BinaryAST>(left, right, op);
+}
+
+static std::shared_ptr<BaseAST> FoldNode(const std::shared_ptr<BaseAST>& exprAST, const std::shared_ptr<BaseAST>* cofactors)
+{
+    switch (exprAST->Type()) {
+        case ASTType::Factor:
+        {
+            const std::shared_ptr<BaseAST>& cofactor = cofactors[0];
+
+            if (cofactor == std::static_pointer_cast<FactorAST>(exprAST)->Expr())
+                return exprAST;
+
+            // 萔ϐɂȂꍇ͊ʂO
+            if (cofactor->Type() == ASTType::Constant || cofactor->Type() == ASTType::Variable)
+                return cofactor;
+
+            return std::make_shared<FactorAST>(cofactor);
+        }
+        case ASTType::NotExpression:
+        {
+            const std::shared_ptr<BaseAST>& cofactor = cofactors[0];
+            std::optional<bool> value = ConstantValue(cofactor);
+
+            if (value.has_value())
+                return std::make_shared<ConstantAST>(!value.value());
+
+            if (cofactor == std::static_pointer_cast<NotExpressionAST>(exprAST)->Expr())
+                return exprAST;
+
+            return std::make_shared<NotExpressionAST>(cofactor);
+        }
+        case ASTType::AndOrExpression:
+        {
+            // Andł͐^, Orł͋ŨIyh菜, t̒萔ΑŜ̒萔ɂȂ
+            const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(exprAST.get());
+            bool isAnd = (andOrExprAST->Operator() == "");
+            std::vector<std::shared_ptr<BaseAST>> operands;
+            bool changed = false;
+
+            for (std::size_t i = 0; i < andOrExprAST->OperandCount(); ++i) {
+                const std::shared_ptr<BaseAST>& cofactor = cofactors[i];
+                std::optional<bool> value = ConstantValue(cofactor);
+                changed = changed || (cofactor != andOrExprAST->Operand(i));
+
+                if (!value.has_value())
+                    operands.push_back(cofactor);
+                else if (value.value() != isAnd)
+                    return std::make_shared<ConstantAST>(!isAnd);
+            }
+
+            if (!changed)
+                return exprAST;
+
+            if (operands.empty())
+                return std::make_shared<ConstantAST>(isAnd);
+
+            if (operands.size() == 1U)
+                return operands.front();
+
+            return std::make_shared<AndOrExpressionAST>(std::move(operands), andOrExprAST->Operator());
+        }
+        case ASTType::Expression:
+            return FoldBinary<ExpressionAST>(exprAST, cofactors[0], cofactors[1]);
+        case ASTType::XorExpression:
+            return FoldBinary<XorExpressionAST>(exprAST, cofactors[0], cofactors[1]);
+        case ASTType::NandNorExpression:
+            return FoldBinary<NandNorExpressionAST>(exprAST, cofactors[0], cofactors[1]);
+        default:
+            return exprAST;
+    }
+}
+
+static std::shared_ptr<BaseAST> CofactorNode(const std::shared_ptr<BaseAST>& exprAST, const VariableAssignment& partialAssignment)
+{
+    switch (exprAST->Type()) {
+        case ASTType::Constant:
+            return exprAST;
+        case ASTType::Variable:
+        {
+            auto iter = partialAssignment.find(std::static_pointer_cast<VariableAST>(exprAST)->Name());
+
+            if (iter == partialAssignment.end())
+                return exprAST;
+
+            return std::make_shared<ConstantAST>(iter->second);
+        }
+        case ASTType::AndOrExpression:
+        {
+            const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(exprAST.get());
+            bool isAnd = (andOrExprAST->Operator() == "");
+            std::vector<std::shared_ptr<BaseAST>> cofactors;
+            cofactors.reserve(andOrExprAST->OperandCount());
+
+            for (const auto& operand : andOrExprAST->Operands()) {
+                cofactors.push_back(CofactorNode(operand, partialAssignment));
+
+                // t̒萔ɂȂIyh, c̃Iyh͊Ȗ񂵂Ȃ
+                std::optional<bool> value = ConstantValue(cofactors.back());
+
+                if (value.has_value() && value.value() != isAnd)
+                    return std::make_shared<ConstantAST>(!isAnd);
+            }
+
+            return FoldNode(exprAST, cofactors.data());
+        }
+        default:
+        {
+            // , Not, 2Zq͎qm[hX2Ȃ̂, zɗ]quďݍ
+            std::shared_ptr<BaseAST> cofactors[2];
+            std::size_t childCount = ASTChildCount(exprAST.get());
+
+            for (std::size_t i = 0; i < childCount; ++i)
+                cofactors[i] = CofactorNode(ASTChild(exprAST.get(), i), partialAssignment);
+
+            return FoldNode(exprAST, cofactors);
+        }
+    }
+}
+
+//
+// ResidualFormulaNX
+//
+
+ResidualFormula::ResidualFormula(const std::shared_ptr<BaseAST>& residualAST) :
+    mAST(residualAST),
+    mSymbolTable(std::make_shared<SymbolTable>())
+{
+    assert(residualAST != nullptr);
+
+    // ĉ݂RpĈ, ϐԍ͌Œ肳ĂȂϐɂ̂ݐU
+    Compiler compiler(this->mSymbolTable);
+    this->mProgram = compiler.Compile(residualAST);
+}
+
+std::optional<bool> ResidualFormula::Evaluate(const VariableAssignment& assignment) const
+{
+    if (this->mProgram == nullptr)
+        return std::nullopt;
+
+    std::vector<std::uint64_t> values(this->mSymbolTable->Size() / 64U + 1U, 0U);
+
+    for (std::uint32_t i = 0; i < this->mSymbolTable->Size(); ++i) {
+        auto iter = assignment.find(this->mSymbolTable->Name(i));
+
+        if (iter == assignment.end())
+            return std::nullopt;
+
+        if (iter->second)
+            values[i >> 6] |= static_cast<std::uint64_t>(1U) << (i & 63U);
+    }
+
+    return this->mProgram->View().Evaluate(values.data());
+}
+
+//
+// PartialEvaluatorNX
+//
+
+std::size_t PartialEvaluator::CacheKeyHash::operator()(const std::vector<std::uint64_t>& key) const
+{
+    // FNV-1a
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    for (std::uint64_t value : key) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    }
+
+    return static_cast<std::size_t>(hash);
+}
+
+PartialEvaluator::PartialEvaluator(const std::shared_ptr<BaseAST>& logicalExprAST, std::size_t cacheCapacity) :
+    mAST(logicalExprAST),
+    mCacheCapacity(std::max<std::size_t>(1U, cacheCapacity)),
+    mCacheHits(0U),
+    mCacheMisses(0U)
+{
+    assert(logicalExprAST != nullptr);
+
+    std::unordered_set<std::string> seenNames;
+    CollectVariables(logicalExprAST.get(), this->mVariableNames, seenNames);
+}
+
+std::shared_ptr<BaseAST> PartialEvaluator::Cofactor(const std::shared_ptr<BaseAST>& logicalExprAST,
+                                                    const VariableAssignment& partialAssignment)
+{
+    assert(logicalExprAST != nullptr);
+
+    return CofactorNode(logicalExprAST, partialAssignment);
+}
+
+std::shared_ptr<BaseAST> PartialEvaluator::Fold(const std::shared_ptr<BaseAST>& logicalExprAST,
+                                                const std::shared_ptr<BaseAST>* cofactors)
+{
+    assert(logicalExprAST != nullptr);
+
+    return FoldNode(logicalExprAST, cofactors);
+}
+
+std::shared_ptr<const ResidualFormula> PartialEvaluator::Specialize(const VariableAssignment& partialAssignment)
+{
+    // L[͘_̕ϐƂ, lŒ肵ǂ̃rbgƌŒ肵l̃rbg
+    const std::size_t wordCount = (this->mVariableNames.size() + 63U) / 64U;
+    std::vector<std::uint64_t> key(wordCount * 2U, 0U);
+    VariableAssignment relevantAssignment;
+
+    for (std::size_t i = 0; i < this->mVariableNames.size(); ++i) {
+        auto iter = partialAssignment.find(this->mVariableNames[i]);
+
+        if (iter == partialAssignment.end())
+            continue;
+
+        key[i >> 6] |= static_cast<std::uint64_t>(1U) << (i & 63U);
+
+        if (iter->second)
+            key[wordCount + (i >> 6)] |= static_cast<std::uint64_t>(1U) << (i & 63U);
+
+        relevantAssignment.emplace(iter->first, iter->second);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->mCacheMutex);
+        auto iter = this->mCache.find(key);
+
+        if (iter != this->mCache.end()) {
+            ++this->mCacheHits;
+            this->mCacheOrder.splice(this->mCacheOrder.begin(), this->mCacheOrder, iter->second.second);
+            return iter->second.first;
+        }
+
+        ++this->mCacheMisses;
+    }
+
+    // ꉻ̓bN̊Oōs (L[𓯎ɓꉻꍇ͐ɓo^g)
+    std::shared_ptr<const ResidualFormula> residual =
+        std::make_shared<const ResidualFormula>(CofactorNode(this->mAST, relevantAssignment));
+
+    std::lock_guard<std::mutex> lock(this->mCacheMutex);
+    auto iter = this->mCache.find(key);
+
+    if (iter != this->mCache.end())
+        return iter->second.first;
+
+    if (this->mCache.size() >= this->mCacheCapacity) {
+        this->mCache.erase(this->mCacheOrder.back());
+        this->mCacheOrder.pop_back();
+    }
+
+    this->mCacheOrder.push_front(key);
+    this->mCache.emplace(std::move(key), std::make_pair(residual, this->mCacheOrder.begin()));
+
+    return residual;
+}
@@ -0,0 +1,90 @@
+// LogicalExpressionParser
+// PartialEvaluator.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_PARTIAL_EVALUATOR_HPP
+#define LOGICAL_EXPRESSION_PARSER_PARTIAL_EVALUATOR_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Compiler.hpp"
+#include "Evaluator.hpp"
+
+class BaseAST;
+
+// ꕔ̕ϐ̒lŒ肵ĊȖ񂵂_ (c)
+class ResidualFormula {
+public:
+    ResidualFormula(const std::shared_ptr<BaseAST>& residualAST);
+    ~ResidualFormula() = default;
+
+    inline const std::shared_ptr<BaseAST>& AST() const { return this->mAST; }
+    inline const std::shared_ptr<Program>& Compiled() const { return this->mProgram; }
+    // ľŒ肳ĂȂϐ
+    inline std::size_t FreeVariableCount() const { return this->mSymbolTable->Size(); }
+    inline const std::string& FreeVariable(std::uint32_t index) const { return this->mSymbolTable->Name(index); }
+
+    // c̕ϐ̒l^ĕ] (l̖ϐstd::nullopt)
+    std::optional<bool> Evaluate(const VariableAssignment& assignment) const;
+
+private:
+    std::shared_ptr<BaseAST> mAST;
+    std::shared_ptr<SymbolTable> mSymbolTable;
+    std::shared_ptr<Program> mProgram;
+};
+
+/*
+]ɂ_̓ꉻ
+ꕔ̕ϐ̒lŒ肵ė]q, 萔ݍ񂾎c̘_
+c͘_Ɍϐւ̌Œl̑gL[ɂăLbV̂,
+ϐ̌Œlv͎c̕ϐ݂̂]΂悢
+ */
+class PartialEvaluator {
+public:
+    PartialEvaluator(const std::shared_ptr<BaseAST>& logicalExprAST, std::size_t cacheCapacity = 1024U);
+    ~PartialEvaluator() = default;
+
+    // ϐ̒lŒ肵Ē萔ݍ (Œ肵ϐ܂܂Ȃ؂̖͌؂ƋL)
+    static std::shared_ptr<BaseAST> Cofactor(const std::shared_ptr<BaseAST>& logicalExprAST,
+                                             const VariableAssignment& partialAssignment);
+    // qm[h̗]q (ASTChildƓASTChildCount) , m[h̗]qgݗĂĒ萔ݍ
+    static std::shared_ptr<BaseAST> Fold(const std::shared_ptr<BaseAST>& logicalExprAST,
+                                         const std::shared_ptr<BaseAST>* cofactors);
+
+    // _ɌȂϐ̒l͖
+    std::shared_ptr<const ResidualFormula> Specialize(const VariableAssignment& partialAssignment);
+
+    inline std::uint64_t CacheHits() const { return this->mCacheHits; }
+    inline std::uint64_t CacheMisses() const { return this->mCacheMisses; }
+
+private:
+    struct CacheKeyHash {
+        std::size_t operator()(const std::vector<std::uint64_t>& key) const;
+    };
+
+    using CacheOrder = std::list<std::vector<std::uint64_t>>;
+
+    std::shared_ptr<BaseAST> mAST;
+    std::vector<std::string> mVariableNames;
+    std::size_t mCacheCapacity;
+
+    // ŋߎgɕ, eʂ𒴂łÂĉĂ
+    std::mutex mCacheMutex;
+    CacheOrder mCacheOrder;
+    std::unordered_map<std::vector<std::uint64_t>,
+        std::pair<std::shared_ptr<const ResidualFormula>, CacheOrder::iterator>, CacheKeyHash> mCache;
+    std::uint64_t mCacheHits;
+    std::uint64_t mCacheMisses;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_PARTIAL_EVALUATOR_HPP
@@ -0,0 +1,250 @@
+
+// LogicalExpressionParser
+// PerformanceCounters.cpp
+
+#include "PerformanceCounters.hpp"
+#include "AST.hpp"
+
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <new>
+
+static_assert(ASTTypeCount == static_cast<std::size_t>(ASTType::Variable) + 1U, "ASTTypeCount mismatch");
+static_assert(NotationCount == static_cast<std::size_t>(Notation::Postfix) + 1U, "NotationCount mismatch");
+static_assert(DiagnosticCodeCount == static_cast<std::size_t>(DiagnosticCode::InternalError) + 1U, "DiagnosticCodeCount mismatch");
+
+// XbhƂ̃JE^ (ނ̂͏LXbĥ)
+// Xbh̏IWvɊ܂߂邽߉, SẴubNAXgŒH悤ɂ
+struct ThreadCounters {
+    std::atomic<std::uint64_t> mValues[PerformanceCounterCount];
+    ThreadCounters* mNext;
+};
+
+static std::atomic<ThreadCounters*> sThreadCountersHead { nullptr };
+static std::atomic<std::size_t> sThreadCount { 0U };
+
+#ifndef LEP_DISABLE_PERFORMANCE_COUNTERS
+static thread_local ThreadCounters* tThreadCounters = nullptr;
+
+static ThreadCounters* RegisterThreadCounters()
+{
+    // uZqnewĂ΂̂, mallocŊmۂ
+    void* memory = std::malloc(sizeof(ThreadCounters));
+
+    if (memory == nullptr)
+        return nullptr;
+
+    ThreadCounters* threadCounters = ::new (memory) ThreadCounters;
+
+    for (auto& value : threadCounters->mValues)
+        value.store(0U, std::memory_order_relaxed);
+
+    threadCounters->mNext = sThreadCountersHead.load(std::memory_order_relaxed);
+
+    while (!sThreadCountersHead.compare_exchange_weak(
+        threadCounters->mNext, threadCounters, std::memory_order_release, std::memory_order_relaxed))
+        ;
+
+    sThreadCount.fetch_add(1U, std::memory_order_relaxed);
+    tThreadCounters = threadCounters;
+
+    return threadCounters;
+}
+#endif
+
+static PerformanceDumpFormat sDumpFormat = PerformanceDumpFormat::Text;
+static volatile std::sig_atomic_t sDumpRequested = 0;
+
+static void RequestDump(int)
+{
+    sDumpRequested = 1;
+}
+
+static void DumpAtExit()
+{
+    PerformanceCounters::Snapshot().Print(std::cerr, sDumpFormat);
+}
+
+static const char* ASTTypeName(std::size_t astType)
+{
+    static const char* const astTypeNames[ASTTypeCount] = {
+        "Base", "Factor", "NotExpression", "AndOrExpression", "Expression",
+        "XorExpression", "NandNorExpression", "Constant", "Variable"
+    };
+
+    return astTypeNames[astType];
+}
+
+static const char* NotationName(std::size_t notation)
+{
+    static const char* const notationNames[NotationCount] = { "Infix", "Prefix", "Postfix" };
+
+    return notationNames[notation];
+}
+
+//
+// PerformanceSnapshotNX
+//
+
+PerformanceSnapshot PerformanceSnapshot::operator-(const PerformanceSnapshot& base) const
+{
+    PerformanceSnapshot difference;
+
+    for (std::size_t i = 0; i < PerformanceCounterCount; ++i)
+        difference.mValues[i] = this->mValues[i] - base.mValues[i];
+
+    difference.mThreadCount = this->mThreadCount;
+
+    return difference;
+}
+
+void PerformanceSnapshot::Print(std::ostream& os, PerformanceDumpFormat format) const
+{
+    switch (format) {
+        case PerformanceDumpFormat::Text:
+            this->PrintText(os);
+            break;
+        case PerformanceDumpFormat::Json:
+            this->PrintJson(os);
+            break;
+    }
+}
+
+void PerformanceSnapshot::PrintText(std::ostream& os) const
+{
+    os << "Performance counters (" << this->mThreadCount << " threads)\n"
+       << "  Tokens lexed: " << this->TokensLexed() << '\n'
+       << "  Heap allocations: " << this->HeapAllocations() << '\n'
+       << "  Heap deallocations: " << this->HeapDeallocations() << '\n'
+       << "  Heap bytes: " << this->HeapBytes() << '\n'
+       << "  Printer bytes: " << this->PrinterBytes() << '\n';
+
+    os << "  AST nodes:\n";
+
+    for (std::size_t i = 0; i < ASTTypeCount; ++i)
+        if (this->Value(PerformanceCounter::ASTNodes, i) != 0U)
+            os << "    " << ASTTypeName(i) << ": " << this->Value(PerformanceCounter::ASTNodes, i) << '\n';
+
+    os << "  Parse attempts:\n";
+
+    for (std::size_t i = 0; i < NotationCount; ++i)
+        os << "    " << NotationName(i) << ": " << this->Value(PerformanceCounter::ParseAttempts, i) << '\n';
+
+    os << "  Parse failures:\n";
+
+    for (std::size_t i = 0; i < DiagnosticCodeCount; ++i)
+        if (this->Value(PerformanceCounter::ParseFailures, i) != 0U)
+            os << "    " << DiagnosticCodeName(static_cast<DiagnosticCode>(i)) << ": "
+               << this->Value(PerformanceCounter::ParseFailures, i) << '\n';
+}
+
+void PerformanceSnapshot::PrintJson(std::ostream& os) const
+{
+    // O͑SĉpƋ󔒂݂̂Ȃ̂, GXP[v͕sv
+    os << "{\"threads\":" << this->mThreadCount
+       << ",\"tokensLexed\":" << this->TokensLexed()
+       << ",\"heapAllocations\":" << this->HeapAllocations()
+       << ",\"heapDeallocations\":" << this->HeapDeallocations()
+       << ",\"heapBytes\":" << this->HeapBytes()
+       << ",\"printerBytes\":" << this->PrinterBytes();
+
+    os << ",\"astNodes\":{";
+
+    for (std::size_t i = 0; i < ASTTypeCount; ++i)
+        os << (i > 0 ? "," : "") << '\"' << ASTTypeName(i) << "\":" << this->Value(PerformanceCounter::ASTNodes, i);
+
+    os << "},\"parseAttempts\":{";
+
+    for (std::size_t i = 0; i < NotationCount; ++i)
+        os << (i > 0 ? "," : "") << '\"' << NotationName(i) << "\":" << this->Value(PerformanceCounter::ParseAttempts, i);
+
+    os << "},\"parseFailures\":{";
+
+    for (std::size_t i = 0; i < DiagnosticCodeCount; ++i)
+        os << (i > 0 ? "," : "") << '\"' << DiagnosticCodeName(static_cast<DiagnosticCode>(i)) << "\":"
+           << this->Value(PerformanceCounter::ParseFailures, i);
+
+    os << "}}\n";
+}
+
+//
+// PerformanceCountersNX
+//
+
+#ifndef LEP_DISABLE_PERFORMANCE_COUNTERS
+void PerformanceCounters::Add(PerformanceCounter counter, std::size_t offset, std::uint64_t value)
+{
+    ThreadCounters* threadCounters = tThreadCounters;
+
+    if (threadCounters == nullptr && (threadCounters = RegisterThreadCounters()) == nullptr)
+        return;
+
+    // ނ͎̂Xbĥ݂Ȃ̂, sȉZ߂͕sv
+    std::atomic<std::uint64_t>& counterValue =
+        threadCounters->mValues[static_cast<std::size_t>(counter) + offset];
+    counterValue.store(counterValue.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+#endif
+
+PerformanceSnapshot PerformanceCounters::Snapshot()
+{
+    PerformanceSnapshot snapshot;
+
+    for (const ThreadCounters* threadCounters = sThreadCountersHead.load(std::memory_order_acquire);
+         threadCounters != nullptr; threadCounters = threadCounters->mNext)
+        for (std::size_t i = 0; i < PerformanceCounterCount; ++i)
+            snapshot.mValues[i] += threadCounters->mValues[i].load(std::memory_order_relaxed);
+
+    snapshot.mThreadCount = sThreadCount.load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+void PerformanceCounters::InstallDump(PerformanceDumpFormat format)
+{
+    sDumpFormat = format;
+    std::atexit(DumpAtExit);
+
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, RequestDump);
+#endif
+}
+
+bool PerformanceCounters::DumpIfRequested(std::ostream& os)
+{
+    if (sDumpRequested == 0)
+        return false;
+
+    sDumpRequested = 0;
+    Snapshot().Print(os, sDumpFormat);
+
+    return true;
+}
+
+//
+// CountingStreamBufferNX
+//
+
+CountingStreamBuffer::int_type CountingStreamBuffer::overflow(int_type ch)
+{
+    if (traits_type::eq_int_type(ch, traits_type::eof()))
+        return traits_type::not_eof(ch);
+
+    ++this->mByteCount;
+
+    return this->mStreamBuffer->sputc(traits_type::to_char_type(ch));
+}
+
+std::streamsize CountingStreamBuffer::xsputn(const char* str, std::streamsize count)
+{
+    std::streamsize written = this->mStreamBuffer->sputn(str, count);
+    this->mByteCount += static_cast<std::uint64_t>(written);
+
+    return written;
+}
+
+int CountingStreamBuffer::sync()
+{
+    return this->mStreamBuffer->pubsync();
+}
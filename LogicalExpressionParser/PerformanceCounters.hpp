@@ -0,0 +1,133 @@
+// LogicalExpressionParser
+// PerformanceCounters.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_PERFORMANCE_COUNTERS_HPP
+#define LOGICAL_EXPRESSION_PARSER_PERFORMANCE_COUNTERS_HPP
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <streambuf>
+
+#include "Diagnostics.hpp"
+
+/*
+\JE^
+eXbh͎g̃JE^݂̂, Wv̓XibvVbgƂɂ̂ݍs
+q[vmۂHeapCounters.cpp̉Zqnew̒uŐ, ̃t@C͎st@Ĉ݂ŃN
+LEP_DISABLE_PERFORMANCE_COUNTERS`, JE^̍XVƉZqnew̒uSĎ菜
+ */
+
+enum class ASTType;
+enum class Notation;
+
+// 񋓌^̗vf (PerformanceCounters.cppŒ`ƈv邱ƂmF)
+constexpr std::size_t ASTTypeCount = 9U;
+constexpr std::size_t NotationCount = 3U;
+constexpr std::size_t DiagnosticCodeCount = 15U;
+
+enum class PerformanceCounter : std::uint32_t {
+    TokensLexed,
+    HeapAllocations,
+    HeapDeallocations,
+    HeapBytes,
+    PrinterBytes,
+    ASTNodes,                                           // ASTType
+    ParseAttempts = ASTNodes + ASTTypeCount,            // Notation
+    ParseFailures = ParseAttempts + NotationCount,      // DiagnosticCode
+    Count = ParseFailures + DiagnosticCodeCount
+};
+
+constexpr std::size_t PerformanceCounterCount = static_cast<std::size_t>(PerformanceCounter::Count);
+
+enum class PerformanceDumpFormat {
+    Text,
+    Json
+};
+
+class PerformanceSnapshot {
+public:
+    PerformanceSnapshot() { this->mValues.fill(0U); }
+    ~PerformanceSnapshot() = default;
+
+    inline std::uint64_t Value(PerformanceCounter counter, std::size_t offset = 0U) const {
+        return this->mValues[static_cast<std::size_t>(counter) + offset]; }
+    inline std::uint64_t TokensLexed() const { return this->Value(PerformanceCounter::TokensLexed); }
+    inline std::uint64_t HeapAllocations() const { return this->Value(PerformanceCounter::HeapAllocations); }
+    inline std::uint64_t HeapDeallocations() const { return this->Value(PerformanceCounter::HeapDeallocations); }
+    inline std::uint64_t HeapBytes() const { return this->Value(PerformanceCounter::HeapBytes); }
+    inline std::uint64_t PrinterBytes() const { return this->Value(PerformanceCounter::PrinterBytes); }
+    inline std::uint64_t ASTNodes(ASTType astType) const {
+        return this->Value(PerformanceCounter::ASTNodes, static_cast<std::size_t>(astType)); }
+    inline std::uint64_t ParseAttempts(Notation notation) const {
+        return this->Value(PerformanceCounter::ParseAttempts, static_cast<std::size_t>(notation)); }
+    inline std::uint64_t ParseFailures(DiagnosticCode code) const {
+        return this->Value(PerformanceCounter::ParseFailures, static_cast<std::size_t>(code)); }
+    inline std::size_t ThreadCount() const { return this->mThreadCount; }
+
+    // 2̃XibvVbg̍, ̊Ԃ̋Ԃ݂̂̒l
+    PerformanceSnapshot operator-(const PerformanceSnapshot& base) const;
+
+    void Print(std::ostream& os, PerformanceDumpFormat format) const;
+
+private:
+    void PrintText(std::ostream& os) const;
+    void PrintJson(std::ostream& os) const;
+
+    friend class PerformanceCounters;
+
+    std::array<std::uint64_t, PerformanceCounterCount> mValues;
+    std::size_t mThreadCount = 0U;
+};
+
+class PerformanceCounters {
+public:
+    PerformanceCounters() = delete;
+
+#ifndef LEP_DISABLE_PERFORMANCE_COUNTERS
+    static void Add(PerformanceCounter counter, std::size_t offset, std::uint64_t value);
+#else
+    static inline void Add(PerformanceCounter, std::size_t, std::uint64_t) { }
+#endif
+
+    static inline void Add(PerformanceCounter counter, std::uint64_t value = 1U) {
+        Add(counter, 0U, value); }
+    static inline void CountASTNode(ASTType astType) {
+        Add(PerformanceCounter::ASTNodes, static_cast<std::size_t>(astType), 1U); }
+    static inline void CountParseAttempt(Notation notation) {
+        Add(PerformanceCounter::ParseAttempts, static_cast<std::size_t>(notation), 1U); }
+    static inline void CountParseFailure(DiagnosticCode code) {
+        Add(PerformanceCounter::ParseFailures, static_cast<std::size_t>(code), 1U); }
+
+    // IXbh̒l܂߂đSẴXbh̃JE^Wv
+    static PerformanceSnapshot Snapshot();
+
+    // IƃVOi(SIGUSR1)̎MɕWG[o͂֏o
+    static void InstallDump(PerformanceDumpFormat format);
+    // VOinhł͏łȂ̂, v΂ŏo
+    static bool DumpIfRequested(std::ostream& os);
+};
+
+// ooCg𐔂Ȃʂ̃Xg[obt@֓]
+class CountingStreamBuffer final : public std::streambuf {
+public:
+    CountingStreamBuffer(std::streambuf* streamBuffer) :
+        mStreamBuffer(streamBuffer), mByteCount(0U) { }
+    ~CountingStreamBuffer() = default;
+
+    inline std::uint64_t ByteCount() const { return this->mByteCount; }
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* str, std::streamsize count) override;
+    int sync() override;
+
+private:
+    std::streambuf* mStreamBuffer;
+    std::uint64_t   mByteCount;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_PERFORMANCE_COUNTERS_HPP
@@ -0,0 +1,512 @@
+
+// LogicalExpressionParser
+// ProbabilityEvaluator.cpp
+
+#include "ProbabilityEvaluator.hpp"
+#include "AST.hpp"
+#include "ResourceGovernor.hpp"
+
+#include <algorithm>
+#include <limits>
+
+// I[̕ϐ̔ԍ (ǂ̕ϐ̏Ƃ)
+static constexpr std::uint32_t TerminalVariable = std::numeric_limits<std::uint32_t>::max();
+static constexpr std::uint32_t UnreachableSlot = std::numeric_limits<std::uint32_t>::max();
+
+void ProbabilityEvaluator::Clear()
+{
+    this->mVariableNames.clear();
+    this->mVariableIndices.clear();
+    this->mRules.clear();
+    this->mTreeSteps.clear();
+    this->mBDDNodes.assign({ BDDNode { TerminalVariable, 0U, 0U }, BDDNode { TerminalVariable, 1U, 1U } });
+    this->mUniqueTable.clear();
+    this->mComputedTable.clear();
+    this->mReachableNodes.assign(this->mBDDNodes.begin(), this->mBDDNodes.end());
+    this->mNodeSlots.assign({ 0U, 1U });
+}
+
+std::optional<std::size_t> ProbabilityEvaluator::AddRule(const std::shared_ptr<BaseAST>& logicalExprAST)
+{
+    assert(logicalExprAST != nullptr);
+
+    // ϐ̔ԍ (񕪌}̕ϐ̏) , K̒ō猻ꂽɕt
+    std::vector<bool> seenVariables;
+
+    if (this->CheckReadOnce(logicalExprAST.get(), seenVariables)) {
+        this->mRules.push_back(Rule { true, this->CompileTree(logicalExprAST.get()) });
+        return this->mRules.size() - 1U;
+    }
+
+    std::size_t nodeCount = this->mBDDNodes.size();
+    std::optional<std::uint32_t> root = this->CompileBDD(logicalExprAST.get());
+
+    if (!root.has_value()) {
+        this->RollBack(nodeCount);
+        return std::nullopt;
+    }
+
+    this->mRules.push_back(Rule { false, this->MarkReachable(root.value()) });
+    return this->mRules.size() - 1U;
+}
+
+std::uint32_t ProbabilityEvaluator::VariableIndex(const std::string& name)
+{
+    auto iter = this->mVariableIndices.find(name);
+
+    if (iter != this->mVariableIndices.end())
+        return iter->second;
+
+    std::uint32_t variableIndex = static_cast<std::uint32_t>(this->mVariableNames.size());
+    this->mVariableNames.push_back(name);
+    this->mVariableIndices.emplace(name, variableIndex);
+
+    return variableIndex;
+}
+
+bool ProbabilityEvaluator::CheckReadOnce(const BaseAST* exprAST, std::vector<bool>& seenVariables)
+{
+    // 2ڂɌꂽϐĂ, SĂ̕ϐɔԍt邽ߍŌ܂łǂ
+    bool isReadOnce = true;
+
+    if (exprAST->Type() == ASTType::Variable) {
+        std::uint32_t variableIndex = this->VariableIndex(static_cast<const VariableAST*>(exprAST)->Name());
+
+        if (seenVariables.size() <= variableIndex)
+            seenVariables.resize(variableIndex + 1U, false);
+
+        isReadOnce = !seenVariables[variableIndex];
+        seenVariables[variableIndex] = true;
+        return isReadOnce;
+    }
+
+    for (std::size_t i = 0; i < ASTChildCount(exprAST); ++i)
+        isReadOnce = this->CheckReadOnce(ASTChild(exprAST, i).get(), seenVariables) && isReadOnce;
+
+    return isReadOnce;
+}
+
+//
+// read-once ̋K
+//
+
+std::uint32_t ProbabilityEvaluator::AddStep(StepKind kind, std::uint32_t first, std::uint32_t second)
+{
+    this->mTreeSteps.push_back(TreeStep { kind, first, second });
+    return static_cast<std::uint32_t>(this->mTreeSteps.size() - 1U);
+}
+
+std::uint32_t ProbabilityEvaluator::CompileTree(const BaseAST* exprAST)
+{
+    switch (exprAST->Type()) {
+        case ASTType::Constant:
+            return this->AddStep(static_cast<const ConstantAST*>(exprAST)->Value() ? StepKind::True : StepKind::False, 0U, 0U);
+        case ASTType::Variable:
+            return this->AddStep(StepKind::Variable, this->mVariableIndices.at(static_cast<const VariableAST*>(exprAST)->Name()), 0U);
+        case ASTType::Factor:
+            return this->CompileTree(static_cast<const FactorAST*>(exprAST)->Expr().get());
+        case ASTType::NotExpression:
+            return this->AddStep(StepKind::Not, this->CompileTree(static_cast<const NotExpressionAST*>(exprAST)->Expr().get()), 0U);
+        case ASTType::AndOrExpression:
+        {
+            const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(exprAST);
+            StepKind kind = (andOrExprAST->Operator() == "") ? StepKind::Or : StepKind::And;
+            std::uint32_t step = this->CompileTree(andOrExprAST->Operands().front().get());
+
+            for (std::size_t i = 1; i < andOrExprAST->OperandCount(); ++i)
+                step = this->AddStep(kind, step, this->CompileTree(andOrExprAST->Operands()[i].get()));
+
+            return step;
+        }
+        case ASTType::Expression:
+        {
+            const ExpressionAST* binaryExprAST = static_cast<const ExpressionAST*>(exprAST);
+            std::uint32_t left = this->CompileTree(binaryExprAST->Left().get());
+            std::uint32_t right = this->CompileTree(binaryExprAST->Right().get());
+
+            if (binaryExprAST->Operator() == "->")
+                return this->AddStep(StepKind::Or, this->AddStep(StepKind::Not, left, 0U), right);
+
+            return this->AddStep(StepKind::Not, this->AddStep(StepKind::Xor, left, right), 0U);
+        }
+        case ASTType::XorExpression:
+        {
+            const XorExpressionAST* xorExprAST = static_cast<const XorExpressionAST*>(exprAST);
+            std::uint32_t left = this->CompileTree(xorExprAST->Left().get());
+            std::uint32_t right = this->CompileTree(xorExprAST->Right().get());
+            std::uint32_t step = this->AddStep(StepKind::Xor, left, right);
+
+            return (xorExprAST->Operator() == "") ? step : this->AddStep(StepKind::Not, step, 0U);
+        }
+        case ASTType::NandNorExpression:
+        {
+            const NandNorExpressionAST* nandNorExprAST = static_cast<const NandNorExpressionAST*>(exprAST);
+            std::uint32_t left = this->CompileTree(nandNorExprAST->Left().get());
+            std::uint32_t right = this->CompileTree(nandNorExprAST->Right().get());
+            StepKind kind = (nandNorExprAST->Operator() == "") ? StepKind::And : StepKind::Or;
+
+            return this->AddStep(StepKind::Not, this->AddStep(kind, left, right), 0U);
+        }
+        default:
+            assert(false);
+            return this->AddStep(StepKind::False, 0U, 0U);
+    }
+}
+
+//
+// 񕪌}
+//
+
+std::optional<std::uint32_t> ProbabilityEvaluator::MakeNode(std::uint32_t variable, std::uint32_t low, std::uint32_t high)
+{
+    if (low == high)
+        return low;
+
+    std::pair<std::uint64_t, std::uint32_t> key { (static_cast<std::uint64_t>(variable) << 32) | low, high };
+    auto iter = this->mUniqueTable.find(key);
+
+    if (iter != this->mUniqueTable.end())
+        return iter->second;
+
+    if (this->mBDDNodes.size() >= this->mNodeLimit)
+        return std::nullopt;
+    if (this->mGovernor != nullptr && !this->mGovernor->ChargeSteps(1U))
+        return std::nullopt;
+
+    std::uint32_t node = static_cast<std::uint32_t>(this->mBDDNodes.size());
+    this->mBDDNodes.push_back(BDDNode { variable, low, high });
+    this->mUniqueTable.emplace(key, node);
+
+    return node;
+}
+
+std::optional<std::uint32_t> ProbabilityEvaluator::Apply(BDDOperation operation, std::uint32_t left, std::uint32_t right)
+{
+    // I[̏ꍇ (Z͂Ȃ̂, ԍ̏ɂ)
+    if (left > right)
+        std::swap(left, right);
+
+    switch (operation) {
+        case BDDOperation::And:
+            if (left == 0U || left == right)
+                return left;
+            if (left == 1U)
+                return right;
+            break;
+        case BDDOperation::Or:
+            if (left == 1U)
+                return 1U;
+            if (left == 0U || left == right)
+                return right;
+            break;
+        case BDDOperation::Xor:
+            if (left == right)
+                return 0U;
+            if (left == 0U)
+                return right;
+            break;
+    }
+
+    std::pair<std::uint64_t, std::uint32_t> key { (static_cast<std::uint64_t>(operation) << 32) | left, right };
+    auto iter = this->mComputedTable.find(key);
+
+    if (iter != this->mComputedTable.end())
+        return iter->second;
+
+    // ̕ϐŏꍇ
+    const BDDNode leftNode = this->mBDDNodes[left];
+    const BDDNode rightNode = this->mBDDNodes[right];
+    std::uint32_t variable = std::min(leftNode.mVariable, rightNode.mVariable);
+    std::uint32_t leftLow = (leftNode.mVariable == variable) ? leftNode.mLow : left;
+    std::uint32_t leftHigh = (leftNode.mVariable == variable) ? leftNode.mHigh : left;
+    std::uint32_t rightLow = (rightNode.mVariable == variable) ? rightNode.mLow : right;
+    std::uint32_t rightHigh = (rightNode.mVariable == variable) ? rightNode.mHigh : right;
+
+    std::optional<std::uint32_t> low = this->Apply(operation, leftLow, rightLow);
+
+    if (!low.has_value())
+        return std::nullopt;
+
+    std::optional<std::uint32_t> high = this->Apply(operation, leftHigh, rightHigh);
+
+    if (!high.has_value())
+        return std::nullopt;
+
+    std::optional<std::uint32_t> node = this->MakeNode(variable, low.value(), high.value());
+
+    if (node.has_value())
+        this->mComputedTable.emplace(key, node.value());
+
+    return node;
+}
+
+std::optional<std::uint32_t> ProbabilityEvaluator::CompileBDD(const BaseAST* exprAST)
+{
+    switch (exprAST->Type()) {
+        case ASTType::Constant:
+            return static_cast<const ConstantAST*>(exprAST)->Value() ? 1U : 0U;
+        case ASTType::Variable:
+            return this->MakeNode(this->mVariableIndices.at(static_cast<const VariableAST*>(exprAST)->Name()), 0U, 1U);
+        case ASTType::Factor:
+            return this->CompileBDD(static_cast<const FactorAST*>(exprAST)->Expr().get());
+        case ASTType::NotExpression:
+        {
+            std::optional<std::uint32_t> operand = this->CompileBDD(static_cast<const NotExpressionAST*>(exprAST)->Expr().get());
+            return operand.has_value() ? this->Negate(operand.value()) : std::nullopt;
+        }
+        case ASTType::AndOrExpression:
+        {
+            const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(exprAST);
+            BDDOperation operation = (andOrExprAST->Operator() == "") ? BDDOperation::Or : BDDOperation::And;
+            std::optional<std::uint32_t> result = this->CompileBDD(andOrExprAST->Operands().front().get());
+
+            for (std::size_t i = 1; result.has_value() && i < andOrExprAST->OperandCount(); ++i) {
+                std::optional<std::uint32_t> operand = this->CompileBDD(andOrExprAST->Operands()[i].get());
+                result = operand.has_value() ? this->Apply(operation, result.value(), operand.value()) : std::nullopt;
+            }
+
+            return result;
+        }
+        default:
+            break;
+    }
+
+    // 2Zq, Xor, And, Or̂ꂩƔےɒ
+    const std::shared_ptr<BaseAST>& leftAST = ASTChild(exprAST, 0);
+    const std::shared_ptr<BaseAST>& rightAST = ASTChild(exprAST, 1);
+    std::optional<std::uint32_t> left = this->CompileBDD(leftAST.get());
+    std::optional<std::uint32_t> right = left.has_value() ? this->CompileBDD(rightAST.get()) : std::nullopt;
+
+    if (!right.has_value())
+        return std::nullopt;
+
+    switch (exprAST->Type()) {
+        case ASTType::Expression:
+        {
+            if (static_cast<const ExpressionAST*>(exprAST)->Operator() == "->") {
+                std::optional<std::uint32_t> notLeft = this->Negate(left.value());
+                return notLeft.has_value() ? this->Apply(BDDOperation::Or, notLeft.value(), right.value()) : std::nullopt;
+            }
+
+            std::optional<std::uint32_t> result = this->Apply(BDDOperation::Xor, left.value(), right.value());
+            return result.has_value() ? this->Negate(result.value()) : std::nullopt;
+        }
+        case ASTType::XorExpression:
+        {
+            std::optional<std::uint32_t> result = this->Apply(BDDOperation::Xor, left.value(), right.value());
+
+            if (!result.has_value() || static_cast<const XorExpressionAST*>(exprAST)->Operator() == "")
+                return result;
+
+            return this->Negate(result.value());
+        }
+        case ASTType::NandNorExpression:
+        {
+            BDDOperation operation = (static_cast<const NandNorExpressionAST*>(exprAST)->Operator() == "") ?
+                BDDOperation::And : BDDOperation::Or;
+            std::optional<std::uint32_t> result = this->Apply(operation, left.value(), right.value());
+            return result.has_value() ? this->Negate(result.value()) : std::nullopt;
+        }
+        default:
+            assert(false);
+            return std::nullopt;
+    }
+}
+
+void ProbabilityEvaluator::RollBack(std::size_t nodeCount)
+{
+    // sK̂߂ɍߓ_ӕ\Ǝ菜
+    for (std::size_t node = nodeCount; node < this->mBDDNodes.size(); ++node) {
+        const BDDNode& bddNode = this->mBDDNodes[node];
+        this->mUniqueTable.erase({ (static_cast<std::uint64_t>(bddNode.mVariable) << 32) | bddNode.mLow, bddNode.mHigh });
+    }
+
+    this->mBDDNodes.resize(nodeCount);
+
+    // LbV͎菜ߓ_w
+    this->mComputedTable.clear();
+}
+
+std::uint32_t ProbabilityEvaluator::MarkReachable(std::uint32_t root)
+{
+    // sɔԍt̂, q͐eOɕ (ɔԍ̂ߓ_͂ǂȂ)
+    if (this->mNodeSlots.size() < this->mBDDNodes.size())
+        this->mNodeSlots.resize(this->mBDDNodes.size(), UnreachableSlot);
+
+    std::vector<std::pair<std::uint32_t, bool>> pendingNodes { { root, false } };
+
+    while (!pendingNodes.empty()) {
+        auto [node, childrenDone] = pendingNodes.back();
+        pendingNodes.pop_back();
+
+        if (this->mNodeSlots[node] != UnreachableSlot)
+            continue;
+
+        const BDDNode& bddNode = this->mBDDNodes[node];
+
+        if (!childrenDone) {
+            pendingNodes.push_back({ node, true });
+            pendingNodes.push_back({ bddNode.mHigh, false });
+            pendingNodes.push_back({ bddNode.mLow, false });
+            continue;
+        }
+
+        this->mNodeSlots[node] = static_cast<std::uint32_t>(this->mReachableNodes.size());
+        this->mReachableNodes.push_back(BDDNode { bddNode.mVariable, this->mNodeSlots[bddNode.mLow], this->mNodeSlots[bddNode.mHigh] });
+    }
+
+    return this->mNodeSlots[root];
+}
+
+//
+// m̌vZ
+//
+
+void ProbabilityEvaluator::Evaluate(const std::vector<double>& probabilities, std::vector<double>& ruleProbabilities) const
+{
+    assert(probabilities.size() >= this->mVariableNames.size());
+
+    std::vector<double> stepValues(this->mTreeSteps.size());
+
+    for (std::size_t i = 0; i < this->mTreeSteps.size(); ++i) {
+        const TreeStep& step = this->mTreeSteps[i];
+
+        switch (step.mKind) {
+            case StepKind::False:
+                stepValues[i] = 0.0;
+                break;
+            case StepKind::True:
+                stepValues[i] = 1.0;
+                break;
+            case StepKind::Variable:
+                stepValues[i] = probabilities[step.mFirst];
+                break;
+            case StepKind::Not:
+                stepValues[i] = 1.0 - stepValues[step.mFirst];
+                break;
+            case StepKind::And:
+                stepValues[i] = stepValues[step.mFirst] * stepValues[step.mSecond];
+                break;
+            case StepKind::Or:
+                stepValues[i] = 1.0 - (1.0 - stepValues[step.mFirst]) * (1.0 - stepValues[step.mSecond]);
+                break;
+            case StepKind::Xor:
+                stepValues[i] = stepValues[step.mFirst] * (1.0 - stepValues[step.mSecond]) +
+                                (1.0 - stepValues[step.mFirst]) * stepValues[step.mSecond];
+                break;
+        }
+    }
+
+    std::vector<double> nodeValues(this->mReachableNodes.size());
+    nodeValues[0] = 0.0;
+    nodeValues[1] = 1.0;
+
+    for (std::size_t i = 2; i < this->mReachableNodes.size(); ++i) {
+        const BDDNode& node = this->mReachableNodes[i];
+        double probability = probabilities[node.mVariable];
+        nodeValues[i] = nodeValues[node.mLow] + probability * (nodeValues[node.mHigh] - nodeValues[node.mLow]);
+    }
+
+    ruleProbabilities.resize(this->mRules.size());
+
+    for (std::size_t i = 0; i < this->mRules.size(); ++i)
+        ruleProbabilities[i] = this->mRules[i].mReadOnce ?
+            stepValues[this->mRules[i].mRoot] : nodeValues[this->mRules[i].mRoot];
+}
+
+std::optional<std::vector<double>> ProbabilityEvaluator::Evaluate(const VariableProbabilities& probabilities) const
+{
+    std::vector<double> variableProbabilities;
+    variableProbabilities.reserve(this->mVariableNames.size());
+
+    for (const auto& variableName : this->mVariableNames) {
+        auto iter = probabilities.find(variableName);
+
+        if (iter == probabilities.end())
+            return std::nullopt;
+
+        variableProbabilities.push_back(iter->second);
+    }
+
+    std::vector<double> ruleProbabilities;
+    this->Evaluate(variableProbabilities, ruleProbabilities);
+
+    return ruleProbabilities;
+}
+
+void ProbabilityEvaluator::EvaluateBatch(const std::vector<std::vector<double>>& probabilitySets,
+                                         std::vector<std::vector<double>>& ruleProbabilities) const
+{
+    // l͎菇 (ߓ_) ƂɊm̑g̐, ̌JԂgɂĂ̒PȐϘaɂ
+    std::size_t setCount = probabilitySets.size();
+    std::size_t variableCount = this->mVariableNames.size();
+    std::vector<double> probabilities(variableCount * setCount);
+
+    for (std::size_t j = 0; j < setCount; ++j) {
+        assert(probabilitySets[j].size() >= variableCount);
+
+        for (std::size_t v = 0; v < variableCount; ++v)
+            probabilities[v * setCount + j] = probabilitySets[j][v];
+    }
+
+    std::vector<double> stepValues(this->mTreeSteps.size() * setCount);
+
+    for (std::size_t i = 0; i < this->mTreeSteps.size(); ++i) {
+        const TreeStep& step = this->mTreeSteps[i];
+        double* values = stepValues.data() + i * setCount;
+        const double* first = stepValues.data() + static_cast<std::size_t>(step.mFirst) * setCount;
+        const double* second = stepValues.data() + static_cast<std::size_t>(step.mSecond) * setCount;
+
+        switch (step.mKind) {
+            case StepKind::False:
+                std::fill(values, values + setCount, 0.0);
+                break;
+            case StepKind::True:
+                std::fill(values, values + setCount, 1.0);
+                break;
+            case StepKind::Variable:
+                std::copy_n(probabilities.data() + static_cast<std::size_t>(step.mFirst) * setCount, setCount, values);
+                break;
+            case StepKind::Not:
+                for (std::size_t j = 0; j < setCount; ++j)
+                    values[j] = 1.0 - first[j];
+                break;
+            case StepKind::And:
+                for (std::size_t j = 0; j < setCount; ++j)
+                    values[j] = first[j] * second[j];
+                break;
+            case StepKind::Or:
+                for (std::size_t j = 0; j < setCount; ++j)
+                    values[j] = 1.0 - (1.0 - first[j]) * (1.0 - second[j]);
+                break;
+            case StepKind::Xor:
+                for (std::size_t j = 0; j < setCount; ++j)
+                    values[j] = first[j] * (1.0 - second[j]) + (1.0 - first[j]) * second[j];
+                break;
+        }
+    }
+
+    std::vector<double> nodeValues(this->mReachableNodes.size() * setCount);
+    std::fill_n(nodeValues.data() + setCount, setCount, 1.0);
+
+    for (std::size_t i = 2; i < this->mReachableNodes.size(); ++i) {
+        const BDDNode& node = this->mReachableNodes[i];
+        double* values = nodeValues.data() + i * setCount;
+        const double* low = nodeValues.data() + static_cast<std::size_t>(node.mLow) * setCount;
+        const double* high = nodeValues.data() + static_cast<std::size_t>(node.mHigh) * setCount;
+        const double* variableProbabilities = probabilities.data() + static_cast<std::size_t>(node.mVariable) * setCount;
+
+        for (std::size_t j = 0; j < setCount; ++j)
+            values[j] = low[j] + variableProbabilities[j] * (high[j] - low[j]);
+    }
+
+    ruleProbabilities.assign(setCount, std::vector<double>(this->mRules.size()));
+
+    for (std::size_t i = 0; i < this->mRules.size(); ++i) {
+        const double* values = (this->mRules[i].mReadOnce ? stepValues.data() : nodeValues.data()) +
+            static_cast<std::size_t>(this->mRules[i].mRoot) * setCount;
+
+        for (std::size_t j = 0; j < setCount; ++j)
+            ruleProbabilities[j][i] = values[j];
+    }
+}
@@ -0,0 +1,140 @@
+// LogicalExpressionParser
+// ProbabilityEvaluator.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_PROBABILITY_EVALUATOR_HPP
+#define LOGICAL_EXPRESSION_PARSER_PROBABILITY_EVALUATOR_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class BaseAST;
+class ResourceGovernor;
+
+// ϐƂ̐^łm
+using VariableProbabilities = std::unordered_map<std::string, double>;
+
+/*
+ϐ݂ɓƗɐ^ɂȂƂƂ, K^ɂȂm̌ȌvZ
+eϐX1񂵂ȂK (read-once) , ۍ\؂̌s̎菇ɒ
+And, OrȂǂ̊em[hŊm𒼐ڑgݍ킹 (Iyh͋ʂ̕ϐȂ̂œƗ)
+ȊŐK͑SĂ̋KŋL񕪌} (BDD) ɂ, ߓ_Ƃ
+P = (1 - p) * P(U̎}) + p * P(^̎}) ŋ߂ (ϐ̏͋KɌꂽ)
+\z菇Ɠ񕪌}͊mςĂg񂷂̂, m̑gςvZ͐ߓ_ɔႷ鎞Ԃōς
+ */
+class ProbabilityEvaluator {
+public:
+    ProbabilityEvaluator() :
+        mNodeLimit(1U << 22),
+        mGovernor(nullptr) { this->Clear(); }
+    ~ProbabilityEvaluator() = default;
+
+    // 񕪌}̐ߓ_̏ (KAddRuleŎs)
+    inline void SetNodeLimit(std::size_t nodeLimit) { this->mNodeLimit = nodeLimit; }
+    // ߓ_̐XebvƂĉZ, 𒴂KAddRuleŎs
+    inline void SetGovernor(ResourceGovernor* governor) { this->mGovernor = governor; }
+
+    void Clear();
+
+    // KĔԍԂ (񕪌}𒴂ꍇstd::nullopt, K͉Ȃ)
+    std::optional<std::size_t> AddRule(const std::shared_ptr<BaseAST>& logicalExprAST);
+
+    inline std::size_t RuleCount() const { return this->mRules.size(); }
+    inline bool IsReadOnce(std::size_t ruleIndex) const { return this->mRules[ruleIndex].mReadOnce; }
+    // I[܂ޓ񕪌}̐ߓ_
+    inline std::size_t BDDNodeCount() const { return this->mBDDNodes.size(); }
+
+    // KɌꂽϐ (m̔z͂̏ŗ^)
+    inline const std::vector<std::string>& Variables() const { return this->mVariableNames; }
+
+    // probabilities[i]Variables()[i]̊m, KƂ̊mruleProbabilitiesɕԂ
+    void Evaluate(const std::vector<double>& probabilities, std::vector<double>& ruleProbabilities) const;
+    // KɌϐ̊mstd::nullopt
+    std::optional<std::vector<double>> Evaluate(const VariableProbabilities& probabilities) const;
+    // m̑gƂɋKƂ̊mԂ (ߓ_ƂɑSĂ̑g܂Ƃ߂ČvZ)
+    void EvaluateBatch(const std::vector<std::vector<double>>& probabilitySets,
+                       std::vector<std::vector<double>>& ruleProbabilities) const;
+
+private:
+    // read-once ̋K̎菇 (Iyh͑O̎菇̔ԍ, ϐ͕ϐ̔ԍ)
+    enum class StepKind : std::uint8_t {
+        False,
+        True,
+        Variable,
+        Not,
+        And,
+        Or,
+        Xor
+    };
+
+    struct TreeStep {
+        StepKind        mKind;
+        std::uint32_t   mFirst;
+        std::uint32_t   mSecond;
+    };
+
+    // 񕪌}̐ߓ_ (0͋U, 1͐^̏I[)
+    struct BDDNode {
+        std::uint32_t   mVariable;
+        std::uint32_t   mLow;
+        std::uint32_t   mHigh;
+    };
+
+    struct BDDKeyHash {
+        std::size_t operator()(const std::pair<std::uint64_t, std::uint32_t>& key) const {
+            return static_cast<std::size_t>((key.first ^ (static_cast<std::uint64_t>(key.second) << 21)) * 0x9E3779B97F4A7C15ULL); }
+    };
+
+    enum class BDDOperation : std::uint8_t {
+        And,
+        Or,
+        Xor
+    };
+
+    struct Rule {
+        bool            mReadOnce;
+        // read-once łΎ菇̔ԍ, łȂΌvZp̐ߓ_̔ԍ
+        std::uint32_t   mRoot;
+    };
+
+    std::uint32_t VariableIndex(const std::string& name);
+    bool CheckReadOnce(const BaseAST* exprAST, std::vector<bool>& seenVariables);
+
+    std::uint32_t AddStep(StepKind kind, std::uint32_t first, std::uint32_t second);
+    std::uint32_t CompileTree(const BaseAST* exprAST);
+
+    std::optional<std::uint32_t> MakeNode(std::uint32_t variable, std::uint32_t low, std::uint32_t high);
+    std::optional<std::uint32_t> Apply(BDDOperation operation, std::uint32_t left, std::uint32_t right);
+    std::optional<std::uint32_t> Negate(std::uint32_t node) { return this->Apply(BDDOperation::Xor, node, 1U); }
+    std::optional<std::uint32_t> CompileBDD(const BaseAST* exprAST);
+    void RollBack(std::size_t nodeCount);
+    std::uint32_t MarkReachable(std::uint32_t root);
+
+    std::size_t mNodeLimit;
+    ResourceGovernor* mGovernor;
+
+    std::vector<std::string> mVariableNames;
+    std::unordered_map<std::string, std::uint32_t> mVariableIndices;
+    std::vector<Rule> mRules;
+
+    std::vector<TreeStep> mTreeSteps;
+
+    std::vector<BDDNode> mBDDNodes;
+    // ߓ_̈ӕ\ (L[(ϐ, U̎})Ɛ^̎})
+    std::unordered_map<std::pair<std::uint64_t, std::uint32_t>, std::uint32_t, BDDKeyHash> mUniqueTable;
+    // Žʂ̃LbV (L[(Z, )ƉE)
+    std::unordered_map<std::pair<std::uint64_t, std::uint32_t>, std::uint32_t, BDDKeyHash> mComputedTable;
+
+    // K̍瓞Błߓ_݂̂, vZp̔ԍ (01͏I[, q͐eO) tĕג
+    // }vZp̔ԍŎ, mNodeSlots͐ߓ_vZp̔ԍւ̑Ή (BłȂߓ_~0)
+    std::vector<BDDNode> mReachableNodes;
+    std::vector<std::uint32_t> mNodeSlots;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_PROBABILITY_EVALUATOR_HPP
@@ -0,0 +1,83 @@
+
+// LogicalExpressionParser
+// ResourceGovernor.cpp
+
+#include "ResourceGovernor.hpp"
+
+#include <cstdlib>
+#include <sstream>
+
+std::optional<ResourceLimits> ParseResourceLimits(const std::string& limitsText)
+{
+    ResourceLimits limits;
+    std::istringstream limitsStream(limitsText);
+    std::string item;
+
+    while (std::getline(limitsStream, item, ',')) {
+        std::size_t separator = item.find('=');
+
+        if (separator == std::string::npos || separator + 1U == item.size())
+            return std::nullopt;
+
+        const std::string name = item.substr(0, separator);
+        const char* valueText = item.c_str() + separator + 1U;
+        char* valueEnd = nullptr;
+        unsigned long long value = std::strtoull(valueText, &valueEnd, 10);
+
+        if (*valueEnd != '\0' || *valueText == '-')
+            return std::nullopt;
+
+        if (name == "bytes")
+            limits.mMaxInputBytes = static_cast<std::size_t>(value);
+        else if (name == "tokens")
+            limits.mMaxTokens = static_cast<std::size_t>(value);
+        else if (name == "depth")
+            limits.mMaxNestingDepth = static_cast<std::size_t>(value);
+        else if (name == "nodes")
+            limits.mMaxASTNodes = static_cast<std::size_t>(value);
+        else if (name == "steps")
+            limits.mMaxSteps = static_cast<std::uint64_t>(value);
+        else
+            return std::nullopt;
+    }
+
+    return limits;
+}
+
+const char* ResourceKindName(ResourceKind resourceKind)
+{
+    switch (resourceKind) {
+        case ResourceKind::None:
+            return "None";
+        case ResourceKind::InputBytes:
+            return "Input bytes";
+        case ResourceKind::Tokens:
+            return "Tokens";
+        case ResourceKind::NestingDepth:
+            return "Nesting depth";
+        case ResourceKind::ASTNodes:
+            return "AST nodes";
+        case ResourceKind::Steps:
+            return "Steps";
+    }
+
+    return "Unknown";
+}
+
+DiagnosticCode ResourceDiagnosticCode(ResourceKind resourceKind)
+{
+    switch (resourceKind) {
+        case ResourceKind::InputBytes:
+            return DiagnosticCode::InputTooLarge;
+        case ResourceKind::Tokens:
+            return DiagnosticCode::TooManyTokens;
+        case ResourceKind::NestingDepth:
+            return DiagnosticCode::NestingTooDeep;
+        case ResourceKind::ASTNodes:
+            return DiagnosticCode::TooManyASTNodes;
+        case ResourceKind::Steps:
+            return DiagnosticCode::StepLimitExceeded;
+        default:
+            return DiagnosticCode::None;
+    }
+}
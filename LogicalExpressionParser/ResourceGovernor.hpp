@@ -0,0 +1,108 @@
+// LogicalExpressionParser
+// ResourceGovernor.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_RESOURCE_GOVERNOR_HPP
+#define LOGICAL_EXPRESSION_PARSER_RESOURCE_GOVERNOR_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+
+#include "Diagnostics.hpp"
+
+// ݂鎑̎
+enum class ResourceKind : std::uint8_t {
+    None,
+    InputBytes,
+    Tokens,
+    NestingDepth,
+    ASTNodes,
+    Steps
+};
+
+// 1̗vŎg鎑̏ (l͐Ȃ)
+struct ResourceLimits {
+    std::size_t     mMaxInputBytes = std::numeric_limits<std::size_t>::max();
+    std::size_t     mMaxTokens = std::numeric_limits<std::size_t>::max();
+    // \͂̍ċAƒۍ\؂̐[
+    std::size_t     mMaxNestingDepth = std::numeric_limits<std::size_t>::max();
+    std::size_t     mMaxASTNodes = std::numeric_limits<std::size_t>::max();
+    // ]ŖKm[h, ^l\̊蓖, T̕Ȃǂ1XebvƂĐ
+    std::uint64_t   mMaxSteps = std::numeric_limits<std::uint64_t>::max();
+};
+
+// "bytes=1048576,tokens=100000,depth=256,nodes=100000,steps=10000000" ̌` (w肵Ȃڂ͐Ȃ)
+std::optional<ResourceLimits> ParseResourceLimits(const std::string& limitsText);
+
+/*
+MłȂ̘͂_ɑ΂鎑̊Ǘ
+, \, ], ̊eiK͎gʂ̃IuWFNgɉZ, 𒴂
+ł؂ĎsԂ (ǂ̎sExhausted()ŕ)
+JE^͒PȐȂ̂, 1̗v̏1̃Xbĥݎg
+ */
+class ResourceGovernor {
+public:
+    ResourceGovernor(const ResourceLimits& limits = ResourceLimits()) :
+        mLimits(limits) { this->Reset(); }
+    ~ResourceGovernor() = default;
+
+    inline const ResourceLimits& Limits() const { return this->mLimits; }
+    inline ResourceKind Exhausted() const { return this->mExhausted; }
+    inline bool IsExhausted() const { return this->mExhausted != ResourceKind::None; }
+
+    inline std::size_t TokenCount() const { return this->mTokenCount; }
+    inline std::size_t ASTNodeCount() const { return this->mASTNodeCount; }
+    inline std::uint64_t StepCount() const { return this->mStepCount; }
+    inline std::uint64_t RemainingSteps() const {
+        return (this->mStepCount < this->mLimits.mMaxSteps) ? this->mLimits.mMaxSteps - this->mStepCount : 0U; }
+
+    // ̗v̂߂Ɏgʂ0ɖ߂ (͕ςȂ)
+    inline void Reset() {
+        this->mTokenCount = 0U;
+        this->mASTNodeCount = 0U;
+        this->mStepCount = 0U;
+        this->mExhausted = ResourceKind::None;
+    }
+
+    // 𒴂ꍇfalseԂ, ŏɐsL^
+    inline bool CheckInputBytes(std::size_t inputBytes) {
+        return inputBytes <= this->mLimits.mMaxInputBytes || this->Exhaust(ResourceKind::InputBytes); }
+    inline bool CheckNestingDepth(std::size_t nestingDepth) {
+        return nestingDepth <= this->mLimits.mMaxNestingDepth || this->Exhaust(ResourceKind::NestingDepth); }
+    inline bool ChargeTokens(std::size_t tokenCount) {
+        this->mTokenCount += tokenCount;
+        return this->mTokenCount <= this->mLimits.mMaxTokens || this->Exhaust(ResourceKind::Tokens); }
+    inline bool ChargeASTNodes(std::size_t nodeCount) {
+        this->mASTNodeCount += nodeCount;
+        return this->mASTNodeCount <= this->mLimits.mMaxASTNodes || this->Exhaust(ResourceKind::ASTNodes); }
+    inline bool ChargeSteps(std::uint64_t stepCount) {
+        // ӂꂵȂ悤, cƔׂĂZ
+        if (stepCount > this->RemainingSteps()) {
+            this->mStepCount = this->mLimits.mMaxSteps;
+            return this->Exhaust(ResourceKind::Steps);
+        }
+        this->mStepCount += stepCount;
+        return !this->IsExhausted(); }
+
+private:
+    inline bool Exhaust(ResourceKind resourceKind) {
+        if (this->mExhausted == ResourceKind::None)
+            this->mExhausted = resourceKind;
+        return false; }
+
+    ResourceLimits  mLimits;
+    std::size_t     mTokenCount;
+    std::size_t     mASTNodeCount;
+    std::uint64_t   mStepCount;
+    ResourceKind    mExhausted;
+};
+
+const char* ResourceKindName(ResourceKind resourceKind);
+// sƂ\G[̎
+DiagnosticCode ResourceDiagnosticCode(ResourceKind resourceKind);
+
+#endif // LOGICAL_EXPRESSION_PARSER_RESOURCE_GOVERNOR_HPP
@@ -0,0 +1,299 @@
+
+// LogicalExpressionParser
+// RuleBatch.cpp
+
+#include "RuleBatch.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define LEP_RULE_BATCH_X86
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define LEP_TARGET_AVX2
+#define LEP_TARGET_AVX512
+#else
+// ֐Ƃɖ߃Zbgw肵, gǂ͎sɔ肷
+#define LEP_TARGET_AVX2 __attribute__((target("avx2")))
+#define LEP_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+const char* SimdLevelName(SimdLevel simdLevel)
+{
+    switch (simdLevel) {
+        case SimdLevel::Scalar:
+            return "Scalar";
+        case SimdLevel::Avx2:
+            return "AVX2";
+        case SimdLevel::Avx512:
+            return "AVX-512";
+        default:
+            return "Unknown";
+    }
+}
+
+static SimdLevel DetectSimdLevel()
+{
+#if !defined(LEP_RULE_BATCH_X86)
+    return SimdLevel::Scalar;
+#elif defined(_MSC_VER)
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 0);
+
+    if (cpuInfo[0] < 7)
+        return SimdLevel::Scalar;
+
+    // OSAVX̃WX^ۑȂꍇ͎gȂ
+    __cpuid(cpuInfo, 1);
+
+    if ((cpuInfo[2] & (1 << 27)) == 0)
+        return SimdLevel::Scalar;
+
+    unsigned long long enabledStates = _xgetbv(0);
+    __cpuidex(cpuInfo, 7, 0);
+
+    if ((cpuInfo[1] & (1 << 16)) != 0 && (enabledStates & 0xE6U) == 0xE6U)
+        return SimdLevel::Avx512;
+
+    if ((cpuInfo[1] & (1 << 5)) != 0 && (enabledStates & 0x06U) == 0x06U)
+        return SimdLevel::Avx2;
+
+    return SimdLevel::Scalar;
+#else
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+        return SimdLevel::Avx512;
+
+    if (__builtin_cpu_supports("avx2"))
+        return SimdLevel::Avx2;
+
+    return SimdLevel::Scalar;
+#endif
+}
+
+static inline unsigned int CountTrailingZeros(std::uint64_t value)
+{
+    assert(value != 0U);
+
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<unsigned int>(index);
+#else
+    return static_cast<unsigned int>(__builtin_ctzll(value));
+#endif
+}
+
+static std::uint64_t GatherScalar(const std::uint64_t* assignment, const std::uint32_t* variables)
+{
+    std::uint64_t bits = 0U;
+
+    for (std::size_t i = 0; i < RuleBatch::BlockSize; ++i)
+        bits |= ((assignment[variables[i] >> 6] >> (variables[i] & 63U)) & 1U) << i;
+
+    return bits;
+}
+
+#ifdef LEP_RULE_BATCH_X86
+LEP_TARGET_AVX2 static std::uint64_t GatherAvx2(const std::uint64_t* assignment, const std::uint32_t* variables)
+{
+    // 蓖Ă32rbgPʂœǂ, ϐ̃rbgŏʂɈڂĂ畄rbgW߂
+    const int* words = reinterpret_cast<const int*>(assignment);
+    const __m256i bitMask = _mm256_set1_epi32(31);
+    std::uint64_t bits = 0U;
+
+    for (std::size_t i = 0; i < RuleBatch::BlockSize; i += 8U) {
+        __m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(variables + i));
+        __m256i gathered = _mm256_i32gather_epi32(words, _mm256_srli_epi32(indices, 5), 4);
+        __m256i shifted = _mm256_sllv_epi32(gathered, _mm256_sub_epi32(bitMask, _mm256_and_si256(indices, bitMask)));
+        std::uint32_t laneBits = static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(shifted)));
+        bits |= static_cast<std::uint64_t>(laneBits) << i;
+    }
+
+    return bits;
+}
+
+LEP_TARGET_AVX512 static std::uint64_t GatherAvx512(const std::uint64_t* assignment, const std::uint32_t* variables)
+{
+    // }XNȂ̌`͖̒loR̂ (GCCŌxo), SẴ[Lɂ}XN̌`g
+    const int* words = reinterpret_cast<const int*>(assignment);
+    const __mmask16 allLanes = static_cast<__mmask16>(0xFFFFU);
+    const __m512i bitMask = _mm512_set1_epi32(31);
+    const __m512i one = _mm512_set1_epi32(1);
+    std::uint64_t bits = 0U;
+
+    for (std::size_t i = 0; i < RuleBatch::BlockSize; i += 16U) {
+        __m512i indices = _mm512_loadu_si512(variables + i);
+        __m512i wordIndices = _mm512_maskz_srli_epi32(allLanes, indices, 5);
+        __m512i gathered = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), allLanes, wordIndices, words, 4);
+        __m512i shifted = _mm512_maskz_srlv_epi32(allLanes, gathered, _mm512_and_si512(indices, bitMask));
+        __mmask16 laneBits = _mm512_test_epi32_mask(shifted, one);
+        bits |= static_cast<std::uint64_t>(laneBits) << i;
+    }
+
+    return bits;
+}
+#endif
+
+//
+// RuleBatchNX
+//
+
+RuleBatch::RuleBatch(SimdLevel maxSimdLevel) :
+    mSimdLevel(std::min(maxSimdLevel, DetectSimdLevel())),
+    mGather(GatherScalar),
+    mRuleCount(0U),
+    mVariableCount(0U),
+    mMaxInstructionCount(0U)
+{
+#ifdef LEP_RULE_BATCH_X86
+    if (this->mSimdLevel == SimdLevel::Avx512)
+        this->mGather = GatherAvx512;
+    else if (this->mSimdLevel == SimdLevel::Avx2)
+        this->mGather = GatherAvx2;
+#endif
+}
+
+std::uint32_t RuleBatch::AddRule(const ProgramView& program)
+{
+    assert(program.InstructionCount() > 0U);
+
+    // ϐԍXbgԍɒu, gȂIyh0ɂ߂̕т`Ƃ
+    std::vector<Instruction> instructions(program.Instructions(), program.Instructions() + program.InstructionCount());
+    std::vector<std::uint32_t> variables;
+
+    for (auto& instruction : instructions) {
+        std::memset(instruction.mReserved, 0, sizeof(instruction.mReserved));
+
+        switch (instruction.mOpCode) {
+            case OpCode::False:
+            case OpCode::True:
+                instruction.mOperand0 = 0U;
+                instruction.mOperand1 = 0U;
+                break;
+            case OpCode::Variable:
+                variables.push_back(instruction.mOperand0);
+                this->mVariableCount = std::max<std::size_t>(this->mVariableCount, instruction.mOperand0 + 1U);
+                instruction.mOperand0 = static_cast<std::uint32_t>(variables.size() - 1U);
+                instruction.mOperand1 = 0U;
+                break;
+            case OpCode::Not:
+                instruction.mOperand1 = 0U;
+                break;
+            default:
+                break;
+        }
+    }
+
+    std::string shapeKey(reinterpret_cast<const char*>(instructions.data()), instructions.size() * sizeof(Instruction));
+    auto inserted = this->mShapeIndices.emplace(std::move(shapeKey), static_cast<std::uint32_t>(this->mShapes.size()));
+
+    if (inserted.second) {
+        this->mMaxInstructionCount = std::max(this->mMaxInstructionCount, instructions.size());
+        this->mShapes.emplace_back();
+        this->mShapes.back().mInstructions = std::move(instructions);
+        this->mShapes.back().mSlotVariables.resize(variables.size());
+    }
+
+    RuleShape& shape = this->mShapes[inserted.first->second];
+    std::size_t lane = shape.mRules.size();
+    std::uint32_t ruleIndex = static_cast<std::uint32_t>(this->mRuleCount++);
+
+    shape.mRules.push_back(ruleIndex);
+
+    // ubN̋󂫂͕ϐԍ0Ŗ߂Ă, ]̌ʂ͎̂Ă
+    for (std::size_t slot = 0; slot < variables.size(); ++slot) {
+        if (lane % BlockSize == 0U)
+            shape.mSlotVariables[slot].resize(lane + BlockSize, 0U);
+
+        shape.mSlotVariables[slot][lane] = variables[slot];
+    }
+
+    return ruleIndex;
+}
+
+void RuleBatch::Evaluate(const std::uint64_t* assignment, std::uint64_t* result) const
+{
+    // ]̂тɊmۂȂ悤, Ɨ̈̓XbhI܂ŕێ
+    static thread_local std::vector<std::uint64_t> tScratch;
+
+    if (tScratch.size() < this->ScratchWordCount())
+        tScratch.resize(this->ScratchWordCount());
+
+    this->Evaluate(assignment, result, tScratch.data());
+}
+
+void RuleBatch::Evaluate(const std::uint64_t* assignment, std::uint64_t* result, std::uint64_t* scratch) const
+{
+    std::fill(result, result + this->ResultWordCount(), static_cast<std::uint64_t>(0U));
+
+    // e߂̒l, ubN̋KƂ1rbgŕ\ (e߂͑O̖߂̒l݂̂ĝ, O̕]̒lcĂĂ悢)
+    std::uint64_t* values = scratch;
+
+    for (const auto& shape : this->mShapes) {
+        for (std::size_t block = 0; block < shape.mRules.size(); block += BlockSize) {
+            for (std::size_t i = 0; i < shape.mInstructions.size(); ++i) {
+                const Instruction& instruction = shape.mInstructions[i];
+                std::uint64_t left = values[instruction.mOperand0];
+                std::uint64_t right = values[instruction.mOperand1];
+
+                switch (instruction.mOpCode) {
+                    case OpCode::False:
+                        values[i] = 0U;
+                        break;
+                    case OpCode::True:
+                        values[i] = ~static_cast<std::uint64_t>(0U);
+                        break;
+                    case OpCode::Variable:
+                        values[i] = this->mGather(assignment, shape.mSlotVariables[instruction.mOperand0].data() + block);
+                        break;
+                    case OpCode::Not:
+                        values[i] = ~left;
+                        break;
+                    case OpCode::And:
+                        values[i] = left & right;
+                        break;
+                    case OpCode::Or:
+                        values[i] = left | right;
+                        break;
+                    case OpCode::Then:
+                        values[i] = ~left | right;
+                        break;
+                    case OpCode::Eq:
+                    case OpCode::Xnor:
+                        values[i] = ~(left ^ right);
+                        break;
+                    case OpCode::Xor:
+                        values[i] = left ^ right;
+                        break;
+                    case OpCode::Nand:
+                        values[i] = ~(left & right);
+                        break;
+                    case OpCode::Nor:
+                        values[i] = ~(left | right);
+                        break;
+                    default:
+                        assert(false);
+                        break;
+                }
+            }
+
+            std::uint64_t bits = values[shape.mInstructions.size() - 1U];
+            std::size_t laneCount = std::min(BlockSize, shape.mRules.size() - block);
+
+            if (laneCount < BlockSize)
+                bits &= (static_cast<std::uint64_t>(1U) << laneCount) - 1U;
+
+            // ^ɂȂK̔ԍ̈ʒuɃrbg𗧂Ă
+            for (; bits != 0U; bits &= bits - 1U) {
+                std::uint32_t ruleIndex = shape.mRules[block + CountTrailingZeros(bits)];
+                result[ruleIndex >> 6] |= static_cast<std::uint64_t>(1U) << (ruleIndex & 63U);
+            }
+        }
+    }
+}
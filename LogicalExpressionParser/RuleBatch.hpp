@@ -0,0 +1,81 @@
+// LogicalExpressionParser
+// RuleBatch.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_RULE_BATCH_HPP
+#define LOGICAL_EXPRESSION_PARSER_RULE_BATCH_HPP
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Compiler.hpp"
+
+// ϐ̒lW߂̂Ɏg߃Zbg
+enum class SimdLevel {
+    Scalar,
+    Avx2,
+    Avx512
+};
+
+const char* SimdLevelName(SimdLevel simdLevel);
+
+// ߂̕т, ϐԍ݂̂قȂK̏W܂
+struct RuleShape {
+    // ϐ̖߂̃Iyhɂ͕ϐԍ̑ɃXbgԍi[
+    std::vector<Instruction>                mInstructions;
+    std::vector<std::uint32_t>              mRules;
+    // XbgƂɊeK̕ϐԍׂ (RuleBatch::BlockSize̔{)
+    std::vector<std::vector<std::uint32_t>> mSlotVariables;
+};
+
+/*
+1̊蓖Ăɑ΂đ̏ȋK܂Ƃ߂ĕ]
+K`Ƃɂ܂Ƃ߂ĕϐԍXbgƂ̔zɕ, 64̋K̕ϐ̒lMU[߂
+1̃rbgɏW߂Ă, e߂64̋Kɑ΂1̃rbgZŕ]
+ */
+class RuleBatch {
+public:
+    static constexpr std::size_t BlockSize = 64U;
+
+    // sCPUΉ閽߃Zbĝ, maxSimdLevel𒴂Ȃ̂g
+    RuleBatch(SimdLevel maxSimdLevel = SimdLevel::Avx512);
+    ~RuleBatch() = default;
+
+    inline std::size_t RuleCount() const { return this->mRuleCount; }
+    inline std::size_t ShapeCount() const { return this->mShapes.size(); }
+    inline SimdLevel Level() const { return this->mSimdLevel; }
+    // 蓖ĂɕKv64rbgPʂ̌ꐔ
+    inline std::size_t AssignmentWordCount() const { return this->mVariableCount / 64U + 1U; }
+    inline std::size_t ResultWordCount() const { return (this->mRuleCount + 63U) / 64U; }
+    // ]̍Ɨ̈ɕKv64rbgPʂ̌ꐔ (KǉƑ邱Ƃ)
+    inline std::size_t ScratchWordCount() const { return std::max<std::size_t>(1U, this->mMaxInstructionCount); }
+
+    // K̔ԍ (ǉ) Ԃ
+    std::uint32_t AddRule(const ProgramView& program);
+
+    // ϐ̒l͕ϐԍƂ1rbgŕ\ (AssignmentWordCount()ꂪKv)
+    // ʂ͋K̔ԍƂ1rbg, ResultWordCount()
+    // Ɨ̈̓XbhƂ1g
+    void Evaluate(const std::uint64_t* assignment, std::uint64_t* result) const;
+    // Ăяo̍Ɨ̈ (ScratchWordCount()) g (̃XbhĂԏꍇ͕ʁẌ̗n)
+    void Evaluate(const std::uint64_t* assignment, std::uint64_t* result, std::uint64_t* scratch) const;
+
+private:
+    using GatherFunction = std::uint64_t (*)(const std::uint64_t* assignment, const std::uint32_t* variables);
+
+    SimdLevel mSimdLevel;
+    GatherFunction mGather;
+    std::size_t mRuleCount;
+    std::size_t mVariableCount;
+    std::size_t mMaxInstructionCount;
+    std::vector<RuleShape> mShapes;
+    // ߂̕т𕶎ɂ̂`̔ԍ
+    std::unordered_map<std::string, std::uint32_t> mShapeIndices;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_RULE_BATCH_HPP
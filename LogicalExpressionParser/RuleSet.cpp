@@ -0,0 +1,392 @@
+
+// LogicalExpressionParser
+// RuleSet.cpp
+
+#include "RuleSet.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char RuleSetMagic[8] = { 'L', 'E', 'P', 'R', 'U', 'L', 'E', 'S' };
+static const std::uint32_t RuleSetEndianMarker = 0x01020304U;
+
+static inline std::uint64_t AlignOffset(std::uint64_t offset)
+{
+    return (offset + 7U) & ~static_cast<std::uint64_t>(7U);
+}
+
+std::uint64_t RuleSetChecksum(const char* data, std::size_t size, std::uint64_t hash)
+{
+    // FNV-1a (64rbg)
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+std::uint64_t RuleSetFileChecksum(const char* data, std::size_t size)
+{
+    assert(size >= sizeof(RuleSetHeader));
+
+    RuleSetHeader header;
+    std::memcpy(&header, data, sizeof(RuleSetHeader));
+
+    if (header.mVersion < RuleSetHeaderChecksumVersion)
+        return RuleSetChecksum(data + sizeof(RuleSetHeader), size - sizeof(RuleSetHeader));
+
+    header.mChecksum = 0U;
+    std::uint64_t hash = RuleSetChecksum(reinterpret_cast<const char*>(&header), sizeof(RuleSetHeader));
+
+    return RuleSetChecksum(data + sizeof(RuleSetHeader), size - sizeof(RuleSetHeader), hash);
+}
+
+//
+// RuleSetWriterNX
+//
+
+void RuleSetWriter::AddRule(const std::shared_ptr<Program>& program)
+{
+    assert(program != nullptr);
+    assert(!program->Instructions().empty());
+
+    this->mRules.push_back(program);
+}
+
+bool RuleSetWriter::Write(const std::string& fileName, const SymbolTable& symbolTable) const
+{
+    std::uint32_t symbolCount = static_cast<std::uint32_t>(symbolTable.Size());
+    std::uint64_t instructionCount = 0;
+    std::uint64_t stringPoolSize = 0;
+
+    for (const auto& program : this->mRules)
+        instructionCount += program->Instructions().size();
+
+    for (std::uint32_t i = 0; i < symbolCount; ++i)
+        stringPoolSize += symbolTable.Name(i).size();
+
+    // ë̔zu߂
+    RuleSetHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.mMagic, RuleSetMagic, sizeof(RuleSetMagic));
+    header.mVersion = RuleSetVersion;
+    header.mEndianMarker = RuleSetEndianMarker;
+    header.mRuleCount = static_cast<std::uint32_t>(this->mRules.size());
+    header.mSymbolCount = symbolCount;
+    header.mInstructionCount = instructionCount;
+    header.mRuleTableOffset = AlignOffset(sizeof(RuleSetHeader));
+    header.mSymbolTableOffset = AlignOffset(header.mRuleTableOffset + sizeof(RuleEntry) * header.mRuleCount);
+    header.mSymbolOrderOffset = AlignOffset(header.mSymbolTableOffset + sizeof(SymbolEntry) * symbolCount);
+    header.mStringPoolOffset = AlignOffset(header.mSymbolOrderOffset + sizeof(std::uint32_t) * symbolCount);
+    header.mStringPoolSize = stringPoolSize;
+    header.mInstructionOffset = AlignOffset(header.mStringPoolOffset + stringPoolSize);
+    header.mFileSize = header.mInstructionOffset + sizeof(Instruction) * instructionCount;
+
+    std::vector<char> buffer(static_cast<std::size_t>(header.mFileSize), 0);
+
+    // K̕\Ɩߗ
+    RuleEntry* ruleEntries = reinterpret_cast<RuleEntry*>(buffer.data() + header.mRuleTableOffset);
+    Instruction* instructions = reinterpret_cast<Instruction*>(buffer.data() + header.mInstructionOffset);
+    std::uint64_t firstInstruction = 0;
+
+    for (std::size_t i = 0; i < this->mRules.size(); ++i) {
+        const std::vector<Instruction>& ruleInstructions = this->mRules[i]->Instructions();
+
+        ruleEntries[i].mFirstInstruction = firstInstruction;
+        ruleEntries[i].mInstructionCount = ruleInstructions.size();
+        std::memcpy(instructions + firstInstruction, ruleInstructions.data(), sizeof(Instruction) * ruleInstructions.size());
+
+        firstInstruction += ruleInstructions.size();
+    }
+
+    // ϐ̕\ƕ̈
+    SymbolEntry* symbolEntries = reinterpret_cast<SymbolEntry*>(buffer.data() + header.mSymbolTableOffset);
+    char* stringPool = buffer.data() + header.mStringPoolOffset;
+    std::uint32_t stringOffset = 0;
+
+    for (std::uint32_t i = 0; i < symbolCount; ++i) {
+        const std::string& name = symbolTable.Name(i);
+
+        symbolEntries[i].mOffset = stringOffset;
+        symbolEntries[i].mLength = static_cast<std::uint32_t>(name.size());
+        std::memcpy(stringPool + stringOffset, name.data(), name.size());
+
+        stringOffset += static_cast<std::uint32_t>(name.size());
+    }
+
+    // Oϐԍ񕪒Tň悤, ̍
+    std::vector<std::uint32_t> symbolOrder(symbolCount);
+
+    for (std::uint32_t i = 0; i < symbolCount; ++i)
+        symbolOrder[i] = i;
+
+    std::sort(symbolOrder.begin(), symbolOrder.end(), [&symbolTable](std::uint32_t lhs, std::uint32_t rhs) {
+        return symbolTable.Name(lhs) < symbolTable.Name(rhs); });
+    std::memcpy(buffer.data() + header.mSymbolOrderOffset, symbolOrder.data(), sizeof(std::uint32_t) * symbolCount);
+
+    // wb_܂ޑŜɑ΂`FbNT
+    std::memcpy(buffer.data(), &header, sizeof(RuleSetHeader));
+    header.mChecksum = RuleSetFileChecksum(buffer.data(), buffer.size());
+    std::memcpy(buffer.data(), &header, sizeof(RuleSetHeader));
+
+    std::ofstream outputStream(fileName, std::ios::binary | std::ios::trunc);
+
+    if (!outputStream)
+        return false;
+
+    outputStream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+    return static_cast<bool>(outputStream);
+}
+
+//
+// MappedRuleSetNX
+//
+
+MappedRuleSet::MappedRuleSet() :
+    mData(nullptr),
+    mSize(0U),
+    mHeader(nullptr)
+#ifdef _WIN32
+    , mFileHandle(nullptr),
+    mMappingHandle(nullptr)
+#endif
+{
+}
+
+MappedRuleSet::~MappedRuleSet()
+{
+    this->Close();
+}
+
+bool MappedRuleSet::Open(const std::string& fileName, bool verifyChecksum)
+{
+    this->Close();
+
+    // t@CŜǂݎpŃ}bv (t񉻂͍sȂ)
+#ifdef _WIN32
+    HANDLE fileHandle = ::CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+
+    if (!::GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        ::CloseHandle(fileHandle);
+        return false;
+    }
+
+    HANDLE mappingHandle = ::CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (mappingHandle == nullptr) {
+        ::CloseHandle(fileHandle);
+        return false;
+    }
+
+    void* data = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+    if (data == nullptr) {
+        ::CloseHandle(mappingHandle);
+        ::CloseHandle(fileHandle);
+        return false;
+    }
+
+    this->mFileHandle = fileHandle;
+    this->mMappingHandle = mappingHandle;
+    this->mSize = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    int fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+
+    if (fileDescriptor < 0)
+        return false;
+
+    struct stat fileStatus;
+
+    if (::fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0) {
+        ::close(fileDescriptor);
+        return false;
+    }
+
+    void* data = ::mmap(nullptr, static_cast<std::size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+    // }bv̓t@CLqq͕sv
+    ::close(fileDescriptor);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    this->mSize = static_cast<std::size_t>(fileStatus.st_size);
+#endif
+
+    this->mData = static_cast<const char*>(data);
+
+    if (this->mSize < sizeof(RuleSetHeader) || !this->Validate(verifyChecksum)) {
+        this->Close();
+        return false;
+    }
+
+    this->mHeader = this->At<RuleSetHeader>(0);
+
+    return true;
+}
+
+void MappedRuleSet::Close()
+{
+    if (this->mData == nullptr)
+        return;
+
+#ifdef _WIN32
+    ::UnmapViewOfFile(this->mData);
+    ::CloseHandle(static_cast<HANDLE>(this->mMappingHandle));
+    ::CloseHandle(static_cast<HANDLE>(this->mFileHandle));
+    this->mMappingHandle = nullptr;
+    this->mFileHandle = nullptr;
+#else
+    ::munmap(const_cast<char*>(this->mData), this->mSize);
+#endif
+
+    this->mData = nullptr;
+    this->mSize = 0U;
+    this->mHeader = nullptr;
+}
+
+bool MappedRuleSet::Validate(bool verifyChecksum) const
+{
+    const RuleSetHeader* header = this->At<RuleSetHeader>(0);
+
+    if (std::memcmp(header->mMagic, RuleSetMagic, sizeof(RuleSetMagic)) != 0)
+        return false;
+
+    // قȂłoCg̃t@C͓ǂݍ܂Ȃ
+    if (header->mVersion < RuleSetMinimumVersion || header->mVersion > RuleSetVersion ||
+        header->mEndianMarker != RuleSetEndianMarker)
+        return false;
+
+    if (header->mFileSize != this->mSize)
+        return false;
+
+    // ë悪t@C͈͓̔Ɏ܂Ă邩
+    auto inRange = [this](std::uint64_t offset, std::uint64_t size) {
+        return (offset % 8U == 0U) && offset <= this->mSize && size <= this->mSize - offset; };
+
+    if (!inRange(header->mRuleTableOffset, sizeof(RuleEntry) * static_cast<std::uint64_t>(header->mRuleCount)) ||
+        !inRange(header->mSymbolTableOffset, sizeof(SymbolEntry) * static_cast<std::uint64_t>(header->mSymbolCount)) ||
+        !inRange(header->mSymbolOrderOffset, sizeof(std::uint32_t) * static_cast<std::uint64_t>(header->mSymbolCount)) ||
+        !inRange(header->mStringPoolOffset, header->mStringPoolSize) ||
+        header->mInstructionCount > this->mSize / sizeof(Instruction) ||
+        !inRange(header->mInstructionOffset, sizeof(Instruction) * header->mInstructionCount))
+        return false;
+
+    const RuleEntry* ruleEntries = this->At<RuleEntry>(header->mRuleTableOffset);
+
+    for (std::uint32_t i = 0; i < header->mRuleCount; ++i)
+        if (ruleEntries[i].mInstructionCount == 0 ||
+            ruleEntries[i].mFirstInstruction > header->mInstructionCount ||
+            ruleEntries[i].mInstructionCount > header->mInstructionCount - ruleEntries[i].mFirstInstruction)
+            return false;
+
+    const SymbolEntry* symbolEntries = this->At<SymbolEntry>(header->mSymbolTableOffset);
+
+    for (std::uint32_t i = 0; i < header->mSymbolCount; ++i)
+        if (static_cast<std::uint64_t>(symbolEntries[i].mOffset) + symbolEntries[i].mLength > header->mStringPoolSize)
+            return false;
+
+    const std::uint32_t* symbolOrder = this->At<std::uint32_t>(header->mSymbolOrderOffset);
+
+    for (std::uint32_t i = 0; i < header->mSymbolCount; ++i)
+        if (symbolOrder[i] >= header->mSymbolCount)
+            return false;
+
+    // \̌̓`FbNT؂Ȃꍇs (ProgramViewFindSymbol͈͊Oǂ܂Ȃ悤ɂ)
+    // ߂̃IyhgO̖(܂͗Lȕϐԍ)wĂ邩
+    for (std::uint32_t i = 0; i < header->mRuleCount; ++i) {
+        const Instruction* instructions = this->At<Instruction>(header->mInstructionOffset) + ruleEntries[i].mFirstInstruction;
+
+        for (std::uint64_t j = 0; j < ruleEntries[i].mInstructionCount; ++j) {
+            const Instruction& instruction = instructions[j];
+
+            switch (instruction.mOpCode) {
+                case OpCode::False:
+                case OpCode::True:
+                    break;
+                case OpCode::Variable:
+                    if (instruction.mOperand0 >= header->mSymbolCount)
+                        return false;
+                    break;
+                case OpCode::Not:
+                    if (instruction.mOperand0 >= j)
+                        return false;
+                    break;
+                case OpCode::And:
+                case OpCode::Or:
+                case OpCode::Then:
+                case OpCode::Eq:
+                case OpCode::Xor:
+                case OpCode::Xnor:
+                case OpCode::Nand:
+                case OpCode::Nor:
+                    if (instruction.mOperand0 >= j || instruction.mOperand1 >= j)
+                        return false;
+                    break;
+                default:
+                    return false;
+            }
+        }
+    }
+
+    if (verifyChecksum && RuleSetFileChecksum(this->mData, this->mSize) != header->mChecksum)
+        return false;
+
+    return true;
+}
+
+ProgramView MappedRuleSet::Rule(std::size_t index) const
+{
+    assert(this->IsOpen());
+    assert(index < this->mHeader->mRuleCount);
+
+    const RuleEntry& ruleEntry = this->At<RuleEntry>(this->mHeader->mRuleTableOffset)[index];
+    const Instruction* instructions = this->At<Instruction>(this->mHeader->mInstructionOffset);
+
+    return ProgramView(instructions + ruleEntry.mFirstInstruction, static_cast<std::size_t>(ruleEntry.mInstructionCount));
+}
+
+std::string_view MappedRuleSet::SymbolName(std::uint32_t index) const
+{
+    assert(this->IsOpen());
+    assert(index < this->mHeader->mSymbolCount);
+
+    const SymbolEntry& symbolEntry = this->At<SymbolEntry>(this->mHeader->mSymbolTableOffset)[index];
+
+    return std::string_view(this->At<char>(this->mHeader->mStringPoolOffset) + symbolEntry.mOffset, symbolEntry.mLength);
+}
+
+std::optional<std::uint32_t> MappedRuleSet::FindSymbol(std::string_view name) const
+{
+    assert(this->IsOpen());
+
+    const std::uint32_t* symbolOrder = this->At<std::uint32_t>(this->mHeader->mSymbolOrderOffset);
+    const std::uint32_t* symbolOrderEnd = symbolOrder + this->mHeader->mSymbolCount;
+
+    auto iter = std::lower_bound(symbolOrder, symbolOrderEnd, name, [this](std::uint32_t index, std::string_view value) {
+        return this->SymbolName(index) < value; });
+
+    if (iter == symbolOrderEnd || this->SymbolName(*iter) != name)
+        return std::nullopt;
+
+    return *iter;
+}
@@ -0,0 +1,118 @@
+// LogicalExpressionParser
+// RuleSet.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_RULE_SET_HPP
+#define LOGICAL_EXPRESSION_PARSER_RULE_SET_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Compiler.hpp"
+
+/*
+RpCς݂̋KW̃oCi` (gGfBA, ë8oCgEɔzu)
+    RuleSetHeader
+    RuleEntry[mRuleCount]           (ߗ̈ʒu͋KƂ̑΃CfbNX)
+    SymbolEntry[mSymbolCount]       (ϐԍ̏)
+    std::uint32_t[mSymbolCount]     (O̎ɕׂϐԍ)
+    char[mStringPoolSize]           (ϐ, I[Ȃ)
+    Instruction[mInstructionCount]
+ItZbg͑Săt@C̐擪̈ʒuȂ̂, ǂ̃AhXɃ}bvĂ̂܂܎g
+ */
+
+struct RuleSetHeader {
+    char            mMagic[8];
+    std::uint32_t   mVersion;
+    std::uint32_t   mEndianMarker;
+    std::uint64_t   mFileSize;
+    std::uint64_t   mChecksum;
+    std::uint32_t   mRuleCount;
+    std::uint32_t   mSymbolCount;
+    std::uint64_t   mInstructionCount;
+    std::uint64_t   mRuleTableOffset;
+    std::uint64_t   mSymbolTableOffset;
+    std::uint64_t   mSymbolOrderOffset;
+    std::uint64_t   mStringPoolOffset;
+    std::uint64_t   mStringPoolSize;
+    std::uint64_t   mInstructionOffset;
+};
+
+struct RuleEntry {
+    std::uint64_t   mFirstInstruction;
+    std::uint64_t   mInstructionCount;
+};
+
+struct SymbolEntry {
+    std::uint32_t   mOffset;
+    std::uint32_t   mLength;
+};
+
+// 2Xor, Xnor, Nand, Nor̖߂ǉ (1̃t@Ĉ܂ܓǂݍ߂)
+// 3Ń`FbNTɃwb_ (`FbNT̗0Ƃ) ܂߂ (2܂ł̃`FbNT̓wb_ȍ~̂)
+constexpr std::uint32_t RuleSetVersion = 3U;
+constexpr std::uint32_t RuleSetMinimumVersion = 1U;
+constexpr std::uint32_t RuleSetHeaderChecksumVersion = 3U;
+
+class RuleSetWriter {
+public:
+    RuleSetWriter() = default;
+    ~RuleSetWriter() = default;
+
+    inline std::size_t RuleCount() const { return this->mRules.size(); }
+
+    void AddRule(const std::shared_ptr<Program>& program);
+    bool Write(const std::string& fileName, const SymbolTable& symbolTable) const;
+
+private:
+    std::vector<std::shared_ptr<Program>> mRules;
+};
+
+class MappedRuleSet {
+public:
+    MappedRuleSet();
+    ~MappedRuleSet();
+
+    MappedRuleSet(const MappedRuleSet&) = delete;
+    MappedRuleSet& operator=(const MappedRuleSet&) = delete;
+
+    inline bool IsOpen() const { return this->mHeader != nullptr; }
+    inline std::size_t RuleCount() const { return this->mHeader->mRuleCount; }
+    inline std::size_t SymbolCount() const { return this->mHeader->mSymbolCount; }
+
+    bool Open(const std::string& fileName, bool verifyChecksum = true);
+    void Close();
+
+    ProgramView Rule(std::size_t index) const;
+    std::string_view SymbolName(std::uint32_t index) const;
+    std::optional<std::uint32_t> FindSymbol(std::string_view name) const;
+
+private:
+    bool Validate(bool verifyChecksum) const;
+
+    template <typename T>
+    inline const T* At(std::uint64_t offset) const {
+        return reinterpret_cast<const T*>(this->mData + offset); }
+
+    const char*             mData;
+    std::size_t             mSize;
+    const RuleSetHeader*    mHeader;
+
+#ifdef _WIN32
+    void*                   mFileHandle;
+    void*                   mMappingHandle;
+#endif
+};
+
+// hashɑÖ̗̃`FbNTnƑČvZ
+std::uint64_t RuleSetChecksum(const char* data, std::size_t size, std::uint64_t hash = 14695981039346656037ULL);
+// t@CS (擪Ƀwb_) ̃`FbNT
+std::uint64_t RuleSetFileChecksum(const char* data, std::size_t size);
+
+#endif // LOGICAL_EXPRESSION_PARSER_RULE_SET_HPP
@@ -0,0 +1,210 @@
+
+// LogicalExpressionParser
+// RuleSnapshot.cpp
+
+#include "RuleSnapshot.hpp"
+#include "AST.hpp"
+#include "Diagnostics.hpp"
+
+#include <algorithm>
+#include <limits>
+
+std::optional<std::uint32_t> RuleSnapshot::FindRule(std::string_view logicalExpr) const
+{
+    auto iter = this->mRuleIndices.find(logicalExpr);
+    return (iter != this->mRuleIndices.end()) ? std::make_optional(iter->second) : std::nullopt;
+}
+
+RuleSnapshotStore::RuleSnapshotStore(std::size_t maxReaders) :
+    mMaxReaders(maxReaders),
+    mReaderSlots(new ReaderSlot[maxReaders]),
+    mCurrent(nullptr),
+    mEpoch(1U),
+    mReclaimedCount(0U),
+    mGovernor(nullptr),
+    mFailedRule(0U),
+    mParsedRuleCount(0U)
+{
+    for (std::size_t i = 0; i < this->mMaxReaders; ++i) {
+        this->mReaderSlots[i].mEpoch.store(0U, std::memory_order_relaxed);
+        this->mReaderSlots[i].mInUse.store(false, std::memory_order_relaxed);
+    }
+
+    // ŏPublish܂ł͋K̖XibvVbg
+    RuleSnapshot* emptySnapshot = new RuleSnapshot();
+    emptySnapshot->mSymbolTable = std::make_shared<const SymbolTable>();
+    this->mCurrent.store(emptySnapshot, std::memory_order_release);
+}
+
+RuleSnapshotStore::~RuleSnapshotStore()
+{
+    for (std::size_t i = 0; i < this->mMaxReaders; ++i)
+        assert(this->mReaderSlots[i].mEpoch.load(std::memory_order_relaxed) == 0U);
+
+    delete this->mCurrent.load(std::memory_order_acquire);
+}
+
+std::size_t RuleSnapshotStore::RetiredCount()
+{
+    std::lock_guard<std::mutex> lock(this->mWriterMutex);
+    return this->mRetired.size();
+}
+
+void RuleSnapshotStore::SetGovernor(ResourceGovernor* governor)
+{
+    std::lock_guard<std::mutex> lock(this->mWriterMutex);
+
+    this->mGovernor = governor;
+    this->mParserSession.SetGovernor(governor);
+}
+
+std::optional<std::uint64_t> RuleSnapshotStore::Publish(const std::vector<std::string>& logicalExprs, Diagnostics* diagnostics)
+{
+    std::lock_guard<std::mutex> lock(this->mWriterMutex);
+
+    // ͎Ȃ̂, ݂̃XibvVbg͉Ȃ
+    const RuleSnapshot* currentSnapshot = this->mCurrent.load(std::memory_order_acquire);
+    std::unique_ptr<RuleSnapshot> newSnapshot(new RuleSnapshot());
+    std::shared_ptr<SymbolTable> symbolTable;
+    Diagnostics localDiagnostics;
+    Diagnostics& parseDiagnostics = (diagnostics != nullptr) ? *diagnostics : localDiagnostics;
+
+    newSnapshot->mVersion = currentSnapshot->mVersion + 1U;
+    newSnapshot->mRules.reserve(logicalExprs.size());
+    this->mParsedRuleCount = 0U;
+
+    for (std::size_t i = 0; i < logicalExprs.size(); ++i) {
+        // _K, VXibvVbg̑ŐK݂̃XibvVbg̋KL
+        const std::string& logicalExpr = logicalExprs[i];
+        std::optional<std::uint32_t> newIndex = newSnapshot->FindRule(logicalExpr);
+        std::optional<std::uint32_t> currentIndex = newIndex.has_value() ? std::nullopt : currentSnapshot->FindRule(logicalExpr);
+        std::shared_ptr<const RuleSnapshot::CompiledRule> compiledRule;
+
+        if (newIndex.has_value()) {
+            compiledRule = newSnapshot->mRules[newIndex.value()];
+        } else if (currentIndex.has_value()) {
+            compiledRule = currentSnapshot->mRules[currentIndex.value()];
+        } else {
+            // ςK݂̂\͂ăRpC
+            // Jς݂̃V{\͓ǂݎ肪QƂĂ̂, ɕϐǉ
+            if (symbolTable == nullptr)
+                symbolTable = std::make_shared<SymbolTable>(*currentSnapshot->mSymbolTable);
+
+            parseDiagnostics.Clear();
+
+            if (this->mGovernor != nullptr)
+                this->mGovernor->Reset();
+
+            std::shared_ptr<BaseAST> exprAST = this->mParserSession.Parse(logicalExpr, nullptr, parseDiagnostics);
+            std::shared_ptr<Program> program = (exprAST != nullptr) ? Compiler(symbolTable).Compile(exprAST) : nullptr;
+
+            if (program == nullptr) {
+                this->mFailedRule = i;
+                return std::nullopt;
+            }
+
+            compiledRule = std::make_shared<const RuleSnapshot::CompiledRule>(
+                RuleSnapshot::CompiledRule { logicalExpr, exprAST, program });
+            ++this->mParsedRuleCount;
+        }
+
+        newSnapshot->mRules.push_back(compiledRule);
+        newSnapshot->mRuleIndices.emplace(compiledRule->mText, static_cast<std::uint32_t>(i));
+    }
+
+    // ϐȂ, V{\͌ƓeɂȂ
+    if (symbolTable != nullptr && symbolTable->Size() != currentSnapshot->mSymbolTable->Size())
+        newSnapshot->mSymbolTable = symbolTable;
+    else
+        newSnapshot->mSymbolTable = currentSnapshot->mSymbolTable;
+
+    // ւɃG|bNi߂̂, ÂXibvVbgǂ񂾓ǂݎ̘g̃G|bN͑ޔG|bNȉɂȂ
+    std::uint64_t version = newSnapshot->mVersion;
+    const RuleSnapshot* oldSnapshot = this->mCurrent.exchange(newSnapshot.release(), std::memory_order_seq_cst);
+    std::uint64_t retiredEpoch = this->mEpoch.fetch_add(1U, std::memory_order_seq_cst);
+
+    this->mRetired.push_back(RetiredSnapshot { std::unique_ptr<const RuleSnapshot>(oldSnapshot), retiredEpoch });
+    this->ReclaimLocked();
+
+    return version;
+}
+
+std::size_t RuleSnapshotStore::Reclaim()
+{
+    std::lock_guard<std::mutex> lock(this->mWriterMutex);
+    return this->ReclaimLocked();
+}
+
+std::size_t RuleSnapshotStore::ReclaimLocked()
+{
+    if (this->mRetired.empty())
+        return 0U;
+
+    // Qƒ̓ǂݎ̂łÂG|bN
+    std::uint64_t oldestEpoch = std::numeric_limits<std::uint64_t>::max();
+
+    for (std::size_t i = 0; i < this->mMaxReaders; ++i) {
+        std::uint64_t readerEpoch = this->mReaderSlots[i].mEpoch.load(std::memory_order_seq_cst);
+
+        if (readerEpoch != 0U)
+            oldestEpoch = std::min(oldestEpoch, readerEpoch);
+    }
+
+    // ޔG|bNɎQƂn߂ǂݎ, ւ̃XibvVbgǂ܂Ȃ
+    auto reclaimedEnd = std::remove_if(this->mRetired.begin(), this->mRetired.end(),
+        [oldestEpoch](const RetiredSnapshot& retiredSnapshot) { return retiredSnapshot.mEpoch < oldestEpoch; });
+    std::size_t reclaimedCount = static_cast<std::size_t>(this->mRetired.end() - reclaimedEnd);
+
+    this->mRetired.erase(reclaimedEnd, this->mRetired.end());
+    this->mReclaimedCount.fetch_add(reclaimedCount, std::memory_order_relaxed);
+
+    return reclaimedCount;
+}
+
+std::optional<std::size_t> RuleSnapshotStore::RegisterReader()
+{
+    for (std::size_t i = 0; i < this->mMaxReaders; ++i) {
+        bool inUse = false;
+
+        if (this->mReaderSlots[i].mInUse.compare_exchange_strong(inUse, true, std::memory_order_acq_rel))
+            return i;
+    }
+
+    return std::nullopt;
+}
+
+void RuleSnapshotStore::UnregisterReader(std::size_t readerIndex)
+{
+    assert(readerIndex < this->mMaxReaders);
+    assert(this->mReaderSlots[readerIndex].mEpoch.load(std::memory_order_relaxed) == 0U);
+
+    this->mReaderSlots[readerIndex].mInUse.store(false, std::memory_order_release);
+}
+
+const RuleSnapshot* RuleSnapshotStore::Pin(std::size_t readerIndex)
+{
+    assert(readerIndex < this->mMaxReaders);
+    assert(this->mReaderSlots[readerIndex].mEpoch.load(std::memory_order_relaxed) == 0U);
+
+    // gւ̃G|bN݂̏|C^̓ǂݍ݂ɏ肩猩悤ɂ (seq_cst)
+    ReaderSlot& readerSlot = this->mReaderSlots[readerIndex];
+    readerSlot.mEpoch.store(this->mEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+
+    return this->mCurrent.load(std::memory_order_seq_cst);
+}
+
+void RuleSnapshotStore::Unpin(std::size_t readerIndex)
+{
+    assert(readerIndex < this->mMaxReaders);
+
+    this->mReaderSlots[readerIndex].mEpoch.store(0U, std::memory_order_release);
+}
+
+RuleSnapshotReader::~RuleSnapshotReader()
+{
+    if (this->mPinned)
+        this->Unpin();
+
+    if (this->mReaderIndex.has_value())
+        this->mStore.UnregisterReader(this->mReaderIndex.value());
+}
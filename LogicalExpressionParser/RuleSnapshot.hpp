@@ -0,0 +1,166 @@
+// LogicalExpressionParser
+// RuleSnapshot.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_RULE_SNAPSHOT_HPP
+#define LOGICAL_EXPRESSION_PARSER_RULE_SNAPSHOT_HPP
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Compiler.hpp"
+#include "Parser.hpp"
+
+class BaseAST;
+class Diagnostics;
+
+// \͂ƃRpCς܂KW̕sςȃXibvVbg
+// J͕ύXȂ̂, ǂݎ̓bNQƃJEg̑ɎQƂł
+class RuleSnapshot {
+public:
+    ~RuleSnapshot() = default;
+
+    RuleSnapshot(const RuleSnapshot&) = delete;
+    RuleSnapshot& operator=(const RuleSnapshot&) = delete;
+
+    // J1Uԍ
+    inline std::uint64_t Version() const { return this->mVersion; }
+    inline std::size_t RuleCount() const { return this->mRules.size(); }
+    inline const std::string& RuleText(std::size_t index) const { return this->mRules[index]->mText; }
+    inline const std::shared_ptr<BaseAST>& RuleAST(std::size_t index) const { return this->mRules[index]->mAST; }
+    inline ProgramView Rule(std::size_t index) const { return this->mRules[index]->mProgram->View(); }
+    inline const SymbolTable& Symbols() const { return *this->mSymbolTable; }
+    // 蓖ĂɕKv64rbgPʂ̌ꐔ
+    inline std::size_t AssignmentWordCount() const { return this->mSymbolTable->Size() / 64U + 1U; }
+
+    // _̋K΍ŏ̋K̔ԍԂ
+    std::optional<std::uint32_t> FindRule(std::string_view logicalExpr) const;
+
+private:
+    friend class RuleSnapshotStore;
+
+    // ύXȂK͑ÕXibvVbgƋL
+    struct CompiledRule {
+        std::string                 mText;
+        std::shared_ptr<BaseAST>    mAST;
+        std::shared_ptr<Program>    mProgram;
+    };
+
+    RuleSnapshot() : mVersion(0U) { }
+
+    std::uint64_t mVersion;
+    std::vector<std::shared_ptr<const CompiledRule>> mRules;
+    // K̘_ (CompiledRule::mTextw) K̔ԍ
+    std::unordered_map<std::string_view, std::uint32_t> mRuleIndices;
+    // ϐȂΑÕXibvVbgƋL (ϐԍ͒ǉ݂̂ŕςȂ)
+    std::shared_ptr<const SymbolTable> mSymbolTable;
+};
+
+/*
+KW̃XibvVbgRCU̕ōւ
+͐VXibvVbg (_ςK݂̂\͂ăRpC) |C^ւ,
+ÂXibvVbg̓G|bNtđޔ, ÕG|bNŎQƂn߂ǂݎ肪SėĂ
+ǂݎ͎̘g (LbVC𕪂Ă) Ɍ݂̃G|bNł|C^ǂނ̂,
+LLbVCɂ͏܂, bNQƃJEggȂ
+ǂݎ1̃Xbhg, QƂI (ႦΗṽob`Ƃ) Unpin
+ */
+class RuleSnapshotStore {
+public:
+    static constexpr std::size_t DefaultMaxReaders = 64U;
+
+    RuleSnapshotStore(std::size_t maxReaders = DefaultMaxReaders);
+    ~RuleSnapshotStore();
+
+    RuleSnapshotStore(const RuleSnapshotStore&) = delete;
+    RuleSnapshotStore& operator=(const RuleSnapshotStore&) = delete;
+
+    // OPublishŎsK̔ԍ
+    inline std::size_t FailedRule() const { return this->mFailedRule; }
+    // OPublishō\͂K̐
+    inline std::size_t ParsedRuleCount() const { return this->mParsedRuleCount; }
+    // ҂ĂXibvVbg̐, ܂łɉXibvVbg̐
+    std::size_t RetiredCount();
+    inline std::uint64_t ReclaimedCount() const { return this->mReclaimedCount.load(std::memory_order_relaxed); }
+
+    // ςK̍\͂ŎZ (KƂReset)
+    void SetGovernor(ResourceGovernor* governor);
+
+    // KWuČJXibvVbg̔łԂ
+    // 1ł\͂RpCɎsK, Jstd::nulloptԂ
+    std::optional<std::uint64_t> Publish(const std::vector<std::string>& logicalExprs, Diagnostics* diagnostics = nullptr);
+    // SĂ̓ǂݎ肪ꂽÂXibvVbg, Ԃ (PublishĂ)
+    std::size_t Reclaim();
+
+    // ǂݎ̘gmۂ (󂫂std::nullopt)
+    std::optional<std::size_t> RegisterReader();
+    void UnregisterReader(std::size_t readerIndex);
+
+    // Unpin܂ŕԂXibvVbg͉Ȃ (qɂ͂łȂ)
+    const RuleSnapshot* Pin(std::size_t readerIndex);
+    void Unpin(std::size_t readerIndex);
+
+private:
+    // 0͎QƂĂȂƂ\
+    struct alignas(64) ReaderSlot {
+        std::atomic<std::uint64_t>  mEpoch;
+        std::atomic<bool>           mInUse;
+    };
+
+    struct RetiredSnapshot {
+        std::unique_ptr<const RuleSnapshot> mSnapshot;
+        std::uint64_t                       mEpoch;
+    };
+
+    std::size_t ReclaimLocked();
+
+    std::size_t mMaxReaders;
+    std::unique_ptr<ReaderSlot[]> mReaderSlots;
+    std::atomic<const RuleSnapshot*> mCurrent;
+    std::atomic<std::uint64_t> mEpoch;
+    std::atomic<std::uint64_t> mReclaimedCount;
+
+    // 蓯m͔rIɌJ
+    std::mutex mWriterMutex;
+    std::vector<RetiredSnapshot> mRetired;
+    ParserSession mParserSession;
+    ResourceGovernor* mGovernor;
+    std::size_t mFailedRule;
+    std::size_t mParsedRuleCount;
+};
+
+// 1̃XbhŎgǂݎ (g̊mۂƉ󂯎)
+class RuleSnapshotReader {
+public:
+    RuleSnapshotReader(RuleSnapshotStore& store) :
+        mStore(store), mReaderIndex(store.RegisterReader()), mPinned(false) { }
+    ~RuleSnapshotReader();
+
+    RuleSnapshotReader(const RuleSnapshotReader&) = delete;
+    RuleSnapshotReader& operator=(const RuleSnapshotReader&) = delete;
+
+    // g̋󂫂ꍇfalse
+    inline bool IsRegistered() const { return this->mReaderIndex.has_value(); }
+
+    inline const RuleSnapshot* Pin() {
+        assert(this->IsRegistered() && !this->mPinned);
+        this->mPinned = true; return this->mStore.Pin(this->mReaderIndex.value()); }
+    inline void Unpin() {
+        assert(this->mPinned);
+        this->mPinned = false; this->mStore.Unpin(this->mReaderIndex.value()); }
+
+private:
+    RuleSnapshotStore& mStore;
+    std::optional<std::size_t> mReaderIndex;
+    bool mPinned;
+};
+
+#endif // LOGICAL_EXPRESSION_PARSER_RULE_SNAPSHOT_HPP
@@ -3,15 +3,36 @@
 // Token.cpp
 
 #include "Token.hpp"
+#include "LatencyTracing.hpp"
+#include "PerformanceCounters.hpp"
+#include "ResourceGovernor.hpp"
 
-Token::Token(const std::string& text, TokenType tokenType) :
+#include <limits>
+
+static inline std::optional<bool> TokenValue(TokenType tokenType)
+{
+    return tokenType == TokenType::True ? std::optional<bool>{ true } :
+           tokenType == TokenType::False ? std::optional<bool>{ false } :
+           std::nullopt;
+}
+
+Token::Token(const std::string& text, TokenType tokenType, std::size_t offset) :
     mText(text),
     mType(tokenType),
-    mValue(
-        tokenType == TokenType::True ? std::optional<bool>{ true } : 
-        tokenType == TokenType::False ? std::optional<bool>{ false } :
-        std::nullopt)
+    mOffset(offset),
+    mValue(TokenValue(tokenType))
+{
+    PerformanceCounters::Add(PerformanceCounter::TokensLexed);
+}
+
+void Token::Assign(std::string_view text, TokenType tokenType, std::size_t offset)
 {
+    this->mText.assign(text.data(), text.size());
+    this->mType = tokenType;
+    this->mOffset = offset;
+    this->mValue = TokenValue(tokenType);
+
+    PerformanceCounters::Add(PerformanceCounter::TokensLexed);
 }
 
 std::ostream& operator<<(std::ostream& os, const Token& token)
@@ -20,14 +41,56 @@ std::ostream& operator<<(std::ostream& os, const Token& token)
     return os;
 }
 
+TokenStream::TokenStream(const std::shared_ptr<StreamLexer>& streamLexer) :
+    mTokenCount(0U),
+    mCurrentIndex(0U),
+    mStreamLexer(streamLexer)
+{
+    assert(streamLexer != nullptr);
+
+    // ŏ̃g[N, ̎̃g[Nǂ݂Ă
+    this->mCurrentToken = this->mStreamLexer->NextToken();
+    this->mNextToken = (this->mCurrentToken != nullptr) ? this->mStreamLexer->NextToken() : nullptr;
+}
+
 const std::shared_ptr<Token> TokenStream::CurrentToken() const
 {
-    return (this->mCurrentIndex >= this->mTokens.size()) ? nullptr : this->mTokens[this->mCurrentIndex];
+    if (this->IsStreaming())
+        return this->mCurrentToken;
+
+    return (this->mCurrentIndex >= this->mTokenCount) ? nullptr : this->mTokens[this->mCurrentIndex];
+}
+
+std::size_t TokenStream::EndOffset() const
+{
+    // ̖͂̈ʒu (Ō̃g[N̒)
+    if (this->IsStreaming())
+        return this->mStreamLexer->ConsumedBytes();
+
+    if (this->mTokenCount == 0U)
+        return 0U;
+
+    const std::shared_ptr<Token>& lastToken = this->mTokens[this->mTokenCount - 1U];
+
+    return lastToken->Offset() + lastToken->Text().size();
 }
 
 bool TokenStream::MoveNext()
 {
-    std::size_t tokenSize = this->mTokens.size();
+    if (this->IsStreaming()) {
+        // ͍ς݂̃g[N͕ێɔj
+        this->mCurrentToken = std::move(this->mNextToken);
+
+        if (this->mCurrentToken == nullptr)
+            return false;
+
+        this->mNextToken = this->mStreamLexer->NextToken();
+        ++this->mCurrentIndex;
+
+        return true;
+    }
+
+    std::size_t tokenSize = this->mTokenCount;
 
     if (this->mCurrentIndex >= tokenSize - 1) {
         this->mCurrentIndex = tokenSize;
@@ -46,7 +109,11 @@ bool TokenStream::MovePrevious()
 
 bool TokenStream::MoveBack(std::size_t times)
 {
-    std::size_t tokenSize = this->mTokens.size();
+    // Xg[~O͔jg[Nɖ߂邱Ƃ͂łȂ
+    if (this->IsStreaming())
+        return false;
+
+    std::size_t tokenSize = this->mTokenCount;
 
     // ȏOɃCfbNX߂ƂłȂ
     if (times > tokenSize || times > this->mCurrentIndex) {
@@ -61,47 +128,148 @@ bool TokenStream::MoveBack(std::size_t times)
 
 void TokenStream::AddToken(Token* newToken)
 {
-    this->mTokens.push_back(std::shared_ptr<Token>(newToken));
+    assert(!this->IsStreaming());
+
+    if (this->mTokenCount < this->mTokens.size())
+        this->mTokens[this->mTokenCount].reset(newToken);
+    else
+        this->mTokens.push_back(std::shared_ptr<Token>(newToken));
+
+    ++this->mTokenCount;
+}
+
+void TokenStream::AddToken(std::string_view text, TokenType tokenType, std::size_t offset)
+{
+    assert(!this->IsStreaming());
+
+    // O̎͂Ŋmۂg[NQƂĂȂ΍ėp
+    if (this->mTokenCount < this->mTokens.size() && this->mTokens[this->mTokenCount].use_count() == 1) {
+        this->mTokens[this->mTokenCount]->Assign(text, tokenType, offset);
+        ++this->mTokenCount;
+        return;
+    }
+
+    this->AddToken(new Token(std::string(text), tokenType, offset));
 }
 
-void TokenStream::PrintTokens() const
+void TokenStream::Clear()
+{
+    assert(!this->IsStreaming());
+
+    this->mTokenCount = 0U;
+    this->mCurrentIndex = 0U;
+}
+
+void TokenStream::Resize(std::size_t tokenCount)
+{
+    assert(!this->IsStreaming());
+
+    if (this->mTokens.size() < tokenCount)
+        this->mTokens.resize(tokenCount);
+
+    this->mTokenCount = tokenCount;
+    this->mCurrentIndex = 0U;
+}
+
+void TokenStream::SetToken(std::size_t index, std::string_view text, TokenType tokenType, std::size_t offset)
+{
+    assert(!this->IsStreaming());
+    assert(index < this->mTokenCount);
+
+    std::shared_ptr<Token>& token = this->mTokens[index];
+
+    // AddTokenƓ, QƂĂȂg[N͍ėp
+    if (token != nullptr && token.use_count() == 1)
+        token->Assign(text, tokenType, offset);
+    else
+        token.reset(new Token(std::string(text), tokenType, offset));
+}
+
+void TokenStream::PrintTokens(std::ostream& os) const
 {
     std::ostringstream strStream;
 
-    for (const auto& token : this->mTokens)
-        strStream << *token;
+    for (std::size_t i = 0; i < this->mTokenCount; ++i)
+        strStream << *this->mTokens[i];
 
-    std::cout << strStream.str() << '\n';
+    os << strStream.str() << '\n';
 }
 
-enum class LexerState {
-    None,
-    Identifier,
-    Eq
-};
+TokenType IdentifierTokenType(std::string_view tokenText)
+{
+    if (tokenText == "True" || tokenText == "true" || tokenText == "T" || tokenText == "t") {
+        // ^ (True, true, T, t̂ꂩ)
+        return TokenType::True;
+    } else if (tokenText == "False" || tokenText == "false" || tokenText == "F" || tokenText == "f") {
+        // U (False, false, F, f̂ꂩ)
+        return TokenType::False;
+    } else if (tokenText == "And" || tokenText == "and") {
+        //  (And, and̂ꂩ)
+        return TokenType::And;
+    } else if (tokenText == "Or" || tokenText == "or") {
+        // ܂ (Or, or̂ꂩ)
+        return TokenType::Or;
+    } else if (tokenText == "Not" || tokenText == "not") {
+        //  (Not, not̂ꂩ)
+        return TokenType::Not;
+    } else if (tokenText == "Xor" || tokenText == "xor") {
+        // rI_a (Xor, xor̂ꂩ)
+        return TokenType::Xor;
+    } else if (tokenText == "Xnor" || tokenText == "xnor") {
+        // rI_a̔ے (Xnor, xnor̂ꂩ)
+        return TokenType::Xnor;
+    } else if (tokenText == "Nand" || tokenText == "nand") {
+        // ے_ (Nand, nand̂ꂩ)
+        return TokenType::Nand;
+    } else if (tokenText == "Nor" || tokenText == "nor") {
+        // ے_a (Nor, nor̂ꂩ)
+        return TokenType::Nor;
+    }
 
-std::shared_ptr<TokenStream> Lexer(std::string& logicalExpr)
+    // ȊȌꍇ͑Sĕϐ(ύ)Ƃ݂Ȃ
+    return TokenType::Variable;
+}
+
+static inline void ReportError(Diagnostics* diagnostics, DiagnosticCode code,
+                               std::size_t offset, std::size_t tokenIndex, char character = '\0')
 {
-    TokenStream* tokenStream = new(std::nothrow) TokenStream();
+    if (diagnostics != nullptr)
+        diagnostics->Report(code, offset, tokenIndex, 0U, character);
+}
 
-    if (tokenStream == nullptr) {
-        std::cout << "Failed to create TokenStream object.\n";
-        return nullptr;
+bool Lexer(const std::string& logicalExpr, TokenStream& tokenStream, Diagnostics* diagnostics, ResourceGovernor* governor)
+{
+    ScopedPhaseTimer phaseTimer(Phase::Lex);
+
+    tokenStream.Clear();
+
+    // ͂̑傫͎͂̑Oɒ, g[Ň1Ƃɔׂ邾ɂčŌɂ܂Ƃ߂ĉZ
+    std::size_t maxTokenCount = std::numeric_limits<std::size_t>::max();
+
+    if (governor != nullptr) {
+        if (!governor->CheckInputBytes(logicalExpr.size())) {
+            ReportError(diagnostics, DiagnosticCode::InputTooLarge, governor->Limits().mMaxInputBytes, 0U);
+            return false;
+        }
+
+        maxTokenCount = (governor->TokenCount() < governor->Limits().mMaxTokens) ?
+            governor->Limits().mMaxTokens - governor->TokenCount() : 0U;
     }
 
     LexerState state = LexerState::None;
 
-    std::string tokenText;
+    std::size_t tokenBegin = 0U;
     char currentChar;
     char nextChar;
 
-    logicalExpr += ' ';
-
+    // ̖͂ɂ͋؂̋󔒂1̂ƂĈ (͂̕͏Ȃ)
     std::size_t inputSize = logicalExpr.size();
+    auto charAt = [&logicalExpr, inputSize](std::size_t index) {
+        return (index < inputSize) ? logicalExpr[index] : (index == inputSize) ? ' ' : '\0'; };
 
-    for (size_t i = 0; i < inputSize; ++i) {
-        currentChar = logicalExpr[i];
-        nextChar = (i + 1) < inputSize ? logicalExpr[i + 1] : '\0';
+    for (size_t i = 0; i <= inputSize; ++i) {
+        currentChar = charAt(i);
+        nextChar = charAt(i + 1);
 
         switch (state) {
             case LexerState::None:
@@ -111,18 +279,19 @@ std::shared_ptr<TokenStream> Lexer(std::string& logicalExpr)
                 } else if (std::isalpha(currentChar) || currentChar == '_') {
                     // At@xbg܂̓A_[o[ŊJn鎯ʎq
                     state = LexerState::Identifier;
+                    tokenBegin = i;
 
                     // ݂̕ɂĂxʂ
                     --i;
                 } else if (currentChar == '(') {
                     // ۊ
-                    tokenStream->AddToken(new Token("(", TokenType::LeftParenthesis));
+                    tokenStream.AddToken("(", TokenType::LeftParenthesis, i);
                 } else if (currentChar == ')') {
                     // Eۊ
-                    tokenStream->AddToken(new Token(")", TokenType::RightParenthesis));
+                    tokenStream.AddToken(")", TokenType::RightParenthesis, i);
                 } else if (currentChar == '-' && nextChar == '>') {
                     // Ȃ('->')̋L
-                    tokenStream->AddToken(new Token("->", TokenType::Then));
+                    tokenStream.AddToken("->", TokenType::Then, i);
 
                     // ̕ɂĂς񂾂̂, CfbNX1ɐi߂
                     ++i;
@@ -131,39 +300,21 @@ std::shared_ptr<TokenStream> Lexer(std::string& logicalExpr)
                     state = LexerState::Eq;
                 } else {
                     // ȊȌ̕ꍇ̓G[
-                    std::cout << "Invalid character: \'" << currentChar << "\'\n";
-                    return nullptr;
+                    ReportError(diagnostics, DiagnosticCode::InvalidCharacter, i, tokenStream.TokenCount(), currentChar);
+                    return false;
                 }
                 break;
             case LexerState::Identifier:
                 if (std::isalnum(currentChar) || currentChar == '_') {
-                    // At@xbg, , A_[o[łƂ͎ʎqɒǉ
-                    tokenText += currentChar;
+                    // At@xbg, , A_[o[łƂ͎ʎq
+                    continue;
                 } else {
                     // At@xbg, , A_[o[łƂ, ʎq̏I
 
                     // ʎqɑ邩𒲂, g[N쐬Ēǉ
-                    if (tokenText == "True" || tokenText == "true" || tokenText == "T" || tokenText == "t") {
-                        // ^ (True, true, T, t̂ꂩ)
-                        tokenStream->AddToken(new Token(tokenText, TokenType::True));
-                    } else if (tokenText == "False" || tokenText == "false" || tokenText == "F" || tokenText == "f") {
-                        // U (False, false, F, f̂ꂩ)
-                        tokenStream->AddToken(new Token(tokenText, TokenType::False));
-                    } else if (tokenText == "And" || tokenText == "and") {
-                        //  (And, and̂ꂩ)
-                        tokenStream->AddToken(new Token(tokenText, TokenType::And));
-                    } else if (tokenText == "Or" || tokenText == "or") {
-                        // ܂ (Or, or̂ꂩ)
-                        tokenStream->AddToken(new Token(tokenText, TokenType::Or));
-                    } else if (tokenText == "Not" || tokenText == "not") {
-                        //  (Not, not̂ꂩ)
-                        tokenStream->AddToken(new Token(tokenText, TokenType::Not));
-                    } else {
-                        // ȊȌꍇ͑Sĕϐ(ύ)Ƃ݂Ȃ
-                        tokenStream->AddToken(new Token(tokenText, TokenType::Variable));
-                    }
-
-                    tokenText = "";
+                    std::string_view tokenText(logicalExpr.data() + tokenBegin, i - tokenBegin);
+                    tokenStream.AddToken(tokenText, IdentifierTokenType(tokenText), tokenBegin);
+
                     state = LexerState::None;
 
                     // ʎqł͂Ȃ݂̕ɂĂxʂ
@@ -173,9 +324,8 @@ std::shared_ptr<TokenStream> Lexer(std::string& logicalExpr)
             case LexerState::Eq:
                 if (currentChar == '-' && nextChar == '>') {
                     // l('<->')̋L̍ŏ1ɂĂ͏ςł̂, c2mF
-                    tokenStream->AddToken(new Token("<->", TokenType::Eq));
+                    tokenStream.AddToken("<->", TokenType::Eq, i - 1);
 
-                    tokenText = "";
                     state = LexerState::None;
 
                     // ̕ɂĂς񂾂̂, CfbNX1ɐi߂
@@ -183,23 +333,213 @@ std::shared_ptr<TokenStream> Lexer(std::string& logicalExpr)
                 } else {
                     // l('<->')̋Lł͂Ȃ̂ŃG[Ԃ
                     if (currentChar != '-')
-                        std::cout << "Invalid character: \'" << currentChar << "\'\n";
+                        ReportError(diagnostics, DiagnosticCode::InvalidCharacter, i, tokenStream.TokenCount(), currentChar);
+                    else
+                        ReportError(diagnostics, DiagnosticCode::InvalidCharacter, i + 1, tokenStream.TokenCount(), nextChar);
 
-                    if (nextChar != '>')
-                        std::cout << "Invalid character: \'" << nextChar << "\'\n";
+                    return false;
+                }
+                break;
+            default:
+                // ͂L蓾ȂԂɂ̂ŃG[Ԃ
+                ReportError(diagnostics, DiagnosticCode::InternalError, i, tokenStream.TokenCount());
+                return false;
+        }
+
+        if (tokenStream.TokenCount() > maxTokenCount) {
+            governor->ChargeTokens(tokenStream.TokenCount());
+            ReportError(diagnostics, DiagnosticCode::TooManyTokens, i, tokenStream.TokenCount());
+            return false;
+        }
+    }
 
+    // Ōɖ\ʂȃg[Nǉ
+    // tokenStream.AddToken("", TokenType::End, inputSize);
+
+    if (governor != nullptr)
+        governor->ChargeTokens(tokenStream.TokenCount());
+
+    return true;
+}
+
+std::shared_ptr<TokenStream> Lexer(const std::string& logicalExpr, Diagnostics* diagnostics, ResourceGovernor* governor)
+{
+    // G[œrŔꍇɂ悤ɂ
+    std::shared_ptr<TokenStream> tokenStream(new(std::nothrow) TokenStream());
+
+    if (tokenStream == nullptr) {
+        ReportError(diagnostics, DiagnosticCode::OutOfMemory, 0U, 0U);
+        return nullptr;
+    }
+
+    if (!Lexer(logicalExpr, *tokenStream, diagnostics, governor))
+        return nullptr;
+
+    return tokenStream;
+}
+
+//
+// StreamLexerNX
+//
+
+StreamLexer::StreamLexer(std::istream& inputStream, std::size_t chunkSize, Diagnostics* diagnostics) :
+    mInputStream(inputStream),
+    mDiagnostics(diagnostics),
+    mGovernor(nullptr),
+    mBuffer(chunkSize > 0U ? chunkSize : 1U),
+    mBufferPosition(0U),
+    mBufferSize(0U),
+    mConsumedBytes(0U),
+    mState(LexerState::None),
+    mTokenCount(0U),
+    mTokenOffset(0U),
+    mEndOfInput(false),
+    mError(false)
+{
+}
+
+bool StreamLexer::FillBuffer()
+{
+    if (this->mEndOfInput)
+        return false;
+
+    // ͂Œ蒷̃`NƂɓǂݍ (obt@͎g)
+    this->mInputStream.read(this->mBuffer.data(), static_cast<std::streamsize>(this->mBuffer.size()));
+    this->mBufferSize = static_cast<std::size_t>(this->mInputStream.gcount());
+    this->mBufferPosition = 0U;
+
+    if (this->mBufferSize == 0U) {
+        this->mEndOfInput = true;
+        return false;
+    }
+
+    // 𒴂镔͎͂ɑł؂
+    if (this->mGovernor != nullptr && !this->mGovernor->CheckInputBytes(this->mConsumedBytes + this->mBufferSize)) {
+        this->mConsumedBytes = this->mGovernor->Limits().mMaxInputBytes;
+        this->ReportError(DiagnosticCode::InputTooLarge, '\0');
+        return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<Token> StreamLexer::NextToken()
+{
+    if (this->mError)
+        return nullptr;
+
+    while (true) {
+        if (this->mBufferPosition >= this->mBufferSize && !this->FillBuffer()) {
+            if (this->mError)
+                return nullptr;
+
+            // ̖͂ɒB̂, r܂œǂ񂾃g[N
+            switch (this->mState) {
+                case LexerState::None:
                     return nullptr;
+                case LexerState::Identifier:
+                {
+                    std::shared_ptr<Token> token = this->MakeToken(this->mTokenText, IdentifierTokenType(this->mTokenText));
+                    this->mTokenText.clear();
+                    this->mState = LexerState::None;
+                    return token;
                 }
-                break;
+                default:
+                    // '->'܂'<->'̋LrŏIĂ
+                    this->ReportError(DiagnosticCode::UnexpectedEndOfInput, '\0');
+                    return nullptr;
+            }
+        }
+
+        // `N̋E܂ł(ǂ݂̎ʎqL)͕ێ
+        char currentChar = this->mBuffer[this->mBufferPosition];
+
+        switch (this->mState) {
+            case LexerState::None:
+                if (std::isspace(static_cast<unsigned char>(currentChar))) {
+                    // pXy[X̏ꍇ̓XLbv
+                    break;
+                } else if (std::isalpha(static_cast<unsigned char>(currentChar)) || currentChar == '_') {
+                    // ݂͎̕ʎq̈ꕔƂď
+                    this->mState = LexerState::Identifier;
+                    this->mTokenOffset = this->mConsumedBytes;
+                    continue;
+                } else if (currentChar == '(') {
+                    this->mTokenOffset = this->mConsumedBytes;
+                    this->Advance();
+                    return this->MakeToken("(", TokenType::LeftParenthesis);
+                } else if (currentChar == ')') {
+                    this->mTokenOffset = this->mConsumedBytes;
+                    this->Advance();
+                    return this->MakeToken(")", TokenType::RightParenthesis);
+                } else if (currentChar == '-') {
+                    this->mState = LexerState::Then;
+                    this->mTokenOffset = this->mConsumedBytes;
+                    break;
+                } else if (currentChar == '<') {
+                    this->mState = LexerState::Eq;
+                    this->mTokenOffset = this->mConsumedBytes;
+                    break;
+                }
+
+                this->ReportError(DiagnosticCode::InvalidCharacter, currentChar);
+                return nullptr;
+            case LexerState::Identifier:
+                if (std::isalnum(static_cast<unsigned char>(currentChar)) || currentChar == '_') {
+                    this->mTokenText += currentChar;
+                    break;
+                } else {
+                    // ʎq̏I (݂͎̃̕g[NƂď)
+                    std::shared_ptr<Token> token = this->MakeToken(this->mTokenText, IdentifierTokenType(this->mTokenText));
+                    this->mTokenText.clear();
+                    this->mState = LexerState::None;
+                    return token;
+                }
+            case LexerState::Then:
+            case LexerState::EqThen:
+                if (currentChar == '>') {
+                    bool isThen = (this->mState == LexerState::Then);
+                    this->mState = LexerState::None;
+                    this->Advance();
+                    return isThen ? this->MakeToken("->", TokenType::Then) : this->MakeToken("<->", TokenType::Eq);
+                }
+
+                this->ReportError(DiagnosticCode::InvalidCharacter, currentChar);
+                return nullptr;
+            case LexerState::Eq:
+                if (currentChar == '-') {
+                    this->mState = LexerState::EqThen;
+                    break;
+                }
+
+                this->ReportError(DiagnosticCode::InvalidCharacter, currentChar);
+                return nullptr;
             default:
                 // ͂L蓾ȂԂɂ̂ŃG[Ԃ
-                std::cout << "Illegal lexer state.\n";
+                this->ReportError(DiagnosticCode::InternalError, currentChar);
                 return nullptr;
         }
+
+        this->Advance();
+    }
+}
+
+std::shared_ptr<Token> StreamLexer::MakeToken(const std::string& text, TokenType tokenType)
+{
+    ++this->mTokenCount;
+
+    if (this->mGovernor != nullptr && !this->mGovernor->ChargeTokens(1U)) {
+        this->ReportError(DiagnosticCode::TooManyTokens, '\0');
+        return nullptr;
     }
 
-    // Ōɖ\ʂȃg[Nǉ
-    // tokenStream->AddToken(new Token("", TokenType::End));
+    return std::make_shared<Token>(text, tokenType, this->mTokenOffset);
+}
+
+void StreamLexer::ReportError(DiagnosticCode code, char character)
+{
+    this->mError = true;
 
-    return std::shared_ptr<TokenStream>(tokenStream);
+    if (this->mDiagnostics != nullptr)
+        this->mDiagnostics->Report(code, this->mConsumedBytes, this->mTokenCount, 0U, character);
 }
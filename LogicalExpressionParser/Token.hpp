@@ -15,8 +15,11 @@
 #include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "Diagnostics.hpp"
+
 enum class TokenType {
     True,
     False,
@@ -26,6 +29,10 @@ enum class TokenType {
     Not,
     Then,
     Eq,
+    Xor,
+    Xnor,
+    Nand,
+    Nor,
     LeftParenthesis,
     RightParenthesis,
     End
@@ -33,43 +40,122 @@ enum class TokenType {
 
 class Token {
 public:
-    Token(const std::string& text, TokenType tokenType);
+    Token(const std::string& text, TokenType tokenType, std::size_t offset = 0U);
     Token() = delete;
     ~Token() = default;
 
     inline const std::string& Text() const { return this->mText; }
     inline TokenType Type() const { return this->mType; }
+    inline std::size_t Offset() const { return this->mOffset; }
     inline bool HasValue() const { return this->mValue.has_value(); }
     inline bool Value() const { return this->mValue.value(); }
 
+    // mۍς݂̗̈̕ėpăg[N
+    void Assign(std::string_view text, TokenType tokenType, std::size_t offset);
+
     friend std::ostream& operator<<(std::ostream& os, const Token& token);
 
 private:
     std::string	            mText;
     TokenType               mType;
+    std::size_t             mOffset;
     std::optional<bool>     mValue;
 };
 
+class StreamLexer;
+class ResourceGovernor;
+
 class TokenStream {
 public:
-    TokenStream() : mCurrentIndex(0U) { }
+    TokenStream() : mTokenCount(0U), mCurrentIndex(0U) { }
+    TokenStream(const std::shared_ptr<StreamLexer>& streamLexer);
     ~TokenStream() = default;
 
-    inline bool HasMoreTokens() const { return this->mCurrentIndex < this->mTokens.size() - 1; }
-    inline void SetCurrentIndex(std::size_t index) { this->mCurrentIndex = index; }
+    inline bool IsStreaming() const { return this->mStreamLexer != nullptr; }
+    inline bool HasMoreTokens() const {
+        return this->IsStreaming() ? (this->mNextToken != nullptr) : (this->mCurrentIndex < this->mTokenCount - 1); }
+    inline void SetCurrentIndex(std::size_t index) { assert(!this->IsStreaming()); this->mCurrentIndex = index; }
+    inline std::size_t CurrentIndex() const { return this->mCurrentIndex; }
+    inline std::size_t TokenCount() const { return this->mTokenCount; }
+    inline const std::shared_ptr<Token>& TokenAt(std::size_t index) const { assert(!this->IsStreaming()); return this->mTokens[index]; }
 
     const std::shared_ptr<Token> CurrentToken() const;
+    std::size_t EndOffset() const;
     bool MoveNext();
     bool MovePrevious();
     bool MoveBack(std::size_t times);
     void AddToken(Token* newToken);
-    void PrintTokens() const;
+    void AddToken(std::string_view text, TokenType tokenType, std::size_t offset);
+    // g[NSĎ菜 (mۍς݂̃g[N͎̎͂ōėp)
+    void Clear();
+    // g[ŇtokenCountɂ, eʒũg[NSetTokenŏ
+    // قȂʒuւSetTokeñ͕Xbh瓯ɌĂяoĂ悢
+    void Resize(std::size_t tokenCount);
+    void SetToken(std::size_t index, std::string_view text, TokenType tokenType, std::size_t offset);
+    void PrintTokens(std::ostream& os = std::cout) const;
 
 private:
+    // 擪mTokenCount݂̃g[N, c͍ėp҂g[N
     std::vector<std::shared_ptr<Token>> mTokens;
+    std::size_t mTokenCount;
     std::size_t mCurrentIndex;
+
+    // Xg[~O݂͌̃g[NƐǂ݂1̃g[N݂̂ێ
+    std::shared_ptr<StreamLexer> mStreamLexer;
+    std::shared_ptr<Token> mCurrentToken;
+    std::shared_ptr<Token> mNextToken;
 };
 
-std::shared_ptr<TokenStream> Lexer(std::string& logicalExpr);
+enum class LexerState {
+    None,
+    Identifier,
+    Then,
+    Eq,
+    EqThen
+};
+
+class StreamLexer {
+public:
+    StreamLexer(std::istream& inputStream, std::size_t chunkSize = 4096U, Diagnostics* diagnostics = nullptr);
+    StreamLexer() = delete;
+    ~StreamLexer() = default;
+
+    inline bool HasError() const { return this->mError; }
+    inline std::size_t ConsumedBytes() const { return this->mConsumedBytes; }
+    // ǂݍ񂾃oCgƃg[ŇZ
+    inline void SetGovernor(ResourceGovernor* governor) { this->mGovernor = governor; }
+
+    std::shared_ptr<Token> NextToken();
+
+private:
+    bool FillBuffer();
+    std::shared_ptr<Token> MakeToken(const std::string& text, TokenType tokenType);
+    void ReportError(DiagnosticCode code, char character);
+    inline void Advance() { ++this->mBufferPosition; ++this->mConsumedBytes; }
+
+    std::istream&       mInputStream;
+    Diagnostics*        mDiagnostics;
+    ResourceGovernor*   mGovernor;
+    std::vector<char>   mBuffer;
+    std::size_t         mBufferPosition;
+    std::size_t         mBufferSize;
+    std::size_t         mConsumedBytes;
+    LexerState          mState;
+    std::string         mTokenText;
+    std::size_t         mTokenCount;
+    std::size_t         mTokenOffset;
+    bool                mEndOfInput;
+    bool                mError;
+};
+
+// ʎq̃g[N̎ (L[[hłȂΕϐ)
+TokenType IdentifierTokenType(std::string_view tokenText);
+
+// governorw肵ꍇ, ͂̃oCgƃg[Ň𒴂Ǝs
+std::shared_ptr<TokenStream> Lexer(const std::string& logicalExpr, Diagnostics* diagnostics = nullptr,
+                                   ResourceGovernor* governor = nullptr);
+// g[NɂĂ玚͂̌ʂǉ (g[Ng񂷏ꍇɗp)
+bool Lexer(const std::string& logicalExpr, TokenStream& tokenStream, Diagnostics* diagnostics = nullptr,
+           ResourceGovernor* governor = nullptr);
 
 #endif // LOGICAL_EXPRESSION_PARSER_TOKEN_HPP
@@ -0,0 +1,544 @@
+
+// LogicalExpressionParser
+// TruthTable.cpp
+
+#include "TruthTable.hpp"
+#include "AST.hpp"
+#include "ResourceGovernor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+static inline unsigned int CountTrailingZeros(std::uint64_t value)
+{
+    assert(value != 0U);
+
+    unsigned int count = 0U;
+
+    while ((value & 1U) == 0U) {
+        value >>= 1;
+        ++count;
+    }
+
+    return count;
+}
+
+static inline unsigned int PopulationCount(std::uint64_t value)
+{
+    unsigned int count = 0U;
+
+    for (; value != 0U; value &= value - 1U)
+        ++count;
+
+    return count;
+}
+
+template <typename T>
+static inline void WriteValue(std::ostream& os, T value)
+{
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void WriteVarint(std::vector<std::uint8_t>& data, std::uint64_t value)
+{
+    while (value >= 0x80U) {
+        data.push_back(static_cast<std::uint8_t>(value | 0x80U));
+        value >>= 7;
+    }
+
+    data.push_back(static_cast<std::uint8_t>(value));
+}
+
+static void WriteWord(std::vector<std::uint8_t>& data, std::uint64_t word)
+{
+    for (unsigned int i = 0; i < 8U; ++i)
+        data.push_back(static_cast<std::uint8_t>(word >> (i * 8U)));
+}
+
+static std::vector<std::uint8_t> CompressTruthTableBlock(const std::vector<std::uint64_t>& words)
+{
+    // ꂪ2ȏ㑱͌JԂ, ȊO͂̂܂ܕׂ
+    std::vector<std::uint8_t> data;
+    std::size_t i = 0;
+
+    while (i < words.size()) {
+        std::size_t runEnd = i + 1U;
+
+        while (runEnd < words.size() && words[runEnd] == words[i])
+            ++runEnd;
+
+        if (runEnd - i >= 2U) {
+            WriteVarint(data, (static_cast<std::uint64_t>(runEnd - i) << 1) | 1U);
+            WriteWord(data, words[i]);
+            i = runEnd;
+            continue;
+        }
+
+        std::size_t literalEnd = i + 1U;
+
+        while (literalEnd < words.size() &&
+               !(literalEnd + 1U < words.size() && words[literalEnd] == words[literalEnd + 1U]))
+            ++literalEnd;
+
+        WriteVarint(data, static_cast<std::uint64_t>(literalEnd - i) << 1);
+
+        for (; i < literalEnd; ++i)
+            WriteWord(data, words[i]);
+    }
+
+    return data;
+}
+
+bool DecompressTruthTableBlock(const std::uint8_t* data, std::size_t size, std::vector<std::uint64_t>& words)
+{
+    std::size_t position = 0U;
+
+    auto readWord = [&](std::uint64_t& word) {
+        if (size - position < 8U)
+            return false;
+
+        word = 0U;
+
+        for (unsigned int i = 0; i < 8U; ++i)
+            word |= static_cast<std::uint64_t>(data[position++]) << (i * 8U);
+
+        return true;
+    };
+
+    while (position < size) {
+        std::uint64_t header = 0U;
+        unsigned int shift = 0U;
+
+        do {
+            if (position >= size || shift > 63U)
+                return false;
+
+            header |= static_cast<std::uint64_t>(data[position] & 0x7FU) << shift;
+            shift += 7U;
+        } while (data[position++] & 0x80U);
+
+        std::uint64_t length = header >> 1;
+        std::uint64_t word = 0U;
+
+        if (header & 1U) {
+            if (!readWord(word))
+                return false;
+
+            words.insert(words.end(), static_cast<std::size_t>(length), word);
+        } else {
+            for (std::uint64_t i = 0; i < length; ++i) {
+                if (!readWord(word))
+                    return false;
+
+                words.push_back(word);
+            }
+        }
+    }
+
+    return true;
+}
+
+//
+// TruthTableEngineNX
+//
+
+TruthTableEngine::TruthTableEngine(const std::shared_ptr<BaseAST>& logicalExprAST, unsigned int threadCount) :
+    mThreadCount(threadCount != 0U ? threadCount : std::max(1U, std::thread::hardware_concurrency())),
+    mGovernor(nullptr)
+{
+    assert(logicalExprAST != nullptr);
+
+    this->AddNode(logicalExprAST.get());
+}
+
+std::uint32_t TruthTableEngine::AddNode(const BaseAST* exprAST)
+{
+    std::vector<std::uint32_t> children;
+    Node node { OpCode::False, NoParent, 0U, 0U };
+
+    switch (exprAST->Type()) {
+        case ASTType::Constant:
+            node.mOpCode = static_cast<const ConstantAST*>(exprAST)->Value() ? OpCode::True : OpCode::False;
+            break;
+        case ASTType::Variable:
+        {
+            // ϐ̐ߓ_łmFirstChildɕϐԍ
+            const std::string& name = static_cast<const VariableAST*>(exprAST)->Name();
+            auto iter = this->mVariableIndices.find(name);
+
+            if (iter == this->mVariableIndices.end()) {
+                iter = this->mVariableIndices.emplace(name, static_cast<std::uint32_t>(this->mVariableNames.size())).first;
+                this->mVariableNames.push_back(name);
+                this->mVariableLeaves.emplace_back();
+            }
+
+            node.mOpCode = OpCode::Variable;
+            node.mFirstChild = iter->second;
+            this->mVariableLeaves[iter->second].push_back(static_cast<std::uint32_t>(this->mNodes.size()));
+            this->mNodes.push_back(node);
+
+            return static_cast<std::uint32_t>(this->mNodes.size() - 1U);
+        }
+        case ASTType::Factor:
+            // ʂ͐ߓ_Ȃ
+            return this->AddNode(static_cast<const FactorAST*>(exprAST)->Expr().get());
+        case ASTType::NotExpression:
+            node.mOpCode = OpCode::Not;
+            children.push_back(this->AddNode(static_cast<const NotExpressionAST*>(exprAST)->Expr().get()));
+            break;
+        case ASTType::AndOrExpression:
+        {
+            const AndOrExpressionAST* andOrExprAST = static_cast<const AndOrExpressionAST*>(exprAST);
+            node.mOpCode = (andOrExprAST->Operator() == "") ? OpCode::And : OpCode::Or;
+
+            for (const auto& operand : andOrExprAST->Operands())
+                children.push_back(this->AddNode(operand.get()));
+
+            break;
+        }
+        case ASTType::Expression:
+        {
+            const ExpressionAST* thenEqExprAST = static_cast<const ExpressionAST*>(exprAST);
+            node.mOpCode = (thenEqExprAST->Operator() == "->") ? OpCode::Then : OpCode::Eq;
+            children.push_back(this->AddNode(thenEqExprAST->Left().get()));
+            children.push_back(this->AddNode(thenEqExprAST->Right().get()));
+            break;
+        }
+        case ASTType::XorExpression:
+        {
+            const XorExpressionAST* xorExprAST = static_cast<const XorExpressionAST*>(exprAST);
+            node.mOpCode = (xorExprAST->Operator() == "") ? OpCode::Xor : OpCode::Xnor;
+            children.push_back(this->AddNode(xorExprAST->Left().get()));
+            children.push_back(this->AddNode(xorExprAST->Right().get()));
+            break;
+        }
+        case ASTType::NandNorExpression:
+        {
+            const NandNorExpressionAST* nandNorExprAST = static_cast<const NandNorExpressionAST*>(exprAST);
+            node.mOpCode = (nandNorExprAST->Operator() == "") ? OpCode::Nand : OpCode::Nor;
+            children.push_back(this->AddNode(nandNorExprAST->Left().get()));
+            children.push_back(this->AddNode(nandNorExprAST->Right().get()));
+            break;
+        }
+        default:
+            break;
+    }
+
+    std::uint32_t nodeIndex = static_cast<std::uint32_t>(this->mNodes.size());
+    node.mFirstChild = static_cast<std::uint32_t>(this->mChildren.size());
+    node.mChildCount = static_cast<std::uint32_t>(children.size());
+
+    for (std::uint32_t child : children) {
+        this->mNodes[child].mParent = nodeIndex;
+        this->mChildren.push_back(child);
+    }
+
+    this->mNodes.push_back(node);
+
+    return nodeIndex;
+}
+
+bool TruthTableEngine::ComputeNode(const EvaluationState& state, std::uint32_t nodeIndex) const
+{
+    const Node& node = this->mNodes[nodeIndex];
+    const std::uint32_t* children = this->mChildren.data() + node.mFirstChild;
+
+    switch (node.mOpCode) {
+        case OpCode::False:
+            return false;
+        case OpCode::True:
+            return true;
+        case OpCode::Variable:
+            return state.mValues[nodeIndex] != 0U;
+        case OpCode::Not:
+            return state.mValues[children[0]] == 0U;
+        case OpCode::And:
+            return state.mTrueCounts[nodeIndex] == node.mChildCount;
+        case OpCode::Or:
+            return state.mTrueCounts[nodeIndex] != 0U;
+        case OpCode::Then:
+            return state.mValues[children[0]] == 0U || state.mValues[children[1]] != 0U;
+        case OpCode::Eq:
+        case OpCode::Xnor:
+            return state.mValues[children[0]] == state.mValues[children[1]];
+        case OpCode::Xor:
+            return state.mValues[children[0]] != state.mValues[children[1]];
+        case OpCode::Nand:
+            return state.mValues[children[0]] == 0U || state.mValues[children[1]] == 0U;
+        case OpCode::Nor:
+            return state.mValues[children[0]] == 0U && state.mValues[children[1]] == 0U;
+    }
+
+    return false;
+}
+
+void TruthTableEngine::EvaluateAll(EvaluationState& state, std::uint64_t assignment) const
+{
+    // Ԃ̐擪ł͑SĂ̐ߓ_]
+    state.mValues.resize(this->mNodes.size());
+    state.mTrueCounts.resize(this->mNodes.size());
+
+    for (std::uint32_t i = 0; i < this->mNodes.size(); ++i) {
+        const Node& node = this->mNodes[i];
+
+        if (node.mOpCode == OpCode::Variable) {
+            state.mValues[i] = static_cast<std::uint8_t>((assignment >> node.mFirstChild) & 1U);
+            continue;
+        }
+
+        if (node.mOpCode == OpCode::And || node.mOpCode == OpCode::Or) {
+            std::uint32_t trueCount = 0U;
+
+            for (std::uint32_t j = 0; j < node.mChildCount; ++j)
+                trueCount += state.mValues[this->mChildren[node.mFirstChild + j]];
+
+            state.mTrueCounts[i] = trueCount;
+        }
+
+        state.mValues[i] = this->ComputeNode(state, i) ? 1U : 0U;
+    }
+}
+
+void TruthTableEngine::FlipVariable(EvaluationState& state, std::uint32_t variable) const
+{
+    for (std::uint32_t leaf : this->mVariableLeaves[variable]) {
+        state.mValues[leaf] ^= 1U;
+
+        // lςߓ_̐ê݂ČvZ, e̒lςȂ΂Ŏ~߂
+        for (std::uint32_t nodeIndex = leaf; this->mNodes[nodeIndex].mParent != NoParent; ) {
+            std::uint32_t parentIndex = this->mNodes[nodeIndex].mParent;
+            OpCode parentOpCode = this->mNodes[parentIndex].mOpCode;
+
+            if (parentOpCode == OpCode::And || parentOpCode == OpCode::Or) {
+                if (state.mValues[nodeIndex] != 0U)
+                    ++state.mTrueCounts[parentIndex];
+                else
+                    --state.mTrueCounts[parentIndex];
+            }
+
+            std::uint8_t parentValue = this->ComputeNode(state, parentIndex) ? 1U : 0U;
+
+            if (parentValue == state.mValues[parentIndex])
+                break;
+
+            state.mValues[parentIndex] = parentValue;
+            nodeIndex = parentIndex;
+        }
+    }
+}
+
+unsigned int TruthTableEngine::SliceBits() const
+{
+    // Xbh8{ȏ̋Ԃɕ, 1̋Ԃ͍X2^24̊蓖Ăɗ}
+    unsigned int variableCount = static_cast<unsigned int>(this->mVariableNames.size());
+    unsigned int sliceBits = 0U;
+
+    while (sliceBits < variableCount && (static_cast<std::uint64_t>(1U) << sliceBits) < this->mThreadCount * 8ULL)
+        ++sliceBits;
+
+    return std::max(sliceBits, variableCount > 24U ? variableCount - 24U : 0U);
+}
+
+template <typename Visitor>
+bool TruthTableEngine::WalkSlice(EvaluationState& state, std::uint64_t slice, unsigned int lowBits, Visitor&& visitor) const
+{
+    std::uint64_t baseAssignment = slice << lowBits;
+    std::uint64_t stepCount = static_cast<std::uint64_t>(1U) << lowBits;
+    std::uint32_t rootIndex = static_cast<std::uint32_t>(this->mNodes.size() - 1U);
+
+    this->EvaluateAll(state, baseAssignment);
+
+    if (!visitor(baseAssignment, state.mValues[rootIndex] != 0U))
+        return false;
+
+    for (std::uint64_t step = 1; step < stepCount; ++step) {
+        // OCR[hł̓Xebvԍ̍ŉʂ1̃rbgɑΉϐ݂̂ς
+        this->FlipVariable(state, CountTrailingZeros(step));
+
+        if (!visitor(baseAssignment | (step ^ (step >> 1)), state.mValues[rootIndex] != 0U))
+            return false;
+    }
+
+    return true;
+}
+
+void TruthTableEngine::RunSlices(const std::function<bool(std::uint64_t, EvaluationState&)>& sliceFunction) const
+{
+    std::uint64_t sliceCount = static_cast<std::uint64_t>(1U) << this->SliceBits();
+    std::atomic<std::uint64_t> nextSlice { 0U };
+    std::atomic<bool> stopped { false };
+
+    // Ԃ͔ԍ̏Ɏô, o҂̋Ԃ̓XbhxɎ܂
+    auto worker = [&]() {
+        EvaluationState state;
+
+        while (!stopped.load(std::memory_order_relaxed)) {
+            std::uint64_t slice = nextSlice.fetch_add(1U, std::memory_order_relaxed);
+
+            if (slice >= sliceCount)
+                break;
+
+            if (!sliceFunction(slice, state))
+                stopped.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    unsigned int threadCount = static_cast<unsigned int>(std::min<std::uint64_t>(this->mThreadCount, sliceCount));
+    std::vector<std::thread> threads;
+
+    for (unsigned int i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+
+    worker();
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+bool TruthTableEngine::ChargeAssignments() const
+{
+    return this->mGovernor == nullptr ||
+        this->mGovernor->ChargeSteps(static_cast<std::uint64_t>(1U) << this->mVariableNames.size());
+}
+
+std::optional<VariableAssignment> TruthTableEngine::FindCounterexample(bool expectedValue) const
+{
+    if (!this->IsValid() || !this->ChargeAssignments())
+        return std::nullopt;
+
+    unsigned int lowBits = static_cast<unsigned int>(this->mVariableNames.size()) - this->SliceBits();
+    std::atomic<bool> found { false };
+    std::mutex counterexampleMutex;
+    std::optional<std::uint64_t> counterexample;
+
+    this->RunSlices([&](std::uint64_t slice, EvaluationState& state) {
+        std::uint64_t stepCount = 0U;
+
+        return this->WalkSlice(state, slice, lowBits, [&](std::uint64_t assignment, bool value) {
+            if (value != expectedValue) {
+                std::lock_guard<std::mutex> lock(counterexampleMutex);
+
+                if (!counterexample.has_value())
+                    counterexample = assignment;
+
+                found.store(true, std::memory_order_relaxed);
+                return false;
+            }
+
+            // ̃XbhĂΑł؂
+            return (++stepCount & 4095U) != 0U || !found.load(std::memory_order_relaxed);
+        });
+    });
+
+    if (!counterexample.has_value())
+        return std::nullopt;
+
+    VariableAssignment assignment;
+
+    for (std::size_t i = 0; i < this->mVariableNames.size(); ++i)
+        assignment[this->mVariableNames[i]] = ((counterexample.value() >> i) & 1U) != 0U;
+
+    return assignment;
+}
+
+std::optional<TruthTableVerdict> TruthTableEngine::Classify(std::optional<VariableAssignment>* counterexample) const
+{
+    // UɂȂ銄蓖Ă΍P^, ^ɂȂ銄蓖Ă΍PU
+    std::optional<VariableAssignment> falseAssignment = this->FindCounterexample(true);
+
+    if (this->mGovernor != nullptr && this->mGovernor->IsExhausted())
+        return std::nullopt;
+
+    if (!falseAssignment.has_value())
+        return TruthTableVerdict::Tautology;
+
+    std::optional<VariableAssignment> trueAssignment = this->FindCounterexample(false);
+
+    if (this->mGovernor != nullptr && this->mGovernor->IsExhausted())
+        return std::nullopt;
+
+    if (!trueAssignment.has_value())
+        return TruthTableVerdict::Contradiction;
+
+    if (counterexample != nullptr)
+        *counterexample = std::move(falseAssignment);
+
+    return TruthTableVerdict::Contingent;
+}
+
+std::optional<TruthTableSummary> TruthTableEngine::Enumerate(std::ostream* output) const
+{
+    if (!this->IsValid() || !this->ChargeAssignments())
+        return std::nullopt;
+
+    unsigned int lowBits = static_cast<unsigned int>(this->mVariableNames.size()) - this->SliceBits();
+    std::uint64_t sliceAssignmentCount = static_cast<std::uint64_t>(1U) << lowBits;
+    std::atomic<std::uint64_t> trueCount { 0U };
+    std::mutex outputMutex;
+    std::map<std::uint64_t, std::vector<std::uint8_t>> pendingBlocks;
+    std::uint64_t nextBlock = 0U;
+    bool outputFailed = false;
+
+    if (output != nullptr) {
+        output->write("LEPTRUTH", 8);
+        WriteValue<std::uint32_t>(*output, TruthTableVersion);
+        WriteValue<std::uint32_t>(*output, static_cast<std::uint32_t>(this->mVariableNames.size()));
+
+        for (const auto& variableName : this->mVariableNames) {
+            WriteValue<std::uint32_t>(*output, static_cast<std::uint32_t>(variableName.size()));
+            output->write(variableName.data(), static_cast<std::streamsize>(variableName.size()));
+        }
+    }
+
+    this->RunSlices([&](std::uint64_t slice, EvaluationState& state) {
+        std::vector<std::uint64_t> words(static_cast<std::size_t>((sliceAssignmentCount + 63U) / 64U), 0U);
+        std::uint64_t baseAssignment = slice << lowBits;
+
+        this->WalkSlice(state, slice, lowBits, [&](std::uint64_t assignment, bool value) {
+            std::uint64_t offset = assignment - baseAssignment;
+            words[static_cast<std::size_t>(offset >> 6)] |= static_cast<std::uint64_t>(value) << (offset & 63U);
+            return true;
+        });
+
+        std::uint64_t sliceTrueCount = 0U;
+
+        for (std::uint64_t word : words)
+            sliceTrueCount += PopulationCount(word);
+
+        trueCount.fetch_add(sliceTrueCount, std::memory_order_relaxed);
+
+        if (output == nullptr)
+            return true;
+
+        // k̓bN̊Oōs, o͋Ԃ̔ԍ̏ɂ
+        std::vector<std::uint8_t> block = CompressTruthTableBlock(words);
+        std::lock_guard<std::mutex> lock(outputMutex);
+        pendingBlocks.emplace(slice, std::move(block));
+
+        for (auto iter = pendingBlocks.begin(); iter != pendingBlocks.end() && iter->first == nextBlock;
+             iter = pendingBlocks.erase(iter), ++nextBlock) {
+            WriteValue<std::uint64_t>(*output, iter->first << lowBits);
+            WriteValue<std::uint64_t>(*output, sliceAssignmentCount);
+            WriteValue<std::uint32_t>(*output, static_cast<std::uint32_t>(iter->second.size()));
+            output->write(reinterpret_cast<const char*>(iter->second.data()), static_cast<std::streamsize>(iter->second.size()));
+        }
+
+        outputFailed = outputFailed || !*output;
+
+        return !outputFailed;
+    });
+
+    if (outputFailed)
+        return std::nullopt;
+
+    TruthTableSummary summary;
+    summary.mAssignmentCount = static_cast<std::uint64_t>(1U) << this->mVariableNames.size();
+    summary.mTrueCount = trueCount.load();
+    summary.mVerdict = (summary.mTrueCount == summary.mAssignmentCount) ? TruthTableVerdict::Tautology :
+                       (summary.mTrueCount == 0U) ? TruthTableVerdict::Contradiction : TruthTableVerdict::Contingent;
+
+    return summary;
+}
@@ -0,0 +1,122 @@
+// LogicalExpressionParser
+// TruthTable.hpp
+
+#ifndef LOGICAL_EXPRESSION_PARSER_TRUTH_TABLE_HPP
+#define LOGICAL_EXPRESSION_PARSER_TRUTH_TABLE_HPP
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Compiler.hpp"
+#include "Evaluator.hpp"
+
+class BaseAST;
+class ResourceGovernor;
+
+enum class TruthTableVerdict {
+    Tautology,
+    Contradiction,
+    Contingent
+};
+
+struct TruthTableSummary {
+    std::uint64_t       mAssignmentCount;
+    std::uint64_t       mTrueCount;
+    TruthTableVerdict   mVerdict;
+};
+
+/*
+^l\̏o͌` (gGfBA)
+    char[8]             "LEPTRUTH"
+    std::uint32_t        (TruthTableVersion)
+    std::uint32_t       ϐ̌ n
+    { std::uint32_t , char[] }[n]     ϐ (ϐ0蓖Ă̔ԍ̍ŉʃrbg)
+    { std::uint64_t 擪̊蓖Ă̔ԍ, std::uint64_t 蓖Ă̌,
+      std::uint32_t k̃oCg, std::uint8_t[] k̃f[^ }[ubN]
+eubN͊蓖Ă̔ԍ̏ɕ, 蓖Ă̔ԍi̒lrbgiɊi[64rbg̗
+OXk̂ł (Ȃϒ ( << 1 | JԂ) ̌,
+JԂłΌ1, łȂΒ̕u)
+ */
+constexpr std::uint32_t TruthTableVersion = 1U;
+
+/*
+SĂ̊蓖Ă񋓂^l\̌vZ
+蓖Ă̋Ԃʂ̕ϐŋ؂ăXbhɕ, eԂł͉ʂ̕ϐOCR[h̏
+ǂ̂, 1XebvŒlςϐ1ɂȂ
+l̕ςt獪ɌĒl̕ςߓ_݂̂ČvZ, lςȂȂőł؂
+ */
+class TruthTableEngine {
+public:
+    // 64rbg̊蓖Ă̔ԍŕ\͈ (p40ϐx܂)
+    static constexpr std::size_t MaxVariableCount = 63U;
+
+    TruthTableEngine(const std::shared_ptr<BaseAST>& logicalExprAST, unsigned int threadCount = 0U);
+    ~TruthTableEngine() = default;
+
+    inline bool IsValid() const { return !this->mNodes.empty() && this->mVariableNames.size() <= MaxVariableCount; }
+    inline const std::vector<std::string>& Variables() const { return this->mVariableNames; }
+    inline unsigned int ThreadCount() const { return this->mThreadCount; }
+    // 蓖Ă̗񋓂Ƃ, SĂ̊蓖Ă̌XebvƂė񋓂̑OɉZ
+    // (𒴂ꍇ͗񋓂n߂Ɏŝ, ł؂̗LŌʂς邱Ƃ͂Ȃ)
+    inline void SetGovernor(ResourceGovernor* governor) { this->mGovernor = governor; }
+
+    // lexpectedValuełȂ蓖Ă1T, _őSẴXbh~߂
+    std::optional<VariableAssignment> FindCounterexample(bool expectedValue) const;
+    // Xebv̏𒴂ꍇstd::nullopt
+    std::optional<TruthTableVerdict> Classify(std::optional<VariableAssignment>* counterexample = nullptr) const;
+
+    // SĂ̊蓖ĂɂĒl, outputnullptrłȂΈk^l\o
+    std::optional<TruthTableSummary> Enumerate(std::ostream* output) const;
+
+private:
+    static constexpr std::uint32_t NoParent = 0xFFFFFFFFU;
+
+    // ߓ_͌uɕׂ̂, q͕KeOɂ
+    struct Node {
+        OpCode          mOpCode;
+        std::uint32_t   mParent;
+        std::uint32_t   mFirstChild;
+        std::uint32_t   mChildCount;
+    };
+
+    // XbhƂ̕]̏
+    struct EvaluationState {
+        std::vector<std::uint8_t>   mValues;
+        std::vector<std::uint32_t>  mTrueCounts;
+    };
+
+    std::uint32_t AddNode(const BaseAST* exprAST);
+    void EvaluateAll(EvaluationState& state, std::uint64_t assignment) const;
+    void FlipVariable(EvaluationState& state, std::uint32_t variable) const;
+    bool ComputeNode(const EvaluationState& state, std::uint32_t nodeIndex) const;
+
+    unsigned int SliceBits() const;
+    bool ChargeAssignments() const;
+    // ԂƂsliceFunctionĂ, falseԂƎc̋Ԃɑł؂
+    void RunSlices(const std::function<bool(std::uint64_t, EvaluationState&)>& sliceFunction) const;
+    // ԓ̊蓖ĂOCR[h̏ɂǂ, 蓖Ă̔ԍƍ̒lvisitorɓn
+    template <typename Visitor>
+    bool WalkSlice(EvaluationState& state, std::uint64_t slice, unsigned int lowBits, Visitor&& visitor) const;
+
+    std::vector<Node> mNodes;
+    std::vector<std::uint32_t> mChildren;
+    std::vector<std::vector<std::uint32_t>> mVariableLeaves;
+    std::vector<std::string> mVariableNames;
+    std::unordered_map<std::string, std::uint32_t> mVariableIndices;
+    unsigned int mThreadCount;
+    ResourceGovernor* mGovernor;
+};
+
+// OXk^l\̃ubNWJ
+bool DecompressTruthTableBlock(const std::uint8_t* data, std::size_t size, std::vector<std::uint64_t>& words);
+
+#endif // LOGICAL_EXPRESSION_PARSER_TRUTH_TABLE_HPP